@@ -1,6 +1,8 @@
 #include "EditorContext.h"
 
+#include "Actor.h"
 #include "Component.h"
+#include "Game.h"
 
 auto EditorContext::BindToOnSelectedComponentChanged(SelectedComponentChangedDelegate Delegate) -> DelegateHandle
 {
@@ -15,19 +17,30 @@ auto EditorContext::UnbindFromSelectedComponentChanged(DelegateHandle& handle) -
 
 auto EditorContext::SetSelectedActor(Actor* InActor) -> void
 {
-	SelectedActor = InActor;
-	SelectedComponent = nullptr;
+	SelectedActor = InActor ? InActor->GetHandle() : ObjectHandle<Actor>();
+	SelectedComponent = ObjectHandle<Component>();
 
-	OnSelectedComponentChanged.Broadcast(SelectedComponent);
+	OnSelectedComponentChanged.Broadcast(nullptr);
+}
+
+auto EditorContext::GetSelectedActor() const -> Actor*
+{
+	return Game::GetInstance()->ResolveActor(SelectedActor);
 }
 
 auto EditorContext::SetSelectedComponent(Component* InComponent) -> void
 {
-	SelectedComponent = InComponent;
-	if (SelectedComponent)
+	SelectedComponent = InComponent ? InComponent->GetHandle() : ObjectHandle<Component>();
+	if (InComponent)
 	{
-		SelectedActor = SelectedComponent->GetOwner();
+		Actor* owner = InComponent->GetOwner();
+		SelectedActor = owner ? owner->GetHandle() : ObjectHandle<Actor>();
 	}
 
-	OnSelectedComponentChanged.Broadcast(SelectedComponent);
+	OnSelectedComponentChanged.Broadcast(InComponent);
+}
+
+auto EditorContext::GetSelectedComponent() const -> Component*
+{
+	return Game::GetInstance()->GetComponentHandles()->Get(SelectedComponent);
 }
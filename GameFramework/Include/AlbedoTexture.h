@@ -1,20 +1,16 @@
 #pragma once
-#include "Asset.h"
+#include "StreamedTexture.h"
 #include <WICTextureLoader.h>
 #include <wrl/client.h>
 
 using namespace Microsoft::WRL;
 
 
-class AlbedoTexture : public Asset
+class AlbedoTexture : public StreamedTexture
 {
 	friend class AssetManager;
 public:
-	auto GetSRV() -> ComPtr<ID3D11ShaderResourceView> { return TexSRV; }
-
-	virtual auto Load() -> bool override;
-
-private:
-	ComPtr<ID3D11Resource> Tex;
-	ComPtr<ID3D11ShaderResourceView> TexSRV;
+	// Cooking (see TextureCache) and texture creation happen in LoadData, the device is free threaded
+	virtual auto LoadData() -> bool override;
+	virtual auto GetTypeName() const -> const char* override { return "AlbedoTexture"; }
 };
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ComponentsEnum.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Actor;
+class Component;
+
+// Opt-in archetype index over actors and their components. It is an index layer only, the component data is not stored here:
+// components stay polymorphic objects owned by their actor (renderers, physics and Mono keep pointers to them),
+// and the columns hold pointers to them. What the chunks make contiguous is the set of components to visit,
+// each visit still reads the component wherever the object pool put it.
+//
+// Actors with the same set of component types share an archetype, which lists them in fixed size chunks:
+// for every component type of the archetype a chunk keeps a packed column with one component pointer per actor.
+// Queries then walk matching chunks linearly instead of searching every actor's component list.
+// When an actor has several components of the same type, the column holds the first one.
+class ArchetypeStorage
+{
+public:
+	using ComponentMask = uint64_t;
+	static_assert(Last <= 64, "ComponentMask can't fit all component types");
+
+	static constexpr uint32_t ChunkCapacity = 128;
+
+	static auto MakeMask(std::initializer_list<ComponentType> InTypes) -> ComponentMask;
+	static auto GetTypeBit(ComponentType InType) -> ComponentMask { return InType == Undefined ? 0 : 1ull << InType; }
+
+	// Read only view of a chunk rows, handed out by queries
+	class ChunkView
+	{
+	public:
+		auto GetNum() const -> uint32_t { return Num; }
+		auto GetActors() const -> Actor* const* { return Actors; }
+
+		// Column of components of the given type, InType must be part of the query
+		auto GetColumn(ComponentType InType) const -> Component* const*;
+
+		template<class T>
+		auto GetColumnAs(ComponentType InType) const -> T* const* { return reinterpret_cast<T* const*>(GetColumn(InType)); }
+
+	private:
+		friend class ArchetypeStorage;
+
+		uint32_t Num = 0;
+		Actor* const* Actors = nullptr;
+		Component* const* Columns = nullptr;
+		const int8_t* ColumnByType = nullptr;
+	};
+
+	// Places the actor into the archetype of the given components, indexed by ComponentType and null for the types it doesn't have.
+	// Actor::RefreshComponentIndex calls it after the component set changed
+	auto SetActorComponents(Actor* InActor, const Component* const (&InComponentsByType)[Last]) -> void;
+	auto RemoveActor(Actor* InActor) -> void;
+
+	// Calls InFunc(const ChunkView&) for every chunk whose archetype contains all InRequiredTypes
+	template<class Func>
+	auto ForEachChunk(std::initializer_list<ComponentType> InRequiredTypes, Func&& InFunc) const -> void
+	{
+		const ComponentMask required = MakeMask(InRequiredTypes);
+		for (const auto& [mask, archetype] : Archetypes)
+		{
+			if ((mask & required) != required)
+			{
+				continue;
+			}
+
+			for (const auto& chunk : archetype->Chunks)
+			{
+				if (chunk->Num == 0)
+				{
+					continue;
+				}
+
+				InFunc(MakeView(*archetype, *chunk));
+			}
+		}
+	}
+
+	auto GetNumArchetypes() const -> size_t { return Archetypes.size(); }
+	auto GetNumActors() const -> size_t { return Locations.size(); }
+
+private:
+	struct Chunk
+	{
+		uint32_t Num = 0;
+		Actor* Actors[ChunkCapacity] = {};
+		// Column after column, ChunkCapacity rows each
+		std::unique_ptr<Component*[]> Columns;
+	};
+
+	struct Archetype
+	{
+		ComponentMask Mask = 0;
+		uint32_t NumColumns = 0;
+		int8_t ColumnByType[Last] = {};
+		std::vector<std::unique_ptr<Chunk>> Chunks;
+	};
+
+	struct Location
+	{
+		Archetype* Owner = nullptr;
+		uint32_t ChunkIndex = 0;
+		uint32_t Row = 0;
+	};
+
+	auto FindOrCreateArchetype(ComponentMask InMask) -> Archetype*;
+	auto AddRow(Archetype& InArchetype, Actor* InActor, const Component* const* InComponentsByType) -> Location;
+	auto RemoveRow(const Location& InLocation) -> void;
+
+	static auto MakeView(const Archetype& InArchetype, const Chunk& InChunk) -> ChunkView;
+
+	std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> Archetypes;
+	std::unordered_map<const Actor*, Location> Locations;
+};
@@ -2,19 +2,132 @@
 
 #include "FileSystem.h"
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+enum class AssetLoadState : uint8_t
+{
+	Unloaded,
+	// Requested, the asset loader is still working on it
+	Loading,
+	Loaded,
+	Failed
+};
+
+// Memory held by the loaded data of an asset
+struct AssetMemoryUsage
+{
+	size_t CpuBytes = 0;
+	size_t GpuBytes = 0;
+};
+
 class Asset // : public Object?
 {
 	friend class AssetManager;
+	friend class AssetLoader;
+	friend class AssetResidency;
+	template<class T>
+	friend class AssetRef;
 public:
 
 	auto GetFullPath() const -> const Path& { return fullPath; }
 
-	virtual auto Load() -> bool { return false; }
+	auto GetLoadState() const -> AssetLoadState { return loadState; }
+	auto IsLoaded() const -> bool { return loadState == AssetLoadState::Loaded; }
+	// Incremented every time loaded data is published, users holding on to parts of the data compare it to pick up reloads
+	auto GetGeneration() const -> uint32_t { return generation; }
+
+	// Loads the asset on the calling thread
+	virtual auto Load() -> bool { return LoadData() && FinishLoad(); }
+
+	// Asynchronous loads are split in two steps.
+	// LoadData runs on an asset loader thread: file I/O and decoding, it must not touch what the main thread reads.
+	// FinishLoad runs on the main thread afterwards and publishes the data (GPU upload).
+	// Hot reload runs both steps again on a loaded asset, the old data stays in use until FinishLoad.
+	virtual auto LoadData() -> bool { return false; }
+	virtual auto FinishLoad() -> bool { return true; }
+
+	// Runs Load on an unloaded asset and publishes the result, the synchronous path of the asset manager
+	auto LoadSynchronously() -> bool
+	{
+		assert(loadState == AssetLoadState::Unloaded);
+		loadState = Load() ? AssetLoadState::Loaded : AssetLoadState::Failed;
+		generation += IsLoaded() ? 1 : 0;
+		return IsLoaded();
+	}
+
+	// Frees the loaded data, the asset manager does it to unreferenced assets when over its memory budget.
+	// The asset goes back to Unloaded and is loaded again on the next request.
+	virtual auto Unload() -> void { SetMemoryUsage({}); }
+
+	auto GetMemoryUsage() const -> const AssetMemoryUsage& { return memoryUsage; }
+	auto GetRefCount() const -> uint32_t { return refCount; }
+	virtual auto GetTypeName() const -> const char* { return "Asset"; }
+
+	// Bumped when memory usage changes or an asset loses its last reference, the asset manager checks its budget then
+	static auto GetResidencyClock() -> uint64_t { return ResidencyClock; }
 
 	virtual ~Asset() = default;
 
+protected:
+	// Called by subclasses when they publish or free data, on the main thread
+	auto SetMemoryUsage(const AssetMemoryUsage& InUsage) -> void { memoryUsage = InUsage; ++ResidencyClock; }
+	// For subclasses that swap in other data between loads (texture streaming), users pick it up like a reload
+	auto BumpGeneration() -> void { ++generation; }
+
 private:
+	auto AddRef() -> void { ++refCount; }
+	auto Release() -> void
+	{
+		assert(refCount > 0);
+		if (--refCount == 0)
+		{
+			lastReleaseTime = ++ResidencyClock;
+		}
+	}
+
+	static inline uint64_t ResidencyClock = 0;
+
+	AssetMemoryUsage memoryUsage;
+	uint32_t refCount = 0;
+	// Eviction order of unreferenced assets, least recently released first
+	uint64_t lastReleaseTime = 0;
+
 	Path fullPath;
+	AssetLoadState loadState = AssetLoadState::Unloaded;
+	uint32_t generation = 0;
+
+	// Set by the asset loader while the source of a loaded asset is imported again
+	bool bReloading = false;
+	// The source changed again while it was being loaded
+	bool bReloadRequested = false;
+};
+
+// Keeps an asset from being evicted while it is in use, main thread only like the asset manager
+template<class T>
+class AssetRef
+{
+public:
+	AssetRef() = default;
+	AssetRef(T* InAsset) : Ptr(InAsset) { if (Ptr) Ptr->AddRef(); }
+	AssetRef(const AssetRef& Other) : AssetRef(Other.Ptr) {}
+	AssetRef(AssetRef&& Other) noexcept : Ptr(std::exchange(Other.Ptr, nullptr)) {}
+	~AssetRef() { if (Ptr) Ptr->Release(); }
+
+	AssetRef& operator=(AssetRef Other) noexcept
+	{
+		std::swap(Ptr, Other.Ptr);
+		return *this;
+	}
+
+	auto Get() const -> T* { return Ptr; }
+	auto operator->() const -> T* { return Ptr; }
+	explicit operator bool() const { return Ptr != nullptr; }
+
+private:
+	T* Ptr = nullptr;
 };
 
 class TextureAsset : public Asset
@@ -35,4 +148,4 @@ class MaterialAsset : public Asset
 class MaterialInstanceAsset : public Asset
 {
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "DirectoryTree.h"
+#include "FileSystem.h"
+#include "JobSystem.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// What the asset browser needs to know about a file, without opening it
+struct AssetIndexEntry
+{
+	DirectoryTreeNodeType NodeType = DirectoryTreeNodeType::File;
+	AssetType Type = AssetType::Unspecified;
+
+	// Source state the entry was made from, a different one means the file is scanned again
+	int64_t WriteTime = 0;
+	uint64_t Size = 0;
+
+	// Meshes of an asset collection
+	std::vector<std::string> SubAssets;
+};
+
+// Recursive directory walk that never throws, entries and directories that can't be read are skipped
+auto WalkDirectory(const Path& InRoot, const std::function<void(const std::filesystem::directory_entry&)>& InVisit) -> void;
+
+// Persistent index of the asset directory.
+// Startup only walks the directory and compares write times and sizes with the saved index,
+// new and changed files are scanned in parallel on the job system and everything else comes from the index file.
+class AssetIndex
+{
+public:
+	// Fills the entry of a new or changed file, called from job system workers
+	using ScanFunction = std::function<void(const Path& InFilePath, AssetIndexEntry& OutEntry)>;
+
+	struct Item
+	{
+		// Relative to the indexed root
+		Path RelativePath;
+		bool bDirectory = false;
+		const AssetIndexEntry* Entry = nullptr;
+	};
+
+	struct Stats
+	{
+		uint32_t NumFiles = 0;
+		uint32_t NumScanned = 0;
+		uint32_t NumRemoved = 0;
+		float UpdateMs = 0.0f;
+	};
+
+	explicit AssetIndex(const Path& InIndexPath);
+	// Waits for the scan jobs of an unfinished update
+	~AssetIndex();
+
+	// A missing or broken index file leaves the index empty, the next update scans every file and rewrites it
+	auto Load() -> bool;
+	auto Save() const -> bool;
+
+	// Brings the index up to date with InRoot and waits for the scans, saves it when anything changed
+	auto Update(const Path& InRoot, const ScanFunction& InScan, JobSystem& InJobSystem) -> void;
+	// Same for the given files and directories only, they may have been removed
+	auto UpdatePaths(const Path& InRoot, const std::vector<Path>& InRelativePaths, const ScanFunction& InScan, JobSystem& InJobSystem) -> void;
+
+	// Non blocking updates: the directory is walked right away, the scans run as jobs and the index only changes
+	// in TryFinishUpdate. There is one update at a time, InScan has to stay callable until it is finished.
+	auto BeginUpdate(const Path& InRoot, const ScanFunction& InScan, JobSystem& InJobSystem) -> void;
+	auto BeginUpdatePaths(const Path& InRoot, const std::vector<Path>& InRelativePaths, const ScanFunction& InScan, JobSystem& InJobSystem) -> void;
+	auto IsUpdating() const -> bool { return Pending != nullptr; }
+	// Applies the scan results once the jobs are done, false while they still run
+	auto TryFinishUpdate() -> bool;
+
+	auto FindEntry(const Path& InRelativePath) const -> const AssetIndexEntry*;
+
+	// Directories and files in directory walk order, filled by full updates and valid until the next update of any kind
+	auto GetItems() const -> const std::vector<Item>& { return Items; }
+	// Files scanned or removed by the last update, relative to the root
+	auto GetChangedPaths() const -> const std::vector<Path>& { return ChangedPaths; }
+	auto GetStats() const -> const Stats& { return LastStats; }
+
+private:
+	struct PendingScan
+	{
+		Path FilePath;
+		Path RelativePath;
+		// Written by the scan job, moved into the index when the update finishes
+		AssetIndexEntry Entry;
+	};
+
+	struct PendingUpdate
+	{
+		ScanFunction Scan;
+		JobSystem* Jobs = nullptr;
+		JobCounter Counter;
+		std::chrono::steady_clock::time_point Start;
+
+		bool bFull = false;
+		std::vector<Item> Items;
+		std::vector<PendingScan> Scans;
+		std::vector<std::string> RemovedKeys;
+		Stats UpdateStats;
+	};
+
+	auto StartUpdate(const ScanFunction& InScan, JobSystem& InJobSystem) -> PendingUpdate&;
+	// Queues a scan when a regular file is new or changed, false for anything else
+	auto CheckFile(const std::filesystem::directory_entry& InDirEntry, const Path& InRelativePath,
+		PendingUpdate& OutUpdate, std::unordered_set<std::string>& OutSeenPaths) -> bool;
+	auto SubmitScans() -> void;
+	// Collects entries at or below InPrefix (everything when empty) that weren't seen
+	auto CollectUnseen(const std::string& InPrefix, const std::unordered_set<std::string>& InSeenPaths, PendingUpdate& OutUpdate) const -> void;
+
+	Path IndexPath;
+
+	// Keyed by the generic relative path
+	std::unordered_map<std::string, AssetIndexEntry> Entries;
+	std::vector<Item> Items;
+	std::vector<Path> ChangedPaths;
+
+	std::unique_ptr<PendingUpdate> Pending;
+
+	Stats LastStats;
+	// The index file is missing, broken or failed to save and has to be written even if nothing changed
+	bool bSaveNeeded = false;
+};
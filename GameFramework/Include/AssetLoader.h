@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Asset;
+
+// Loads assets in the background.
+// Dedicated threads run Asset::LoadData (file I/O, Assimp, WIC) so long imports never stall the frame jobs,
+// the main thread then finishes decoded assets with Asset::FinishLoad in Tick, within a time budget.
+// Everything but the worker threads is main thread only.
+class AssetLoader
+{
+public:
+	explicit AssetLoader(uint32_t InNumThreads = 2);
+	~AssetLoader();
+
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	// InAsset has to be unloaded, it stays in the Loading state until a Tick finishes it
+	auto Enqueue(Asset* InAsset) -> void;
+	// Imports the source of InAsset again, a loaded asset keeps its current data until a Tick swaps the new one in
+	auto Reload(Asset* InAsset) -> void;
+
+	// Finishes decoded assets in request order, at least one and then until InBudgetMs is spent
+	auto Tick(float InBudgetMs) -> void;
+
+	// Blocks until InAsset is decoded and finishes it, an asset no thread has picked yet is decoded on the calling thread
+	auto Wait(Asset* InAsset) -> void;
+	auto WaitAll() -> void;
+
+	auto GetNumInFlight() const -> uint32_t { return NumInFlight; }
+
+private:
+	struct QueuedAsset
+	{
+		Asset* LoadedAsset;
+		bool bReload;
+	};
+
+	struct DecodedAsset
+	{
+		Asset* LoadedAsset;
+		bool bReload;
+		bool bSucceeded;
+	};
+
+	auto ThreadLoop() -> void;
+	auto Push(const QueuedAsset& InQueued) -> void;
+	auto Finish(const DecodedAsset& InDecoded) -> void;
+
+	std::vector<std::thread> Threads;
+
+	std::mutex Mutex;
+	std::condition_variable WorkCondition;
+	std::condition_variable DecodedCondition;
+	std::deque<QueuedAsset> Queued;
+	std::deque<DecodedAsset> Decoded;
+	bool bStopRequested = false;
+
+	uint32_t NumInFlight = 0;
+};
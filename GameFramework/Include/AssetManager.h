@@ -2,12 +2,23 @@
 
 #include "MeshLoader.h"
 
+#include "Asset.h"
+#include "AssetResidency.h"
 #include "FileSystem.h"
+#include <map>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 class Asset;
+class AssetIndex;
+struct AssetIndexEntry;
+class AssetLoader;
+class AssetWatcher;
 class DirectoryTree;
+class MeshCache;
+class TextureCache;
+class TextureStreamer;
 class StaticMesh;
 class AlbedoTexture;
 class NormalTexture;
@@ -16,6 +27,9 @@ class AssetManager
 {
 public:
 
+	AssetManager();
+	~AssetManager();
+
 	auto Initialize() -> void;
 
 	template<class K, class V>
@@ -24,7 +38,35 @@ public:
 	auto LoadStaticMesh(const Path& path)->StaticMesh*;
 	auto LoadAlbedoTexture(const Path& path)->AlbedoTexture*;
 	auto LoadNormalTexture(const Path& path) -> NormalTexture*;
-	
+
+	// Asynchronous versions of the above: the asset is returned right away and loaded in the background,
+	// check IsLoaded() before using its data. Loading it synchronously meanwhile waits for it.
+	auto RequestStaticMesh(const Path& path) -> StaticMesh*;
+	auto RequestAlbedoTexture(const Path& path) -> AlbedoTexture*;
+	auto RequestNormalTexture(const Path& path) -> NormalTexture*;
+
+	// Applies settled changes of the asset directory and finishes requested assets once they are decoded,
+	// called by the game every frame
+	auto Tick() -> void;
+
+	// Main thread time Tick may spend on finishing assets (GPU uploads), at least one is finished per frame
+	auto SetUploadBudgetMs(float budget) -> void { uploadBudgetMs = budget; }
+	auto GetUploadBudgetMs() const -> float { return uploadBudgetMs; }
+
+	// Unreferenced assets (see AssetRef) are unloaded, least recently released first, while resident memory is over budget
+	auto SetMemoryBudget(size_t cpuBytes, size_t gpuBytes) -> void { residency.SetMemoryBudget(cpuBytes, gpuBytes); }
+	auto GetCpuMemoryBudget() const -> size_t { return residency.GetCpuMemoryBudget(); }
+	auto GetGpuMemoryBudget() const -> size_t { return residency.GetGpuMemoryBudget(); }
+
+	// Resident memory per asset type name and in total, updated by Tick
+	auto GetMemoryStatsByType() const -> const std::map<std::string, AssetMemoryStats>& { return residency.GetMemoryStatsByType(); }
+	auto GetTotalMemoryStats() const -> const AssetMemoryStats& { return residency.GetTotalMemoryStats(); }
+	auto GetNumEvicted() const -> uint64_t { return residency.GetNumEvicted(); }
+
+	auto GetAssetLoader() const -> AssetLoader* { return assetLoader.get(); }
+	auto GetMeshCache() const -> MeshCache* { return meshCache.get(); }
+	auto GetTextureCache() const -> TextureCache* { return textureCache.get(); }
+	auto GetTextureStreamer() const -> TextureStreamer* { return textureStreamer.get(); }
 
 	/*Asset* LoadAsset(const Path& AssetPath) {}
 
@@ -46,11 +88,45 @@ private:
 
 	AssetMapType<std::filesystem::path, Asset*> LoadedAssetsMap;
 
+	std::unique_ptr<MeshCache> meshCache;
+	std::unique_ptr<TextureCache> textureCache;
+	std::unique_ptr<TextureStreamer> textureStreamer;
+	std::unique_ptr<AssetIndex> assetIndex;
+	std::unique_ptr<AssetLoader> assetLoader;
+	std::unique_ptr<AssetWatcher> assetWatcher;
+	// What the index update in flight was started for
+	std::vector<Path> pendingChangedPaths;
+	bool bPendingFullRescan = false;
+	float uploadBudgetMs = 4.0f;
+
+	AssetResidency residency;
+
 private:
 	Path assetsPath = Path("../Assets");
 	Path projectPath = Path("../");
 
+	// Startup: updates the index and waits for the scans
 	auto FillDirectoryTree() -> void;
+	auto FillDirectoryTreeFromIndex() -> void;
+	// Fills the index entry of a new or changed file, runs on job system workers
+	auto ScanAssetFile(const Path& filePath, AssetIndexEntry& entry) -> void;
+	auto AddFileNode(const Path& relativePath, const AssetIndexEntry& entry) -> void;
+
+	// Hot reload: starts an index update for what the watcher reported, a later tick applies it to
+	// the directory tree and imports loaded assets of changed files again
+	auto ProcessAssetChanges() -> void;
+	auto ApplyAssetChanges() -> void;
+	auto RefreshDirectoryTreeNode(const Path& relativePath) -> void;
+	auto ReloadAssetsFromFile(const Path& filePath) -> void;
+
+	auto EnforceMemoryBudget() -> void;
 
 	auto IsAssetCollectionExtension(const Path& extension) const -> bool;
+
+	template<class T>
+	auto FindOrAddAsset(const Path& path) -> T*;
+	template<class T>
+	auto LoadAsset(const Path& path) -> T*;
+	template<class T>
+	auto RequestAsset(const Path& path) -> T*;
 };
\ No newline at end of file
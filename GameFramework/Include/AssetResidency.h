@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Asset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+struct AssetMemoryStats
+{
+	uint32_t NumResident = 0;
+	size_t CpuBytes = 0;
+	size_t GpuBytes = 0;
+};
+
+// Memory budget of the loaded assets, owned by the asset manager.
+// Unreferenced assets (see AssetRef) are unloaded, least recently released first, while resident memory is over budget.
+// Evicted assets go back to Unloaded and are loaded again on the next request.
+class AssetResidency
+{
+public:
+	auto SetMemoryBudget(size_t InCpuBytes, size_t InGpuBytes) -> void;
+	auto GetCpuMemoryBudget() const -> size_t { return CpuMemoryBudget; }
+	auto GetGpuMemoryBudget() const -> size_t { return GpuMemoryBudget; }
+
+	// Nothing was loaded, unloaded or released since the last update
+	auto IsUpToDate() const -> bool { return Asset::GetResidencyClock() == LastResidencyClock; }
+	// Counts the memory of InAssets and evicts while over budget, main thread only
+	auto Update(const std::vector<Asset*>& InAssets) -> void;
+
+	// Resident memory per asset type name and in total, as of the last update
+	auto GetMemoryStatsByType() const -> const std::map<std::string, AssetMemoryStats>& { return MemoryStatsByType; }
+	auto GetTotalMemoryStats() const -> const AssetMemoryStats& { return TotalMemoryStats; }
+	auto GetNumEvicted() const -> uint64_t { return NumEvicted; }
+
+private:
+	auto UpdateMemoryStats(const std::vector<Asset*>& InAssets) -> void;
+	auto IsOverMemoryBudget() const -> bool;
+
+	size_t CpuMemoryBudget = size_t(256) << 20;
+	size_t GpuMemoryBudget = size_t(1024) << 20;
+	std::map<std::string, AssetMemoryStats> MemoryStatsByType;
+	AssetMemoryStats TotalMemoryStats;
+	uint64_t NumEvicted = 0;
+	// Asset::GetResidencyClock() when the budget was last checked
+	uint64_t LastResidencyClock = ~0ull;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "FileSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Watches the asset directory on a background thread and collects what changed.
+// Uses ReadDirectoryChangesW and falls back to comparing directory snapshots when the directory can't be watched
+// (network shares, some virtual file systems).
+// A path is reported once it has been quiet for the debounce time, so files that are still being written are picked up once.
+class AssetWatcher
+{
+public:
+	AssetWatcher(const Path& InRoot, uint32_t InDebounceMs = 300, uint32_t InPollIntervalMs = 1000);
+	~AssetWatcher();
+
+	AssetWatcher(const AssetWatcher&) = delete;
+	AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+	// Moves settled changes to OutRelativePaths (files or directories, possibly removed).
+	// Returns true when changes were lost and everything has to be checked again.
+	auto PopSettledChanges(std::vector<Path>& OutRelativePaths) -> bool;
+
+	auto IsPolling() const -> bool { return bPolling; }
+
+private:
+	auto ThreadLoop() -> void;
+	// Returns false if the directory can't be watched natively
+	auto WatchLoop() -> bool;
+	auto PollLoop() -> void;
+
+	auto AddChange(const Path& InRelativePath) -> void;
+	auto RequestFullRescan() -> void;
+
+	struct FileState
+	{
+		int64_t WriteTime = 0;
+		uint64_t Size = 0;
+		bool bDirectory = false;
+	};
+	using Snapshot = std::unordered_map<Path, FileState>;
+	auto TakeSnapshot() const -> Snapshot;
+
+	Path Root;
+	std::chrono::milliseconds Debounce;
+	std::chrono::milliseconds PollInterval;
+
+	std::mutex Mutex;
+	// Last time each path changed
+	std::unordered_map<Path, std::chrono::steady_clock::time_point> PendingChanges;
+	bool bFullRescanRequested = false;
+
+	// Win32 event that wakes the thread up to stop
+	void* StopEvent = nullptr;
+	std::atomic<bool> bPolling = false;
+	std::thread Thread;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "FileSystem.h"
+#include "JsonInclude.h"
+
+// Little endian binary output used by the binary level format.
+// Strings written with WriteStringRef are stored once in a string table and referenced by index,
+// the table is written by the owner of the writer (see Serializer).
+class BinaryWriter
+{
+public:
+	template<class T>
+	auto Write(const T& InValue) -> void
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written as is");
+		WriteBytes(&InValue, sizeof(T));
+	}
+
+	auto WriteBytes(const void* InData, size_t InSize) -> void;
+
+	// Overwrites a value written earlier, used for sizes and offsets known only later
+	template<class T>
+	auto Patch(size_t InOffset, const T& InValue) -> void
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written as is");
+		assert(InOffset + sizeof(T) <= Buffer.size());
+		std::memcpy(Buffer.data() + InOffset, &InValue, sizeof(T));
+	}
+
+	// Length prefixed string stored inline
+	auto WriteString(std::string_view InString) -> void;
+	// Index into the string table, use for asset paths and names that repeat a lot
+	auto WriteStringRef(std::string_view InString) -> void;
+	auto WriteUuid(const uuid& InId) -> void;
+	// Size prefixed blob, InJson is stored as MessagePack
+	auto WriteJson(const json& InJson) -> void;
+
+	auto GetSize() const -> size_t { return Buffer.size(); }
+	auto GetBuffer() const -> const std::vector<uint8_t>& { return Buffer; }
+	auto GetStrings() const -> const std::vector<std::string>& { return Strings; }
+
+private:
+	std::vector<uint8_t> Buffer;
+
+	std::vector<std::string> Strings;
+	std::unordered_map<std::string, uint32_t> StringIndices;
+};
+
+// Reads what BinaryWriter wrote, directly from memory (usually a mapped file).
+// Reading past the end or a bad string reference marks the reader as failed and returns zeroed values,
+// check IsValid() after reading a block.
+class BinaryReader
+{
+public:
+	BinaryReader(const uint8_t* InData, size_t InSize, const std::vector<std::string_view>* InStrings = nullptr);
+
+	template<class T>
+	auto Read() -> T
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read as is");
+		T value{};
+		ReadBytes(&value, sizeof(T));
+		return value;
+	}
+
+	auto ReadBytes(void* OutData, size_t InSize) -> bool;
+	// Returns a pointer into the source memory and moves past InSize bytes
+	auto ReadView(size_t InSize) -> const uint8_t*;
+
+	auto ReadString() -> std::string_view;
+	auto ReadStringRef() -> std::string_view;
+	auto ReadUuid() -> uuid;
+	auto ReadJson() -> json;
+
+	auto Skip(size_t InSize) -> void { ReadView(InSize); }
+
+	// Caps an element count read from the data by how many elements of at least InMinElementSize bytes are left,
+	// a corrupt count can't make a reserve() allocate more than the data could hold
+	auto ClampCount(uint32_t InCount, size_t InMinElementSize) const -> uint32_t
+	{
+		const size_t maxCount = (Size - Offset) / (InMinElementSize > 0 ? InMinElementSize : 1);
+		return InCount < maxCount ? InCount : static_cast<uint32_t>(maxCount);
+	}
+
+	auto IsValid() const -> bool { return bValid; }
+	auto GetOffset() const -> size_t { return Offset; }
+	auto GetRemaining() const -> size_t { return Size - Offset; }
+	auto GetStrings() const -> const std::vector<std::string_view>* { return Strings; }
+
+private:
+	auto Fail() -> void;
+
+	const uint8_t* Data;
+	size_t Size;
+	size_t Offset = 0;
+	const std::vector<std::string_view>* Strings;
+	bool bValid = true;
+};
+
+// Read only memory mapping of a whole file, a file mapping on Windows and mmap elsewhere
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	auto Open(const Path& InPath) -> bool;
+	auto Close() -> void;
+
+	auto GetData() const -> const uint8_t* { return Data; }
+	auto GetSize() const -> size_t { return Size; }
+
+private:
+	// Windows handles, unused with mmap
+	void* FileHandle = nullptr;
+	void* MappingHandle = nullptr;
+	const uint8_t* Data = nullptr;
+	size_t Size = 0;
+};
+
+// Writes InData under a temporary name and renames it, readers never see a truncated file
+auto WriteFileAtomically(const Path& InPath, const std::vector<uint8_t>& InData) -> bool;
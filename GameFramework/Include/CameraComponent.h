@@ -17,11 +17,11 @@ public:
 
 
 	static auto Create() -> Component* {
-		return new CameraComponent();
+		return ObjectPools::New<CameraComponent>();
 	}
 
 
-	MonoCameraComponent* mMonoComponent = new MonoCameraComponent();
+	MonoCameraComponent* mMonoComponent = ObjectPools::New<MonoCameraComponent>();
 
 	auto GetPOVData() const -> const Camera&;
 
@@ -2,6 +2,8 @@
 #include "FactoryRegistry.h"
 #include <string>
 #include "ComponentsEnum.h"
+#include "JsonInclude.h"
+#include "LevelConverter.h"
 
 class Component;
 
@@ -12,12 +14,16 @@ public:
 	static std::string GetNameByType(ComponentType type);
 	static Component* CreateByName(std::string& name);
 	static Component* CreateByType(ComponentType type);
+	// Level conversion without creating components: the json Serialize writes to what SerializeBinary writes and back.
+	// Types without a converter store the json (see Component::SerializeBinary and LevelConverter).
+	static auto GetBinaryConverters() -> const LevelConverter::ComponentConverters& { return BinaryConverters; }
 	static void Init();
 	static void Validate();
 private:
 	ComponentRegistry(): FactoryRegistry() {}
 
 	static void Register(ComponentType type, const std::string& name, FactoryFunction factory);
+	static void RegisterBinaryConverter(const std::string& name, LevelConverter::JsonToBinaryFunction toBinary, LevelConverter::BinaryToJsonFunction toJson);
 	static auto GetInstance() -> ComponentRegistry*
 	{
 		if(Instance == nullptr) {
@@ -30,4 +36,5 @@ private:
 	static ComponentRegistry* Instance;
 	static std::unordered_map<ComponentType, std::string> TypeToName;
 	static std::unordered_map<std::string, ComponentType> NameToType;
+	static LevelConverter::ComponentConverters BinaryConverters;
 };
\ No newline at end of file
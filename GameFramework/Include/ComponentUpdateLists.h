@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ComponentsEnum.h"
+#include "UpdateList.h"
+
+#include <array>
+#include <vector>
+
+class Component;
+
+// Components of all actors grouped by ComponentType, so that every type is updated in one tight loop
+// without RTTI. Components without a type (Undefined) share their own list.
+//
+// Update order, by type:
+// RigidBodyCubeType, RigidBodySphereType, then Undefined and the other types in ComponentType order
+// (MeshRendererType, StaticMeshRendererType, LightPointType, SceneComponentType, MovementComponentType, ...).
+// Within a type the order is unspecified: registration order until a removal moves the last component into the freed slot.
+// Components must not rely on the order among components of the same type.
+//
+// Components registered during UpdateAll are updated in the same frame when their type's list hasn't been passed yet.
+// Components unregistered (destroyed) during UpdateAll aren't updated any more, the lists are compacted after every list update.
+class ComponentUpdateLists
+{
+public:
+	auto Register(Component* InComponent) -> void;
+	auto Unregister(Component* InComponent) -> void;
+
+	// Rigid bodies go first so that other components see transforms synced from the physics step
+	auto UpdateAll(float DeltaTime) -> void;
+
+	// Has null entries for components unregistered while their list is being updated
+	auto GetComponents(ComponentType InType) const -> const std::vector<Component*>& { return Lists[GetListIndex(InType)].GetObjects(); }
+
+private:
+	static auto GetListIndex(ComponentType InType) -> size_t { return InType == Undefined ? 0 : static_cast<size_t>(InType); }
+
+	auto UpdateComponents(UpdateList<Component>& InList, float DeltaTime) -> void;
+
+	std::array<UpdateList<Component>, Last> Lists;
+};
@@ -3,6 +3,7 @@
 #include <type_traits>
 
 #include "Game.h"
+#include "ObjectPool.h"
 
 class Actor;
 
@@ -11,7 +12,7 @@ auto CreateActor() -> T*
 {
 	static_assert(std::is_base_of_v<Actor, T>, "Use this only to create actors");
 
-	T* newActor = new T();
+	T* newActor = ObjectPools::New<T>();
 
 	if (newActor)
 		Game::GetInstance()->Actors.push_back(newActor);
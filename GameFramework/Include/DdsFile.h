@@ -0,0 +1,44 @@
+#pragma once
+
+#include <dxgiformat.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reading of .dds files in place, the subresources point into the file data so a mapped file is uploaded without copies.
+// Parsing is CPU only and checks every size against the data, it doesn't need a device.
+
+// One mip of one array slice, in the layout D3D11_SUBRESOURCE_DATA wants
+struct DdsSubresource
+{
+	const uint8_t* Data = nullptr;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	size_t RowPitch = 0;
+	size_t SlicePitch = 0;
+};
+
+struct DdsTextureInfo
+{
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t MipLevels = 0;
+	// Faces count as slices for cube maps, 6 per cube
+	uint32_t ArraySize = 0;
+	bool bCubeMap = false;
+	DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+
+	// MipLevels subresources for every slice, slice 0 first as D3D11CalcSubresource numbers them
+	std::vector<DdsSubresource> Subresources;
+};
+
+// 2D textures, arrays and cube maps with a DX10 header or the common legacy pixel formats.
+// False for volume textures, formats without a known pitch and data that is too short
+auto ParseDdsTexture(const uint8_t* InData, size_t InSize, DdsTextureInfo& OutInfo) -> bool;
+
+// Pitches of one mip, false for formats ParseDdsTexture doesn't support
+auto GetDdsSurfacePitch(DXGI_FORMAT InFormat, uint32_t InWidth, uint32_t InHeight, size_t& OutRowPitch, size_t& OutSlicePitch) -> bool;
+
+// Coarsest mip a texture can be created from, block compressed top levels have to be a multiple of 4
+auto GetDdsMaxFirstMip(const DdsTextureInfo& InInfo) -> uint32_t;
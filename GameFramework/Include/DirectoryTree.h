@@ -42,9 +42,10 @@ private:
 	DirectoryTreeNode* parent = nullptr;
 	std::vector<DirectoryTreeNode*> children = {};
 
-	size_t counts[static_cast<size_t>(DirectoryTreeNodeType::Max)];
+	size_t counts[static_cast<size_t>(DirectoryTreeNodeType::Max)] = {};
 private:
 	auto AddChildNode(DirectoryTreeNode* node)->void;
+	auto RemoveChildNode(DirectoryTreeNode* node)->void;
 	DirectoryTreeNode(Path p, DirectoryTreeNodeType nodeType);
 
 public: 
@@ -81,6 +82,8 @@ private:
 
 	DirectoryTreeNode* root;
 	auto AddNodeByPath(const Path& path, DirectoryTreeNodeType nodeType, AssetType assetType = AssetType::Unspecified) -> DirectoryTreeNode*;
+	// Deletes the node and everything below it, path is relative to the root like in AddNodeByPath
+	auto RemoveNodeByPath(const Path& path) -> bool;
 	
 public:
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Delegates.h"
+#include "HandleRegistry.h"
 
 class Actor;
 class Component;
@@ -20,18 +21,19 @@ public:
 	auto BindToOnSelectedComponentChanged(SelectedComponentChangedDelegate Delegate) -> DelegateHandle;
 	auto UnbindFromSelectedComponentChanged(DelegateHandle& handle) -> void;
 
+	// Selection is kept by handle, getters return nullptr once the selected object is destroyed
 	auto SetSelectedActor(Actor* InActor) -> void;
-	auto GetSelectedActor() const->Actor* { return SelectedActor; }
+	auto GetSelectedActor() const->Actor*;
 
 	auto SetSelectedComponent(Component* InComponent) -> void;
-	auto GetSelectedComponent() const ->Component*  { return SelectedComponent; }
+	auto GetSelectedComponent() const ->Component*;
 
 	auto SetSelectedDirectory(const Path& path) -> void { selectedDirectory = path; }
 	auto GetSelectedDirectory() const -> const Path& { return selectedDirectory; }
 
 private:
-	Actor* SelectedActor = nullptr;
-	Component* SelectedComponent;
+	ObjectHandle<Actor> SelectedActor;
+	ObjectHandle<Component> SelectedComponent;
 
 	Path selectedDirectory;
 
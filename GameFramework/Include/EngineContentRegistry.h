@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "Singleton.h"
+#include "TextureArrayPacker.h"
 
 class Actor;
 class Game;
@@ -43,6 +44,9 @@ public:
 
 	auto GetWhiteTexSRV()->ComPtr<ID3D11ShaderResourceView> { return WhiteTexSRV; }
 	auto GetBasicNormalTexSRV()->ComPtr<ID3D11ShaderResourceView> { return BasicNormalTexSRV; }
+	// Slices of the placeholders in the texture arrays
+	auto GetWhiteTexArraySlot() const -> const TextureArraySlot& { return WhiteTexArraySlot; }
+	auto GetBasicNormalTexArraySlot() const -> const TextureArraySlot& { return BasicNormalTexArraySlot; }
 
 	auto GetFolderTexSRV()->ComPtr<ID3D11ShaderResourceView> { return FolderTexSRV; }
 	auto GetGenericFileTexSRV()->ComPtr<ID3D11ShaderResourceView> { return GenericFileTexSRV; }
@@ -58,6 +62,16 @@ public:
 		return DefaultVertexShader;
 	}
 
+	// For meshes cooked with PackedTexturedVertex
+	auto GetPackedVertexShader() const -> VertexShader* {
+		return PackedVertexShader;
+	}
+
+	// The default pixel shader sampling albedo and normal from texture arrays, see TextureArrayTable
+	auto GetTextureArrayPixelShader() const -> PixelShader* {
+		return TextureArrayPixelShader;
+	}
+
 	auto GetPosColorVertexShader() const -> VertexShader*
 	{
 		return PosColorVertexShader;
@@ -91,6 +105,9 @@ private:
 	ComPtr<ID3D11Resource> BasicNormalTex;
 	ComPtr<ID3D11ShaderResourceView> BasicNormalTexSRV;
 
+	TextureArraySlot WhiteTexArraySlot;
+	TextureArraySlot BasicNormalTexArraySlot;
+
 	ComPtr<ID3D11Resource> FolderTex;
 	ComPtr<ID3D11ShaderResourceView> FolderTexSRV;
 
@@ -104,7 +121,9 @@ private:
 	RenderPrimitiveProxy* SphereMeshProxy;
 
 	VertexShader* DefaultVertexShader;
+	VertexShader* PackedVertexShader;
 	PixelShader* DefaultPixelShader;
+	PixelShader* TextureArrayPixelShader;
 
 	VertexShader* PosColorVertexShader;
 	PixelShader* PosColorPixelShader;
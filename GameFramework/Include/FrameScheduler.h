@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+enum class FramePhase : uint8_t
+{
+	PrePhysics,
+	Physics,
+	PostPhysics,
+	Script,
+	PreRender,
+
+	Count
+};
+
+// Data a tick function touches, ticks of the same phase that don't write anything the other one uses run in parallel
+using TickResourceMask = uint64_t;
+
+enum TickResource : TickResourceMask
+{
+	TickResourceNone = 0,
+
+	TickResourceTransforms = 1ull << 0,
+	TickResourcePhysics = 1ull << 1,
+	TickResourceRenderers = 1ull << 2,
+	TickResourceScripts = 1ull << 3,
+	TickResourceAudio = 1ull << 4,
+	TickResourceDebugDraw = 1ull << 5,
+	TickResourceGameComponents = 1ull << 6,
+	TickResourceNavigation = 1ull << 7,
+
+	TickResourceAll = ~0ull
+};
+
+struct TickFunction
+{
+	std::string Name;
+	FramePhase Phase = FramePhase::Script;
+
+	// The defaults conflict with every other tick, declare what the tick really touches so it can overlap others
+	TickResourceMask Reads = TickResourceAll;
+	TickResourceMask Writes = TickResourceAll;
+
+	// Mono, D3D immediate context and Bullet calls have to stay on the main thread
+	bool bMainThreadOnly = true;
+
+	std::function<void(float)> Function;
+};
+
+// Runs registered tick functions phase by phase.
+// Inside a phase ticks keep their registration order for everything they conflict on,
+// independent ticks are dispatched to the job system together.
+class FrameScheduler
+{
+public:
+	using TickHandle = uint32_t;
+
+	explicit FrameScheduler(JobSystem* InJobSystem);
+
+	// Changes are applied at the start of the next Tick(), so ticks may (un)register others safely
+	auto RegisterTick(TickFunction&& InTick) -> TickHandle;
+	auto UnregisterTick(TickHandle InHandle) -> void;
+
+	auto Tick(float DeltaTime) -> void;
+
+	// Duration of the phase during the last frame, in milliseconds
+	auto GetPhaseTime(FramePhase InPhase) const -> float { return PhaseTimes[static_cast<size_t>(InPhase)]; }
+	static auto GetPhaseName(FramePhase InPhase) -> const char*;
+	// Groups of ticks that run one after another in the phase, one per tick when nothing overlaps
+	auto GetNumWaves(FramePhase InPhase) const -> size_t { return PhaseWaves[static_cast<size_t>(InPhase)].size(); }
+
+private:
+	struct RegisteredTick
+	{
+		TickHandle Handle;
+		TickFunction Tick;
+	};
+
+	// Ticks of a phase split into waves, every tick of a wave is independent from the others in it
+	using Wave = std::vector<const RegisteredTick*>;
+
+	auto ApplyPendingChanges() -> void;
+	auto RebuildWaves() -> void;
+	auto RunWave(const Wave& InWave, float DeltaTime) -> void;
+
+	JobSystem* Jobs;
+
+	std::vector<RegisteredTick> Ticks;
+	std::vector<RegisteredTick> PendingTicks;
+	std::vector<TickHandle> PendingRemovals;
+	TickHandle NextHandle = 0;
+
+	std::array<std::vector<Wave>, static_cast<size_t>(FramePhase::Count)> PhaseWaves;
+
+	std::array<float, static_cast<size_t>(FramePhase::Count)> PhaseTimes = {};
+};
@@ -18,12 +18,14 @@
 #include "JsonInclude.h"
 #include "UUIDGenerator.h"
 #include "JsonSerializers.h"
+#include "HandleRegistry.h"
 
 
 
 using Path = std::filesystem::path;
 
 class Actor;
+class Component;
 class AssetManager;
 class RenderingSystem;
 class ImGuiSubsystem;
@@ -31,9 +33,20 @@ class EngineContentRegistry;
 class Serializer;
 class CameraComponent;
 class RecastNavigationManager;
+class TransformStore;
+class JobSystem;
+class FrameScheduler;
+class ComponentUpdateLists;
+class ArchetypeStorage;
+class BinaryWriter;
+class BinaryReader;
+class PlaySnapshot;
 
 using namespace Microsoft::WRL;
 
+using ActorHandle = ObjectHandle<Actor>;
+using ComponentHandle = ObjectHandle<Component>;
+
 // TODO: try to remove everything apart from game from this header to include it in less files
 #pragma pack(push, 4)
 struct DirLight
@@ -59,6 +72,7 @@ public:
 	friend int main();
 	friend class Actor;
 	friend ImGuiSubsystem;
+	friend class PlaySnapshot;
 	template<class T>
 	friend auto CreateActor()->T*;
 
@@ -191,6 +205,9 @@ public:
 
 	json Serialize() const;
 	void Deserialize(const json* in, bool destructive = false);
+	// Binary level format, see Serializer for the file layout
+	void SerializeBinary(BinaryWriter& out) const;
+	void DeserializeBinary(BinaryReader& in, bool destructive = false);
 	UUIDGenerator* GetUuidGenerator() const;
 
 	auto GetImGuiSubsystem() const -> ImGuiSubsystem* { return mImGuiSubsystem; }
@@ -226,6 +243,14 @@ private:
 
 	void InitializeInternal();
 
+	// Deletes every actor before a destructive level load
+	void DestroyAllActors();
+	// Grows actor storage once before a level with that many actors and components is loaded
+	void ReserveForLevel(size_t numActors, size_t numComponents);
+
+	// Registers engine tick functions that used to be hardcoded in UpdateInternal
+	void RegisterEngineTicks();
+
 private:
 	
 	class InputDevice* Input = nullptr;
@@ -264,6 +289,21 @@ private:
 
 	std::unique_ptr<RecastNavigationManager> recastNavigationManager;
 
+	std::unique_ptr<TransformStore> transformStore;
+
+	std::unique_ptr<JobSystem> jobSystem;
+
+	std::unique_ptr<FrameScheduler> frameScheduler;
+
+	std::unique_ptr<ComponentUpdateLists> componentUpdateLists;
+
+	std::unique_ptr<ArchetypeStorage> archetypeStorage;
+
+	std::unique_ptr<HandleRegistry<Actor>> actorHandles;
+	std::unique_ptr<HandleRegistry<Component>> componentHandles;
+
+	std::unique_ptr<PlaySnapshot> playSnapshot;
+
 private:
 	json tempGameSave;
 
@@ -271,6 +311,12 @@ private:
 	bool bUseEditorCamera = true;
 	bool doDebugRender = false;
 
+	// Copy-on-write play snapshot instead of the full json round trip
+	bool bUseIncrementalPlaySnapshot = true;
+	// Milliseconds spent on saving the editor world in StartPlay and on restoring it in StopPlay
+	float LastPlaySnapshotTime = 0.0f;
+	float LastPlayRestoreTime = 0.0f;
+
 public:
 	auto GetAssetManager() const -> AssetManager* { return assetManager.get(); }
 
@@ -281,6 +327,32 @@ public:
 
 	auto GetRecastNavigationManager() const -> RecastNavigationManager* { return recastNavigationManager.get(); }
 
+	auto GetTransformStore() const -> TransformStore* { return transformStore.get(); }
+
+	auto GetJobSystem() const -> JobSystem* { return jobSystem.get(); }
+
+	auto GetFrameScheduler() const -> FrameScheduler* { return frameScheduler.get(); }
+
+	auto GetComponentUpdateLists() const -> ComponentUpdateLists* { return componentUpdateLists.get(); }
+
+	// Archetype index over actors, nullptr unless enabled
+	auto GetArchetypeStorage() const -> ArchetypeStorage* { return archetypeStorage.get(); }
+	auto SetUseArchetypeStorage(bool InUseArchetypeStorage) -> void;
+
+	// Every live actor and component registered by handle and uuid
+	auto GetActorHandles() const -> HandleRegistry<Actor>* { return actorHandles.get(); }
+	auto GetComponentHandles() const -> HandleRegistry<Component>* { return componentHandles.get(); }
+
+	// nullptr when the actor has been destroyed
+	auto ResolveActor(ActorHandle InHandle) const -> Actor* { return actorHandles->Get(InHandle); }
+	auto FindActorById(const uuid& InId) const -> Actor* { return actorHandles->FindObjectById(InId); }
+
+	auto GetPlaySnapshot() const -> PlaySnapshot* { return playSnapshot.get(); }
+	auto SetUseIncrementalPlaySnapshot(bool InUseIncremental) -> void { bUseIncrementalPlaySnapshot = InUseIncremental; }
+	auto GetUseIncrementalPlaySnapshot() const -> bool { return bUseIncrementalPlaySnapshot; }
+	auto GetPlaySnapshotTime() const -> float { return LastPlaySnapshotTime; }
+	auto GetPlayRestoreTime() const -> float { return LastPlayRestoreTime; }
+
 	auto LoadGameFacade() -> void;
 
 	auto GetTasksJson() const -> json;
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <uuid.h>
+
+// Weak reference to an object registered in a HandleRegistry.
+// Resolving a handle of a destroyed object gives nullptr, even if its slot has been reused since.
+template<class T>
+struct ObjectHandle
+{
+	static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+	uint32_t Index = InvalidIndex;
+	uint32_t Generation = 0;
+
+	auto IsSet() const -> bool { return Index != InvalidIndex; }
+
+	// Handles cross the Mono boundary packed into a pointer sized integer
+	auto ToPacked() const -> uint64_t { return (static_cast<uint64_t>(Generation) << 32) | Index; }
+	static auto FromPacked(uint64_t InPacked) -> ObjectHandle { return { static_cast<uint32_t>(InPacked), static_cast<uint32_t>(InPacked >> 32) }; }
+
+	friend auto operator==(const ObjectHandle& A, const ObjectHandle& B) -> bool { return A.Index == B.Index && A.Generation == B.Generation; }
+	friend auto operator!=(const ObjectHandle& A, const ObjectHandle& B) -> bool { return !(A == B); }
+};
+
+// Slot map of live objects with generational handles and an uuid -> handle index
+template<class T>
+class HandleRegistry
+{
+public:
+	using Handle = ObjectHandle<T>;
+
+	auto Add(T* InObject, const uuids::uuid& InId) -> Handle
+	{
+		uint32_t index;
+		if (!FreeSlots.empty())
+		{
+			index = FreeSlots.back();
+			FreeSlots.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(Slots.size());
+			Slots.emplace_back();
+		}
+
+		Slot& slot = Slots[index];
+		slot.Object = InObject;
+		slot.Id = InId;
+
+		const Handle handle{ index, slot.Generation };
+		IdIndex[InId] = handle;
+		return handle;
+	}
+
+	auto Remove(Handle InHandle) -> void
+	{
+		if (Get(InHandle) == nullptr)
+		{
+			return;
+		}
+
+		Slot& slot = Slots[InHandle.Index];
+
+		const auto found = IdIndex.find(slot.Id);
+		if (found != IdIndex.end() && found->second == InHandle)
+		{
+			IdIndex.erase(found);
+		}
+
+		slot.Object = nullptr;
+		// Invalidates every handle still pointing to this slot
+		++slot.Generation;
+		FreeSlots.push_back(InHandle.Index);
+	}
+
+	auto Get(Handle InHandle) const -> T*
+	{
+		if (InHandle.Index >= Slots.size())
+		{
+			return nullptr;
+		}
+
+		const Slot& slot = Slots[InHandle.Index];
+		return slot.Generation == InHandle.Generation ? slot.Object : nullptr;
+	}
+
+	auto SetId(Handle InHandle, const uuids::uuid& InId) -> void
+	{
+		if (Get(InHandle) == nullptr)
+		{
+			return;
+		}
+
+		Slot& slot = Slots[InHandle.Index];
+
+		const auto found = IdIndex.find(slot.Id);
+		if (found != IdIndex.end() && found->second == InHandle)
+		{
+			IdIndex.erase(found);
+		}
+
+		slot.Id = InId;
+		IdIndex[InId] = InHandle;
+	}
+
+	auto FindById(const uuids::uuid& InId) const -> Handle
+	{
+		const auto found = IdIndex.find(InId);
+		return found != IdIndex.end() ? found->second : Handle{};
+	}
+
+	auto FindObjectById(const uuids::uuid& InId) const -> T* { return Get(FindById(InId)); }
+
+	auto Reserve(size_t InNum) -> void
+	{
+		Slots.reserve(InNum);
+		IdIndex.reserve(InNum);
+	}
+
+	auto GetNum() const -> size_t { return Slots.size() - FreeSlots.size(); }
+
+private:
+	struct Slot
+	{
+		T* Object = nullptr;
+		uint32_t Generation = 0;
+		uuids::uuid Id;
+	};
+
+	std::vector<Slot> Slots;
+	std::vector<uint32_t> FreeSlots;
+	std::unordered_map<uuids::uuid, Handle> IdIndex;
+};
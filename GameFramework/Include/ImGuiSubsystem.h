@@ -88,6 +88,7 @@ private:
 	// World settings
 	auto DrawWorldSettings() -> void;
 	auto DrawNavMeshSettings() -> void;
+	auto DrawFrameStats() -> void;
 	// Node Editor
 	auto DrawNodeEditor(ned::EditorContext* nodeEditorContext) -> void;
 
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts unfinished jobs of a group, a job can also wait on a counter before it is allowed to run
+class JobCounter
+{
+public:
+	auto IsDone() const -> bool { return Value.load(std::memory_order_acquire) == 0; }
+
+private:
+	std::atomic<uint32_t> Value = 0;
+
+	friend class JobSystem;
+};
+
+// Fixed size worker pool, every worker owns a deque: it pushes and pops jobs at the back
+// while idle workers steal the oldest jobs from the front of the others.
+// The thread that created the job system is worker 0 and helps executing jobs while it waits.
+class JobSystem
+{
+public:
+	using JobFunction = std::function<void()>;
+
+	// 0 workers means one per hardware thread, main thread included
+	explicit JobSystem(uint32_t InNumWorkers = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// InCounter (optional) is incremented now and decremented once the job has finished.
+	// The job doesn't start before InDependency (optional) reaches zero.
+	auto Run(JobFunction&& InJob, JobCounter* InCounter = nullptr, const JobCounter* InDependency = nullptr) -> void;
+
+	// Executes other jobs on the calling thread until the counter reaches zero
+	auto Wait(const JobCounter& InCounter) -> void;
+
+	// Splits [0, InCount) into batches of InBatchSize and calls InFunc(begin, end) for each of them in parallel,
+	// returns once every batch has finished
+	auto ParallelFor(uint32_t InCount, uint32_t InBatchSize, const std::function<void(uint32_t, uint32_t)>& InFunc) -> void;
+
+	auto GetNumWorkers() const -> uint32_t { return static_cast<uint32_t>(Queues.size()); }
+
+	// Index of the calling worker, 0 for the main thread and any thread not owned by this job system
+	auto GetCurrentWorkerIndex() const -> uint32_t;
+
+private:
+	struct Job
+	{
+		JobFunction Function;
+		JobCounter* Counter = nullptr;
+		const JobCounter* Dependency = nullptr;
+	};
+
+	struct WorkQueue
+	{
+		std::mutex Mutex;
+		std::deque<Job> Jobs;
+	};
+
+	auto WorkerLoop(uint32_t InWorkerIndex) -> void;
+
+	// Pops a job from own queue or steals one from another worker and executes it
+	auto TryRunJob(uint32_t InWorkerIndex) -> bool;
+	auto PopJob(uint32_t InWorkerIndex, Job& OutJob) -> bool;
+	auto StealJob(uint32_t InWorkerIndex, Job& OutJob) -> bool;
+	auto PushJob(uint32_t InWorkerIndex, Job&& InJob) -> void;
+
+	std::vector<std::unique_ptr<WorkQueue>> Queues;
+	std::vector<std::thread> Workers;
+
+	std::mutex WakeMutex;
+	std::condition_variable WakeCondition;
+	std::atomic<uint32_t> NumPendingJobs = 0;
+	std::atomic<bool> bStopRequested = false;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "BinaryArchive.h"
+#include "JsonInclude.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Binary level file layout (little endian):
+//   BinaryLevelHeader
+//   level data written by Game::SerializeBinary
+//   string table: NumStrings times (uint32 length, chars), referenced by index from the level data
+struct BinaryLevelHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	uint64_t StringTableOffset;
+	uint32_t NumStrings;
+	uint32_t Reserved;
+};
+
+// The binary level container and the json <-> binary level conversion, which works on the data alone.
+// Level data layout:
+//   uint32 number of actors, uint32 number of components of all actors
+//   per actor: uuid, name, uint8 has mono (namespace and class string refs), uint32 number of components
+//     per component: type name string ref, uuid, uint8 has parent (parent uuid), uint32 data size, data
+//   uint8 has directional light (json blob)
+// Component data is what the component's SerializeBinary writes: the converter registered for the type name,
+// or the Serialize json as MessagePack for types without one.
+class LevelConverter
+{
+public:
+	static constexpr char BinaryLevelMagic[4] = { 'N', 'L', 'V', 'L' };
+	static constexpr uint32_t BinaryLevelVersion = 1;
+
+	using JsonToBinaryFunction = void (*)(const json& in, BinaryWriter& out);
+	using BinaryToJsonFunction = json (*)(BinaryReader& in);
+
+	struct ComponentConverter
+	{
+		JsonToBinaryFunction ToBinary = nullptr;
+		BinaryToJsonFunction ToJson = nullptr;
+	};
+	using ComponentConverters = std::unordered_map<std::string, ComponentConverter>;
+
+	// Checks the header and reads the string table, the strings point straight into the level data
+	static auto ReadStrings(const uint8_t* InData, size_t InSize, BinaryLevelHeader& OutHeader, std::vector<std::string_view>& OutStrings) -> bool;
+	// Appends the string table and fills in the header, InWriter has to start with an empty BinaryLevelHeader
+	static auto Finish(BinaryWriter& InWriter) -> std::vector<uint8_t>;
+
+	// False when InLevel isn't a level json or the data of a component doesn't match its type
+	static auto JsonToBinary(const json& InLevel, const ComponentConverters& InConverters, std::vector<uint8_t>& OutData) -> bool;
+	// False when the data is malformed, OutLevel is then incomplete
+	static auto BinaryToJson(const uint8_t* InData, size_t InSize, const ComponentConverters& InConverters, json& OutLevel) -> bool;
+
+	// One actor of the "actors" array and back, in the layout Actor::SerializeBinary writes
+	static auto ActorJsonToBinary(const json& InActor, const ComponentConverters& InConverters, BinaryWriter& Out) -> bool;
+	static auto ActorBinaryToJson(BinaryReader& In, const ComponentConverters& InConverters, json& OutActor) -> bool;
+};
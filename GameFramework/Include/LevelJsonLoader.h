@@ -0,0 +1,71 @@
+#pragma once
+
+#include "JsonInclude.h"
+
+#include <string>
+
+// The walk over a level json shared by Game::Deserialize and Actor::Deserialize.
+// Existing actors and components are found through the uuid indices and nothing is copied out of the json,
+// so a load stays linear in the size of the level. Creating and filling the objects is up to the callers.
+class LevelJsonLoader
+{
+public:
+	// Components of all actors of the "actors" array, to reserve the registries before loading
+	static auto CountComponents(const json& InActors) -> size_t
+	{
+		size_t numComponents = 0;
+		for (const json& actorObj : InActors)
+		{
+			numComponents += actorObj.at("components").size();
+		}
+		return numComponents;
+	}
+
+	// For every actor json: InFind(id) gives the existing actor or null, InCreate(id) makes a new one,
+	// then InLoad(actor, actorObj) fills it
+	template<class FindFunc, class CreateFunc, class LoadFunc>
+	static auto LoadActors(const json& InActors, FindFunc&& InFind, CreateFunc&& InCreate, LoadFunc&& InLoad) -> void
+	{
+		for (const json& actorObj : InActors)
+		{
+			const uuid id = ToUuid(actorObj.at("id"));
+
+			auto actor = InFind(id);
+			if (actor == nullptr)
+			{
+				actor = InCreate(id);
+			}
+
+			InLoad(actor, actorObj);
+		}
+	}
+
+	// For every component wrapper of an actor: InFind(id) gives the actor's existing component or null,
+	// InUpdate(component, data) refills it, otherwise InCreate(name, id, data, parentId) makes it.
+	// parentId is null for components without a parent, parents may come later in the array.
+	template<class FindFunc, class UpdateFunc, class CreateFunc>
+	static auto LoadComponents(const json& InComponents, FindFunc&& InFind, UpdateFunc&& InUpdate, CreateFunc&& InCreate) -> void
+	{
+		for (const json& wrapper : InComponents)
+		{
+			const uuid id = ToUuid(wrapper.at("id"));
+			const json& data = wrapper.at("data");
+
+			if (auto component = InFind(id))
+			{
+				InUpdate(component, data);
+				continue;
+			}
+
+			const auto parent = wrapper.find("parent");
+			const uuid parentId = parent != wrapper.end() ? ToUuid(*parent) : uuid();
+			InCreate(wrapper.at("name").get_ref<const std::string&>(), id, data, parent != wrapper.end() ? &parentId : nullptr);
+		}
+	}
+
+	// Same as the uuid from_json of JsonSerializers.h, which needs the math headers
+	static auto ToUuid(const json& InValue) -> uuid
+	{
+		return uuid::from_string(InValue.get_ref<const std::string&>()).value();
+	}
+};
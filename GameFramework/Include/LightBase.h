@@ -78,7 +78,7 @@ public:
 
 private:
 	//TODO: POPRAVIT'
-	MonoPhysicsComponent* mMonoComponent = new MonoPhysicsComponent;
+	MonoPhysicsComponent* mMonoComponent = ObjectPools::New<MonoPhysicsComponent>();
 protected:
 	LightData lightData = LightData();
 };
@@ -99,7 +99,7 @@ public:
 		return lightData; 
 	};
 
-	static auto Create() -> Component* { return new AmbientLight(); }
+	static auto Create() -> Component* { return ObjectPools::New<AmbientLight>(); }
 
 	// todo: mb this should be the base implementation?
 	virtual auto GetLightRenderer() -> Renderer* override { return EngineContentRegistry::GetInstance()->GetQuadRenderer(); }
@@ -118,7 +118,7 @@ public:
 
 	virtual LightData GetLightData() { return lightData; };
 
-	static auto Create() -> Component* { return new DirectionalLight(); }
+	static auto Create() -> Component* { return ObjectPools::New<DirectionalLight>(); }
 
 	virtual auto GetLightRenderer() -> Renderer* override { return EngineContentRegistry::GetInstance()->GetQuadRenderer(); }
 };
@@ -149,7 +149,7 @@ public:
 
 	Color color = Color(1.0f, 1.0f, 1.0f, 1.0f);
 
-	static auto Create() -> Component* { return new PointLight(); }
+	static auto Create() -> Component* { return ObjectPools::New<PointLight>(); }
 
 	virtual auto GetLightRenderer() -> Renderer* override { 
 		Renderer* r = EngineContentRegistry::GetInstance()->GetBoxLightRenderer();
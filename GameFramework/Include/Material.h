@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Asset.h"
+#include "RenderingSystemTypes.h"
+#include "TextureArrayPacker.h"
+
+#include <cstdint>
+#include <d3d11.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wrl/client.h>
+
+class AlbedoTexture;
+class NormalTexture;
+class PixelShader;
+class VertexShader;
+
+// Everything a material is made of, renderers describing the same material share it
+struct MaterialDesc
+{
+	VertexShader* VS = nullptr;
+	PixelShader* PS = nullptr;
+	// Empty for the placeholder textures
+	std::string AlbedoPath;
+	std::string NormalPath;
+	LitMaterial Params;
+
+	auto operator==(const MaterialDesc& Other) const -> bool;
+};
+
+struct MaterialDescHash
+{
+	auto operator()(const MaterialDesc& InDesc) const -> size_t;
+};
+
+// Shader pair, textures and lighting parameters of static mesh draws.
+// The textures are requested from the asset manager, placeholders are bound until they are loaded.
+// The id is unique among live materials and doesn't change while the material lives, the render queue sorts by it.
+class Material
+{
+	friend class MaterialRegistry;
+public:
+	~Material();
+
+	auto GetId() const -> uint32_t { return Id; }
+	auto GetDesc() const -> const MaterialDesc& { return Desc; }
+
+	auto GetAlbedoTexture() const -> AlbedoTexture* { return Albedo.Get(); }
+	auto GetNormalTexture() const -> NormalTexture* { return Normal.Get(); }
+	auto GetAlbedoSRV() const -> ID3D11ShaderResourceView* { return AlbedoSRV.Get(); }
+	auto GetNormalSRV() const -> ID3D11ShaderResourceView* { return NormalSRV.Get(); }
+	// Where the textures are in the texture arrays, invalid when they aren't
+	auto GetAlbedoArraySlot() const -> const TextureArraySlot& { return AlbedoArraySlot; }
+	auto GetNormalArraySlot() const -> const TextureArraySlot& { return NormalArraySlot; }
+
+private:
+	Material(uint32_t InId, const MaterialDesc& InDesc);
+
+	// Swaps placeholders for the textures once they are loaded and picks up hot reloads and streamed mips
+	auto UpdateTextures() -> void;
+
+	uint32_t Id;
+	MaterialDesc Desc;
+
+	AssetRef<AlbedoTexture> Albedo;
+	AssetRef<NormalTexture> Normal;
+	// Asset generations the views below were taken from
+	uint32_t AlbedoGeneration = 0;
+	uint32_t NormalGeneration = 0;
+
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> AlbedoSRV;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> NormalSRV;
+	TextureArraySlot AlbedoArraySlot;
+	TextureArraySlot NormalArraySlot;
+};
+
+// Hands out one shared material per description, main thread only.
+// A material is destroyed with its last reference and its id is given to the next new material.
+class MaterialRegistry
+{
+public:
+	auto Acquire(const MaterialDesc& InDesc) -> std::shared_ptr<Material>;
+
+	// Called once a frame before drawing
+	auto Update() -> void;
+
+	auto GetNumMaterials() const -> size_t { return Materials.size(); }
+
+private:
+	struct Entry
+	{
+		Material* Raw;
+		std::weak_ptr<Material> Shared;
+	};
+
+	auto Release(Material* InMaterial) -> void;
+
+	std::unordered_map<MaterialDesc, Entry, MaterialDescHash> Materials;
+	std::vector<uint32_t> FreeIds;
+	// 0 is left for draws without a material
+	uint32_t NextId = 1;
+};
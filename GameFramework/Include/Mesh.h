@@ -26,6 +26,16 @@ struct TexturedVertex
 	Vector2 TexCoord;
 };
 
+// 20 byte TexturedVertex used by cooked static meshes, see VertexCompression.h.
+// Half position with the bitangent sign in w, octahedral snorm16 normal and tangent, half texcoord.
+struct PackedTexturedVertex
+{
+	uint16_t Position[4];
+	int16_t Normal[2];
+	int16_t Tangent[2];
+	uint16_t TexCoord[2];
+};
+
 struct BasicVertex
 {
 	Vector3 Position;
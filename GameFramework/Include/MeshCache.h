@@ -0,0 +1,114 @@
+#pragma once
+
+#include "BinaryArchive.h"
+#include "FileSystem.h"
+#include "Mesh.h"
+#include "StaticMesh.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// See StaticMeshLod
+struct CookedMeshLod
+{
+	float MaxScreenSize = 0.0f;
+	float Error = 0.0f;
+};
+
+// Data of one cooked mesh, points into a CookedMeshCollection
+struct CookedMeshView
+{
+	// NumSections sections for every LOD, LOD0 first
+	const StaticMeshSection* Sections = nullptr;
+	uint32_t NumSections = 0;
+
+	const CookedMeshLod* Lods = nullptr;
+	uint32_t NumLods = 0;
+
+	// Referenced by the sections, see StaticMeshSection::meshletStart
+	const StaticMeshMeshlet* Meshlets = nullptr;
+	uint32_t NumMeshlets = 0;
+
+	Vector3 BoundsCenter;
+	float BoundsRadius = 0.0f;
+
+	// TexturedVertex or PackedTexturedVertex, see VertexFormat
+	const void* Vertices = nullptr;
+	uint32_t NumVertices = 0;
+	uint32_t VertexSize = sizeof(TexturedVertex);
+	StaticMeshVertexFormat VertexFormat = StaticMeshVertexFormat::Full;
+
+	// uint16_t or uint32_t, see IndexSize
+	const void* Indices = nullptr;
+	uint32_t NumIndices = 0;
+	uint32_t IndexSize = sizeof(uint32_t);
+};
+
+// All meshes of an .fbx/.obj file in the cooked format, normally a mapping of the cache file
+class CookedMeshCollection
+{
+public:
+	auto GetData() const -> const uint8_t* { return File.GetData() ? File.GetData() : Buffer.data(); }
+	auto GetSize() const -> size_t { return File.GetData() ? File.GetSize() : Buffer.size(); }
+
+	// First mesh named InName, in the same order as the Assimp node walk
+	auto FindMesh(std::string_view InName, CookedMeshView& OutView) const -> bool;
+	// Names of all meshes that can be loaded from the collection
+	auto GetMeshNames() const -> std::vector<std::string_view>;
+
+private:
+	MappedFile File;
+	// Used when the cache can't be written
+	std::vector<uint8_t> Buffer;
+
+	friend class MeshCache;
+};
+
+// Cache of imported mesh collections.
+// A collection is imported with Assimp once, optimized (see MeshOptimizer) and written as interleaved vertices
+// (packed when precise enough, see VertexCompression.h), 16 or 32 bit indices and section tables for a LOD chain
+// (see MeshSimplifier) split into meshlets for culling (see MeshletBuilder.h),
+// later loads map the cooked file and upload straight from it.
+// Cache files are keyed by source path, source write time and size, import flags and format version,
+// so a changed source is cooked again. Thread safe, the asset loader threads share it.
+class MeshCache
+{
+public:
+	struct Stats
+	{
+		uint32_t NumCooked = 0;
+		uint32_t NumHits = 0;
+		float CookMs = 0.0f;
+		float MapMs = 0.0f;
+	};
+
+	explicit MeshCache(const Path& InCacheDirectory);
+
+	// Maps the cooked version of InCollectionPath, cooking it first when needed
+	auto Open(const Path& InCollectionPath, CookedMeshCollection& OutCollection) -> bool;
+
+	// Name of the cache file for the current state of the source, empty when the source doesn't exist
+	auto GetCookedPath(const Path& InCollectionPath) const -> Path;
+
+	auto GetCacheDirectory() const -> const Path& { return CacheDirectory; }
+	auto GetStats() const -> Stats;
+
+private:
+	auto Cook(const Path& InCollectionPath, BinaryWriter& Out) const -> bool;
+	// Cache files of older versions of the same source
+	auto RemoveStaleFiles(const Path& InCookedPath) const -> void;
+	auto GetCollectionMutex(const Path& InCollectionPath) -> std::mutex&;
+
+	Path CacheDirectory;
+
+	// Meshes of one collection are often requested together, only one of the loaders cooks it
+	std::mutex CollectionMutexesMutex;
+	std::unordered_map<Path, std::unique_ptr<std::mutex>> CollectionMutexes;
+
+	mutable std::mutex StatsMutex;
+	Stats CurrentStats;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Post-transform vertex cache behaviour of an index buffer, simulated with a FIFO cache.
+// Counts add up, so stats of several sections can be summed.
+struct VertexCacheStats
+{
+	uint32_t NumTransformed = 0;
+	uint32_t NumTriangles = 0;
+	uint32_t NumVertices = 0;
+
+	// Average cache miss ratio, transformed vertices per triangle, 0.5 is the best possible for a regular grid
+	auto GetAcmr() const -> float { return NumTriangles ? float(NumTransformed) / NumTriangles : 0.0f; }
+	// Average transform to vertex ratio, 1.0 means every vertex is transformed exactly once
+	auto GetAtvr() const -> float { return NumVertices ? float(NumTransformed) / NumVertices : 0.0f; }
+
+	auto operator+=(const VertexCacheStats& InOther) -> VertexCacheStats&
+	{
+		NumTransformed += InOther.NumTransformed;
+		NumTriangles += InOther.NumTriangles;
+		NumVertices += InOther.NumVertices;
+		return *this;
+	}
+};
+
+struct MeshOptimizationStats
+{
+	uint32_t NumVerticesBefore = 0;
+	uint32_t NumVerticesAfter = 0;
+	VertexCacheStats CacheBefore;
+	VertexCacheStats CacheAfter;
+
+	auto operator+=(const MeshOptimizationStats& InOther) -> MeshOptimizationStats&
+	{
+		NumVerticesBefore += InOther.NumVerticesBefore;
+		NumVerticesAfter += InOther.NumVerticesAfter;
+		CacheBefore += InOther.CacheBefore;
+		CacheAfter += InOther.CacheAfter;
+		return *this;
+	}
+};
+
+// Triangle list index buffer optimizations run by the mesh cook (see MeshCache).
+// Remap tables map an old vertex index to the new one, unused vertices map to InvalidVertexIndex.
+namespace MeshOptimizer
+{
+	constexpr uint32_t InvalidVertexIndex = ~0u;
+	// Close to the post-transform cache of current GPUs, only used for the stats
+	constexpr uint32_t SimulatedCacheSize = 16;
+
+	// Whether a section of InNumVertices vertices can use 16 bit indices relative to its base vertex,
+	// 0xFFFF is left out as it is the strip cut value
+	constexpr auto FitsIn16BitIndices(uint32_t InNumVertices) -> bool { return InNumVertices < 0xFFFF; }
+
+	auto AnalyzeVertexCache(const std::vector<uint32_t>& InIndices, uint32_t InNumVertices, uint32_t InCacheSize = SimulatedCacheSize) -> VertexCacheStats;
+
+	// Maps bitwise identical vertices to the first of them, returns the number of unique vertices
+	auto GenerateWeldRemap(const void* InVertices, uint32_t InNumVertices, size_t InVertexSize, std::vector<uint32_t>& OutRemap) -> uint32_t;
+
+	// Reorders triangles for post-transform cache hits (Forsyth's linear-speed vertex cache optimisation)
+	auto OptimizeVertexCache(std::vector<uint32_t>& InOutIndices, uint32_t InNumVertices) -> void;
+
+	// Numbers vertices in the order the index buffer first uses them and rewrites the indices,
+	// returns the number of referenced vertices
+	auto GenerateFetchRemap(std::vector<uint32_t>& InOutIndices, uint32_t InNumVertices, std::vector<uint32_t>& OutRemap) -> uint32_t;
+
+	template<class VertexType>
+	auto RemapVertices(std::vector<VertexType>& InOutVertices, const std::vector<uint32_t>& InRemap, uint32_t InNumNewVertices) -> void
+	{
+		std::vector<VertexType> remapped(InNumNewVertices);
+		for (size_t i = 0; i < InOutVertices.size(); ++i)
+		{
+			if (InRemap[i] != InvalidVertexIndex)
+			{
+				remapped[InRemap[i]] = InOutVertices[i];
+			}
+		}
+		InOutVertices = std::move(remapped);
+	}
+
+	auto RemapIndices(std::vector<uint32_t>& InOutIndices, const std::vector<uint32_t>& InRemap) -> void;
+
+	// Whole stage for one triangle list: weld, cache order, fetch order
+	template<class VertexType>
+	auto OptimizeMesh(std::vector<VertexType>& InOutVertices, std::vector<uint32_t>& InOutIndices) -> MeshOptimizationStats
+	{
+		MeshOptimizationStats stats;
+		stats.NumVerticesBefore = static_cast<uint32_t>(InOutVertices.size());
+		stats.CacheBefore = AnalyzeVertexCache(InOutIndices, stats.NumVerticesBefore);
+
+		std::vector<uint32_t> remap;
+		const uint32_t numUnique = GenerateWeldRemap(InOutVertices.data(), stats.NumVerticesBefore, sizeof(VertexType), remap);
+		RemapIndices(InOutIndices, remap);
+		RemapVertices(InOutVertices, remap, numUnique);
+
+		OptimizeVertexCache(InOutIndices, numUnique);
+
+		const uint32_t numReferenced = GenerateFetchRemap(InOutIndices, numUnique, remap);
+		RemapVertices(InOutVertices, remap, numReferenced);
+
+		stats.NumVerticesAfter = numReferenced;
+		stats.CacheAfter = AnalyzeVertexCache(InOutIndices, numReferenced);
+		return stats;
+	}
+}
@@ -33,7 +33,7 @@ public:
 	LitMaterial Mat;
 
 	static auto Create() -> Component* {
-		return new MeshRenderer(true);
+		return ObjectPools::New<MeshRenderer>(true);
 	}
 
 protected:
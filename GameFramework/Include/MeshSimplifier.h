@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Quadric error metric simplification of triangle lists (Garland and Heckbert), used by the mesh cook for LODs.
+// Edges are collapsed onto one of their vertices, so the result indexes the same vertex buffer.
+// Vertices on attribute seams and open borders never move, the silhouette and UV charts are kept.
+// CPU only and deterministic: the same input always gives the same output.
+namespace MeshSimplifier
+{
+	// Collapses edges, cheapest first, until the index count is at most InTargetIndexCount
+	// or every remaining collapse would move the surface by more than InTargetError (in position units).
+	// OutError receives the largest error of the collapses done.
+	auto Simplify(const float* InPositions, size_t InPositionStride, uint32_t InNumVertices, const std::vector<uint32_t>& InIndices,
+		size_t InTargetIndexCount, float InTargetError, float* OutError = nullptr) -> std::vector<uint32_t>;
+}
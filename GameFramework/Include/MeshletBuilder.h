@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Small enough for a meshlet to stay in the post-transform cache and be culled as a unit
+constexpr uint32_t MaxMeshletVertices = 64;
+constexpr uint32_t MaxMeshletTriangles = 124;
+
+// A meshlet as the builder makes it, in plain floats so the builder doesn't need the math headers.
+// The cook copies it into a StaticMeshMeshlet, which has the same fields and culling convention.
+struct MeshletData
+{
+	uint32_t IndexOffset = 0;
+	uint32_t NumIndices = 0;
+
+	// Bounding sphere
+	float Center[3] = {};
+	float Radius = 0.0f;
+
+	// Normal cone: back facing from an eye when dot(center - eye, ConeAxis) >= ConeCutoff * |center - eye| + Radius,
+	// a cutoff of 1 never culls
+	float ConeAxis[3] = {};
+	float ConeCutoff = 1.0f;
+};
+
+// Positions and normals are three floats each, InVertexStride bytes from one vertex to the next
+namespace MeshletBuilder
+{
+	// Splits a triangle list into meshlets of consecutive triangles, the index order is kept, so it should already be
+	// vertex cache optimized (see MeshOptimizer) for the meshlets to be compact. Index offsets are relative to InIndices.
+	auto BuildMeshlets(const float* InPositions, const float* InNormals, size_t InVertexStride,
+		const uint32_t* InIndices, size_t InNumIndices, std::vector<MeshletData>& OutMeshlets) -> void;
+
+	// Sphere and normal cone of the triangles InOutMeshlet covers in InIndices
+	auto ComputeMeshletBounds(const float* InPositions, const float* InNormals, size_t InVertexStride,
+		const uint32_t* InIndices, MeshletData& InOutMeshlet) -> void;
+}
@@ -19,6 +19,9 @@ public:
 
 	MonoComponent* GetMonoComponent() override { return mMonoComponent; }
 
+	// Owns a Bullet character controller, a play session restores the whole actor instead
+	bool CanRestoreInPlace() const override { return false; }
+
 	auto Init() -> void;
 
 	auto Update(float deltaTime) -> void override;
@@ -33,7 +36,7 @@ public:
 	const btVector3& getUp() { return btController->getUp(); }
 
 	static auto Create() -> Component* {
-		return new MovementComponent();
+		return ObjectPools::New<MovementComponent>();
 	}
 
 	/// This should probably be called setPositionIncrementPerSimulatorStep.
@@ -139,7 +142,7 @@ private:
 	btScalar stepHeight = 0.2f;
 	Vector3 up = { 0.0f, 1.0f, 0.0f };
 
-	MonoMovementComponent* mMonoComponent = new MonoMovementComponent;
+	MonoMovementComponent* mMonoComponent = ObjectPools::New<MonoMovementComponent>();
 
 	NavPath navPath;
 
@@ -1,18 +1,32 @@
 #include "NormalTexture.h"
+#include "AssetManager.h"
 #include "Game.h"
+#include "TextureCache.h"
 
-auto NormalTexture::Load() -> bool
+auto NormalTexture::LoadData() -> bool
 {
-	DirectX::CreateWICTextureFromFileEx(
-		Game::GetInstance()->GetD3DDevice().Get(),
+	ID3D11Device* device = Game::GetInstance()->GetD3DDevice().Get();
+
+	Path cookedPath;
+	if (Game::GetInstance()->GetAssetManager()->GetTextureCache()->Open(GetFullPath(), TextureUsage::Normal, cookedPath))
+	{
+		if (LoadCookedTexture(device, cookedPath))
+		{
+			return true;
+		}
+	}
+
+	// Images the cooker can't handle are still shown, uncompressed and without mips
+	const HRESULT hr = DirectX::CreateWICTextureFromFileEx(
+		device,
 		GetFullPath().wstring().c_str(),
 		0,
 		D3D11_USAGE_DEFAULT,
 		D3D11_BIND_SHADER_RESOURCE,
 		0, 0,
 		DirectX::WIC_LOADER_IGNORE_SRGB,
-		Tex.GetAddressOf(),
-		TexSRV.GetAddressOf());
+		LoadedTex.GetAddressOf(),
+		LoadedTexSRV.GetAddressOf());
 
-	return TexSRV.GetAddressOf() != nullptr;
+	return SUCCEEDED(hr) && LoadedTexSRV != nullptr;
 }
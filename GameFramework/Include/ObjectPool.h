@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+// Fixed block allocator: memory is taken from the system in slabs and split into equally sized blocks,
+// freed blocks go to an intrusive free list and are reused first.
+class FixedBlockPool
+{
+public:
+	struct Stats
+	{
+		// Type the pool was made for, null for the pools shared by size
+		const char* TypeName = nullptr;
+		size_t BlockSize = 0;
+		size_t NumSlabs = 0;
+		size_t NumBlocks = 0;
+		size_t NumUsedBlocks = 0;
+		size_t PeakUsedBlocks = 0;
+	};
+
+	FixedBlockPool(size_t InBlockSize, size_t InBlocksPerSlab, const char* InTypeName = nullptr);
+
+	FixedBlockPool(const FixedBlockPool&) = delete;
+	FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+	auto Allocate() -> void*;
+	auto Free(void* InBlock) -> void;
+
+	auto GetStats() const -> Stats;
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* Next;
+	};
+
+	auto AddSlab() -> void;
+
+	mutable std::mutex Mutex;
+
+	const char* TypeName;
+	size_t BlockSize;
+	size_t BlocksPerSlab;
+
+	std::vector<std::unique_ptr<std::byte[]>> Slabs;
+	FreeBlock* FreeList = nullptr;
+
+	size_t NumUsedBlocks = 0;
+	size_t PeakUsedBlocks = 0;
+};
+
+// Pools for actors, components and their Mono counterparts.
+// New<T> allocates from a pool of its own for every type, looked up once per type.
+// Plain new expressions on PoolAllocated classes fall back to pools shared by all types of the same size.
+// Every block starts with the pool it came from, so freeing needs neither the type nor a lookup.
+class ObjectPools
+{
+public:
+	// Objects bigger than this go to the regular heap
+	static constexpr size_t MaxPooledSize = 4096;
+	static constexpr size_t BlockAlignment = 16;
+
+	template<class T, class... Args>
+	static auto New(Args&&... InArgs) -> T*
+	{
+		// Thread safe initialization, the pool is created by the first spawn of the type
+		static FixedBlockPool* const pool = GetInstance()->CreateTypePool(sizeof(T), typeid(T).name());
+
+		void* object = Allocate(pool, sizeof(T));
+		try
+		{
+			return ::new (object) T(std::forward<Args>(InArgs)...);
+		}
+		catch (...)
+		{
+			Free(object);
+			throw;
+		}
+	}
+
+	static auto Allocate(size_t InSize) -> void*;
+	static auto Free(void* InObject) -> void;
+
+	static auto GetStats() -> std::vector<FixedBlockPool::Stats>;
+
+private:
+	// Sits in front of every object, padded to keep the objects aligned
+	struct alignas(BlockAlignment) BlockHeader
+	{
+		// Null for objects on the regular heap
+		FixedBlockPool* Pool;
+	};
+
+	static constexpr size_t NumSizePools = MaxPooledSize / BlockAlignment;
+
+	ObjectPools() = default;
+
+	static auto GetInstance() -> ObjectPools*
+	{
+		// Never destroyed, objects may still be freed while static destructors run.
+		// Function local so that pools can be used during static initialization.
+		static ObjectPools* const instance = new ObjectPools();
+		return instance;
+	}
+
+	static auto Allocate(FixedBlockPool* InPool, size_t InSize) -> void*;
+	static auto GetBlockSize(size_t InSize) -> size_t;
+
+	auto CreateTypePool(size_t InSize, const char* InTypeName) -> FixedBlockPool*;
+	auto GetSizePool(size_t InSize) -> FixedBlockPool*;
+
+	// Guards creating pools, allocating from them only takes the lock of the pool
+	std::mutex Mutex;
+	std::vector<std::unique_ptr<FixedBlockPool>> Pools;
+	// Pools by size in BlockAlignment steps, set once
+	std::atomic<FixedBlockPool*> SizePools[NumSizePools] = {};
+};
+
+// Derive from this to allocate instances from ObjectPools, preferably through ObjectPools::New.
+// Deleting needs no virtual destructor for the memory, the block knows its pool.
+class PoolAllocated
+{
+public:
+	static auto operator new(size_t InSize) -> void* { return ObjectPools::Allocate(InSize); }
+	static auto operator delete(void* InObject) -> void { ObjectPools::Free(InObject); }
+};
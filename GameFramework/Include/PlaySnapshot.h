@@ -0,0 +1,73 @@
+#pragma once
+
+#include "BinaryArchive.h"
+#include "HandleRegistry.h"
+
+#include <cstdint>
+#include <vector>
+
+class Actor;
+class Component;
+class Game;
+
+// Copy-on-write record of the editor world for play in editor.
+// While playing, components record their binary state right before they are modified for the first time
+// and actors record themselves before their component set changes or they get destroyed.
+// StopPlay then rewinds only what was recorded and destroys the actors spawned during play.
+//
+// Actors whose components can't be rewound in place (see Component::CanRestoreInPlace) and scripted actors,
+// whose C# state isn't tracked, are recorded as a whole when play starts.
+class PlaySnapshot
+{
+public:
+	struct Stats
+	{
+		size_t NumRecordedActors = 0;
+		size_t NumRecordedComponents = 0;
+		size_t NumSpawnedActors = 0;
+		size_t RecordedBytes = 0;
+	};
+
+	// Non zero while recording, objects remember the epoch they were recorded in to record only once
+	static auto GetRecordingEpoch() -> uint32_t { return RecordingEpoch; }
+
+	auto Begin(Game& InGame) -> void;
+	auto Restore(Game& InGame) -> void;
+
+	auto IsRecording() const -> bool { return RecordingEpoch != 0; }
+
+	// Called by Component and Actor through their NotifyModified / NotifyStructureChanged
+	auto RecordComponent(Component* InComponent) -> void;
+	auto RecordActor(Actor* InActor) -> void;
+	auto OnActorSpawned(Actor* InActor) -> void;
+
+	auto GetStats() const -> const Stats& { return LastStats; }
+
+private:
+	struct BlobRange
+	{
+		uint32_t Offset = 0;
+		uint32_t Size = 0;
+	};
+
+	auto Clear() -> void;
+	auto RestoreActorOrder(Game& InGame) const -> void;
+	auto MakeReader(const BlobRange& InRange, const std::vector<std::string_view>& InStrings) const -> BinaryReader;
+
+	static inline uint32_t RecordingEpoch = 0;
+	uint32_t LastEpoch = 0;
+
+	// All recorded blobs, ranges below point into it
+	BinaryWriter Records;
+
+	// Every object is recorded at most once per session, see the epochs
+	std::vector<std::pair<uuids::uuid, BlobRange>> ActorRecords;
+	std::vector<std::pair<uuids::uuid, BlobRange>> ComponentRecords;
+	std::vector<ObjectHandle<Actor>> SpawnedActors;
+	// Game::Actors when play started, recreated actors are put back at their index
+	std::vector<uuids::uuid> ActorOrder;
+
+	json DirLightState;
+
+	Stats LastStats;
+};
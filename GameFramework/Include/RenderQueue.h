@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct ID3D11Buffer;
+struct ID3D11SamplerState;
+struct ID3D11ShaderResourceView;
+class PixelShader;
+class Renderer;
+class VertexShader;
+
+// Passes in the order their draws are submitted, the top bits of the sort key
+enum class RenderPass : uint32_t
+{
+	Shadow,
+	Opaque,
+	Forward
+};
+
+// What a renderer draws with in a pass, RenderQueue::MakeSortKey packs it
+struct RenderDrawKey
+{
+	// 0 is left for renderers without a draw key
+	uint32_t ShaderId = 0;
+	uint32_t MaterialId = 0;
+	uint32_t MeshId = 0;
+	// Distance from the point of view, draws with the same state go front to back
+	float Depth = 0.0f;
+};
+
+// What the draws of a sorted queue left bound, so the next draw only binds what changed.
+// Renderers without a draw key don't know about it, the queue resets it around them.
+struct RenderStateCache
+{
+	static constexpr uint32_t NumShaderResources = 4;
+
+	// False until a renderer bound its whole state, nothing else is trusted then
+	bool bValid = false;
+	VertexShader* VS = nullptr;
+	PixelShader* PS = nullptr;
+	ID3D11Buffer* IndexBuffer = nullptr;
+	ID3D11Buffer* VertexBuffer = nullptr;
+	ID3D11ShaderResourceView* PSResources[NumShaderResources] = {};
+
+	auto Reset() -> void { *this = RenderStateCache(); }
+};
+
+// Draws of a pass sorted by a 64 bit key, most significant first:
+// pass (4 bits), shader (12), material (16), mesh (16), depth (16).
+// Sorting groups draws that share state, which the renderers then skip binding through RenderStateCache.
+class RenderQueue
+{
+public:
+	struct Item
+	{
+		uint64_t Key;
+		Renderer* Owner;
+	};
+
+	static auto MakeSortKey(RenderPass InPass, const RenderDrawKey& InDrawKey) -> uint64_t;
+	// False for the items of renderers without a draw key
+	static auto HasDrawKey(uint64_t InKey) -> bool { return ((InKey >> 48) & 0xfff) != 0; }
+
+	auto Clear() -> void { Items.clear(); }
+	auto Add(uint64_t InKey, Renderer* InOwner) -> void { Items.push_back({ InKey, InOwner }); }
+
+	// Stable LSD radix sort, one pass per key byte that differs between items
+	auto Sort() -> void;
+
+	auto GetItems() const -> const std::vector<Item>& { return Items; }
+
+private:
+	std::vector<Item> Items;
+	// Other half of the ping-pong between radix passes, kept to reuse the memory
+	std::vector<Item> Scratch;
+};
@@ -2,6 +2,7 @@
 
 #include "SceneComponent.h"
 
+struct RenderDrawKey;
 struct RenderingSystemContext;
 
 class Renderer : public SceneComponent
@@ -10,6 +11,10 @@ public:
 
 	virtual void Render(const RenderingSystemContext& RSContext) = 0;
 
+	// Fills what the draw of the pass uses, the render queue sorts by it. Renderers that return false
+	// are drawn before the sorted ones in registration order and bind all of their state
+	virtual bool GetDrawKey(const RenderingSystemContext& RSContext, RenderDrawKey& OutKey) { return false; }
+
 	void SetVertexShader(class VertexShader* InVertexShader) { mVertexShader = InVertexShader; }
 
 	void SetPixelShader(class PixelShader* InPixelShader) { mPixelShader = InPixelShader; }
@@ -7,7 +7,10 @@ using namespace Microsoft::WRL;
 
 #include "MathInclude.h"
 #include "GBuffer.h"
+#include "Material.h"
+#include "RenderQueue.h"
 #include "RenderingSystemTypes.h"
+#include "TextureArrayTable.h"
 
 
 class Actor;
@@ -45,6 +48,10 @@ public:
 	auto GetWorldPositionUnerScreenPosition(const Vector2& Pos)->Vector3;
 
 	auto GetDebugDrawer() const -> DebugDrawer* { return debugDrawer.get(); }
+	// Texture arrays the static mesh renderers sample their material textures from
+	auto GetTextureArrayTable() -> TextureArrayTable* { return &textureArrays; }
+	// Materials of the static mesh renderers, shared between renderers that describe the same one
+	auto GetMaterialRegistry() -> MaterialRegistry* { return &materials; }
 
 private:
 
@@ -57,6 +64,9 @@ private:
 
 	void PerformDebugPass();
 
+	// Draws the renderers sorted by their draw keys, or just the shadow casters
+	void SubmitRenderers(const RenderingSystemContext& RSContext, RenderPass Pass, bool bShadowCastersOnly = false);
+
 	void ResizeViewport(int Width, int Height);
 
 private:
@@ -107,6 +117,11 @@ private:
 	ObjectLookupHelper* MyObjectLookupHelper = nullptr;
 
 	std::unique_ptr<DebugDrawer> debugDrawer;
+	TextureArrayTable textureArrays;
+	MaterialRegistry materials;
+	// Kept to reuse the memory between passes
+	RenderQueue renderQueue;
+	RenderStateCache stateCache;
 private:
 
 	void SetScreenSizeViewport();
@@ -4,7 +4,9 @@
 
 #include <optional>
 
+class Camera;
 class PixelShader;
+struct RenderStateCache;
 
 #pragma pack(push, 4)
 struct LightData
@@ -42,6 +44,10 @@ struct CBPerObject
 	Matrix NormalObjectToWorld;
 	Color Color;
 	LitMaterial Mat;
+	// Texture array slices of the material textures, when drawn with the texture array pixel shader
+	uint32_t AlbedoSlice = 0;
+	uint32_t NormalSlice = 0;
+	uint32_t pad[2] = {};
 };
 
 struct CBLights
@@ -61,4 +67,10 @@ struct RenderingSystemContext
 {
 	int ShaderFlags = 0;
 	std::optional<PixelShader*> OverridePixelShader;
+	// Point of view of the pass, renderers use it to pick a level of detail and cull
+	const Camera* View = nullptr;
+	// Back faces are culled by the rasterizer state of the pass, so renderers can skip the ones they know of
+	bool bCullBackFaces = false;
+	// Set while a sorted render queue is drawn (see RenderQueue), renderers that use it skip binding unchanged state
+	RenderStateCache* StateCache = nullptr;
 };
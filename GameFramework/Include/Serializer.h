@@ -1,8 +1,11 @@
 ﻿#pragma once
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <vector>
 
 #include "JsonInclude.h"
+#include "LevelConverter.h"
 using Path = std::filesystem::path;
 
 class Game;
@@ -13,6 +16,20 @@ class Serializer
 public:
    static json Serialize(const Game* game);
    static void Deserialize(const json* in, Game& game, bool destructive = false);
-   static void SaveToFile(Path path, const Game* game);
+   // Binary format is picked by the file extension, see IsBinaryLevelPath. False when the file couldn't be written.
+   static bool SaveToFile(Path path, const Game* game);
    static void ReadFromFile(Path path, Game* game, bool destructive = false);
+
+   static bool IsBinaryLevelPath(const Path& path);
+   static std::vector<uint8_t> SerializeBinary(const Game* game);
+   // The whole level is checked before the game is touched, malformed data leaves the current level as it is
+   static bool DeserializeBinary(const uint8_t* data, size_t size, Game& game, bool destructive = false);
+   static bool SaveToBinaryFile(Path path, const Game* game);
+   // The file is memory mapped and read in place
+   static bool ReadFromBinaryFile(Path path, Game* game, bool destructive = false);
+
+   // Json <-> binary level converter, picks the formats by the extensions of the paths.
+   // Works on the files alone, nothing is loaded into the game (see LevelConverter).
+   // False when the source isn't a well formed level, the target is then left as it is.
+   static bool ConvertLevel(const Path& from, const Path& to);
 };
@@ -40,8 +40,13 @@ public:
 
 	virtual void UseShader(ShaderFlag Flags = ShaderFlag::None) = 0;
 
+	// Small number unique per shader, the render queue sorts draws by it
+	uint32_t GetShaderId() const { return ShaderId; }
+
 protected:
 
+	inline static uint32_t NextShaderId = 1;
+	uint32_t ShaderId = NextShaderId++;
 
 	friend class ShaderCompiler;
 };
@@ -96,4 +101,11 @@ public:
 protected:
 	ComPtr<ID3D11InputLayout> PositionOnlyInputLayout;
 
+};
+
+// TexturedShader.hlsl compiled with PACKED_VERTEX for PackedTexturedVertex
+class PackedTexturedVertexShader : public TexturedVertexShader
+{
+public:
+	virtual void Initialize(ID3DBlob* ByteCode, ShaderFlag Flags) override;
 };
\ No newline at end of file
@@ -59,6 +59,11 @@ public:
 
 	void ClearMacros();
 
+	// Defined for every variation, unlike the flag macros CreateShader sets
+	void AddBaseMacro(const D3D_SHADER_MACRO& Macro);
+
+	void ClearBaseMacros();
+
 private:
 
 	std::wstring PathToShader;
@@ -70,6 +75,8 @@ private:
 	std::string Target;
 
 	std::vector<D3D_SHADER_MACRO> Macros;
+
+	std::vector<D3D_SHADER_MACRO> BaseMacros;
 	
 };
 
@@ -6,20 +6,69 @@
 #include <memory>
 #include <vector>
 
+// Cluster of consecutive triangles of a section, culled on its own
+struct StaticMeshMeshlet
+{
+	// Relative to the indicesStart of its section
+	uint32_t indexOffset;
+	uint32_t numIndices;
+
+	// Bounding sphere in object space
+	Vector3 center;
+	float radius;
+
+	// Normal cone: back facing from an eye when dot(center - eye, coneAxis) >= coneCutoff * |center - eye| + radius,
+	// a cutoff of 1 never culls
+	Vector3 coneAxis;
+	float coneCutoff;
+};
+
 struct StaticMeshSection
 {
 	int32_t materialIndex;
 	uint32_t indicesStart;
 	uint32_t vertexStart;
 	uint32_t numIndices;
+
+	// Range of StaticMeshRenderData::meshlets covering the indices of the section
+	uint32_t meshletStart = 0;
+	uint32_t numMeshlets = 0;
+};
+
+enum class StaticMeshVertexFormat : uint32_t
+{
+	// TexturedVertex
+	Full,
+	// PackedTexturedVertex, drawn with EngineContentRegistry::GetPackedVertexShader
+	Packed
+};
+
+// LOD screen sizes are computed for a viewport this many pixels high
+constexpr float StaticMeshLodReferenceHeight = 1080.0f;
+
+// All LODs share the vertex buffer, only their index ranges differ
+struct StaticMeshLod
+{
+	// Used while the bounding sphere covers at most this fraction of the viewport height
+	float maxScreenSize;
+	// Largest distance from the full detail surface the simplification allowed, in mesh units
+	float error;
+	std::vector<StaticMeshSection> sections;
 };
 
 // Data needed to render a static mesh
 struct StaticMeshRenderData
 {
-	std::vector<StaticMeshSection> sections;
+	// LOD0 is the full detail mesh, screen sizes go down with every LOD
+	std::vector<StaticMeshLod> lods;
+	std::vector<StaticMeshMeshlet> meshlets;
+
+	Vector3 boundsCenter;
+	float boundsRadius = 0.0f;
 
 	uint32_t vertexSize;
+	StaticMeshVertexFormat vertexFormat = StaticMeshVertexFormat::Full;
+	DXGI_FORMAT indexFormat = DXGI_FORMAT_R32_UINT;
 
 	ComPtr<ID3D11Buffer> vertexBuffer;
 	ComPtr<ID3D11Buffer> indexBuffer;
@@ -32,18 +81,35 @@ class StaticMesh : public Asset
 {
 	friend class AssetManager;
 public:
-	
+	StaticMesh();
+	~StaticMesh();
+
 	auto GetRenderData() const -> const StaticMeshRenderData* { return renderData.get(); }
+	// Small number unique per mesh asset, the render queue sorts draws by it
+	auto GetMeshId() const -> uint32_t { return meshId; }
 
-	virtual auto Load() -> bool override { CreateRenderData(); return renderData.get() != nullptr; }
+	virtual auto LoadData() -> bool override;
+	virtual auto FinishLoad() -> bool override;
+	virtual auto Unload() -> void override;
+	virtual auto GetTypeName() const -> const char* override { return "StaticMesh"; }
 
 	// import-related variables
 
 	// serialize/deserialize functions
 
 protected:
-	auto CreateRenderData() -> void;
+	// Cooked mesh mapped by LoadData, kept until FinishLoad uploads it
+	struct ImportedData;
 
+	auto ImportMesh() -> bool;
+	// Creates the buffers and releases the mapped cache file, false when the device refused them
+	auto CreateRenderData() -> bool;
+
+	std::unique_ptr<ImportedData> importedData;
 	std::unique_ptr<StaticMeshRenderData> renderData;
 
+private:
+	inline static uint32_t nextMeshId = 1;
+	uint32_t meshId = nextMeshId++;
+
 };
\ No newline at end of file
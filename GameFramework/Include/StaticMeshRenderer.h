@@ -1,16 +1,23 @@
 #pragma once
 
+#include "Asset.h"
+#include "Material.h"
 #include "Renderer.h"
 #include "RenderingSystemTypes.h"
 #include "MonoObjects/StaticMeshRendererComponent.h"
 #include <d3d11.h>
 #include <filesystem>
+#include <memory>
+#include <vector>
 using Path = std::filesystem::path;
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
 
 class StaticMesh;
+struct StaticMeshLod;
+struct StaticMeshRenderData;
+struct StaticMeshSection;
 
 class StaticMeshRenderer : public Renderer
 {
@@ -19,11 +26,13 @@ public:
 	friend class ImGuiSubsystem;
 
 	StaticMeshRenderer();
+	~StaticMeshRenderer() override;
 
-	auto GetStaticMesh() const -> StaticMesh* { return staticMesh; }
-	auto SetStaticMesh(StaticMesh* inStaticMesh) -> void { staticMesh = inStaticMesh; }
+	auto GetStaticMesh() const -> StaticMesh* { return staticMesh.Get(); }
+	auto SetStaticMesh(StaticMesh* inStaticMesh) -> void;
 
 	virtual auto Render(const RenderingSystemContext& RSContext) -> void override;
+	virtual auto GetDrawKey(const RenderingSystemContext& RSContext, RenderDrawKey& OutKey) -> bool override;
 
 	auto SetMeshPath(std::string meshPath) -> void;
 	auto SetTexturePath(std::string texturePath) -> void;
@@ -32,33 +41,69 @@ public:
 	ComponentType GetComponentType() override { return StaticMeshRendererType; }
 	MonoComponent* GetMonoComponent() override { return mMonoComponent; }
 
-	// todo: remove this
-	LitMaterial Mat;
-	void SetAlbedoSRV(ComPtr<ID3D11ShaderResourceView> InAlbedoSRV) { mAlbedoSRV = InAlbedoSRV; }
-	void SetNormalSRV(ComPtr<ID3D11ShaderResourceView> InSRV) { mNormalSRV = InSRV; }
+	// Shared with the renderers that have the same shaders, textures and parameters, null before the renderer has shaders
+	auto GetMaterial() const -> Material* { return material.get(); }
+	auto GetMaterialParams() const -> const LitMaterial& { return materialDesc.Params; }
+	auto SetMaterialParams(const LitMaterial& params) -> void;
+
 	void SetSpecularSRV(ComPtr<ID3D11ShaderResourceView> InSRV) { mSpecularSRV = InSRV; }
 
 	json Serialize() const override;
 	void Deserialize(const json* in) override;
+	void SerializeBinary(BinaryWriter& out) const override;
+	void DeserializeBinary(BinaryReader& in) override;
+	// Level conversion between the Serialize json and the SerializeBinary layout, see ComponentRegistry
+	static void ConvertJsonToBinary(const json& in, BinaryWriter& out);
+	static json ConvertBinaryToJson(BinaryReader& in);
 	static Component* Create()
 	{
-		return new StaticMeshRenderer();
+		return ObjectPools::New<StaticMeshRenderer>();
 	}
 
-	auto GetTexturePath() -> Path { return texturePath; }
-	auto GetNormalPath() -> Path { return normalPath; }
+	auto GetTexturePath() -> Path { return materialDesc.AlbedoPath; }
+	auto GetNormalPath() -> Path { return materialDesc.NormalPath; }
 
 protected:
 	MonoComponent* mMonoComponent = new StaticMeshRendererComponent();
 
 	// The mesh to render
-	StaticMesh* staticMesh = nullptr;
+	AssetRef<StaticMesh> staticMesh;
 
-	ComPtr<ID3D11ShaderResourceView> mAlbedoSRV = nullptr;
-	ComPtr<ID3D11ShaderResourceView> mNormalSRV = nullptr;
 	ComPtr<ID3D11ShaderResourceView> mSpecularSRV = nullptr;
 
 private:
-	std::string texturePath;
-	std::string normalPath;
+	struct DrawShaders
+	{
+		VertexShader* VS = nullptr;
+		PixelShader* PS = nullptr;
+		// Material textures come from the texture arrays
+		bool bTextureArrays = false;
+	};
+
+	// Requests the assets asynchronously, the material shows placeholders until they are loaded
+	auto ApplyAssetPaths(const Path& meshPath, const std::string& texPath, const std::string& normPath) -> void;
+	// Takes the material of the current description from the registry
+	auto UpdateMaterial() -> void;
+	// The shader setters of Renderer don't know about the material, picks up shaders set through them
+	auto RefreshMaterial() -> void;
+	// Shaders the pass draws the mesh with, the texture array pixel shader when both material textures are in the arrays.
+	// Packed meshes always use the packed vertex shader, a custom vertex shader can't read their vertices
+	auto SelectShaders(const StaticMeshRenderData& renderData, const RenderingSystemContext& RSContext) const -> DrawShaders;
+
+	// Pixels the bounding sphere diameter covers on screen, seen from the pass point of view. Unbounded without a view or inside the bounds
+	auto GetScreenDiameter(const StaticMeshRenderData& renderData, const RenderingSystemContext& RSContext) const -> float;
+	// Coarsest LOD whose screen size threshold the mesh bounds still fit under
+	auto SelectLod(const StaticMeshRenderData& renderData, float screenDiameter) const -> const StaticMeshLod&;
+	// Fills visibleRanges with the index ranges of the meshlets of lod in the view, false when none of the mesh is
+	auto CullMeshlets(const StaticMeshRenderData& renderData, const StaticMeshLod& lod, const RenderingSystemContext& RSContext) -> bool;
+
+	// Texture paths and parameters are serialized, the shaders are the defaults
+	MaterialDesc materialDesc;
+	std::shared_ptr<Material> material;
+
+	// Custom vertex shader the packed vertex shader was last logged to replace, to log every shader once
+	VertexShader* replacedVertexShader = nullptr;
+
+	// Draws left after culling, consecutive visible meshlets are merged into one range. Kept to reuse the memory
+	std::vector<StaticMeshSection> visibleRanges;
 };
\ No newline at end of file
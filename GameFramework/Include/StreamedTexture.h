@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Asset.h"
+#include "TextureArrayPacker.h"
+#include "TextureResidency.h"
+
+#include <d3d11.h>
+#include <vector>
+#include <wrl/client.h>
+
+using namespace Microsoft::WRL;
+
+class TextureStreamer;
+
+// Base of the texture assets.
+// Cooked textures are loaded with their mip tail only, TextureStreamer swaps in finer mips as renderers request them.
+// Textures from other sources are loaded whole and aren't streamed.
+class StreamedTexture : public Asset
+{
+	friend class TextureStreamer;
+public:
+	auto GetSRV() -> ComPtr<ID3D11ShaderResourceView> { return TexSRV; }
+
+	// Size in pixels the texture is shown at this frame, main thread
+	auto RequestResolution(float InPixels) -> void;
+	auto IsStreamed() const -> bool { return StreamingId != TextureResidency::InvalidId; }
+	// Slice of the texture in the renderer's texture arrays (see TextureArrayTable), a copy of its mips.
+	// Invalid for streamed textures, they are only drawn from their own texture.
+	auto GetArraySlot() const -> const TextureArraySlot& { return ArraySlot; }
+
+	virtual auto FinishLoad() -> bool override;
+	virtual auto Unload() -> void override;
+
+protected:
+	// Creates the tail of a cooked .dds into LoadedTex for LoadData
+	auto LoadCookedTexture(ID3D11Device* InDevice, const Path& InCookedPath) -> bool;
+
+	// Created by LoadData, moved to the members below by FinishLoad
+	ComPtr<ID3D11Resource> LoadedTex;
+	ComPtr<ID3D11ShaderResourceView> LoadedTexSRV;
+
+private:
+	// The streamer finished a change, on the main thread
+	auto PublishMips(ComPtr<ID3D11Resource> InTex, ComPtr<ID3D11ShaderResourceView> InTexSRV) -> void;
+	auto StopStreaming() -> void;
+	auto UpdateArraySlot() -> void;
+	// The texture and its array slice
+	auto UpdateMemoryUsage() -> void;
+
+	ComPtr<ID3D11Resource> Tex;
+	ComPtr<ID3D11ShaderResourceView> TexSRV;
+
+	// What LoadCookedTexture found out about the file, an empty path when the loaded texture isn't streamed
+	Path LoadedCookedPath;
+	uint32_t LoadedWidth = 0;
+	uint32_t LoadedHeight = 0;
+	uint32_t LoadedTailMip = 0;
+	std::vector<size_t> LoadedMipBytes;
+
+	TextureArraySlot ArraySlot;
+
+	TextureStreamer* Streamer = nullptr;
+	uint32_t StreamingId = TextureResidency::InvalidId;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Textures that can share an array: same format, size and mip count
+struct TextureArrayKey
+{
+	uint32_t Format = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t MipLevels = 0;
+
+	auto operator==(const TextureArrayKey& Other) const -> bool
+	{
+		return Format == Other.Format && Width == Other.Width && Height == Other.Height && MipLevels == Other.MipLevels;
+	}
+	auto operator!=(const TextureArrayKey& Other) const -> bool { return !(*this == Other); }
+};
+
+struct TextureArraySlot
+{
+	static constexpr uint32_t InvalidPage = ~0u;
+
+	uint32_t Page = InvalidPage;
+	uint32_t Slice = 0;
+
+	auto IsValid() const -> bool { return Page != InvalidPage; }
+};
+
+// Hands out array slices of pages, one page is one texture array of textures with the same key.
+// Pages of a key grow from the initial slice count, doubling up to the maximum, so a handful of textures
+// doesn't allocate a large array and a texture alone in its key costs a single slice. New textures go to the fullest page that has room, which keeps pages dense
+// and lets the last texture of a page free it. No D3D, TextureArrayTable creates the arrays.
+class TextureArrayPacker
+{
+public:
+	struct Page
+	{
+		TextureArrayKey Key;
+		uint32_t NumSlices = 0;
+		uint32_t NumUsed = 0;
+		// Free slices, the lowest one is taken first
+		std::vector<uint32_t> FreeSlices;
+		// Released pages keep their index for the next page of any key
+		bool bInUse = false;
+	};
+
+	struct Stats
+	{
+		uint32_t NumPages = 0;
+		uint32_t NumSlices = 0;
+		uint32_t NumUsedSlices = 0;
+	};
+
+	TextureArrayPacker(uint32_t InInitialSlicesPerPage = 1, uint32_t InMaxSlicesPerPage = 64);
+
+	// Returns true when OutSlot is on a new page, its array has to be created before the slice is filled
+	auto Allocate(const TextureArrayKey& InKey, TextureArraySlot& OutSlot) -> bool;
+	// Returns true when the page of InSlot became empty and was released
+	auto Free(const TextureArraySlot& InSlot) -> bool;
+
+	auto GetPage(uint32_t InPage) const -> const Page& { return Pages[InPage]; }
+	auto GetNumPages() const -> uint32_t { return static_cast<uint32_t>(Pages.size()); }
+	auto GetStats() const -> Stats;
+
+private:
+	auto CreatePage(const TextureArrayKey& InKey) -> uint32_t;
+
+	std::vector<Page> Pages;
+	uint32_t InitialSlicesPerPage;
+	uint32_t MaxSlicesPerPage;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "TextureArrayPacker.h"
+
+#include <cstddef>
+#include <d3d11.h>
+#include <vector>
+#include <wrl/client.h>
+
+// Shared Texture2DArray pages for the material textures.
+// Textures with the same format, size and mip count are copied into slices of one array, so draws with different
+// textures bind the same views and only differ in the slice indices they pass in CBPerObject.
+// A slice is a second copy of its texture, streamed textures aren't added since every streamed mip would copy them again.
+// The copies are GPU side on the immediate context, main thread only.
+class TextureArrayTable
+{
+public:
+	// Copies all mips of InTexture into a slice, false for cube maps, arrays and non 2D textures
+	auto Add(ID3D11Resource* InTexture, TextureArraySlot& OutSlot) -> bool;
+	// The slice is reused, an emptied page is freed
+	auto Remove(TextureArraySlot& InOutSlot) -> void;
+
+	auto GetPageSRV(uint32_t InPage) const -> ID3D11ShaderResourceView*;
+	// Video memory of one slice of the page of InSlot, 0 for an invalid slot
+	auto GetSliceMemorySize(const TextureArraySlot& InSlot) const -> size_t;
+	auto GetPacker() const -> const TextureArrayPacker& { return Packer; }
+	// Video memory of all pages, used slices or not
+	auto GetMemorySize() const -> size_t { return MemorySize; }
+
+private:
+	struct PageResources
+	{
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> Texture;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> SRV;
+		size_t MemorySize = 0;
+	};
+
+	auto CreatePage(uint32_t InPage) -> bool;
+
+	TextureArrayPacker Packer;
+	std::vector<PageResources> Pages;
+	size_t MemorySize = 0;
+};
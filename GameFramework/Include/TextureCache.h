@@ -0,0 +1,70 @@
+#pragma once
+
+#include "FileSystem.h"
+#include "TextureCompression.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+enum class TextureUsage : uint32_t
+{
+	// sRGB color, compressed with the albedo format
+	Albedo,
+	// Tangent space normals, BC5 with X and Y only, shaders rebuild Z
+	Normal,
+};
+
+// Cache of cooked textures.
+// A source image is decoded with WIC once, given a mip chain and block compressed (see TextureCompression.h)
+// into a .dds file that StreamedTexture uploads from a mapping of the file, tail mips first.
+// Cache files are keyed by source path, usage, source write time and size, cook settings and format version,
+// so a changed source is cooked again. Thread safe, the asset loader threads share it.
+class TextureCache
+{
+public:
+	struct Stats
+	{
+		uint32_t NumCooked = 0;
+		uint32_t NumHits = 0;
+		float CookMs = 0.0f;
+		// Of all cooked mip chains, as RGBA8 and as written
+		size_t UncompressedBytes = 0;
+		size_t CompressedBytes = 0;
+	};
+
+	explicit TextureCache(const Path& InCacheDirectory);
+
+	// Cooked .dds of InSourcePath, cooking it first when needed. Sources that already are .dds files are used as they are
+	auto Open(const Path& InSourcePath, TextureUsage InUsage, Path& OutCookedPath) -> bool;
+
+	// Name of the cache file for the current state of the source, empty when the source doesn't exist
+	auto GetCookedPath(const Path& InSourcePath, TextureUsage InUsage) const -> Path;
+
+	// Cook settings, change them before textures are requested. Albedo textures with alpha use BC3 instead of BC1
+	auto SetAlbedoFormat(TextureCompressionFormat InFormat) -> void { AlbedoFormat = InFormat; }
+	auto GetAlbedoFormat() const -> TextureCompressionFormat { return AlbedoFormat; }
+	auto SetMipFilter(MipFilter InFilter) -> void { Filter = InFilter; }
+	auto GetMipFilter() const -> MipFilter { return Filter; }
+
+	auto GetCacheDirectory() const -> const Path& { return CacheDirectory; }
+	auto GetStats() const -> Stats;
+
+private:
+	auto Cook(const Path& InSourcePath, TextureUsage InUsage, std::vector<uint8_t>& OutDds) -> bool;
+	// Cache files of older versions of the same source and usage
+	auto RemoveStaleFiles(const Path& InCookedPath) const -> void;
+	auto GetSourceMutex(const Path& InCookedPath) -> std::mutex&;
+
+	Path CacheDirectory;
+	TextureCompressionFormat AlbedoFormat = TextureCompressionFormat::BC7;
+	MipFilter Filter = MipFilter::Kaiser;
+
+	// Albedo and normal textures of one source are cooked separately, a usage is only cooked by one of the loaders
+	std::mutex SourceMutexesMutex;
+	std::unordered_map<std::string, std::unique_ptr<std::mutex>> SourceMutexes;
+
+	mutable std::mutex StatsMutex;
+	Stats CurrentStats;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU side of the texture cook: mip generation and block compression into the BCn formats D3D11 samples directly.
+// No D3D or WIC dependencies, so it runs headless, the decoders are the reference the encoders are measured against.
+
+enum class TextureCompressionFormat : uint32_t
+{
+	// RGB 5:6:5 endpoints, 4 bits per pixel, alpha is dropped
+	BC1,
+	// BC1 color and an interpolated alpha block, 8 bits per pixel
+	BC3,
+	// Two interpolated channels, 8 bits per pixel, used for the XY of normal maps
+	BC5,
+	// RGBA with 7 bit endpoints and 16 weights, 8 bits per pixel. Only mode 6 is written and decoded
+	BC7,
+};
+
+enum class MipFilter : uint32_t
+{
+	// 2x2 average
+	Box,
+	// Kaiser windowed sinc, keeps small mips sharper than the box filter
+	Kaiser,
+};
+
+// 8 bit RGBA pixels, rows are tightly packed
+struct TextureImage
+{
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	std::vector<uint8_t> Pixels;
+};
+
+struct MipChainSettings
+{
+	MipFilter Filter = MipFilter::Kaiser;
+	// RGB is filtered in linear space
+	bool bSrgb = false;
+	// RGB holds a unit vector in [0, 1], it is renormalized in every mip
+	bool bNormalMap = false;
+};
+
+// Level 0 is InImage, every following level halves the size down to 1x1
+auto GenerateMipChain(const TextureImage& InImage, const MipChainSettings& InSettings) -> std::vector<TextureImage>;
+// Filtered the same way as the mips
+auto ResizeImage(const TextureImage& InImage, uint32_t InWidth, uint32_t InHeight, const MipChainSettings& InSettings) -> TextureImage;
+
+auto GetCompressedBlockSize(TextureCompressionFormat InFormat) -> size_t;
+// Bytes of an image compressed with InFormat, partial blocks at the edges are padded to 4x4
+auto GetCompressedSize(uint32_t InWidth, uint32_t InHeight, TextureCompressionFormat InFormat) -> size_t;
+
+// Blocks are 16 RGBA pixels in row order
+auto CompressBlockBC1(const uint8_t InPixels[64], uint8_t OutBlock[8]) -> void;
+auto CompressBlockBC3(const uint8_t InPixels[64], uint8_t OutBlock[16]) -> void;
+auto CompressBlockBC5(const uint8_t InPixels[64], uint8_t OutBlock[16]) -> void;
+auto CompressBlockBC7(const uint8_t InPixels[64], uint8_t OutBlock[16]) -> void;
+
+auto DecompressBlockBC1(const uint8_t InBlock[8], uint8_t OutPixels[64]) -> void;
+auto DecompressBlockBC3(const uint8_t InBlock[16], uint8_t OutPixels[64]) -> void;
+// Blue is 0 and alpha 255, as the sampler returns them
+auto DecompressBlockBC5(const uint8_t InBlock[16], uint8_t OutPixels[64]) -> void;
+// Blocks of other modes decode as transparent black
+auto DecompressBlockBC7(const uint8_t InBlock[16], uint8_t OutPixels[64]) -> void;
+
+// Blocks in row order, GetCompressedSize bytes
+auto CompressImage(const TextureImage& InImage, TextureCompressionFormat InFormat) -> std::vector<uint8_t>;
+auto DecompressImage(const uint8_t* InData, uint32_t InWidth, uint32_t InHeight, TextureCompressionFormat InFormat) -> TextureImage;
+
+// Peak signal to noise ratio in dB over the channels in InChannelMask (bit 0 is red), infinite for equal images
+auto ComputePsnr(const TextureImage& InA, const TextureImage& InB, uint32_t InChannelMask = 0xF) -> float;
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Decides which mips of streamed textures are resident, without touching D3D.
+// A texture always keeps its mip tail (mips up to MinResidentSize), finer mips are streamed in when renderers
+// request a resolution that needs them and streamed out again under memory pressure, least recently requested first.
+// Mips nobody needs any more stay resident while the budget allows it.
+// The owner carries the changes out and reports back with CompleteChange, a texture has at most one change in flight.
+class TextureResidency
+{
+public:
+	struct Change
+	{
+		uint32_t Id;
+		// Most detailed mip the texture is recreated with
+		uint32_t FirstMip;
+	};
+
+	struct Stats
+	{
+		uint32_t NumTextures = 0;
+		uint32_t NumPending = 0;
+		// Of the resident mips, and of the mips the textures would have without a budget
+		size_t ResidentBytes = 0;
+		size_t WantedBytes = 0;
+		uint64_t NumStreamedIn = 0;
+		uint64_t NumStreamedOut = 0;
+		uint64_t NumFailed = 0;
+		// Textures that failed too often and stay at their resident mip
+		uint32_t NumUnstreamable = 0;
+	};
+
+	static constexpr uint32_t InvalidId = ~0u;
+
+	// Most detailed mip of the tail: the first one that fits in MinResidentSize, no coarser than InMaxFirstMip
+	auto GetTailMip(uint32_t InWidth, uint32_t InHeight, uint32_t InMipLevels, uint32_t InMaxFirstMip) const -> uint32_t;
+
+	// InMipBytes has the size of every mip, all array slices included, mip 0 first. The texture starts with InTailMip resident
+	auto AddTexture(uint32_t InWidth, uint32_t InHeight, std::vector<size_t> InMipBytes, uint32_t InTailMip) -> uint32_t;
+	// A change in flight is dropped, CompleteChange ignores removed textures
+	auto RemoveTexture(uint32_t InId) -> void;
+
+	// Size in pixels the texture covers on screen, the finest request since the last Update counts
+	auto RequestResolution(uint32_t InId, float InPixels) -> void;
+
+	// Called once a frame, appends the changes to carry out to OutChanges
+	auto Update(std::vector<Change>& OutChanges) -> void;
+	// A failed change leaves the old mips resident. The texture waits before its next change, twice as long
+	// after every failure in a row, and stops streaming after MaxFailures of them.
+	auto CompleteChange(uint32_t InId, bool bInSucceeded) -> void;
+
+	auto GetResidentMip(uint32_t InId) const -> uint32_t;
+	auto GetWantedMip(uint32_t InId) const -> uint32_t;
+	auto IsPending(uint32_t InId) const -> bool;
+	auto IsStreamable(uint32_t InId) const -> bool;
+	auto GetStats() const -> Stats;
+
+	// Settings, the tail size has to be set before textures are added
+	auto SetMemoryBudget(size_t InBytes) -> void { MemoryBudget = InBytes; }
+	auto GetMemoryBudget() const -> size_t { return MemoryBudget; }
+	// Video memory outside the streamed textures that counts against the budget, set every frame by the owner
+	auto SetReservedBytes(size_t InBytes) -> void { ReservedBytes = InBytes; }
+	auto GetReservedBytes() const -> size_t { return ReservedBytes; }
+	auto SetMinResidentSize(uint32_t InPixels) -> void { MinResidentSize = InPixels; }
+	auto GetMinResidentSize() const -> uint32_t { return MinResidentSize; }
+	// Changes in flight at once, each one is a file read and a texture creation
+	auto SetMaxPendingChanges(uint32_t InNumChanges) -> void { MaxPendingChanges = InNumChanges; }
+	// Frames a texture keeps its wanted mip after the last request, then it only wants its tail
+	auto SetKeepFrames(uint32_t InNumFrames) -> void { KeepFrames = InNumFrames; }
+	// Added to the mip a resolution needs, positive values trade sharpness for memory
+	auto SetMipBias(float InBias) -> void { MipBias = InBias; }
+	// Frames a texture waits after its first failed change, and failures in a row before it stops streaming
+	auto SetFailureBackoff(uint32_t InRetryFrames, uint32_t InMaxFailures) -> void { RetryFrames = InRetryFrames; MaxFailures = InMaxFailures; }
+
+private:
+	struct TextureState
+	{
+		uint32_t Size = 0;
+		std::vector<size_t> MipBytes;
+		uint32_t TailMip = 0;
+		uint32_t ResidentMip = 0;
+		uint32_t WantedMip = 0;
+		// Finest mip requested since the last Update, TailMip when there was no request
+		uint32_t RequestedMip = 0;
+		uint64_t LastRequestFrame = 0;
+		bool bRequested = false;
+		bool bPending = false;
+		uint32_t PendingMip = 0;
+		// Failed changes in a row, no change starts before RetryFrame
+		uint32_t NumFailures = 0;
+		uint64_t RetryFrame = 0;
+	};
+
+	// Bytes of the mips from InFirstMip down to the smallest one
+	static auto GetBytes(const TextureState& InState, uint32_t InFirstMip) -> size_t;
+	// Bytes counted against the budget, the finer of the old and new mips while a change is in flight
+	static auto GetCommittedBytes(const TextureState& InState) -> size_t;
+	auto CanStartChange(const TextureState& InState) const -> bool;
+
+	// Starts streaming out mips nobody wants, least recently requested first, until InBytes are on their way out.
+	// Returns the bytes that will be freed
+	auto TrimUnwanted(size_t InBytes, std::vector<Change>& OutChanges) -> size_t;
+	auto StartChange(uint32_t InId, TextureState& InState, uint32_t InFirstMip, std::vector<Change>& OutChanges) -> void;
+
+	std::unordered_map<uint32_t, TextureState> Textures;
+	uint32_t NextId = 0;
+	uint64_t Frame = 0;
+	uint32_t NumPending = 0;
+	uint64_t NumStreamedIn = 0;
+	uint64_t NumStreamedOut = 0;
+	uint64_t NumFailed = 0;
+
+	size_t MemoryBudget = size_t(512) << 20;
+	size_t ReservedBytes = 0;
+	uint32_t MinResidentSize = 64;
+	uint32_t MaxPendingChanges = 4;
+	uint32_t KeepFrames = 60;
+	float MipBias = 0.0f;
+	uint32_t RetryFrames = 30;
+	uint32_t MaxFailures = 4;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "FileSystem.h"
+#include "TextureResidency.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <d3d11.h>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <wrl/client.h>
+
+class StreamedTexture;
+
+// Streams mips of cooked textures in and out, TextureResidency decides which.
+// A change recreates the texture from its mapped .dds file on a streaming thread, with the new most detailed mip,
+// and the main thread swaps it into the asset in Tick. Everything but the threads is main thread only.
+class TextureStreamer
+{
+public:
+	explicit TextureStreamer(uint32_t InNumThreads = 1);
+	~TextureStreamer();
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	// Called by StreamedTexture when it publishes a texture created with the tail mips of InCookedPath
+	auto Register(StreamedTexture* InTexture, const Path& InCookedPath, uint32_t InWidth, uint32_t InHeight,
+		std::vector<size_t> InMipBytes, uint32_t InTailMip) -> uint32_t;
+	// Changes still in flight are dropped when they finish
+	auto Unregister(uint32_t InId) -> void;
+
+	auto RequestResolution(uint32_t InId, float InPixels) -> void { Residency.RequestResolution(InId, InPixels); }
+
+	// Swaps finished changes in and starts the ones the residency asks for, called by the asset manager every frame
+	auto Tick() -> void;
+
+	// Budget and policy settings, change them before textures are loaded
+	auto GetResidency() -> TextureResidency& { return Residency; }
+	auto GetResidency() const -> const TextureResidency& { return Residency; }
+
+private:
+	struct Request
+	{
+		uint32_t Id;
+		Path CookedPath;
+		uint32_t FirstMip;
+	};
+
+	struct Result
+	{
+		uint32_t Id;
+		// Null when the file couldn't be read
+		Microsoft::WRL::ComPtr<ID3D11Resource> Tex;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> TexSRV;
+	};
+
+	struct Entry
+	{
+		StreamedTexture* Texture;
+		Path CookedPath;
+	};
+
+	auto ThreadLoop() -> void;
+
+	TextureResidency Residency;
+	std::unordered_map<uint32_t, Entry> Entries;
+	// Kept to reuse the memory
+	std::vector<TextureResidency::Change> Changes;
+
+	std::vector<std::thread> Threads;
+
+	std::mutex Mutex;
+	std::condition_variable WorkCondition;
+	std::deque<Request> Queued;
+	std::deque<Result> Finished;
+	bool bStopRequested = false;
+};
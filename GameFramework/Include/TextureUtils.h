@@ -0,0 +1,21 @@
+#pragma once
+
+#include "FileSystem.h"
+
+#include <d3d11.h>
+#include <cstddef>
+
+struct DdsTextureInfo;
+
+// Bytes of video memory used by all mips and array slices of a texture, an estimate for unknown formats
+auto GetTextureMemorySize(ID3D11Resource* InResource) -> size_t;
+
+// Immutable texture and view straight from the subresources of a parsed .dds, no copy of the data is made.
+// Mips finer than InFirstMip are left out, streamed textures start with their smallest mips
+auto CreateTextureFromDds(ID3D11Device* InDevice, const DdsTextureInfo& InInfo, uint32_t InFirstMip,
+	ID3D11Resource** OutTexture, ID3D11ShaderResourceView** OutTextureSRV) -> HRESULT;
+
+// Loads a .dds by mapping the file and uploading from the mapping.
+// Files ParseDdsTexture rejects go through DDSTextureLoader, which reads them into memory
+auto LoadDdsTexture(ID3D11Device* InDevice, const Path& InPath,
+	ID3D11Resource** OutTexture, ID3D11ShaderResourceView** OutTextureSRV) -> HRESULT;
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Transform.h"
+
+#include <cstdint>
+#include <vector>
+
+// Linear storage for scene component transforms.
+// Relative transforms and world matrices are kept in separate arrays (structure of arrays)
+// sorted so that every parent goes before its children, which lets UpdateWorldMatrices()
+// compute the whole hierarchy in a single forward pass.
+// Components reference their data with a stable handle, dense indices may change on relayout.
+class TransformStore
+{
+public:
+	using Handle = uint32_t;
+	static constexpr Handle InvalidHandle = UINT32_MAX;
+
+	auto Allocate() -> Handle;
+	auto Release(Handle InHandle) -> void;
+
+	auto SetParent(Handle InHandle, Handle InParent) -> void;
+	auto GetParent(Handle InHandle) const -> Handle { return ParentHandles[HandleToDense[InHandle]]; }
+
+	auto SetRelativeTransform(Handle InHandle, const Transform& InTransform) -> void;
+	auto GetRelativeTransform(Handle InHandle) const -> Transform;
+
+	auto SetRelativePosition(Handle InHandle, const Vector3& InPosition) -> void;
+	auto GetRelativePosition(Handle InHandle) const -> Vector3 { return Positions[HandleToDense[InHandle]]; }
+
+	auto SetRelativeRotation(Handle InHandle, const Quaternion& InRotation) -> void;
+	auto GetRelativeRotation(Handle InHandle) const -> Quaternion { return Rotations[HandleToDense[InHandle]]; }
+
+	auto SetRelativeScale(Handle InHandle, const Vector3& InScale) -> void;
+	auto GetRelativeScale(Handle InHandle) const -> Vector3 { return Scales[HandleToDense[InHandle]]; }
+
+	// Only invalidates the given entry, propagation to children is up to the owner of the hierarchy
+	auto MarkDirty(Handle InHandle) -> void;
+	auto IsDirty(Handle InHandle) const -> bool { return Flags[HandleToDense[InHandle]] & WorldMatrixDirty; }
+
+	// Returned references stay valid until the next Allocate/Release call
+	auto GetWorldMatrix(Handle InHandle) -> const Matrix&;
+	auto GetWorldTransform(Handle InHandle) -> const Transform&;
+
+	// Batched pass recomputing every dirty world matrix, called once per frame
+	auto UpdateWorldMatrices() -> void;
+
+	auto GetNum() const -> size_t { return Positions.size(); }
+
+private:
+	enum : uint8_t
+	{
+		WorldMatrixDirty = 1 << 0,
+		WorldTransformDirty = 1 << 1,
+	};
+
+	auto UpdateWorldMatrix(uint32_t InDense) -> void;
+
+	// Sorts entries by hierarchy depth so parents always go before their children
+	auto Relayout() -> void;
+
+	// Dense arrays, indexed by the same dense index
+	std::vector<Vector3> Positions;
+	std::vector<Quaternion> Rotations;
+	std::vector<Vector3> Scales;
+	std::vector<Matrix> WorldMatrices;
+	std::vector<Transform> WorldTransforms;
+	std::vector<Handle> ParentHandles;
+	std::vector<uint32_t> ParentIndices;
+	std::vector<uint8_t> Flags;
+	std::vector<Handle> DenseToHandle;
+
+	// Sparse array, indexed by handle
+	std::vector<uint32_t> HandleToDense;
+	std::vector<Handle> FreeHandles;
+
+	// Dirty ancestors of the entry UpdateWorldMatrix resolves
+	std::vector<uint32_t> ChainScratch;
+
+	bool bNeedsRelayout = false;
+};
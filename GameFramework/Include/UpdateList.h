@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// Unordered list of objects updated in one loop, with O(1) removal by swapping the last object into the hole.
+// T keeps its slot in a uint32_t mUpdateListIndex member, InvalidIndex while it isn't listed.
+//
+// Objects may be added and removed while ForEach runs. Added ones are visited by the same loop.
+// Removed ones leave an empty slot that the loop skips, the holes are filled once the loop ends,
+// so nothing is skipped or visited twice because of a removal.
+template<class T>
+class UpdateList
+{
+public:
+	static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+	auto Add(T* InObject) -> void
+	{
+		InObject->mUpdateListIndex = static_cast<uint32_t>(Objects.size());
+		Objects.push_back(InObject);
+	}
+
+	auto Remove(T* InObject) -> void
+	{
+		assert(InObject->mUpdateListIndex != InvalidIndex);
+		const uint32_t index = InObject->mUpdateListIndex;
+		InObject->mUpdateListIndex = InvalidIndex;
+
+		if (bIterating)
+		{
+			Objects[index] = nullptr;
+			Holes.push_back(index);
+			return;
+		}
+
+		SwapRemove(index);
+	}
+
+	// Calls InFunc(T*) for every object, in slot order
+	template<class Func>
+	auto ForEach(Func&& InFunc) -> void
+	{
+		bIterating = true;
+		// Indexed, InFunc may add objects
+		for (size_t i = 0; i < Objects.size(); ++i)
+		{
+			if (T* object = Objects[i])
+			{
+				InFunc(object);
+			}
+		}
+		bIterating = false;
+
+		FillHoles();
+	}
+
+	// Has empty slots while ForEach runs
+	auto GetObjects() const -> const std::vector<T*>& { return Objects; }
+	auto GetNum() const -> size_t { return Objects.size() - Holes.size(); }
+
+private:
+	auto SwapRemove(uint32_t InIndex) -> void
+	{
+		T* last = Objects.back();
+		Objects[InIndex] = last;
+		if (last != nullptr)
+		{
+			last->mUpdateListIndex = InIndex;
+		}
+		Objects.pop_back();
+	}
+
+	auto FillHoles() -> void
+	{
+		if (Holes.empty())
+		{
+			return;
+		}
+
+		// Highest first, the holes above are gone by then so the last slot always holds an object or is the hole itself
+		std::sort(Holes.begin(), Holes.end(), [](uint32_t a, uint32_t b) { return a > b; });
+		for (const uint32_t hole : Holes)
+		{
+			SwapRemove(hole);
+		}
+		Holes.clear();
+	}
+
+	std::vector<T*> Objects;
+	// Slots emptied while iterating
+	std::vector<uint32_t> Holes;
+	bool bIterating = false;
+};
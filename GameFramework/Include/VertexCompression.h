@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Mesh.h"
+#include "VertexQuantization.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Encoding of TexturedVertex into PackedTexturedVertex.
+// UnpackVertex is the CPU reference of the decode done by TexturedShader.hlsl with PACKED_VERTEX defined.
+
+// Unit vector to snorm16 octahedral coordinates, a zero vector decodes as +Z
+auto OctahedralEncode(const Vector3& InDirection, int16_t OutEncoded[2]) -> void;
+auto OctahedralDecode(const int16_t InEncoded[2]) -> Vector3;
+
+auto PackVertex(const TexturedVertex& InVertex) -> PackedTexturedVertex;
+// The binormal is rebuilt from the normal and tangent, so it comes back orthogonal to both
+auto UnpackVertex(const PackedTexturedVertex& InVertex) -> TexturedVertex;
+
+// Largest differences between vertices and their packed versions
+struct VertexPackingError
+{
+	float Position = 0.0f;
+	float TexCoord = 0.0f;
+	float NormalDegrees = 0.0f;
+	float TangentDegrees = 0.0f;
+};
+
+auto MeasurePackingError(const TexturedVertex* InVertices, size_t InNumVertices) -> VertexPackingError;
+
+// Half positions lose precision far from the origin and half texcoords with large tiling,
+// meshes that would move by more than this are kept in the full format
+constexpr float MaxPackedPositionError = 1.0f / 1024.0f; // of the bounding box diagonal
+constexpr float MaxPackedTexCoordError = 1.0f / 2048.0f;
+
+auto CanPackVertices(const TexturedVertex* InVertices, size_t InNumVertices) -> bool;
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// Scalar and direction quantizers of the packed vertex format, without the math library so they build headless.
+// VertexCompression.h packs whole vertices with them.
+
+// Round to nearest even, values past the half range become infinity
+auto FloatToHalf(float InValue) -> uint16_t;
+auto HalfToFloat(uint16_t InValue) -> float;
+
+// Direction to snorm16 octahedral coordinates, a zero vector decodes as +Z
+auto OctahedralEncode(float InX, float InY, float InZ, int16_t OutEncoded[2]) -> void;
+// Unit vector, matches OctahedralDecode in TexturedShader.hlsl
+auto OctahedralDecode(const int16_t InEncoded[2], float OutDirection[3]) -> void;
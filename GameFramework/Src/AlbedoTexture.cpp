@@ -1,9 +1,23 @@
 #include "AlbedoTexture.h"
+#include "AssetManager.h"
 #include "Game.h"
+#include "TextureCache.h"
 
-auto AlbedoTexture::Load() -> bool
+auto AlbedoTexture::LoadData() -> bool
 {
-	DirectX::CreateWICTextureFromFile(Game::GetInstance()->GetD3DDevice().Get(), 
-		GetFullPath().wstring().c_str(), Tex.GetAddressOf(), TexSRV.GetAddressOf());
-	return TexSRV.GetAddressOf() != nullptr;
+	ID3D11Device* device = Game::GetInstance()->GetD3DDevice().Get();
+
+	Path cookedPath;
+	if (Game::GetInstance()->GetAssetManager()->GetTextureCache()->Open(GetFullPath(), TextureUsage::Albedo, cookedPath))
+	{
+		if (LoadCookedTexture(device, cookedPath))
+		{
+			return true;
+		}
+	}
+
+	// Images the cooker can't handle are still shown, uncompressed and without mips
+	const HRESULT hr = DirectX::CreateWICTextureFromFile(device,
+		GetFullPath().wstring().c_str(), LoadedTex.GetAddressOf(), LoadedTexSRV.GetAddressOf());
+	return SUCCEEDED(hr) && LoadedTexSRV != nullptr;
 }
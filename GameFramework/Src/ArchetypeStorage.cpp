@@ -0,0 +1,153 @@
+#include "ArchetypeStorage.h"
+
+#include <cassert>
+
+auto ArchetypeStorage::MakeMask(std::initializer_list<ComponentType> InTypes) -> ComponentMask
+{
+	ComponentMask mask = 0;
+	for (const ComponentType type : InTypes)
+	{
+		mask |= GetTypeBit(type);
+	}
+	return mask;
+}
+
+auto ArchetypeStorage::ChunkView::GetColumn(ComponentType InType) const -> Component* const*
+{
+	assert(InType != Undefined && ColumnByType[InType] >= 0 && "Component type is not part of this archetype");
+	return Columns + ColumnByType[InType] * ChunkCapacity;
+}
+
+auto ArchetypeStorage::SetActorComponents(Actor* InActor, const Component* const (&InComponentsByType)[Last]) -> void
+{
+	ComponentMask mask = 0;
+	for (int type = 0; type < Last; ++type)
+	{
+		if (InComponentsByType[type] != nullptr)
+		{
+			mask |= GetTypeBit(static_cast<ComponentType>(type));
+		}
+	}
+
+	const auto found = Locations.find(InActor);
+	if (found != Locations.end())
+	{
+		const Location location = found->second;
+		if (location.Owner->Mask == mask)
+		{
+			// Same archetype, only refresh the columns in case a component was replaced
+			Chunk& chunk = *location.Owner->Chunks[location.ChunkIndex];
+			for (int type = 0; type < Last; ++type)
+			{
+				const int8_t column = location.Owner->ColumnByType[type];
+				if (column >= 0)
+				{
+					chunk.Columns[column * ChunkCapacity + location.Row] = const_cast<Component*>(InComponentsByType[type]);
+				}
+			}
+			return;
+		}
+
+		RemoveRow(location);
+		Locations.erase(InActor);
+	}
+
+	Archetype* archetype = FindOrCreateArchetype(mask);
+	Locations[InActor] = AddRow(*archetype, InActor, InComponentsByType);
+}
+
+auto ArchetypeStorage::RemoveActor(Actor* InActor) -> void
+{
+	const auto found = Locations.find(InActor);
+	if (found == Locations.end())
+	{
+		return;
+	}
+
+	RemoveRow(found->second);
+	Locations.erase(found);
+}
+
+auto ArchetypeStorage::FindOrCreateArchetype(ComponentMask InMask) -> Archetype*
+{
+	auto& archetype = Archetypes[InMask];
+	if (archetype)
+	{
+		return archetype.get();
+	}
+
+	archetype = std::make_unique<Archetype>();
+	archetype->Mask = InMask;
+	for (int type = 0; type < Last; ++type)
+	{
+		archetype->ColumnByType[type] = (InMask & GetTypeBit(static_cast<ComponentType>(type)))
+			? static_cast<int8_t>(archetype->NumColumns++)
+			: -1;
+	}
+
+	return archetype.get();
+}
+
+auto ArchetypeStorage::AddRow(Archetype& InArchetype, Actor* InActor, const Component* const* InComponentsByType) -> Location
+{
+	// Only the last chunk can have free rows, removal keeps the others full
+	if (InArchetype.Chunks.empty() || InArchetype.Chunks.back()->Num == ChunkCapacity)
+	{
+		auto chunk = std::make_unique<Chunk>();
+		chunk->Columns = std::make_unique<Component*[]>(static_cast<size_t>(InArchetype.NumColumns) * ChunkCapacity);
+		InArchetype.Chunks.push_back(std::move(chunk));
+	}
+
+	const uint32_t chunkIndex = static_cast<uint32_t>(InArchetype.Chunks.size()) - 1;
+	Chunk& chunk = *InArchetype.Chunks.back();
+	const uint32_t row = chunk.Num++;
+
+	chunk.Actors[row] = InActor;
+	for (int type = 0; type < Last; ++type)
+	{
+		const int8_t column = InArchetype.ColumnByType[type];
+		if (column >= 0)
+		{
+			chunk.Columns[column * ChunkCapacity + row] = const_cast<Component*>(InComponentsByType[type]);
+		}
+	}
+
+	return { &InArchetype, chunkIndex, row };
+}
+
+auto ArchetypeStorage::RemoveRow(const Location& InLocation) -> void
+{
+	Archetype& archetype = *InLocation.Owner;
+	Chunk& chunk = *archetype.Chunks[InLocation.ChunkIndex];
+	Chunk& lastChunk = *archetype.Chunks.back();
+	const uint32_t lastRow = lastChunk.Num - 1;
+
+	// Fill the hole with the very last row of the archetype
+	if (&chunk != &lastChunk || InLocation.Row != lastRow)
+	{
+		Actor* moved = lastChunk.Actors[lastRow];
+		chunk.Actors[InLocation.Row] = moved;
+		for (uint32_t column = 0; column < archetype.NumColumns; ++column)
+		{
+			chunk.Columns[column * ChunkCapacity + InLocation.Row] = lastChunk.Columns[column * ChunkCapacity + lastRow];
+		}
+
+		Locations[moved] = InLocation;
+	}
+
+	lastChunk.Actors[lastRow] = nullptr;
+	if (--lastChunk.Num == 0)
+	{
+		archetype.Chunks.pop_back();
+	}
+}
+
+auto ArchetypeStorage::MakeView(const Archetype& InArchetype, const Chunk& InChunk) -> ChunkView
+{
+	ChunkView view;
+	view.Num = InChunk.Num;
+	view.Actors = InChunk.Actors;
+	view.Columns = InChunk.Columns.get();
+	view.ColumnByType = InArchetype.ColumnByType;
+	return view;
+}
@@ -0,0 +1,353 @@
+#include "AssetIndex.h"
+
+#include "BinaryArchive.h"
+#include "JobSystem.h"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <system_error>
+#include <unordered_set>
+
+namespace
+{
+	constexpr uint32_t AssetIndexMagic = 0x5849414E; // "NAIX"
+	// Bump when the entries or what scanning puts into them change
+	constexpr uint32_t AssetIndexVersion = 1;
+
+	struct AssetIndexHeader
+	{
+		uint32_t Magic = AssetIndexMagic;
+		uint32_t Version = AssetIndexVersion;
+		uint32_t NumEntries = 0;
+		uint32_t Reserved = 0;
+	};
+}
+
+auto WalkDirectory(const Path& InRoot, const std::function<void(const std::filesystem::directory_entry&)>& InVisit) -> void
+{
+	std::error_code error;
+	std::filesystem::recursive_directory_iterator it(InRoot, std::filesystem::directory_options::skip_permission_denied, error);
+	const std::filesystem::recursive_directory_iterator end;
+
+	while (!error && it != end)
+	{
+		InVisit(*it);
+
+		it.increment(error);
+		if (error)
+		{
+			// Entering or reading the directory failed, step over it and then out of its parent if that fails too
+			error.clear();
+			it.disable_recursion_pending();
+			it.increment(error);
+			if (error)
+			{
+				error.clear();
+				it.pop(error);
+			}
+		}
+	}
+}
+
+AssetIndex::AssetIndex(const Path& InIndexPath)
+	: IndexPath(InIndexPath)
+{
+}
+
+AssetIndex::~AssetIndex()
+{
+	if (Pending)
+	{
+		Pending->Jobs->Wait(Pending->Counter);
+	}
+}
+
+auto AssetIndex::Load() -> bool
+{
+	Entries.clear();
+	bSaveNeeded = true;
+
+	MappedFile file;
+	if (!file.Open(IndexPath) || file.GetSize() < sizeof(AssetIndexHeader))
+	{
+		return false;
+	}
+
+	BinaryReader reader(file.GetData(), file.GetSize());
+	const AssetIndexHeader header = reader.Read<AssetIndexHeader>();
+	if (header.Magic != AssetIndexMagic || header.Version != AssetIndexVersion)
+	{
+		return false;
+	}
+
+	// Path length, types, write time, size and sub asset count are the least an entry takes
+	Entries.reserve(reader.ClampCount(header.NumEntries, 26));
+	for (uint32_t i = 0; i < header.NumEntries && reader.IsValid(); ++i)
+	{
+		const std::string_view path = reader.ReadString();
+
+		AssetIndexEntry entry;
+		entry.NodeType = static_cast<DirectoryTreeNodeType>(reader.Read<uint8_t>());
+		entry.Type = static_cast<AssetType>(reader.Read<uint8_t>());
+		entry.WriteTime = reader.Read<int64_t>();
+		entry.Size = reader.Read<uint64_t>();
+
+		const uint32_t numSubAssets = reader.Read<uint32_t>();
+		for (uint32_t subAsset = 0; subAsset < numSubAssets && reader.IsValid(); ++subAsset)
+		{
+			entry.SubAssets.emplace_back(reader.ReadString());
+		}
+
+		Entries.emplace(std::string(path), std::move(entry));
+	}
+
+	if (!reader.IsValid())
+	{
+		Entries.clear();
+		return false;
+	}
+
+	bSaveNeeded = false;
+	return true;
+}
+
+auto AssetIndex::Save() const -> bool
+{
+	BinaryWriter out;
+
+	AssetIndexHeader header;
+	header.NumEntries = static_cast<uint32_t>(Entries.size());
+	out.Write(header);
+
+	for (const auto& [path, entry] : Entries)
+	{
+		out.WriteString(path);
+		out.Write(static_cast<uint8_t>(entry.NodeType));
+		out.Write(static_cast<uint8_t>(entry.Type));
+		out.Write(entry.WriteTime);
+		out.Write(entry.Size);
+
+		out.Write(static_cast<uint32_t>(entry.SubAssets.size()));
+		for (const std::string& subAsset : entry.SubAssets)
+		{
+			out.WriteString(subAsset);
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(IndexPath.parent_path(), error);
+	return WriteFileAtomically(IndexPath, out.GetBuffer());
+}
+
+auto AssetIndex::Update(const Path& InRoot, const ScanFunction& InScan, JobSystem& InJobSystem) -> void
+{
+	BeginUpdate(InRoot, InScan, InJobSystem);
+	InJobSystem.Wait(Pending->Counter);
+	TryFinishUpdate();
+}
+
+auto AssetIndex::UpdatePaths(const Path& InRoot, const std::vector<Path>& InRelativePaths, const ScanFunction& InScan, JobSystem& InJobSystem) -> void
+{
+	BeginUpdatePaths(InRoot, InRelativePaths, InScan, InJobSystem);
+	InJobSystem.Wait(Pending->Counter);
+	TryFinishUpdate();
+}
+
+auto AssetIndex::BeginUpdate(const Path& InRoot, const ScanFunction& InScan, JobSystem& InJobSystem) -> void
+{
+	PendingUpdate& update = StartUpdate(InScan, InJobSystem);
+	update.bFull = true;
+
+	std::unordered_set<std::string> seenPaths;
+	seenPaths.reserve(Entries.size());
+
+	WalkDirectory(InRoot, [&](const std::filesystem::directory_entry& InDirEntry)
+	{
+		const Path relativePath = InDirEntry.path().lexically_relative(InRoot);
+
+		std::error_code error;
+		if (InDirEntry.is_directory(error))
+		{
+			update.Items.push_back({ relativePath, true, nullptr });
+		}
+		else if (CheckFile(InDirEntry, relativePath, update, seenPaths))
+		{
+			update.Items.push_back({ relativePath, false, nullptr });
+		}
+	});
+
+	CollectUnseen("", seenPaths, update);
+	SubmitScans();
+}
+
+auto AssetIndex::BeginUpdatePaths(const Path& InRoot, const std::vector<Path>& InRelativePaths, const ScanFunction& InScan, JobSystem& InJobSystem) -> void
+{
+	PendingUpdate& update = StartUpdate(InScan, InJobSystem);
+
+	std::unordered_set<std::string> seenPaths;
+
+	for (const Path& relativePath : InRelativePaths)
+	{
+		const std::string key = relativePath.generic_string();
+		// A path that is gone or can't be read is checked as a missing file and its entries are removed
+		std::error_code error;
+		std::filesystem::directory_entry dirEntry;
+		dirEntry.assign(InRoot / relativePath, error);
+
+		if (dirEntry.is_directory(error))
+		{
+			WalkDirectory(dirEntry.path(), [&](const std::filesystem::directory_entry& InChildEntry)
+			{
+				CheckFile(InChildEntry, InChildEntry.path().lexically_relative(InRoot), update, seenPaths);
+			});
+		}
+		else
+		{
+			CheckFile(dirEntry, relativePath, update, seenPaths);
+		}
+
+		// Whatever was at or below the path and wasn't found again is gone
+		CollectUnseen(key, seenPaths, update);
+	}
+
+	SubmitScans();
+}
+
+auto AssetIndex::TryFinishUpdate() -> bool
+{
+	if (Pending == nullptr)
+	{
+		return true;
+	}
+	if (!Pending->Counter.IsDone())
+	{
+		return false;
+	}
+
+	// Scanned entries are replaced, erasing never invalidates the other entries
+	ChangedPaths.clear();
+	for (PendingScan& scan : Pending->Scans)
+	{
+		Entries[scan.RelativePath.generic_string()] = std::move(scan.Entry);
+		ChangedPaths.push_back(std::move(scan.RelativePath));
+	}
+	for (const std::string& key : Pending->RemovedKeys)
+	{
+		if (Entries.erase(key) > 0)
+		{
+			ChangedPaths.emplace_back(key);
+			++Pending->UpdateStats.NumRemoved;
+		}
+	}
+
+	if (Pending->bFull)
+	{
+		Items = std::move(Pending->Items);
+		for (Item& item : Items)
+		{
+			item.Entry = item.bDirectory ? nullptr : FindEntry(item.RelativePath);
+		}
+	}
+
+	LastStats = Pending->UpdateStats;
+	const auto start = Pending->Start;
+	Pending.reset();
+
+	if (bSaveNeeded || LastStats.NumScanned > 0 || LastStats.NumRemoved > 0)
+	{
+		bSaveNeeded = !Save();
+	}
+
+	LastStats.UpdateMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "Asset index: " << LastStats.NumFiles << " files, " << LastStats.NumScanned << " scanned, "
+		<< LastStats.NumRemoved << " removed in " << LastStats.UpdateMs << " ms" << std::endl;
+
+	return true;
+}
+
+auto AssetIndex::FindEntry(const Path& InRelativePath) const -> const AssetIndexEntry*
+{
+	auto found = Entries.find(InRelativePath.generic_string());
+	return found != Entries.end() ? &found->second : nullptr;
+}
+
+auto AssetIndex::StartUpdate(const ScanFunction& InScan, JobSystem& InJobSystem) -> PendingUpdate&
+{
+	assert(Pending == nullptr && "One asset index update at a time");
+
+	Pending.reset(new PendingUpdate());
+	Pending->Scan = InScan;
+	Pending->Jobs = &InJobSystem;
+	Pending->Start = std::chrono::steady_clock::now();
+	return *Pending;
+}
+
+auto AssetIndex::CheckFile(const std::filesystem::directory_entry& InDirEntry, const Path& InRelativePath,
+	PendingUpdate& OutUpdate, std::unordered_set<std::string>& OutSeenPaths) -> bool
+{
+	// Directory entries carry the write time and size, nothing is opened here.
+	// A file that can't be queried is left out as if it wasn't there.
+	std::error_code error;
+	if (!InDirEntry.is_regular_file(error))
+	{
+		return false;
+	}
+
+	const int64_t writeTime = InDirEntry.last_write_time(error).time_since_epoch().count();
+	if (error)
+	{
+		return false;
+	}
+	const uint64_t size = InDirEntry.file_size(error);
+	if (error)
+	{
+		return false;
+	}
+
+	// Changed paths can overlap, a file is checked once per update
+	std::string key = InRelativePath.generic_string();
+	if (!OutSeenPaths.insert(key).second)
+	{
+		return true;
+	}
+
+	const auto found = Entries.find(key);
+	if (found == Entries.end() || found->second.WriteTime != writeTime || found->second.Size != size)
+	{
+		PendingScan scan;
+		scan.FilePath = InDirEntry.path();
+		scan.RelativePath = InRelativePath;
+		scan.Entry.WriteTime = writeTime;
+		scan.Entry.Size = size;
+		OutUpdate.Scans.push_back(std::move(scan));
+	}
+
+	++OutUpdate.UpdateStats.NumFiles;
+	return true;
+}
+
+auto AssetIndex::SubmitScans() -> void
+{
+	// The scans don't move any more, every job fills its own entry
+	PendingUpdate* update = Pending.get();
+	for (PendingScan& scan : update->Scans)
+	{
+		update->Jobs->Run([update, &scan]() { update->Scan(scan.FilePath, scan.Entry); }, &update->Counter);
+	}
+	update->UpdateStats.NumScanned = static_cast<uint32_t>(update->Scans.size());
+}
+
+auto AssetIndex::CollectUnseen(const std::string& InPrefix, const std::unordered_set<std::string>& InSeenPaths, PendingUpdate& OutUpdate) const -> void
+{
+	for (const auto& [key, entry] : Entries)
+	{
+		const bool bUnderPrefix = InPrefix.empty() || key == InPrefix
+			|| (key.size() > InPrefix.size() && key[InPrefix.size()] == '/' && key.compare(0, InPrefix.size(), InPrefix) == 0);
+
+		if (bUnderPrefix && InSeenPaths.count(key) == 0)
+		{
+			OutUpdate.RemovedKeys.push_back(key);
+		}
+	}
+}
@@ -0,0 +1,218 @@
+#include "AssetLoader.h"
+
+#include "Asset.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#include <Windows.h>
+
+AssetLoader::AssetLoader(uint32_t InNumThreads)
+{
+	for (uint32_t i = 0; i < (std::max)(InNumThreads, 1u); ++i)
+	{
+		Threads.emplace_back(&AssetLoader::ThreadLoop, this);
+	}
+}
+
+AssetLoader::~AssetLoader()
+{
+	{
+		std::lock_guard lock(Mutex);
+		bStopRequested = true;
+	}
+	WorkCondition.notify_all();
+
+	// Assets still queued are dropped, they stay in the Loading state
+	for (std::thread& thread : Threads)
+	{
+		thread.join();
+	}
+}
+
+auto AssetLoader::Enqueue(Asset* InAsset) -> void
+{
+	assert(InAsset->loadState == AssetLoadState::Unloaded);
+	InAsset->loadState = AssetLoadState::Loading;
+	Push({ InAsset, false });
+}
+
+auto AssetLoader::Reload(Asset* InAsset) -> void
+{
+	switch (InAsset->loadState)
+	{
+	case AssetLoadState::Unloaded:
+		// Nobody uses it, the next load reads the new source anyway
+		break;
+
+	case AssetLoadState::Failed:
+		// The source may be fixed now
+		InAsset->loadState = AssetLoadState::Unloaded;
+		Enqueue(InAsset);
+		break;
+
+	case AssetLoadState::Loading:
+		// Might have read the old source, imported once more when done
+		InAsset->bReloadRequested = true;
+		break;
+
+	case AssetLoadState::Loaded:
+		if (InAsset->bReloading)
+		{
+			InAsset->bReloadRequested = true;
+		}
+		else
+		{
+			InAsset->bReloading = true;
+			Push({ InAsset, true });
+		}
+		break;
+	}
+}
+
+auto AssetLoader::Push(const QueuedAsset& InQueued) -> void
+{
+	++NumInFlight;
+
+	{
+		std::lock_guard lock(Mutex);
+		Queued.push_back(InQueued);
+	}
+	WorkCondition.notify_one();
+}
+
+auto AssetLoader::Tick(float InBudgetMs) -> void
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	while (true)
+	{
+		DecodedAsset decoded{};
+		{
+			std::lock_guard lock(Mutex);
+			if (Decoded.empty())
+			{
+				return;
+			}
+			decoded = Decoded.front();
+			Decoded.pop_front();
+		}
+
+		Finish(decoded);
+
+		const float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (elapsedMs >= InBudgetMs)
+		{
+			return;
+		}
+	}
+}
+
+auto AssetLoader::Wait(Asset* InAsset) -> void
+{
+	if (InAsset->loadState != AssetLoadState::Loading)
+	{
+		return;
+	}
+
+	std::unique_lock lock(Mutex);
+
+	// Not started yet, faster to do it here than to wait for everything queued before it
+	const auto queuedIt = std::find_if(Queued.begin(), Queued.end(), [InAsset](const QueuedAsset& queued) { return queued.LoadedAsset == InAsset; });
+	if (queuedIt != Queued.end())
+	{
+		const QueuedAsset queued = *queuedIt;
+		Queued.erase(queuedIt);
+		lock.unlock();
+		Finish({ InAsset, queued.bReload, InAsset->LoadData() });
+		return;
+	}
+
+	auto decodedIt = Decoded.end();
+	DecodedCondition.wait(lock, [&]
+	{
+		decodedIt = std::find_if(Decoded.begin(), Decoded.end(), [InAsset](const DecodedAsset& decoded) { return decoded.LoadedAsset == InAsset; });
+		return decodedIt != Decoded.end();
+	});
+
+	const DecodedAsset decoded = *decodedIt;
+	Decoded.erase(decodedIt);
+	lock.unlock();
+
+	Finish(decoded);
+}
+
+auto AssetLoader::WaitAll() -> void
+{
+	while (NumInFlight > 0)
+	{
+		std::unique_lock lock(Mutex);
+		DecodedCondition.wait(lock, [this] { return !Decoded.empty(); });
+		lock.unlock();
+
+		Tick((std::numeric_limits<float>::max)());
+	}
+}
+
+auto AssetLoader::ThreadLoop() -> void
+{
+	// WIC decoders are COM objects
+	CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+	while (true)
+	{
+		QueuedAsset queued{};
+		{
+			std::unique_lock lock(Mutex);
+			WorkCondition.wait(lock, [this] { return bStopRequested || !Queued.empty(); });
+			if (bStopRequested)
+			{
+				break;
+			}
+			queued = Queued.front();
+			Queued.pop_front();
+		}
+
+		const bool bSucceeded = queued.LoadedAsset->LoadData();
+
+		{
+			std::lock_guard lock(Mutex);
+			Decoded.push_back({ queued.LoadedAsset, queued.bReload, bSucceeded });
+		}
+		DecodedCondition.notify_all();
+	}
+
+	CoUninitialize();
+}
+
+auto AssetLoader::Finish(const DecodedAsset& InDecoded) -> void
+{
+	Asset* asset = InDecoded.LoadedAsset;
+	--NumInFlight;
+
+	const bool bSucceeded = InDecoded.bSucceeded && asset->FinishLoad();
+	if (bSucceeded)
+	{
+		++asset->generation;
+	}
+
+	if (InDecoded.bReload)
+	{
+		// A broken source keeps the data loaded before
+		asset->bReloading = false;
+		std::cout << (bSucceeded ? "Reloaded " : "Failed to reload ") << asset->GetFullPath().string() << std::endl;
+	}
+	else
+	{
+		asset->loadState = bSucceeded ? AssetLoadState::Loaded : AssetLoadState::Failed;
+	}
+
+	if (asset->bReloadRequested)
+	{
+		asset->bReloadRequested = false;
+		Reload(asset);
+	}
+}
@@ -1,9 +1,14 @@
 #include "AssetManager.h"
 
+#include "AssetIndex.h"
+#include "AssetLoader.h"
+#include "AssetWatcher.h"
 #include "DirectoryTree.h"
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
+#include "Game.h"
+#include "JobSystem.h"
+#include "MeshCache.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
 
 #include "StaticMesh.h"
 #include "AlbedoTexture.h"
@@ -11,67 +16,244 @@
 #include <EngineContentRegistry.h>
 
 #include "JsonInclude.h"
+#include "Serializer.h"
+#include <algorithm>
 #include <fstream>
 
+namespace
+{
+	// Stops at the top level "AssetType", it is usually the first key so the rest of the document isn't parsed
+	class AssetTypeReader : public nlohmann::json_sax<json>
+	{
+	public:
+		AssetType Type = AssetType::Unspecified;
+
+		bool null() override { return Value(); }
+		bool boolean(bool) override { return Value(); }
+		bool number_integer(number_integer_t) override { return Value(); }
+		bool number_unsigned(number_unsigned_t) override { return Value(); }
+		bool number_float(number_float_t, const string_t&) override { return Value(); }
+		bool binary(binary_t&) override { return Value(); }
+
+		bool string(string_t& val) override
+		{
+			if (bAtAssetType)
+			{
+				Type = json(val).get<AssetType>();
+				return false;
+			}
+			return Value();
+		}
+
+		bool start_object(std::size_t) override { bAtAssetType = false; ++Depth; return true; }
+		bool end_object() override { --Depth; return true; }
+		bool start_array(std::size_t) override { bAtAssetType = false; ++Depth; return true; }
+		bool end_array() override { --Depth; return true; }
+
+		bool key(string_t& val) override
+		{
+			bAtAssetType = Depth == 1 && val == "AssetType";
+			return true;
+		}
+
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override { return false; }
+
+	private:
+		bool Value() { bAtAssetType = false; return true; }
+
+		int Depth = 0;
+		bool bAtAssetType = false;
+	};
+
+	auto ReadJsonAssetType(std::istream& in) -> AssetType
+	{
+		AssetTypeReader reader;
+		json::sax_parse(in, &reader);
+		return reader.Type;
+	}
+}
+
+
+AssetManager::AssetManager() = default;
+
+AssetManager::~AssetManager() = default;
 
 auto AssetManager::Initialize() -> void
 {
-	directoryTree.reset(new DirectoryTree(Path("Assets")));
+	meshCache.reset(new MeshCache(projectPath / "Cache" / "Meshes"));
+	textureCache.reset(new TextureCache(projectPath / "Cache" / "Textures"));
+	textureStreamer.reset(new TextureStreamer());
+	assetIndex.reset(new AssetIndex(projectPath / "Cache" / "AssetIndex.bin"));
+	assetLoader.reset(new AssetLoader());
+	// Started first so nothing changed during the scan is missed
+	assetWatcher.reset(new AssetWatcher(assetsPath));
+	// A missing or outdated index leaves it empty, every file is scanned once then
+	assetIndex->Load();
 	FillDirectoryTree();
 }
 
 auto AssetManager::FillDirectoryTree() -> void
 {
-	for (auto dir_entry : std::filesystem::recursive_directory_iterator(assetsPath)) {
-		const Path path = dir_entry.path().lexically_relative(assetsPath);
-		const bool isDirectory = dir_entry.is_directory() || dir_entry.is_regular_file() && dir_entry.path().extension() == Path(".fbx");
-		if (dir_entry.is_directory()) {
-			directoryTree->AddNodeByPath(path, DirectoryTreeNodeType::Directory);
+	assetIndex->Update(assetsPath, [this](const Path& filePath, AssetIndexEntry& entry) { ScanAssetFile(filePath, entry); },
+		*Game::GetInstance()->GetJobSystem());
+
+	FillDirectoryTreeFromIndex();
+}
+
+auto AssetManager::FillDirectoryTreeFromIndex() -> void
+{
+	directoryTree.reset(new DirectoryTree(Path("Assets")));
+
+	for (const AssetIndex::Item& item : assetIndex->GetItems())
+	{
+		if (item.bDirectory)
+		{
+			directoryTree->AddNodeByPath(item.RelativePath, DirectoryTreeNodeType::Directory);
+		}
+		else
+		{
+			AddFileNode(item.RelativePath, *item.Entry);
+		}
+	}
+}
+
+auto AssetManager::AddFileNode(const Path& relativePath, const AssetIndexEntry& entry) -> void
+{
+	directoryTree->AddNodeByPath(relativePath, entry.NodeType, entry.Type);
+
+	for (const std::string& subAsset : entry.SubAssets)
+	{
+		directoryTree->AddNodeByPath(relativePath / Path(subAsset), DirectoryTreeNodeType::CollectionAsset);
+	}
+}
+
+auto AssetManager::ProcessAssetChanges() -> void
+{
+	// Files are scanned (meshes cooked) by jobs, the tree and the loaded assets follow once the scan has finished
+	if (assetIndex->IsUpdating())
+	{
+		if (!assetIndex->TryFinishUpdate())
+		{
+			return;
 		}
-		else if (dir_entry.is_regular_file())
+		ApplyAssetChanges();
+	}
+
+	// Changes reported meanwhile stay with the watcher until the scan is done
+	pendingChangedPaths.clear();
+	bPendingFullRescan = assetWatcher->PopSettledChanges(pendingChangedPaths);
+	if (!bPendingFullRescan && pendingChangedPaths.empty())
+	{
+		return;
+	}
+
+	const auto scan = [this](const Path& filePath, AssetIndexEntry& entry) { ScanAssetFile(filePath, entry); };
+	if (bPendingFullRescan)
+	{
+		assetIndex->BeginUpdate(assetsPath, scan, *Game::GetInstance()->GetJobSystem());
+	}
+	else
+	{
+		assetIndex->BeginUpdatePaths(assetsPath, pendingChangedPaths, scan, *Game::GetInstance()->GetJobSystem());
+	}
+}
+
+auto AssetManager::ApplyAssetChanges() -> void
+{
+	if (bPendingFullRescan)
+	{
+		FillDirectoryTreeFromIndex();
+	}
+	else
+	{
+		// Only the nodes of the changed paths are rebuilt
+		for (const Path& relativePath : pendingChangedPaths)
 		{
-			
-			if (IsAssetCollectionExtension(path.extension()))
+			RefreshDirectoryTreeNode(relativePath);
+		}
+	}
+
+	for (const Path& relativePath : assetIndex->GetChangedPaths())
+	{
+		ReloadAssetsFromFile(assetsPath / relativePath);
+	}
+}
+
+auto AssetManager::RefreshDirectoryTreeNode(const Path& relativePath) -> void
+{
+	directoryTree->RemoveNodeByPath(relativePath);
+
+	std::error_code error;
+	std::filesystem::directory_entry dirEntry;
+	dirEntry.assign(assetsPath / relativePath, error);
+	if (dirEntry.is_directory(error))
+	{
+		directoryTree->AddNodeByPath(relativePath, DirectoryTreeNodeType::Directory);
+
+		WalkDirectory(dirEntry.path(), [&](const std::filesystem::directory_entry& childEntry)
+		{
+			const Path childPath = childEntry.path().lexically_relative(assetsPath);
+			std::error_code childError;
+			if (childEntry.is_directory(childError))
+			{
+				directoryTree->AddNodeByPath(childPath, DirectoryTreeNodeType::Directory);
+			}
+			else if (const AssetIndexEntry* entry = assetIndex->FindEntry(childPath))
 			{
-				Assimp::Importer importer;
-				const aiScene* scene = importer.ReadFile(dir_entry.path().string(), aiProcess_FlipUVs | aiProcess_FlipWindingOrder | aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_CalcTangentSpace);
-
-				directoryTree->AddNodeByPath(path, DirectoryTreeNodeType::AssetCollection);
-				
-				// todo: think of how to make it better
-				// at least save this data into meta files
-				std::vector<const aiNode*> stack;
-				stack.push_back(scene->mRootNode);
-				while (!stack.empty())
-				{
-					const aiNode* node = stack.back();
-					stack.pop_back();
-
-					stack.insert(stack.end(), node->mChildren, node->mChildren + node->mNumChildren);
-
-					if (node->mNumMeshes > 0)
-					{
-						for (size_t i = 0; i < node->mNumMeshes; ++i)
-						{
-							const aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-							directoryTree->AddNodeByPath(path/Path(mesh->mName.C_Str()), DirectoryTreeNodeType::CollectionAsset);
-						}
-					}
-				}
+				AddFileNode(childPath, *entry);
 			}
-			else
+		});
+	}
+	else if (const AssetIndexEntry* entry = assetIndex->FindEntry(relativePath))
+	{
+		AddFileNode(relativePath, *entry);
+	}
+}
+
+auto AssetManager::ReloadAssetsFromFile(const Path& filePath) -> void
+{
+	const Path normalPath = filePath.lexically_normal();
+
+	// Changes are rare compared to lookups, a scan is fine here
+	for (const auto& [assetPath, asset] : LoadedAssetsMap)
+	{
+		const Path normalAssetPath = assetPath.lexically_normal();
+
+		// Textures are files, meshes live inside their collection file
+		if (normalAssetPath == normalPath || normalAssetPath.parent_path() == normalPath)
+		{
+			assetLoader->Reload(asset);
+		}
+	}
+}
+
+auto AssetManager::ScanAssetFile(const Path& filePath, AssetIndexEntry& entry) -> void
+{
+	const Path extension = filePath.extension();
+
+	if (IsAssetCollectionExtension(extension))
+	{
+		entry.NodeType = DirectoryTreeNodeType::AssetCollection;
+
+		// Cooking lists the meshes and has them ready for loading
+		CookedMeshCollection collection;
+		if (meshCache->Open(filePath, collection))
+		{
+			for (const std::string_view name : collection.GetMeshNames())
 			{
-				AssetType assetType = AssetType::Unspecified;
-				if (dir_entry.path().extension().native() == L".json")
-				{
-					std::ifstream in(dir_entry.path());
-					const json data = json::parse(in);
-					assetType = data["AssetType"].get<AssetType>();
-				}
-				directoryTree->AddNodeByPath(path, DirectoryTreeNodeType::File, assetType);
+				entry.SubAssets.emplace_back(name);
 			}
 		}
 	}
+	else if (extension.native() == L".json")
+	{
+		std::ifstream in(filePath);
+		entry.Type = ReadJsonAssetType(in);
+	}
+	else if (Serializer::IsBinaryLevelPath(filePath))
+	{
+		entry.Type = AssetType::Level;
+	}
 }
 
 auto AssetManager::IsAssetCollectionExtension(const Path& extension) const -> bool
@@ -79,74 +261,111 @@ auto AssetManager::IsAssetCollectionExtension(const Path& extension) const -> bo
 	return extension == Path(".fbx") || extension == Path(".obj");
 }
 
-auto AssetManager::LoadStaticMesh(const Path& path)->StaticMesh*
+template<class T>
+auto AssetManager::FindOrAddAsset(const Path& path) -> T*
 {
 	auto res = LoadedAssetsMap.find(path);
 	if (res != LoadedAssetsMap.end())
 	{
-		return dynamic_cast<StaticMesh*>(res->second);
+		return dynamic_cast<T*>(res->second);
 	}
 
-	StaticMesh* sm = new StaticMesh();
+	T* asset = new T();
+	asset->fullPath = path;
+	LoadedAssetsMap.insert({ path, asset });
 
-	sm->fullPath = path;
+	return asset;
+}
 
-	if (!sm->Load())
+template<class T>
+auto AssetManager::LoadAsset(const Path& path) -> T*
+{
+	T* asset = FindOrAddAsset<T>(path);
+	if (asset == nullptr)
 	{
 		return nullptr;
 	}
 
-	LoadedAssetsMap.insert({ path, sm });
+	if (asset->loadState == AssetLoadState::Unloaded)
+	{
+		asset->LoadSynchronously();
+	}
+	else if (asset->loadState == AssetLoadState::Loading)
+	{
+		assetLoader->Wait(asset);
+	}
 
-	return sm;
+	// Failed assets stay in the map so they aren't imported again on every call
+	return asset->IsLoaded() ? asset : nullptr;
 }
 
-auto AssetManager::LoadAlbedoTexture(const Path& path) -> AlbedoTexture*
-{	
-	auto res = LoadedAssetsMap.find(path);
-	if (res != LoadedAssetsMap.end())
+template<class T>
+auto AssetManager::RequestAsset(const Path& path) -> T*
+{
+	if (path.empty())
 	{
-		auto* stuff = res->second;
-		return dynamic_cast<AlbedoTexture*>(res->second);
+		return nullptr;
 	}
 
-	AlbedoTexture* at = new AlbedoTexture();
-
-	at->fullPath = path;
-
-	if (!at->Load())
+	T* asset = FindOrAddAsset<T>(path);
+	if (asset != nullptr && asset->loadState == AssetLoadState::Unloaded)
 	{
-		//TODO: return white tex here
-
-		return nullptr;
+		assetLoader->Enqueue(asset);
 	}
 
-	LoadedAssetsMap.insert({ path, at });
+	return asset;
+}
+
+auto AssetManager::LoadStaticMesh(const Path& path)->StaticMesh*
+{
+	return LoadAsset<StaticMesh>(path);
+}
 
-	return at;
+auto AssetManager::LoadAlbedoTexture(const Path& path) -> AlbedoTexture*
+{	
+	return LoadAsset<AlbedoTexture>(path);
 }
 
 auto AssetManager::LoadNormalTexture(const Path& path) -> NormalTexture*
 {
-	auto res = LoadedAssetsMap.find(path);
-	if (res != LoadedAssetsMap.end())
-	{
-		auto* stuff = res->second;
-		return dynamic_cast<NormalTexture*>(res->second);
-	}
+	return LoadAsset<NormalTexture>(path);
+}
 
-	NormalTexture* nt = new NormalTexture();
+auto AssetManager::RequestStaticMesh(const Path& path) -> StaticMesh*
+{
+	return RequestAsset<StaticMesh>(path);
+}
 
-	nt->fullPath = path;
+auto AssetManager::RequestAlbedoTexture(const Path& path) -> AlbedoTexture*
+{
+	return RequestAsset<AlbedoTexture>(path);
+}
 
-	if (!nt->Load())
-	{
-		//TODO: return white tex here
+auto AssetManager::RequestNormalTexture(const Path& path) -> NormalTexture*
+{
+	return RequestAsset<NormalTexture>(path);
+}
 
-		return nullptr;
-	}
+auto AssetManager::Tick() -> void
+{
+	ProcessAssetChanges();
+	assetLoader->Tick(uploadBudgetMs);
+	textureStreamer->Tick();
+	EnforceMemoryBudget();
+}
 
-	LoadedAssetsMap.insert({ path, nt });
+auto AssetManager::EnforceMemoryBudget() -> void
+{
+	if (residency.IsUpToDate())
+	{
+		return;
+	}
 
-	return nt;
+	std::vector<Asset*> assets;
+	assets.reserve(LoadedAssetsMap.size());
+	for (const auto& [path, asset] : LoadedAssetsMap)
+	{
+		assets.push_back(asset);
+	}
+	residency.Update(assets);
 }
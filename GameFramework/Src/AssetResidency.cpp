@@ -0,0 +1,80 @@
+#include "AssetResidency.h"
+
+#include <algorithm>
+
+auto AssetResidency::SetMemoryBudget(size_t InCpuBytes, size_t InGpuBytes) -> void
+{
+	CpuMemoryBudget = InCpuBytes;
+	GpuMemoryBudget = InGpuBytes;
+	LastResidencyClock = ~0ull;
+}
+
+auto AssetResidency::UpdateMemoryStats(const std::vector<Asset*>& InAssets) -> void
+{
+	MemoryStatsByType.clear();
+	TotalMemoryStats = AssetMemoryStats();
+
+	for (const Asset* asset : InAssets)
+	{
+		if (!asset->IsLoaded())
+		{
+			continue;
+		}
+
+		const AssetMemoryUsage& usage = asset->GetMemoryUsage();
+		for (AssetMemoryStats* stats : { &MemoryStatsByType[asset->GetTypeName()], &TotalMemoryStats })
+		{
+			++stats->NumResident;
+			stats->CpuBytes += usage.CpuBytes;
+			stats->GpuBytes += usage.GpuBytes;
+		}
+	}
+}
+
+auto AssetResidency::IsOverMemoryBudget() const -> bool
+{
+	return TotalMemoryStats.CpuBytes > CpuMemoryBudget || TotalMemoryStats.GpuBytes > GpuMemoryBudget;
+}
+
+auto AssetResidency::Update(const std::vector<Asset*>& InAssets) -> void
+{
+	UpdateMemoryStats(InAssets);
+
+	if (IsOverMemoryBudget())
+	{
+		std::vector<Asset*> candidates;
+		for (Asset* asset : InAssets)
+		{
+			if (asset->IsLoaded() && asset->GetRefCount() == 0 && !asset->bReloading)
+			{
+				candidates.push_back(asset);
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const Asset* a, const Asset* b) { return a->lastReleaseTime < b->lastReleaseTime; });
+
+		for (Asset* asset : candidates)
+		{
+			if (!IsOverMemoryBudget())
+			{
+				break;
+			}
+
+			// The shell stays with its owner, raw pointers stay valid
+			const AssetMemoryUsage usage = asset->GetMemoryUsage();
+			asset->Unload();
+			asset->loadState = AssetLoadState::Unloaded;
+			++NumEvicted;
+
+			AssetMemoryStats& typeStats = MemoryStatsByType[asset->GetTypeName()];
+			for (AssetMemoryStats* stats : { &typeStats, &TotalMemoryStats })
+			{
+				--stats->NumResident;
+				stats->CpuBytes -= usage.CpuBytes;
+				stats->GpuBytes -= usage.GpuBytes;
+			}
+		}
+	}
+
+	LastResidencyClock = Asset::GetResidencyClock();
+}
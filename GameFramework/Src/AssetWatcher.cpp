@@ -0,0 +1,184 @@
+#include "AssetWatcher.h"
+
+#include <system_error>
+
+#include <Windows.h>
+
+AssetWatcher::AssetWatcher(const Path& InRoot, uint32_t InDebounceMs, uint32_t InPollIntervalMs)
+	: Root(InRoot)
+	, Debounce(InDebounceMs)
+	, PollInterval(InPollIntervalMs)
+{
+	StopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+	Thread = std::thread(&AssetWatcher::ThreadLoop, this);
+}
+
+AssetWatcher::~AssetWatcher()
+{
+	SetEvent(StopEvent);
+	Thread.join();
+	CloseHandle(StopEvent);
+}
+
+auto AssetWatcher::PopSettledChanges(std::vector<Path>& OutRelativePaths) -> bool
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	std::lock_guard lock(Mutex);
+
+	for (auto it = PendingChanges.begin(); it != PendingChanges.end();)
+	{
+		if (now - it->second >= Debounce)
+		{
+			OutRelativePaths.push_back(it->first);
+			it = PendingChanges.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	const bool bFullRescan = bFullRescanRequested;
+	bFullRescanRequested = false;
+	return bFullRescan;
+}
+
+auto AssetWatcher::ThreadLoop() -> void
+{
+	if (!WatchLoop())
+	{
+		bPolling = true;
+		PollLoop();
+	}
+}
+
+auto AssetWatcher::WatchLoop() -> bool
+{
+	HANDLE directory = CreateFileW(Root.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+	if (directory == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	OVERLAPPED overlapped = {};
+	overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+	constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+	// DWORD aligned as ReadDirectoryChangesW requires
+	std::vector<DWORD> buffer(16 * 1024);
+
+	bool bStopped = false;
+	while (!bStopped)
+	{
+		ResetEvent(overlapped.hEvent);
+		if (!ReadDirectoryChangesW(directory, buffer.data(), static_cast<DWORD>(buffer.size() * sizeof(DWORD)), TRUE, filter, nullptr, &overlapped, nullptr))
+		{
+			break;
+		}
+
+		HANDLE handles[] = { overlapped.hEvent, StopEvent };
+		const DWORD signaled = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+
+		DWORD numBytes = 0;
+		if (signaled != WAIT_OBJECT_0)
+		{
+			CancelIoEx(directory, &overlapped);
+			GetOverlappedResult(directory, &overlapped, &numBytes, TRUE);
+			bStopped = true;
+			break;
+		}
+
+		if (!GetOverlappedResult(directory, &overlapped, &numBytes, FALSE))
+		{
+			break;
+		}
+
+		// The buffer overflowed, individual changes are lost
+		if (numBytes == 0)
+		{
+			RequestFullRescan();
+			continue;
+		}
+
+		const uint8_t* record = reinterpret_cast<const uint8_t*>(buffer.data());
+		while (true)
+		{
+			const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(record);
+			AddChange(Path(std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR))));
+
+			if (info->NextEntryOffset == 0)
+			{
+				break;
+			}
+			record += info->NextEntryOffset;
+		}
+	}
+
+	CloseHandle(overlapped.hEvent);
+	CloseHandle(directory);
+
+	// Any failure continues with polling
+	return bStopped;
+}
+
+auto AssetWatcher::PollLoop() -> void
+{
+	Snapshot previous = TakeSnapshot();
+
+	while (WaitForSingleObject(StopEvent, static_cast<DWORD>(PollInterval.count())) == WAIT_TIMEOUT)
+	{
+		Snapshot current = TakeSnapshot();
+
+		for (const auto& [path, state] : current)
+		{
+			auto found = previous.find(path);
+			if (found == previous.end() || found->second.WriteTime != state.WriteTime || found->second.Size != state.Size)
+			{
+				AddChange(path);
+			}
+		}
+		for (const auto& [path, state] : previous)
+		{
+			if (current.count(path) == 0)
+			{
+				AddChange(path);
+			}
+		}
+
+		previous = std::move(current);
+	}
+}
+
+auto AssetWatcher::AddChange(const Path& InRelativePath) -> void
+{
+	std::lock_guard lock(Mutex);
+	// Every event restarts the debounce time of the path
+	PendingChanges[InRelativePath] = std::chrono::steady_clock::now();
+}
+
+auto AssetWatcher::RequestFullRescan() -> void
+{
+	std::lock_guard lock(Mutex);
+	bFullRescanRequested = true;
+}
+
+auto AssetWatcher::TakeSnapshot() const -> Snapshot
+{
+	Snapshot snapshot;
+
+	std::error_code error;
+	for (auto it = std::filesystem::recursive_directory_iterator(Root, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+	{
+		FileState& state = snapshot[it->path().lexically_relative(Root)];
+		state.bDirectory = it->is_directory(error);
+		if (!state.bDirectory)
+		{
+			state.WriteTime = it->last_write_time(error).time_since_epoch().count();
+			state.Size = it->file_size(error);
+		}
+	}
+
+	return snapshot;
+}
@@ -0,0 +1,275 @@
+#include "BinaryArchive.h"
+
+#include <fstream>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+auto BinaryWriter::WriteBytes(const void* InData, size_t InSize) -> void
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(InData);
+	Buffer.insert(Buffer.end(), bytes, bytes + InSize);
+}
+
+auto BinaryWriter::WriteString(std::string_view InString) -> void
+{
+	Write(static_cast<uint32_t>(InString.size()));
+	WriteBytes(InString.data(), InString.size());
+}
+
+auto BinaryWriter::WriteStringRef(std::string_view InString) -> void
+{
+	auto [found, bInserted] = StringIndices.try_emplace(std::string(InString), static_cast<uint32_t>(Strings.size()));
+	if (bInserted)
+	{
+		Strings.emplace_back(InString);
+	}
+
+	Write(found->second);
+}
+
+auto BinaryWriter::WriteUuid(const uuid& InId) -> void
+{
+	const auto bytes = InId.as_bytes();
+	static_assert(sizeof(uuid) == 16, "uuid is expected to be 16 raw bytes");
+	WriteBytes(bytes.data(), bytes.size());
+}
+
+auto BinaryWriter::WriteJson(const json& InJson) -> void
+{
+	const std::vector<uint8_t> bytes = json::to_msgpack(InJson);
+	Write(static_cast<uint32_t>(bytes.size()));
+	WriteBytes(bytes.data(), bytes.size());
+}
+
+BinaryReader::BinaryReader(const uint8_t* InData, size_t InSize, const std::vector<std::string_view>* InStrings)
+	: Data(InData)
+	, Size(InSize)
+	, Strings(InStrings)
+{
+}
+
+auto BinaryReader::ReadBytes(void* OutData, size_t InSize) -> bool
+{
+	const uint8_t* source = ReadView(InSize);
+	if (source == nullptr)
+	{
+		return false;
+	}
+
+	std::memcpy(OutData, source, InSize);
+	return true;
+}
+
+auto BinaryReader::ReadView(size_t InSize) -> const uint8_t*
+{
+	if (!bValid || InSize > Size - Offset)
+	{
+		Fail();
+		return nullptr;
+	}
+
+	const uint8_t* view = Data + Offset;
+	Offset += InSize;
+	return view;
+}
+
+auto BinaryReader::ReadString() -> std::string_view
+{
+	const uint32_t length = Read<uint32_t>();
+	const uint8_t* chars = ReadView(length);
+	return chars ? std::string_view(reinterpret_cast<const char*>(chars), length) : std::string_view();
+}
+
+auto BinaryReader::ReadStringRef() -> std::string_view
+{
+	const uint32_t index = Read<uint32_t>();
+	if (!bValid || Strings == nullptr || index >= Strings->size())
+	{
+		Fail();
+		return {};
+	}
+
+	return (*Strings)[index];
+}
+
+auto BinaryReader::ReadUuid() -> uuid
+{
+	uint8_t bytes[16] = {};
+	ReadBytes(bytes, sizeof(bytes));
+	return uuid(std::begin(bytes), std::end(bytes));
+}
+
+auto BinaryReader::ReadJson() -> json
+{
+	const uint32_t size = Read<uint32_t>();
+	const uint8_t* bytes = ReadView(size);
+	if (bytes == nullptr)
+	{
+		return json();
+	}
+
+	// No exceptions on a malformed blob, it gives a discarded value instead
+	json out = json::from_msgpack(bytes, bytes + size, true, false);
+	if (out.is_discarded())
+	{
+		Fail();
+		return json();
+	}
+
+	return out;
+}
+
+auto BinaryReader::Fail() -> void
+{
+	// Malformed data is an expected input, the callers check IsValid() and report it
+	bValid = false;
+	Offset = Size;
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if defined(_WIN32)
+auto MappedFile::Open(const Path& InPath) -> bool
+{
+	Close();
+
+	HANDLE file = CreateFileW(InPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	FileHandle = file;
+	MappingHandle = mapping;
+	Data = static_cast<const uint8_t*>(view);
+	Size = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+auto MappedFile::Close() -> void
+{
+	if (Data)
+	{
+		UnmapViewOfFile(Data);
+	}
+	if (MappingHandle)
+	{
+		CloseHandle(MappingHandle);
+	}
+	if (FileHandle)
+	{
+		CloseHandle(FileHandle);
+	}
+
+	FileHandle = nullptr;
+	MappingHandle = nullptr;
+	Data = nullptr;
+	Size = 0;
+}
+#else
+auto MappedFile::Open(const Path& InPath) -> bool
+{
+	Close();
+
+	const int file = open(InPath.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	// The mapping keeps the file alive, the descriptor isn't needed anymore
+	void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	Data = static_cast<const uint8_t*>(view);
+	Size = static_cast<size_t>(status.st_size);
+	return true;
+}
+
+auto MappedFile::Close() -> void
+{
+	if (Data)
+	{
+		munmap(const_cast<uint8_t*>(Data), Size);
+	}
+
+	Data = nullptr;
+	Size = 0;
+}
+#endif
+
+auto WriteFileAtomically(const Path& InPath, const std::vector<uint8_t>& InData) -> bool
+{
+	Path tempPath = InPath;
+	tempPath += ".tmp";
+
+	std::error_code error;
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			return false;
+		}
+		out.write(reinterpret_cast<const char*>(InData.data()), static_cast<std::streamsize>(InData.size()));
+		// A full disk may only show up when the buffered data is flushed
+		out.close();
+		if (out.fail())
+		{
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempPath, InPath, error);
+	if (error)
+	{
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	return true;
+}
@@ -13,10 +13,12 @@
 
 
 #include "MeshRenderer.h"
+#include "BinaryArchive.h"
 
 ComponentRegistry* ComponentRegistry::Instance = nullptr;
 std::unordered_map<ComponentType, std::string> ComponentRegistry::TypeToName;
 std::unordered_map<std::string, ComponentType> ComponentRegistry::NameToType;
+LevelConverter::ComponentConverters ComponentRegistry::BinaryConverters;
 
 ComponentType ComponentRegistry::GetTypeByName(std::string& name)
 {
@@ -51,12 +53,18 @@ void ComponentRegistry::Register(ComponentType type, const std::string& name, Fa
 	GetInstance()->RegisterFactory(type, factory);
 }
 
+void ComponentRegistry::RegisterBinaryConverter(const std::string& name, LevelConverter::JsonToBinaryFunction toBinary, LevelConverter::BinaryToJsonFunction toJson)
+{
+	BinaryConverters.insert(std::make_pair(name, LevelConverter::ComponentConverter{ toBinary, toJson }));
+}
+
 void ComponentRegistry::Init()
 {
 	Register(SceneComponentType, "SceneComponent", &SceneComponent::Create);
 	Register(RigidBodySphereType, "RigidBodySphereComponent", &RigidBodyComponent::Create);
 	Register(RigidBodyCubeType, "RigidBodyCubeComponent", &RigidBodyComponent::Create);
 	Register(StaticMeshRendererType, "StaticMeshRenderer", &StaticMeshRenderer::Create);
+	RegisterBinaryConverter("StaticMeshRenderer", &StaticMeshRenderer::ConvertJsonToBinary, &StaticMeshRenderer::ConvertBinaryToJson);
 	Register(LightPointType, "PointLight", &PointLight::Create);
 	//TODO: remove mesh renderer once it's useless
 	Register(MeshRendererType, "MeshRenderer", &MeshRenderer::Create);
@@ -65,6 +73,13 @@ void ComponentRegistry::Init()
 	Register(CameraComponentType, "CameraComponent", &CameraComponent::Create);
 	Register(CameraComponentType, "AmbientLight", &AmbientLight::Create);
 	Register(CameraComponentType, "DirectionalLight", &DirectionalLight::Create);
+
+	// Every scene component without its own layout stores the transform and name natively, see SceneComponent::SerializeBinary
+	for (const char* name : { "SceneComponent", "RigidBodySphereComponent", "RigidBodyCubeComponent", "PointLight", "MeshRenderer",
+		"MovementComponent", "AudioComponent", "CameraComponent", "AmbientLight", "DirectionalLight" })
+	{
+		RegisterBinaryConverter(name, &SceneComponent::ConvertJsonToBinary, &SceneComponent::ConvertBinaryToJson);
+	}
 }
 
 void ComponentRegistry::Validate()
@@ -0,0 +1,47 @@
+#include "ComponentUpdateLists.h"
+
+#include "Component.h"
+
+auto ComponentUpdateLists::Register(Component* InComponent) -> void
+{
+	if (InComponent->mUpdateListIndex != Component::InvalidUpdateListIndex)
+	{
+		return;
+	}
+
+	// The type is cached, some components (rigid bodies) report a different type once their shape changes
+	const ComponentType type = InComponent->GetComponentType();
+	InComponent->mUpdateListType = type;
+	Lists[GetListIndex(type)].Add(InComponent);
+}
+
+auto ComponentUpdateLists::Unregister(Component* InComponent) -> void
+{
+	if (InComponent->mUpdateListIndex == Component::InvalidUpdateListIndex)
+	{
+		return;
+	}
+
+	Lists[GetListIndex(InComponent->mUpdateListType)].Remove(InComponent);
+}
+
+auto ComponentUpdateLists::UpdateAll(float DeltaTime) -> void
+{
+	UpdateComponents(Lists[GetListIndex(RigidBodyCubeType)], DeltaTime);
+	UpdateComponents(Lists[GetListIndex(RigidBodySphereType)], DeltaTime);
+
+	for (size_t i = 0; i < Lists.size(); ++i)
+	{
+		if (i == GetListIndex(RigidBodyCubeType) || i == GetListIndex(RigidBodySphereType))
+		{
+			continue;
+		}
+
+		UpdateComponents(Lists[i], DeltaTime);
+	}
+}
+
+auto ComponentUpdateLists::UpdateComponents(UpdateList<Component>& InList, float DeltaTime) -> void
+{
+	InList.ForEach([DeltaTime](Component* InComponent) { InComponent->Update(DeltaTime); });
+}
@@ -0,0 +1,356 @@
+#include "DdsFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	constexpr uint32_t DdsMagic = 0x20534444; // "DDS "
+
+	constexpr uint32_t MakeFourCC(char InA, char InB, char InC, char InD)
+	{
+		return uint32_t(uint8_t(InA)) | (uint32_t(uint8_t(InB)) << 8) | (uint32_t(uint8_t(InC)) << 16) | (uint32_t(uint8_t(InD)) << 24);
+	}
+
+	// Pixel format flags
+	constexpr uint32_t DdpfAlpha = 0x2;
+	constexpr uint32_t DdpfFourCC = 0x4;
+	constexpr uint32_t DdpfRgb = 0x40;
+	constexpr uint32_t DdpfLuminance = 0x20000;
+
+	constexpr uint32_t DdsHeaderFlagsVolume = 0x800000;
+	constexpr uint32_t DdsCaps2CubeMap = 0x200;
+	constexpr uint32_t DdsCaps2CubeMapAllFaces = 0xFC00;
+	constexpr uint32_t DdsResourceMiscTextureCube = 0x4;
+
+	// D3D11 limits, the parser only needs dxgiformat.h and builds without the graphics headers
+	constexpr uint32_t ResourceDimensionTexture2D = 3;
+	constexpr uint32_t MaxTextureDimension = 16384;
+	constexpr uint32_t MaxTextureArraySize = 2048;
+
+	// Layouts from the DDS documentation
+	struct DdsPixelFormat
+	{
+		uint32_t Size;
+		uint32_t Flags;
+		uint32_t FourCC;
+		uint32_t RgbBitCount;
+		uint32_t RBitMask;
+		uint32_t GBitMask;
+		uint32_t BBitMask;
+		uint32_t ABitMask;
+	};
+
+	struct DdsHeader
+	{
+		uint32_t Size;
+		uint32_t Flags;
+		uint32_t Height;
+		uint32_t Width;
+		uint32_t PitchOrLinearSize;
+		uint32_t Depth;
+		uint32_t MipMapCount;
+		uint32_t Reserved1[11];
+		DdsPixelFormat PixelFormat;
+		uint32_t Caps;
+		uint32_t Caps2;
+		uint32_t Caps3;
+		uint32_t Caps4;
+		uint32_t Reserved2;
+	};
+
+	struct DdsHeaderDx10
+	{
+		DXGI_FORMAT Format;
+		uint32_t ResourceDimension;
+		uint32_t MiscFlag;
+		uint32_t ArraySize;
+		uint32_t MiscFlags2;
+	};
+
+	static_assert(sizeof(DdsHeader) == 124, "DDS header layout");
+	static_assert(sizeof(DdsHeaderDx10) == 20, "DDS DX10 header layout");
+
+	auto HasMasks(const DdsPixelFormat& InFormat, uint32_t InR, uint32_t InG, uint32_t InB, uint32_t InA) -> bool
+	{
+		return InFormat.RBitMask == InR && InFormat.GBitMask == InG && InFormat.BBitMask == InB && InFormat.ABitMask == InA;
+	}
+
+	// Pixel formats of files written without a DX10 header, the ones DDS tools still produce by default
+	auto GetLegacyFormat(const DdsPixelFormat& InFormat) -> DXGI_FORMAT
+	{
+		if (InFormat.Flags & DdpfFourCC)
+		{
+			switch (InFormat.FourCC)
+			{
+			case MakeFourCC('D', 'X', 'T', '1'): return DXGI_FORMAT_BC1_UNORM;
+			case MakeFourCC('D', 'X', 'T', '2'):
+			case MakeFourCC('D', 'X', 'T', '3'): return DXGI_FORMAT_BC2_UNORM;
+			case MakeFourCC('D', 'X', 'T', '4'):
+			case MakeFourCC('D', 'X', 'T', '5'): return DXGI_FORMAT_BC3_UNORM;
+			case MakeFourCC('A', 'T', 'I', '1'):
+			case MakeFourCC('B', 'C', '4', 'U'): return DXGI_FORMAT_BC4_UNORM;
+			case MakeFourCC('B', 'C', '4', 'S'): return DXGI_FORMAT_BC4_SNORM;
+			case MakeFourCC('A', 'T', 'I', '2'):
+			case MakeFourCC('B', 'C', '5', 'U'): return DXGI_FORMAT_BC5_UNORM;
+			case MakeFourCC('B', 'C', '5', 'S'): return DXGI_FORMAT_BC5_SNORM;
+			// D3DFORMAT values stored as the FourCC
+			case 36: return DXGI_FORMAT_R16G16B16A16_UNORM;
+			case 111: return DXGI_FORMAT_R16_FLOAT;
+			case 112: return DXGI_FORMAT_R16G16_FLOAT;
+			case 113: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+			case 114: return DXGI_FORMAT_R32_FLOAT;
+			case 115: return DXGI_FORMAT_R32G32_FLOAT;
+			case 116: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+			default: return DXGI_FORMAT_UNKNOWN;
+			}
+		}
+
+		if ((InFormat.Flags & DdpfRgb) && InFormat.RgbBitCount == 32)
+		{
+			if (HasMasks(InFormat, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000)) return DXGI_FORMAT_R8G8B8A8_UNORM;
+			if (HasMasks(InFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000)) return DXGI_FORMAT_B8G8R8A8_UNORM;
+			if (HasMasks(InFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00000000)) return DXGI_FORMAT_B8G8R8X8_UNORM;
+		}
+		if ((InFormat.Flags & DdpfLuminance) && InFormat.RgbBitCount == 8 && InFormat.RBitMask == 0xFF)
+		{
+			return DXGI_FORMAT_R8_UNORM;
+		}
+		if ((InFormat.Flags & DdpfAlpha) && InFormat.RgbBitCount == 8)
+		{
+			return DXGI_FORMAT_A8_UNORM;
+		}
+		return DXGI_FORMAT_UNKNOWN;
+	}
+
+	// Bytes per 4x4 block, 0 for formats that aren't block compressed
+	auto GetBlockBytes(DXGI_FORMAT InFormat) -> size_t
+	{
+		switch (InFormat)
+		{
+		case DXGI_FORMAT_BC1_TYPELESS:
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_TYPELESS:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC4_SNORM:
+			return 8;
+
+		case DXGI_FORMAT_BC2_TYPELESS:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_TYPELESS:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_TYPELESS:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC5_SNORM:
+		case DXGI_FORMAT_BC6H_TYPELESS:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+		case DXGI_FORMAT_BC7_TYPELESS:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return 16;
+
+		default:
+			return 0;
+		}
+	}
+
+	// Unlike the memory estimate in TextureUtils, unknown formats give 0 so they are rejected
+	auto GetBitsPerPixel(DXGI_FORMAT InFormat) -> size_t
+	{
+		switch (InFormat)
+		{
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_UINT:
+		case DXGI_FORMAT_R32G32B32A32_SINT:
+			return 128;
+
+		case DXGI_FORMAT_R32G32B32_FLOAT:
+			return 96;
+
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		case DXGI_FORMAT_R16G16B16A16_UNORM:
+		case DXGI_FORMAT_R16G16B16A16_SNORM:
+		case DXGI_FORMAT_R32G32_FLOAT:
+			return 64;
+
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		case DXGI_FORMAT_R8G8B8A8_SNORM:
+		case DXGI_FORMAT_B8G8R8A8_UNORM:
+		case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+		case DXGI_FORMAT_B8G8R8X8_UNORM:
+		case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+		case DXGI_FORMAT_R10G10B10A2_UNORM:
+		case DXGI_FORMAT_R11G11B10_FLOAT:
+		case DXGI_FORMAT_R16G16_FLOAT:
+		case DXGI_FORMAT_R16G16_UNORM:
+		case DXGI_FORMAT_R32_FLOAT:
+			return 32;
+
+		case DXGI_FORMAT_R8G8_UNORM:
+		case DXGI_FORMAT_R8G8_SNORM:
+		case DXGI_FORMAT_R16_FLOAT:
+		case DXGI_FORMAT_R16_UNORM:
+		case DXGI_FORMAT_B5G6R5_UNORM:
+		case DXGI_FORMAT_B5G5R5A1_UNORM:
+			return 16;
+
+		case DXGI_FORMAT_R8_UNORM:
+		case DXGI_FORMAT_R8_SNORM:
+		case DXGI_FORMAT_A8_UNORM:
+			return 8;
+
+		default:
+			return 0;
+		}
+	}
+}
+
+auto GetDdsSurfacePitch(DXGI_FORMAT InFormat, uint32_t InWidth, uint32_t InHeight, size_t& OutRowPitch, size_t& OutSlicePitch) -> bool
+{
+	const size_t blockBytes = GetBlockBytes(InFormat);
+	if (blockBytes != 0)
+	{
+		OutRowPitch = (std::max)((size_t(InWidth) + 3) / 4, size_t(1)) * blockBytes;
+		OutSlicePitch = OutRowPitch * (std::max)((size_t(InHeight) + 3) / 4, size_t(1));
+		return true;
+	}
+
+	const size_t bitsPerPixel = GetBitsPerPixel(InFormat);
+	if (bitsPerPixel == 0)
+	{
+		return false;
+	}
+	OutRowPitch = (size_t(InWidth) * bitsPerPixel + 7) / 8;
+	OutSlicePitch = OutRowPitch * InHeight;
+	return true;
+}
+
+auto ParseDdsTexture(const uint8_t* InData, size_t InSize, DdsTextureInfo& OutInfo) -> bool
+{
+	OutInfo = DdsTextureInfo();
+
+	if (InData == nullptr || InSize < sizeof(uint32_t) + sizeof(DdsHeader))
+	{
+		return false;
+	}
+
+	uint32_t magic;
+	DdsHeader header;
+	std::memcpy(&magic, InData, sizeof(magic));
+	std::memcpy(&header, InData + sizeof(magic), sizeof(header));
+	if (magic != DdsMagic || header.Size != sizeof(DdsHeader) || header.PixelFormat.Size != sizeof(DdsPixelFormat))
+	{
+		return false;
+	}
+
+	size_t offset = sizeof(magic) + sizeof(header);
+	uint32_t arraySize = 1;
+
+	if ((header.PixelFormat.Flags & DdpfFourCC) && header.PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0'))
+	{
+		if (InSize < offset + sizeof(DdsHeaderDx10))
+		{
+			return false;
+		}
+
+		DdsHeaderDx10 headerDx10;
+		std::memcpy(&headerDx10, InData + offset, sizeof(headerDx10));
+		offset += sizeof(headerDx10);
+
+		OutInfo.bCubeMap = (headerDx10.MiscFlag & DdsResourceMiscTextureCube) != 0;
+
+		// Checked before the faces are counted, a large cube count would wrap around to a small slice count
+		if (headerDx10.ResourceDimension != ResourceDimensionTexture2D || headerDx10.ArraySize == 0
+			|| headerDx10.ArraySize > MaxTextureArraySize / (OutInfo.bCubeMap ? 6 : 1))
+		{
+			return false;
+		}
+
+		OutInfo.Format = headerDx10.Format;
+		arraySize = headerDx10.ArraySize * (OutInfo.bCubeMap ? 6 : 1);
+	}
+	else
+	{
+		if (header.Flags & DdsHeaderFlagsVolume)
+		{
+			return false;
+		}
+
+		OutInfo.Format = GetLegacyFormat(header.PixelFormat);
+		if (header.Caps2 & DdsCaps2CubeMap)
+		{
+			// Cube maps without all faces can't be made into a texture
+			if ((header.Caps2 & DdsCaps2CubeMapAllFaces) != DdsCaps2CubeMapAllFaces)
+			{
+				return false;
+			}
+			OutInfo.bCubeMap = true;
+			arraySize = 6;
+		}
+	}
+
+	OutInfo.Width = header.Width;
+	OutInfo.Height = header.Height;
+	OutInfo.MipLevels = (std::max)(header.MipMapCount, 1u);
+	OutInfo.ArraySize = arraySize;
+
+	// Also keeps the mip loop below short for garbage headers
+	uint32_t maxMipLevels = 1;
+	while ((std::max)(OutInfo.Width, OutInfo.Height) >> maxMipLevels)
+	{
+		++maxMipLevels;
+	}
+	if (OutInfo.Width == 0 || OutInfo.Height == 0
+		|| OutInfo.Width > MaxTextureDimension || OutInfo.Height > MaxTextureDimension
+		|| OutInfo.ArraySize > MaxTextureArraySize || OutInfo.MipLevels > maxMipLevels)
+	{
+		return false;
+	}
+
+	OutInfo.Subresources.reserve(size_t(OutInfo.ArraySize) * OutInfo.MipLevels);
+	for (uint32_t slice = 0; slice < OutInfo.ArraySize; ++slice)
+	{
+		for (uint32_t mip = 0; mip < OutInfo.MipLevels; ++mip)
+		{
+			DdsSubresource& subresource = OutInfo.Subresources.emplace_back();
+			subresource.Width = (std::max)(OutInfo.Width >> mip, 1u);
+			subresource.Height = (std::max)(OutInfo.Height >> mip, 1u);
+			if (!GetDdsSurfacePitch(OutInfo.Format, subresource.Width, subresource.Height, subresource.RowPitch, subresource.SlicePitch)
+				|| subresource.SlicePitch > InSize - offset)
+			{
+				OutInfo.Subresources.clear();
+				return false;
+			}
+
+			subresource.Data = InData + offset;
+			offset += subresource.SlicePitch;
+		}
+	}
+
+	return true;
+}
+
+auto GetDdsMaxFirstMip(const DdsTextureInfo& InInfo) -> uint32_t
+{
+	if (InInfo.MipLevels == 0)
+	{
+		return 0;
+	}
+	if (GetBlockBytes(InInfo.Format) == 0)
+	{
+		return InInfo.MipLevels - 1;
+	}
+
+	uint32_t mip = 0;
+	while (mip + 1 < InInfo.MipLevels && ((InInfo.Width >> (mip + 1)) % 4) == 0 && ((InInfo.Height >> (mip + 1)) % 4) == 0
+		&& (InInfo.Width >> (mip + 1)) != 0 && (InInfo.Height >> (mip + 1)) != 0)
+	{
+		++mip;
+	}
+	return mip;
+}
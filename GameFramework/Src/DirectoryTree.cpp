@@ -1,4 +1,5 @@
 #include "DirectoryTree.h"
+#include <algorithm>
 #include <cassert>
 
 
@@ -57,6 +58,15 @@ auto DirectoryTreeNode::AddChildNode(DirectoryTreeNode* node)->void
 	node->parent = this;
 }
 
+auto DirectoryTreeNode::RemoveChildNode(DirectoryTreeNode* node)->void
+{
+	auto found = std::find(children.begin(), children.end(), node);
+	assert(found != children.end());
+	children.erase(found);
+	--counts[static_cast<size_t>(node->nodeType)];
+	node->parent = nullptr;
+}
+
 auto DirectoryTree::AddNodeByPath(const Path& path, DirectoryTreeNodeType nodeType, AssetType assetType) -> DirectoryTreeNode* {
 
 	DirectoryTreeNode* node = root;
@@ -93,6 +103,28 @@ auto DirectoryTree::AddNodeByPath(const Path& path, DirectoryTreeNodeType nodeTy
 	return node;
 }
 
+auto DirectoryTree::RemoveNodeByPath(const Path& path) -> bool
+{
+	DirectoryTreeNode* node = root;
+	for (const Path& part : path)
+	{
+		node = node->GetDirectChildByName(part);
+		if (node == nullptr)
+		{
+			return false;
+		}
+	}
+
+	if (node == root)
+	{
+		return false;
+	}
+
+	node->parent->RemoveChildNode(node);
+	delete node;
+	return true;
+}
+
 auto DirectoryTree::GetDirectoryByPath(const Path& path) -> DirectoryTreeNode*
 {
 	DirectoryTreeNode* node = root;
@@ -7,6 +7,7 @@
 #include "Mesh.h"
 #include "MeshRenderer.h"
 #include "MeshLoader.h"
+#include "RenderingSystem.h"
 #include "RigidBodyComponent.h"
 #include "ShaderCompiler.h"
 #include "StaticMeshRenderer.h"
@@ -23,6 +24,11 @@ EngineContentRegistry::EngineContentRegistry(Game* InGame)
 	DirectX::CreateWICTextureFromFile(MyGame->GetD3DDevice().Get(), L"../Assets/EngineContent/Textures/generic_file_thumb_v2.png", &GenericFileTex, &GenericFileTexSRV, 256);
 	DirectX::CreateWICTextureFromFile(MyGame->GetD3DDevice().Get(), L"../Assets/EngineContent/Textures/collection_folder_thumb.png", &AssetColTex, &AssetColTexSRV, 256);
 	CreateNormalMapTextureFromFile(L"../Assets/basicNormal.png", BasicNormalTex.GetAddressOf(), BasicNormalTexSRV.GetAddressOf());
+
+	// Renderers without a texture of their own can still sample from the texture arrays
+	TextureArrayTable* textureArrays = MyGame->MyRenderingSystem->GetTextureArrayTable();
+	textureArrays->Add(WhiteTex.Get(), WhiteTexArraySlot);
+	textureArrays->Add(BasicNormalTex.Get(), BasicNormalTexArraySlot);
 #pragma endregion Create Textures
 
 
@@ -45,11 +51,19 @@ EngineContentRegistry::EngineContentRegistry(Game* InGame)
 
 	DefaultVertexShader = sc.CreateShader<TexturedVertexShader>();
 
+	sc.AddBaseMacro({ "PACKED_VERTEX", "1" });
+	PackedVertexShader = sc.CreateShader<PackedTexturedVertexShader>();
+	sc.ClearBaseMacros();
+
 	sc.SetEntryPoint("PSMain");
 	sc.SetTarget("ps_5_0");
 
 	DefaultPixelShader = sc.CreateShader<PixelShader>();
 
+	sc.AddBaseMacro({ "TEXTURE_ARRAYS", "1" });
+	TextureArrayPixelShader = sc.CreateShader<PixelShader>();
+	sc.ClearBaseMacros();
+
 	sc.SetPathToShader(L"../Shaders/MyVeryFirstShader.hlsl");
 	sc.SetEntryPoint("VSMain");
 	sc.SetTarget("vs_5_0");
@@ -92,7 +106,9 @@ EngineContentRegistry::~EngineContentRegistry()
 {
 	delete TexturedBoxMeshProxy;
 	delete DefaultPixelShader;
+	delete TextureArrayPixelShader;
 	delete DefaultVertexShader;
+	delete PackedVertexShader;
 	delete quadRenderer;
 	delete boxRenderer;
 }
@@ -121,8 +137,6 @@ auto EngineContentRegistry::CreateBox(const Transform& transform) -> Actor*
 	mesh_component->SetStaticMesh(MyGame->GetAssetManager()->LoadStaticMesh(Path("../Assets/box.fbx/Cube")));
 	mesh_component->SetPixelShader(DefaultPixelShader);
 	mesh_component->SetVertexShader(DefaultVertexShader);
-	mesh_component->SetAlbedoSRV(WhiteTexSRV);
-	mesh_component->SetNormalSRV(BasicNormalTexSRV);
 	box_rb->EnablePhysicsSimulation();
 	return box;
 }
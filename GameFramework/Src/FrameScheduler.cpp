@@ -0,0 +1,152 @@
+#include "FrameScheduler.h"
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+	auto DoTicksConflict(const TickFunction& A, const TickFunction& B) -> bool
+	{
+		return (A.Writes & (B.Reads | B.Writes)) != 0 || (B.Writes & A.Reads) != 0;
+	}
+}
+
+FrameScheduler::FrameScheduler(JobSystem* InJobSystem)
+	: Jobs(InJobSystem)
+{
+}
+
+auto FrameScheduler::RegisterTick(TickFunction&& InTick) -> TickHandle
+{
+	const TickHandle handle = NextHandle++;
+	PendingTicks.push_back({ handle, std::move(InTick) });
+	return handle;
+}
+
+auto FrameScheduler::UnregisterTick(TickHandle InHandle) -> void
+{
+	PendingRemovals.push_back(InHandle);
+}
+
+auto FrameScheduler::Tick(float DeltaTime) -> void
+{
+	ApplyPendingChanges();
+
+	for (size_t phase = 0; phase < PhaseWaves.size(); ++phase)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		for (const Wave& wave : PhaseWaves[phase])
+		{
+			RunWave(wave, DeltaTime);
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+		PhaseTimes[phase] = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0f;
+	}
+}
+
+auto FrameScheduler::GetPhaseName(FramePhase InPhase) -> const char*
+{
+	switch (InPhase)
+	{
+	case FramePhase::PrePhysics: return "PrePhysics";
+	case FramePhase::Physics: return "Physics";
+	case FramePhase::PostPhysics: return "PostPhysics";
+	case FramePhase::Script: return "Script";
+	case FramePhase::PreRender: return "PreRender";
+	default: return "Unknown";
+	}
+}
+
+auto FrameScheduler::ApplyPendingChanges() -> void
+{
+	if (PendingTicks.empty() && PendingRemovals.empty())
+	{
+		return;
+	}
+
+	for (RegisteredTick& tick : PendingTicks)
+	{
+		Ticks.push_back(std::move(tick));
+	}
+	PendingTicks.clear();
+
+	for (const TickHandle handle : PendingRemovals)
+	{
+		Ticks.erase(std::remove_if(Ticks.begin(), Ticks.end(),
+			[handle](const RegisteredTick& tick) { return tick.Handle == handle; }), Ticks.end());
+	}
+	PendingRemovals.clear();
+
+	RebuildWaves();
+}
+
+auto FrameScheduler::RebuildWaves() -> void
+{
+	for (auto& waves : PhaseWaves)
+	{
+		waves.clear();
+	}
+
+	// A tick goes to the wave right after the last one holding a tick it conflicts with,
+	// which keeps registration order between conflicting ticks
+	for (const RegisteredTick& tick : Ticks)
+	{
+		std::vector<Wave>& waves = PhaseWaves[static_cast<size_t>(tick.Tick.Phase)];
+
+		size_t waveIndex = 0;
+		for (size_t i = waves.size(); i > 0; --i)
+		{
+			const Wave& wave = waves[i - 1];
+			const bool conflicts = std::any_of(wave.begin(), wave.end(),
+				[&tick](const RegisteredTick* other) { return DoTicksConflict(tick.Tick, other->Tick); });
+
+			if (conflicts)
+			{
+				waveIndex = i;
+				break;
+			}
+		}
+
+		if (waveIndex == waves.size())
+		{
+			waves.emplace_back();
+		}
+
+		waves[waveIndex].push_back(&tick);
+	}
+}
+
+auto FrameScheduler::RunWave(const Wave& InWave, float DeltaTime) -> void
+{
+	if (InWave.size() == 1 || Jobs == nullptr)
+	{
+		for (const RegisteredTick* tick : InWave)
+		{
+			tick->Tick.Function(DeltaTime);
+		}
+		return;
+	}
+
+	JobCounter counter;
+	for (const RegisteredTick* tick : InWave)
+	{
+		if (!tick->Tick.bMainThreadOnly)
+		{
+			Jobs->Run([tick, DeltaTime]() { tick->Tick.Function(DeltaTime); }, &counter);
+		}
+	}
+
+	for (const RegisteredTick* tick : InWave)
+	{
+		if (tick->Tick.bMainThreadOnly)
+		{
+			tick->Tick.Function(DeltaTime);
+		}
+	}
+
+	Jobs->Wait(counter);
+}
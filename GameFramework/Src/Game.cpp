@@ -13,6 +13,7 @@
 #include "DirectoryTree.h"
 #include "CreateCommon.h"
 #include "Serializer.h"
+#include "LevelJsonLoader.h"
 #include "LightBase.h"
 
 
@@ -32,6 +33,14 @@
 
 #include "RecastNavigationManager.h"
 
+#include "TransformStore.h"
+#include "JobSystem.h"
+#include "FrameScheduler.h"
+#include "ComponentUpdateLists.h"
+#include "ArchetypeStorage.h"
+#include "BinaryArchive.h"
+#include "PlaySnapshot.h"
+
 
 Game* Game::Instance = nullptr;
 
@@ -43,6 +52,13 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT umessage, WPARAM wparam, LPARAM lparam)
 void Game::InitializeInternal()
 {
 	uuidGenerator = new UUIDGenerator();
+	actorHandles.reset(new HandleRegistry<Actor>());
+	componentHandles.reset(new HandleRegistry<Component>());
+	playSnapshot.reset(new PlaySnapshot());
+	transformStore.reset(new TransformStore());
+	jobSystem.reset(new JobSystem());
+	frameScheduler.reset(new FrameScheduler(jobSystem.get()));
+	componentUpdateLists.reset(new ComponentUpdateLists());
 	ComponentRegistry::Init();
 	ComponentRegistry::Validate();
 	StartTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() / 1000.0f;
@@ -66,6 +82,8 @@ void Game::InitializeInternal()
 
 	recastNavigationManager.reset(new RecastNavigationManager());
 
+	RegisterEngineTicks();
+
 	PrepareResources();
 
 	Initialize();
@@ -91,38 +109,28 @@ void Game::Deserialize(const json* in, bool destructive)
 {
 	if(destructive)
 	{
-		for(int i = Actors.size() - 1; i >= 0; i--)
-		{
-			delete Actors[i];
-		}
-		
-		Actors.clear();
+		DestroyAllActors();
 	}
 
 	assert(in->is_object());
 
-	auto actorsArr = in->at("actors");
+	const json& actorsArr = in->at("actors");
 	assert(actorsArr.is_array());
 
-	for (const json actorObj : actorsArr) {
-		assert(actorObj.is_object());
-		
-		uuid id = actorObj.at("id").get<uuid>();
-
-		bool exists = false;
-		for (const auto actor : Actors) {
-			if(actor->GetId() == id) {
-				exists = true;
-				actor->Deserialize(&actorObj, destructive);
-			}
-		}
+	ReserveForLevel(actorsArr.size(), LevelJsonLoader::CountComponents(actorsArr));
 
-		if(!exists) {
+	// Existing actors are found through the uuid index, a level load stays linear in the number of actors
+	LevelJsonLoader::LoadActors(actorsArr,
+		[this](const uuid& id) { return FindActorById(id); },
+		[this](const uuid& id) {
 			Actor* actor = CreateActor<Actor>();
 			actor->SetUuid(id);
+			return actor;
+		},
+		[destructive](Actor* actor, const json& actorObj) {
+			assert(actorObj.is_object());
 			actor->Deserialize(&actorObj, destructive);
-		}
-	}
+		});
 	if (in->contains("dirlight"))
 	{
 		const json& dirlight = in->at("dirlight");
@@ -132,6 +140,83 @@ void Game::Deserialize(const json* in, bool destructive)
 	mImGuiSubsystem->OnSceneLoaded();
 }
 
+void Game::SerializeBinary(BinaryWriter& out) const
+{
+	size_t numComponents = 0;
+	for (const auto actor : Actors) {
+		numComponents += actor->Components.size();
+	}
+
+	out.Write(static_cast<uint32_t>(Actors.size()));
+	out.Write(static_cast<uint32_t>(numComponents));
+	for (const auto actor : Actors) {
+		actor->SerializeBinary(out);
+	}
+
+	out.Write<uint8_t>(dr != nullptr);
+	if (dr != nullptr)
+	{
+		out.WriteJson(dr->Serialize());
+	}
+}
+
+void Game::DeserializeBinary(BinaryReader& in, bool destructive)
+{
+	if(destructive)
+	{
+		DestroyAllActors();
+	}
+
+	// Counts from the file only size the reservations as far as the data can back them,
+	// an actor or a component takes at least 25 bytes
+	const uint32_t numActors = in.Read<uint32_t>();
+	const uint32_t numComponents = in.Read<uint32_t>();
+	ReserveForLevel(in.ClampCount(numActors, 25), in.ClampCount(numComponents, 25));
+
+	for (uint32_t i = 0; i < numActors && in.IsValid(); ++i) {
+		const uuid id = in.ReadUuid();
+
+		if (Actor* actor = FindActorById(id)) {
+			actor->DeserializeBinary(in);
+		}
+		else {
+			Actor* actor = CreateActor<Actor>();
+			actor->SetUuid(id);
+			actor->DeserializeBinary(in);
+		}
+	}
+
+	const bool hasDirLight = in.Read<uint8_t>() != 0;
+	if (hasDirLight)
+	{
+		const json dirlight = in.ReadJson();
+		if (in.IsValid())
+		{
+			dr->Deserialize(&dirlight);
+		}
+	}
+
+	mImGuiSubsystem->OnSceneLoaded();
+}
+
+void Game::DestroyAllActors()
+{
+	// Detach the list first so the actor destructors don't search it one by one
+	std::vector<Actor*> oldActors;
+	oldActors.swap(Actors);
+	for(int i = oldActors.size() - 1; i >= 0; i--)
+	{
+		delete oldActors[i];
+	}
+}
+
+void Game::ReserveForLevel(size_t numActors, size_t numComponents)
+{
+	Actors.reserve(Actors.size() + numActors);
+	actorHandles->Reserve(actorHandles->GetNum() + numActors);
+	componentHandles->Reserve(componentHandles->GetNum() + numComponents);
+}
+
 UUIDGenerator* Game::GetUuidGenerator() const
 {
 	return this->uuidGenerator;
@@ -387,24 +472,110 @@ void Game::UpdateInternal(float DeltaTime)
 	{
 		func();
 	}
-	
-	for (GameComponent* gc : GameComponents)
-	{
-		if (gc != nullptr && gc->bShouldUpdate)
-		{
-			gc->Update(DeltaTime);
-		}
-	}
-	
-	Update(DeltaTime);
 
-	if (doDebugRender)
-		PhysicsModuleData::GetInstance()->GetDynamicsWorld()->debugDrawWorld();
+	frameScheduler->Tick(DeltaTime);
 
 	/*recastNavigationManager->GenerateNavMesh();
 	recastNavigationManager->DrawDebugInputMesh();*/
 }
 
+void Game::RegisterEngineTicks()
+{
+	// Assets decoded in the background are uploaded first so they can be drawn this frame
+	TickFunction assetsTick;
+	assetsTick.Name = "AssetLoader";
+	assetsTick.Phase = FramePhase::PrePhysics;
+	assetsTick.Reads = TickResourceNone;
+	assetsTick.Writes = TickResourceRenderers;
+	assetsTick.Function = [this](float) { assetManager->Tick(); };
+	frameScheduler->RegisterTick(std::move(assetsTick));
+
+	// Bullet only touches its own world here, rigid bodies copy the results to their transforms in the component update
+	TickFunction physicsTick;
+	physicsTick.Name = "Physics";
+	physicsTick.Phase = FramePhase::Physics;
+	physicsTick.Reads = TickResourcePhysics;
+	physicsTick.Writes = TickResourcePhysics;
+	physicsTick.Function = [this](float DeltaTime)
+	{
+		if (GetPlayState() == PlayState::Playing)
+			PhysicsModuleData::GetInstance()->OnUpdate(DeltaTime);
+	};
+	frameScheduler->RegisterTick(std::move(physicsTick));
+
+	// Components type by type (see ComponentUpdateLists), then the C# actors.
+	// Rigid bodies read the simulation, movement queries navigation, and Mono components and actors run scripts
+	TickFunction componentsTick;
+	componentsTick.Name = "Components";
+	componentsTick.Phase = FramePhase::PostPhysics;
+	componentsTick.Reads = TickResourceTransforms | TickResourcePhysics | TickResourceRenderers | TickResourceScripts | TickResourceAudio | TickResourceNavigation;
+	componentsTick.Writes = TickResourceTransforms | TickResourcePhysics | TickResourceRenderers | TickResourceScripts | TickResourceAudio | TickResourceNavigation;
+	componentsTick.Function = [this](float DeltaTime)
+	{
+		if (GetPlayState() != PlayState::Playing)
+			return;
+
+		componentUpdateLists->UpdateAll(DeltaTime);
+
+		// Copy, actors may spawn or destroy others while updating
+		const std::vector<Actor*> actors = Actors;
+		for (Actor* actor : actors)
+		{
+			actor->Update(DeltaTime);
+		}
+	};
+	frameScheduler->RegisterTick(std::move(componentsTick));
+
+	// Editor style components: camera controllers and the like, they only touch themselves
+	TickFunction gameComponentsTick;
+	gameComponentsTick.Name = "GameComponents";
+	gameComponentsTick.Phase = FramePhase::Script;
+	gameComponentsTick.Reads = TickResourceGameComponents;
+	gameComponentsTick.Writes = TickResourceGameComponents;
+	gameComponentsTick.Function = [this](float DeltaTime)
+	{
+		for (GameComponent* gc : GameComponents)
+		{
+			if (gc != nullptr && gc->bShouldUpdate)
+			{
+				gc->Update(DeltaTime);
+			}
+		}
+	};
+	frameScheduler->RegisterTick(std::move(gameComponentsTick));
+
+	// The game's C# OnUpdate and OnGUI, scripts reach every system the Mono modules expose (all but debug drawing)
+	TickFunction gameTick;
+	gameTick.Name = "GameUpdate";
+	gameTick.Phase = FramePhase::Script;
+	gameTick.Reads = TickResourceAll & ~TickResourceDebugDraw;
+	gameTick.Writes = TickResourceAll & ~TickResourceDebugDraw;
+	gameTick.Function = [this](float DeltaTime) { Update(DeltaTime); };
+	frameScheduler->RegisterTick(std::move(gameTick));
+
+	// Resolve all transforms moved during the frame in one pass before rendering
+	TickFunction transformsTick;
+	transformsTick.Name = "TransformStore";
+	transformsTick.Phase = FramePhase::PreRender;
+	transformsTick.Reads = TickResourceTransforms;
+	transformsTick.Writes = TickResourceTransforms;
+	transformsTick.bMainThreadOnly = false;
+	transformsTick.Function = [this](float) { transformStore->UpdateWorldMatrices(); };
+	frameScheduler->RegisterTick(std::move(transformsTick));
+
+	TickFunction physicsDebugDrawTick;
+	physicsDebugDrawTick.Name = "PhysicsDebugDraw";
+	physicsDebugDrawTick.Phase = FramePhase::PreRender;
+	physicsDebugDrawTick.Reads = TickResourcePhysics;
+	physicsDebugDrawTick.Writes = TickResourceDebugDraw;
+	physicsDebugDrawTick.Function = [this](float)
+	{
+		if (doDebugRender)
+			PhysicsModuleData::GetInstance()->GetDynamicsWorld()->debugDrawWorld();
+	};
+	frameScheduler->RegisterTick(std::move(physicsDebugDrawTick));
+}
+
 void Game::Update(float DeltaTime)
 {
 	
@@ -491,6 +662,8 @@ Game::~Game()
 	{
 		delete gc;
 	}
+	// Asset scans may still run as jobs, they finish before the job system goes away
+	assetManager.reset();
 	Context->Flush();
 }
 
@@ -595,7 +768,18 @@ auto Game::StartPlay() -> void
 {
 	if (mPlayState == PlayState::Editor)
 	{
-		tempGameSave = Serializer::Serialize(this);
+		const auto start = std::chrono::steady_clock::now();
+		if (bUseIncrementalPlaySnapshot)
+		{
+			playSnapshot->Begin(*this);
+		}
+		else
+		{
+			tempGameSave = Serializer::Serialize(this);
+		}
+		LastPlaySnapshotTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0f;
+		std::cout << "Play snapshot (" << (bUseIncrementalPlaySnapshot ? "incremental" : "full") << ") took " << LastPlaySnapshotTime << " ms\n";
+
 		mPlayState = PlayState::Playing;
 		OnBeginPlay();
 		recastNavigationManager->GenerateNavMesh();
@@ -630,8 +814,28 @@ auto Game::StopPlay() -> void
 	{
 		MyEditorContext.SetSelectedActor(nullptr);
 		mPlayState = PlayState::Editor;
-		Serializer::Deserialize(&tempGameSave, *this, true);
-		tempGameSave.clear();
+
+		const auto start = std::chrono::steady_clock::now();
+		const bool incremental = playSnapshot->IsRecording();
+		if (incremental)
+		{
+			playSnapshot->Restore(*this);
+			mImGuiSubsystem->OnSceneLoaded();
+		}
+		else
+		{
+			Serializer::Deserialize(&tempGameSave, *this, true);
+			tempGameSave.clear();
+		}
+		LastPlayRestoreTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0f;
+		std::cout << "Play restore (" << (incremental ? "incremental" : "full") << ") took " << LastPlayRestoreTime << " ms\n";
+		if (incremental)
+		{
+			const PlaySnapshot::Stats& stats = playSnapshot->GetStats();
+			std::cout << "\trestored " << stats.NumRecordedActors << " actors, " << stats.NumRecordedComponents << " components, destroyed "
+				<< stats.NumSpawnedActors << " spawned actors, " << stats.RecordedBytes << " bytes recorded\n";
+		}
+
 		SetUseEditorCamera(true);
 	}
 }
@@ -648,6 +852,27 @@ auto Game::SetUseEditorCamera(const bool InUseEditorCamera) -> void
 }
 
 
+auto Game::SetUseArchetypeStorage(const bool InUseArchetypeStorage) -> void
+{
+	if (!InUseArchetypeStorage)
+	{
+		archetypeStorage.reset();
+		return;
+	}
+
+	if (archetypeStorage)
+	{
+		return;
+	}
+
+	archetypeStorage.reset(new ArchetypeStorage());
+	for (Actor* actor : Actors)
+	{
+		actor->RefreshComponentIndex();
+	}
+}
+
+
 auto Game::UpdateCamerasAspectRatio(float NewAspectRatio) -> void
 {
 	DefaultPOV.UpdateAspectRatio(NewAspectRatio);
@@ -9,10 +9,12 @@
 
 #include "Actor.h"
 #include "AssetManager.h"
+#include "FrameScheduler.h"
 #include "Game.h"
 #include "RenderingSystem.h"
 #include "DisplayWin32.h"
 
+#include <iostream>
 #include <string>
 
 #include "EngineContentRegistry.h"
@@ -255,7 +257,10 @@ auto ImGuiSubsystem::DrawToolbar() -> void
 
 			if (ImGui::Button("Save") && std::filesystem::exists(currentLevel))
 			{
-				Serializer::SaveToFile(currentLevel, Game::GetInstance());
+				if (!Serializer::SaveToFile(currentLevel, Game::GetInstance()))
+				{
+					std::cout << "Failed to save " << currentLevel.string() << std::endl;
+				}
 			}
 
 			break;
@@ -691,10 +696,16 @@ auto ImGuiSubsystem::DrawStaticMeshProperties() -> void {
 		ImGui::Text("Normal Texture");
 
 		//some material settings here
-		ImGui::SliderFloat("Specular Strength", &smr->Mat.specularCoef, 0.0f, 1.0f);
-		ImGui::SliderFloat("Specular Exp", &smr->Mat.specularExponent, 0.001f, 100.0f);
-		/*ImGui::SliderFloat("Diffuse  Strength", &smr->Mat.diffuesCoef, 0.0f, 1.0f);
-		ImGui::SliderFloat("Ambient Strength", &smr->Mat.ambientCoef, 0.0f, 1.0f);*/
+		// Renderers share materials, a changed one gets the material of its new parameters
+		LitMaterial matParams = smr->GetMaterialParams();
+		bool bMatChanged = ImGui::SliderFloat("Specular Strength", &matParams.specularCoef, 0.0f, 1.0f);
+		bMatChanged |= ImGui::SliderFloat("Specular Exp", &matParams.specularExponent, 0.001f, 100.0f);
+		/*bMatChanged |= ImGui::SliderFloat("Diffuse  Strength", &matParams.diffuesCoef, 0.0f, 1.0f);
+		bMatChanged |= ImGui::SliderFloat("Ambient Strength", &matParams.ambientCoef, 0.0f, 1.0f);*/
+		if (bMatChanged)
+		{
+			smr->SetMaterialParams(matParams);
+		}
 
 		ImGui::EndChild();
 		ImGui::PopStyleVar();
@@ -730,6 +741,9 @@ auto ImGuiSubsystem::DrawActorInspector() -> void
 
 		if (Actor* actor = GetEditorContext().GetSelectedActor())
 		{
+			// The inspector edits fields in place, so a play session records the selected actor up front
+			actor->NotifyModified();
+
 			//General properties
 			DrawGeneralProperties(actor);
 			DrawComponentSelector(actor);
@@ -1367,6 +1381,23 @@ auto ImGuiSubsystem::DrawAsset(const DirectoryTreeNode* file, const Vector2& ite
 		}
 	}
 
+	// Levels convert between the json and the binary format next to the source file, without being loaded
+	if (file->GetAssetType() == AssetType::Level && ImGui::BeginPopupContextItem())
+	{
+		const Path levelPath = GetAssetManager()->GetProjectRootPath() / file->GetPathFromTreeRoot();
+		const bool bBinary = Serializer::IsBinaryLevelPath(levelPath);
+		if (ImGui::MenuItem(bBinary ? "Convert to json level" : "Convert to binary level"))
+		{
+			Path convertedPath = levelPath;
+			convertedPath.replace_extension(bBinary ? ".json" : ".nlevel");
+			if (!Serializer::ConvertLevel(levelPath, convertedPath))
+			{
+				std::cout << "Failed to convert " << levelPath.string() << std::endl;
+			}
+		}
+		ImGui::EndPopup();
+	}
+
 	if (ImGui::IsItemHovered())
 		ImGui::SetTooltip(nameAsString.c_str());
 	ImGui::SetItemAllowOverlap();
@@ -1413,9 +1444,25 @@ auto ImGuiSubsystem::DrawWorldSettings() -> void
 
 	DrawNavMeshSettings();
 
+	DrawFrameStats();
+
 	ImGui::End();
 }
 
+auto ImGuiSubsystem::DrawFrameStats() -> void
+{
+	if (BoldHeader("Frame", 0)) {
+		const FrameScheduler* scheduler = MyGame->GetFrameScheduler();
+
+		BoldText("Phases");
+		for (size_t i = 0; i < static_cast<size_t>(FramePhase::Count); ++i)
+		{
+			const FramePhase phase = static_cast<FramePhase>(i);
+			ImGui::Text("%-12s %6.2f ms  %zu waves", FrameScheduler::GetPhaseName(phase), scheduler->GetPhaseTime(phase), scheduler->GetNumWaves(phase));
+		}
+	}
+}
+
 auto ImGuiSubsystem::DrawNavMeshSettings() -> void
 {
 	if (BoldHeader("NavMesh", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -0,0 +1,213 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	// Worker threads of every job system share these, the index only means something to the owner
+	thread_local const JobSystem* CurrentJobSystem = nullptr;
+	thread_local uint32_t CurrentWorkerIndex = 0;
+}
+
+JobSystem::JobSystem(uint32_t InNumWorkers)
+{
+	if (InNumWorkers == 0)
+	{
+		InNumWorkers = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	Queues.reserve(InNumWorkers);
+	for (uint32_t i = 0; i < InNumWorkers; ++i)
+	{
+		Queues.push_back(std::make_unique<WorkQueue>());
+	}
+
+	// Worker 0 is the main thread
+	Workers.reserve(InNumWorkers - 1);
+	for (uint32_t i = 1; i < InNumWorkers; ++i)
+	{
+		Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(WakeMutex);
+		bStopRequested = true;
+	}
+	WakeCondition.notify_all();
+
+	for (std::thread& worker : Workers)
+	{
+		worker.join();
+	}
+}
+
+auto JobSystem::Run(JobFunction&& InJob, JobCounter* InCounter, const JobCounter* InDependency) -> void
+{
+	if (InCounter)
+	{
+		InCounter->Value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	PushJob(GetCurrentWorkerIndex(), Job{ std::move(InJob), InCounter, InDependency });
+}
+
+auto JobSystem::Wait(const JobCounter& InCounter) -> void
+{
+	const uint32_t workerIndex = GetCurrentWorkerIndex();
+	while (!InCounter.IsDone())
+	{
+		if (!TryRunJob(workerIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+auto JobSystem::ParallelFor(uint32_t InCount, uint32_t InBatchSize, const std::function<void(uint32_t, uint32_t)>& InFunc) -> void
+{
+	if (InCount == 0)
+	{
+		return;
+	}
+
+	InBatchSize = std::max(1u, InBatchSize);
+
+	// Not worth the scheduling overhead
+	if (InCount <= InBatchSize)
+	{
+		InFunc(0, InCount);
+		return;
+	}
+
+	JobCounter counter;
+	for (uint32_t begin = InBatchSize; begin < InCount; begin += InBatchSize)
+	{
+		const uint32_t end = std::min(begin + InBatchSize, InCount);
+		Run([&InFunc, begin, end]() { InFunc(begin, end); }, &counter);
+	}
+
+	// The calling thread takes the first batch itself
+	InFunc(0, std::min(InBatchSize, InCount));
+
+	Wait(counter);
+}
+
+auto JobSystem::GetCurrentWorkerIndex() const -> uint32_t
+{
+	// Workers of another job system run or wait here from the main thread queue
+	return CurrentJobSystem == this ? CurrentWorkerIndex : 0;
+}
+
+auto JobSystem::WorkerLoop(uint32_t InWorkerIndex) -> void
+{
+	CurrentJobSystem = this;
+	CurrentWorkerIndex = InWorkerIndex;
+
+	while (!bStopRequested.load(std::memory_order_acquire))
+	{
+		if (TryRunJob(InWorkerIndex))
+		{
+			continue;
+		}
+
+		// Only jobs waiting for their dependency are left, don't burn the core spinning on them
+		if (NumPendingJobs.load(std::memory_order_acquire) > 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(WakeMutex);
+		WakeCondition.wait(lock, [this]() { return bStopRequested.load() || NumPendingJobs.load() > 0; });
+	}
+}
+
+auto JobSystem::TryRunJob(uint32_t InWorkerIndex) -> bool
+{
+	Job job;
+	if (!PopJob(InWorkerIndex, job) && !StealJob(InWorkerIndex, job))
+	{
+		return false;
+	}
+
+	if (job.Dependency && !job.Dependency->IsDone())
+	{
+		// Not ready yet, put it back behind the rest of the work
+		std::lock_guard<std::mutex> lock(Queues[InWorkerIndex]->Mutex);
+		Queues[InWorkerIndex]->Jobs.push_front(std::move(job));
+		NumPendingJobs.fetch_add(1, std::memory_order_release);
+		return false;
+	}
+
+	job.Function();
+
+	if (job.Counter)
+	{
+		job.Counter->Value.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	return true;
+}
+
+auto JobSystem::PopJob(uint32_t InWorkerIndex, Job& OutJob) -> bool
+{
+	WorkQueue& queue = *Queues[InWorkerIndex];
+
+	std::lock_guard<std::mutex> lock(queue.Mutex);
+	if (queue.Jobs.empty())
+	{
+		return false;
+	}
+
+	// Newest job first, its data is most likely still in cache
+	OutJob = std::move(queue.Jobs.back());
+	queue.Jobs.pop_back();
+	NumPendingJobs.fetch_sub(1, std::memory_order_relaxed);
+
+	return true;
+}
+
+auto JobSystem::StealJob(uint32_t InWorkerIndex, Job& OutJob) -> bool
+{
+	const uint32_t numQueues = static_cast<uint32_t>(Queues.size());
+	for (uint32_t offset = 1; offset < numQueues; ++offset)
+	{
+		WorkQueue& victim = *Queues[(InWorkerIndex + offset) % numQueues];
+
+		std::unique_lock<std::mutex> lock(victim.Mutex, std::try_to_lock);
+		if (!lock.owns_lock() || victim.Jobs.empty())
+		{
+			continue;
+		}
+
+		// Oldest job, usually the biggest chunk of remaining work
+		OutJob = std::move(victim.Jobs.front());
+		victim.Jobs.pop_front();
+		NumPendingJobs.fetch_sub(1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	return false;
+}
+
+auto JobSystem::PushJob(uint32_t InWorkerIndex, Job&& InJob) -> void
+{
+	assert(InWorkerIndex < Queues.size());
+
+	// Count the job first so that a thief can never take it before it is accounted for
+	{
+		std::lock_guard<std::mutex> lock(WakeMutex);
+		NumPendingJobs.fetch_add(1, std::memory_order_release);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(Queues[InWorkerIndex]->Mutex);
+		Queues[InWorkerIndex]->Jobs.push_back(std::move(InJob));
+	}
+	WakeCondition.notify_one();
+}
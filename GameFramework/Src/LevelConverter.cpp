@@ -0,0 +1,293 @@
+#include "LevelConverter.h"
+
+#include <cstring>
+
+namespace
+{
+	auto FindString(const json& InObject, const char* InKey) -> const std::string*
+	{
+		const auto found = InObject.find(InKey);
+		return found != InObject.end() && found->is_string() ? &found->get_ref<const std::string&>() : nullptr;
+	}
+
+	auto FindUuid(const json& InObject, const char* InKey, uuid& OutId) -> bool
+	{
+		const std::string* text = FindString(InObject, InKey);
+		if (text == nullptr)
+		{
+			return false;
+		}
+
+		const std::optional<uuid> id = uuid::from_string(*text);
+		OutId = id.value_or(uuid());
+		return id.has_value();
+	}
+
+	auto WriteComponentData(const std::string& InTypeName, const json& InData, const LevelConverter::ComponentConverters& InConverters, BinaryWriter& Out) -> bool
+	{
+		const auto converter = InConverters.find(InTypeName);
+		if (converter == InConverters.end())
+		{
+			Out.WriteJson(InData);
+			return true;
+		}
+
+		// Converters read the fields with at() and get(), a level with a missing or mistyped field throws
+		try
+		{
+			converter->second.ToBinary(InData, Out);
+			return true;
+		}
+		catch (const json::exception&)
+		{
+			return false;
+		}
+	}
+
+	auto ReadComponentData(const std::string& InTypeName, BinaryReader& In, const LevelConverter::ComponentConverters& InConverters) -> json
+	{
+		const auto converter = InConverters.find(InTypeName);
+		return converter != InConverters.end() ? converter->second.ToJson(In) : In.ReadJson();
+	}
+}
+
+auto LevelConverter::ReadStrings(const uint8_t* InData, size_t InSize, BinaryLevelHeader& OutHeader, std::vector<std::string_view>& OutStrings) -> bool
+{
+	if (InSize < sizeof(OutHeader))
+	{
+		return false;
+	}
+	std::memcpy(&OutHeader, InData, sizeof(OutHeader));
+
+	if (std::memcmp(OutHeader.Magic, BinaryLevelMagic, sizeof(OutHeader.Magic)) != 0
+		|| OutHeader.Version != BinaryLevelVersion
+		|| OutHeader.StringTableOffset < sizeof(OutHeader) || OutHeader.StringTableOffset > InSize)
+	{
+		return false;
+	}
+
+	BinaryReader stringReader(InData + OutHeader.StringTableOffset, InSize - OutHeader.StringTableOffset);
+	// Every string has at least its length
+	OutStrings.reserve(stringReader.ClampCount(OutHeader.NumStrings, sizeof(uint32_t)));
+	for (uint32_t i = 0; i < OutHeader.NumStrings && stringReader.IsValid(); ++i)
+	{
+		OutStrings.push_back(stringReader.ReadString());
+	}
+	return stringReader.IsValid();
+}
+
+auto LevelConverter::Finish(BinaryWriter& InWriter) -> std::vector<uint8_t>
+{
+	BinaryLevelHeader header = {};
+	std::memcpy(header.Magic, BinaryLevelMagic, sizeof(header.Magic));
+	header.Version = BinaryLevelVersion;
+	header.StringTableOffset = InWriter.GetSize();
+	header.NumStrings = static_cast<uint32_t>(InWriter.GetStrings().size());
+	for (const std::string& str : InWriter.GetStrings())
+	{
+		InWriter.WriteString(str);
+	}
+	InWriter.Patch(0, header);
+
+	return InWriter.GetBuffer();
+}
+
+auto LevelConverter::JsonToBinary(const json& InLevel, const ComponentConverters& InConverters, std::vector<uint8_t>& OutData) -> bool
+{
+	if (!InLevel.is_object())
+	{
+		return false;
+	}
+
+	const auto actors = InLevel.find("actors");
+	if (actors == InLevel.end() || !actors->is_array())
+	{
+		return false;
+	}
+
+	size_t numComponents = 0;
+	for (const json& actorObj : *actors)
+	{
+		const auto components = actorObj.is_object() ? actorObj.find("components") : actorObj.end();
+		if (components == actorObj.end() || !components->is_array())
+		{
+			return false;
+		}
+		numComponents += components->size();
+	}
+
+	BinaryWriter writer;
+	writer.Write(BinaryLevelHeader{});
+	writer.Write(static_cast<uint32_t>(actors->size()));
+	writer.Write(static_cast<uint32_t>(numComponents));
+	for (const json& actorObj : *actors)
+	{
+		if (!ActorJsonToBinary(actorObj, InConverters, writer))
+		{
+			return false;
+		}
+	}
+
+	const auto dirlight = InLevel.find("dirlight");
+	writer.Write<uint8_t>(dirlight != InLevel.end());
+	if (dirlight != InLevel.end())
+	{
+		writer.WriteJson(*dirlight);
+	}
+
+	OutData = Finish(writer);
+	return true;
+}
+
+auto LevelConverter::BinaryToJson(const uint8_t* InData, size_t InSize, const ComponentConverters& InConverters, json& OutLevel) -> bool
+{
+	BinaryLevelHeader header;
+	std::vector<std::string_view> strings;
+	if (!ReadStrings(InData, InSize, header, strings))
+	{
+		return false;
+	}
+
+	BinaryReader reader(InData + sizeof(header), header.StringTableOffset - sizeof(header), &strings);
+	const uint32_t numActors = reader.Read<uint32_t>();
+	reader.Read<uint32_t>();
+
+	OutLevel = json::object();
+	json actorsArr = json::array();
+	for (uint32_t i = 0; i < numActors && reader.IsValid(); ++i)
+	{
+		json actorObj;
+		if (!ActorBinaryToJson(reader, InConverters, actorObj))
+		{
+			return false;
+		}
+		actorsArr.push_back(std::move(actorObj));
+	}
+	OutLevel["actors"] = std::move(actorsArr);
+
+	if (reader.Read<uint8_t>() != 0)
+	{
+		OutLevel["dirlight"] = reader.ReadJson();
+	}
+
+	return reader.IsValid();
+}
+
+auto LevelConverter::ActorJsonToBinary(const json& InActor, const ComponentConverters& InConverters, BinaryWriter& Out) -> bool
+{
+	uuid id;
+	const std::string* name = InActor.is_object() ? FindString(InActor, "name") : nullptr;
+	if (name == nullptr || !FindUuid(InActor, "id", id))
+	{
+		return false;
+	}
+
+	const auto components = InActor.find("components");
+	if (components == InActor.end() || !components->is_array())
+	{
+		return false;
+	}
+
+	Out.WriteUuid(id);
+	Out.WriteString(*name);
+
+	const auto mono = InActor.find("mono");
+	Out.Write<uint8_t>(mono != InActor.end());
+	if (mono != InActor.end())
+	{
+		const std::string* monoNamespace = mono->is_object() ? FindString(*mono, "namespace") : nullptr;
+		const std::string* monoClass = mono->is_object() ? FindString(*mono, "class") : nullptr;
+		if (monoNamespace == nullptr || monoClass == nullptr)
+		{
+			return false;
+		}
+		Out.WriteStringRef(*monoNamespace);
+		Out.WriteStringRef(*monoClass);
+	}
+
+	Out.Write(static_cast<uint32_t>(components->size()));
+	for (const json& wrapper : *components)
+	{
+		uuid componentId;
+		const std::string* typeName = wrapper.is_object() ? FindString(wrapper, "name") : nullptr;
+		const auto data = wrapper.is_object() ? wrapper.find("data") : wrapper.end();
+		if (typeName == nullptr || !FindUuid(wrapper, "id", componentId) || data == wrapper.end())
+		{
+			return false;
+		}
+
+		Out.WriteStringRef(*typeName);
+		Out.WriteUuid(componentId);
+
+		const bool bHasParent = wrapper.contains("parent");
+		uuid parentId;
+		if (bHasParent && !FindUuid(wrapper, "parent", parentId))
+		{
+			return false;
+		}
+		Out.Write<uint8_t>(bHasParent);
+		if (bHasParent)
+		{
+			Out.WriteUuid(parentId);
+		}
+
+		const size_t sizeOffset = Out.GetSize();
+		Out.Write<uint32_t>(0);
+		if (!WriteComponentData(*typeName, *data, InConverters, Out))
+		{
+			return false;
+		}
+		Out.Patch(sizeOffset, static_cast<uint32_t>(Out.GetSize() - sizeOffset - sizeof(uint32_t)));
+	}
+
+	return true;
+}
+
+auto LevelConverter::ActorBinaryToJson(BinaryReader& In, const ComponentConverters& InConverters, json& OutActor) -> bool
+{
+	OutActor = json::object();
+	OutActor["id"] = uuids::to_string(In.ReadUuid());
+	OutActor["name"] = std::string(In.ReadString());
+
+	if (In.Read<uint8_t>() != 0)
+	{
+		json monoObj = json::object();
+		monoObj["namespace"] = std::string(In.ReadStringRef());
+		monoObj["class"] = std::string(In.ReadStringRef());
+		OutActor["mono"] = monoObj;
+	}
+
+	const uint32_t numComponents = In.Read<uint32_t>();
+	json componentArr = json::array();
+	for (uint32_t i = 0; i < numComponents && In.IsValid(); ++i)
+	{
+		json wrapper = json::object();
+		const std::string typeName(In.ReadStringRef());
+		wrapper["name"] = typeName;
+		wrapper["id"] = uuids::to_string(In.ReadUuid());
+		if (In.Read<uint8_t>() != 0)
+		{
+			wrapper["parent"] = uuids::to_string(In.ReadUuid());
+		}
+
+		const uint32_t dataSize = In.Read<uint32_t>();
+		const uint8_t* data = In.ReadView(dataSize);
+		if (data == nullptr)
+		{
+			return false;
+		}
+
+		// Every component gets exactly its own bytes, a converter reading too much or too little is caught here
+		BinaryReader dataReader(data, dataSize, In.GetStrings());
+		wrapper["data"] = ReadComponentData(typeName, dataReader, InConverters);
+		if (!dataReader.IsValid() || dataReader.GetRemaining() != 0)
+		{
+			return false;
+		}
+
+		componentArr.push_back(std::move(wrapper));
+	}
+	OutActor["components"] = std::move(componentArr);
+
+	return In.IsValid();
+}
@@ -0,0 +1,122 @@
+#include "Material.h"
+
+#include "AlbedoTexture.h"
+#include "AssetManager.h"
+#include "EngineContentRegistry.h"
+#include "Game.h"
+#include "NormalTexture.h"
+
+#include <cassert>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+	auto HashCombine(size_t InSeed, size_t InValue) -> size_t
+	{
+		return InSeed ^ (InValue + 0x9e3779b97f4a7c15ull + (InSeed << 6) + (InSeed >> 2));
+	}
+}
+
+auto MaterialDesc::operator==(const MaterialDesc& Other) const -> bool
+{
+	return VS == Other.VS && PS == Other.PS && AlbedoPath == Other.AlbedoPath && NormalPath == Other.NormalPath
+		&& std::memcmp(&Params, &Other.Params, sizeof(Params)) == 0;
+}
+
+auto MaterialDescHash::operator()(const MaterialDesc& InDesc) const -> size_t
+{
+	size_t hash = std::hash<const void*>()(InDesc.VS);
+	hash = HashCombine(hash, std::hash<const void*>()(InDesc.PS));
+	hash = HashCombine(hash, std::hash<std::string>()(InDesc.AlbedoPath));
+	hash = HashCombine(hash, std::hash<std::string>()(InDesc.NormalPath));
+
+	uint32_t params[sizeof(LitMaterial) / sizeof(uint32_t)];
+	std::memcpy(params, &InDesc.Params, sizeof(params));
+	for (const uint32_t param : params)
+	{
+		hash = HashCombine(hash, param);
+	}
+	return hash;
+}
+
+Material::Material(uint32_t InId, const MaterialDesc& InDesc)
+	: Id(InId)
+	, Desc(InDesc)
+{
+	AssetManager* am = Game::GetInstance()->GetAssetManager();
+	EngineContentRegistry* content = EngineContentRegistry::GetInstance();
+
+	Albedo = am->RequestAlbedoTexture(Desc.AlbedoPath);
+	Normal = am->RequestNormalTexture(Desc.NormalPath);
+
+	AlbedoSRV = content->GetWhiteTexSRV();
+	AlbedoArraySlot = content->GetWhiteTexArraySlot();
+	NormalSRV = content->GetBasicNormalTexSRV();
+	NormalArraySlot = content->GetBasicNormalTexArraySlot();
+
+	// Textures loaded before are used right away
+	UpdateTextures();
+}
+
+Material::~Material() = default;
+
+auto Material::UpdateTextures() -> void
+{
+	// Failed textures keep the placeholder, a fixed and reloaded one shows up here
+	if (Albedo && Albedo->IsLoaded() && Albedo->GetGeneration() != AlbedoGeneration)
+	{
+		AlbedoSRV = Albedo->GetSRV();
+		AlbedoArraySlot = Albedo->GetArraySlot();
+		AlbedoGeneration = Albedo->GetGeneration();
+	}
+
+	if (Normal && Normal->IsLoaded() && Normal->GetGeneration() != NormalGeneration)
+	{
+		NormalSRV = Normal->GetSRV();
+		NormalArraySlot = Normal->GetArraySlot();
+		NormalGeneration = Normal->GetGeneration();
+	}
+}
+
+auto MaterialRegistry::Acquire(const MaterialDesc& InDesc) -> std::shared_ptr<Material>
+{
+	const auto found = Materials.find(InDesc);
+	if (found != Materials.end())
+	{
+		// Never expired, the last reference takes the material out of the map
+		return found->second.Shared.lock();
+	}
+
+	uint32_t id = NextId;
+	if (FreeIds.empty())
+	{
+		++NextId;
+	}
+	else
+	{
+		id = FreeIds.back();
+		FreeIds.pop_back();
+	}
+
+	Material* material = new Material(id, InDesc);
+	std::shared_ptr<Material> shared(material, [this](Material* InMaterial) { Release(InMaterial); });
+	Materials.emplace(InDesc, Entry{ material, shared });
+	return shared;
+}
+
+auto MaterialRegistry::Update() -> void
+{
+	for (const auto& [desc, entry] : Materials)
+	{
+		entry.Raw->UpdateTextures();
+	}
+}
+
+auto MaterialRegistry::Release(Material* InMaterial) -> void
+{
+	assert(Materials.count(InMaterial->Desc) == 1);
+	Materials.erase(InMaterial->Desc);
+	FreeIds.push_back(InMaterial->Id);
+	delete InMaterial;
+}
@@ -0,0 +1,700 @@
+#include "MeshCache.h"
+
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexCompression.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+namespace
+{
+	constexpr uint32_t CookedMeshMagic = 0x48534D4E; // "NMSH"
+	// Bump when the cooked layout or the import changes
+	constexpr uint32_t CookedMeshVersion = 5;
+	constexpr size_t CookedDataAlignment = 16;
+
+	// LOD chain: every LOD aims for half the triangles of the previous one,
+	// the chain ends when a LOD saves less than 15% or collapses would move the surface too much
+	constexpr uint32_t MaxMeshLods = 4;
+	constexpr float LodTriangleRatio = 0.5f;
+	constexpr float MinLodReduction = 0.85f;
+	// Of the section bounding radius
+	constexpr float MaxLodError = 0.05f;
+	// A LOD is used while its error projects to at most this many pixels
+	constexpr float LodPixelError = 1.0f;
+
+	constexpr uint32_t MeshImportFlags = aiProcess_FlipUVs | aiProcess_FlipWindingOrder | aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_CalcTangentSpace;
+
+	struct CookedMeshHeader
+	{
+		uint32_t Magic = CookedMeshMagic;
+		uint32_t Version = CookedMeshVersion;
+		uint32_t ImportFlags = MeshImportFlags;
+		uint32_t VertexSize = sizeof(TexturedVertex);
+		uint32_t NumMeshes = 0;
+		uint32_t Reserved = 0;
+	};
+
+	// Offsets are from the start of the file, data blocks are aligned to CookedDataAlignment
+	struct CookedMeshEntry
+	{
+		uint32_t NumSections = 0;
+		uint32_t NumVertices = 0;
+		uint32_t NumIndices = 0;
+		// 2 when every section fits 16 bit indices, 4 otherwise
+		uint32_t IndexSize = sizeof(uint32_t);
+		StaticMeshVertexFormat VertexFormat = StaticMeshVertexFormat::Full;
+		// Sections are stored for every LOD, NumSections per LOD
+		uint32_t NumLods = 1;
+		float BoundsCenter[3] = {};
+		float BoundsRadius = 0.0f;
+		// Meshlets of all sections, see StaticMeshSection::meshletStart
+		uint32_t NumMeshlets = 0;
+		uint64_t LodsOffset = 0;
+		uint64_t SectionsOffset = 0;
+		uint64_t MeshletsOffset = 0;
+		uint64_t VerticesOffset = 0;
+		uint64_t IndicesOffset = 0;
+	};
+
+	struct ImportedSection
+	{
+		int32_t MaterialIndex = 0;
+		uint32_t VertexStart = 0;
+		uint32_t NumVertices = 0;
+		// Indices of every LOD the simplifier could make, relative to VertexStart
+		std::vector<std::vector<uint32_t>> LodIndices;
+		std::vector<float> LodErrors;
+	};
+
+	struct ImportedMesh
+	{
+		std::string Name;
+		// NumSectionsPerLod sections for every LOD
+		std::vector<StaticMeshSection> Sections;
+		uint32_t NumSectionsPerLod = 0;
+		std::vector<CookedMeshLod> Lods;
+		std::vector<StaticMeshMeshlet> Meshlets;
+		Vector3 BoundsCenter;
+		float BoundsRadius = 0.0f;
+		std::vector<TexturedVertex> Vertices;
+		std::vector<uint32_t> Indices;
+		MeshOptimizationStats Optimization;
+	};
+
+	// FNV-1a, stable between runs unlike std::hash
+	auto HashBytes(const void* InData, size_t InSize, uint64_t InHash = 14695981039346656037ull) -> uint64_t
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(InData);
+		for (size_t i = 0; i < InSize; ++i)
+		{
+			InHash = (InHash ^ bytes[i]) * 1099511628211ull;
+		}
+		return InHash;
+	}
+
+	auto ToHex(uint64_t InValue) -> std::string
+	{
+		constexpr char digits[] = "0123456789abcdef";
+		std::string out(16, '0');
+		for (int i = 15; i >= 0; --i, InValue >>= 4)
+		{
+			out[i] = digits[InValue & 0xF];
+		}
+		return out;
+	}
+
+	auto AlignTo(BinaryWriter& Out, size_t InAlignment) -> void
+	{
+		static constexpr uint8_t zeros[CookedDataAlignment] = {};
+		const size_t padding = (InAlignment - Out.GetSize() % InAlignment) % InAlignment;
+		Out.WriteBytes(zeros, padding);
+	}
+
+	auto GetBoundingSphere(const TexturedVertex* InVertices, size_t InNumVertices, Vector3& OutCenter, float& OutRadius) -> void
+	{
+		OutCenter = Vector3{ 0.0f, 0.0f, 0.0f };
+		OutRadius = 0.0f;
+		if (InNumVertices == 0)
+		{
+			return;
+		}
+
+		Vector3 boundsMin = InVertices[0].Position;
+		Vector3 boundsMax = InVertices[0].Position;
+		for (size_t i = 1; i < InNumVertices; ++i)
+		{
+			const Vector3& p = InVertices[i].Position;
+			boundsMin = Vector3{ (std::min)(boundsMin.x, p.x), (std::min)(boundsMin.y, p.y), (std::min)(boundsMin.z, p.z) };
+			boundsMax = Vector3{ (std::max)(boundsMax.x, p.x), (std::max)(boundsMax.y, p.y), (std::max)(boundsMax.z, p.z) };
+		}
+
+		OutCenter = Vector3{ (boundsMin.x + boundsMax.x) * 0.5f, (boundsMin.y + boundsMax.y) * 0.5f, (boundsMin.z + boundsMax.z) * 0.5f };
+		for (size_t i = 0; i < InNumVertices; ++i)
+		{
+			const Vector3& p = InVertices[i].Position;
+			const float dx = p.x - OutCenter.x, dy = p.y - OutCenter.y, dz = p.z - OutCenter.z;
+			OutRadius = (std::max)(OutRadius, std::sqrt(dx * dx + dy * dy + dz * dz));
+		}
+	}
+
+	// Simplified index lists of a section, all of them index its LOD0 vertices
+	auto GenerateSectionLods(const std::vector<TexturedVertex>& InVertices, std::vector<uint32_t>&& InIndices, ImportedSection& OutSection) -> void
+	{
+		Vector3 center;
+		float radius;
+		GetBoundingSphere(InVertices.data(), InVertices.size(), center, radius);
+
+		const uint32_t numVertices = static_cast<uint32_t>(InVertices.size());
+		const size_t numTriangles = InIndices.size() / 3;
+
+		OutSection.LodIndices.push_back(std::move(InIndices));
+		OutSection.LodErrors.push_back(0.0f);
+
+		float ratio = 1.0f;
+		for (uint32_t lod = 1; lod < MaxMeshLods && numTriangles > 0; ++lod)
+		{
+			ratio *= LodTriangleRatio;
+			const size_t targetIndexCount = static_cast<size_t>(numTriangles * ratio) * 3;
+
+			float error = 0.0f;
+			std::vector<uint32_t> indices = MeshSimplifier::Simplify(&InVertices[0].Position.x, sizeof(TexturedVertex), numVertices,
+				OutSection.LodIndices[0], targetIndexCount, MaxLodError * radius, &error);
+			if (indices.size() >= OutSection.LodIndices.back().size())
+			{
+				break;
+			}
+
+			MeshOptimizer::OptimizeVertexCache(indices, numVertices);
+			OutSection.LodIndices.push_back(std::move(indices));
+			OutSection.LodErrors.push_back(error);
+		}
+	}
+
+	auto ToStaticMeshMeshlet(const MeshletData& InMeshlet) -> StaticMeshMeshlet
+	{
+		StaticMeshMeshlet meshlet;
+		meshlet.indexOffset = InMeshlet.IndexOffset;
+		meshlet.numIndices = InMeshlet.NumIndices;
+		meshlet.center = Vector3(InMeshlet.Center);
+		meshlet.radius = InMeshlet.Radius;
+		meshlet.coneAxis = Vector3(InMeshlet.ConeAxis);
+		meshlet.coneCutoff = InMeshlet.ConeCutoff;
+		return meshlet;
+	}
+
+	// Sections missing a LOD draw their last one, the mesh only gets LODs that save enough triangles overall
+	auto BuildLodChain(const std::vector<ImportedSection>& InSections, ImportedMesh& OutMesh) -> void
+	{
+		auto getLodIndex = [](const ImportedSection& InSection, uint32_t InLod) -> uint32_t
+		{
+			return (std::min)(InLod, static_cast<uint32_t>(InSection.LodIndices.size()) - 1);
+		};
+
+		auto countIndices = [&](uint32_t InLod) -> size_t
+		{
+			size_t numIndices = 0;
+			for (const ImportedSection& section : InSections)
+			{
+				numIndices += section.LodIndices[getLodIndex(section, InLod)].size();
+			}
+			return numIndices;
+		};
+
+		uint32_t numLods = 1;
+		while (numLods < MaxMeshLods && !InSections.empty() && countIndices(numLods) <= MinLodReduction * countIndices(numLods - 1))
+		{
+			++numLods;
+		}
+
+		GetBoundingSphere(OutMesh.Vertices.data(), OutMesh.Vertices.size(), OutMesh.BoundsCenter, OutMesh.BoundsRadius);
+		OutMesh.NumSectionsPerLod = static_cast<uint32_t>(InSections.size());
+
+		for (uint32_t lod = 0; lod < numLods; ++lod)
+		{
+			CookedMeshLod& cookedLod = OutMesh.Lods.emplace_back();
+
+			for (size_t i = 0; i < InSections.size(); ++i)
+			{
+				const ImportedSection& imported = InSections[i];
+				const uint32_t lodIndex = getLodIndex(imported, lod);
+				cookedLod.Error = (std::max)(cookedLod.Error, imported.LodErrors[lodIndex]);
+
+				StaticMeshSection section;
+				section.materialIndex = imported.MaterialIndex;
+				section.vertexStart = imported.VertexStart;
+
+				if (lod > 0 && lodIndex == getLodIndex(imported, lod - 1))
+				{
+					// Same indices as the previous LOD, shared
+					const StaticMeshSection& previous = OutMesh.Sections[OutMesh.Sections.size() - InSections.size()];
+					section.indicesStart = previous.indicesStart;
+					section.numIndices = previous.numIndices;
+					section.meshletStart = previous.meshletStart;
+					section.numMeshlets = previous.numMeshlets;
+				}
+				else
+				{
+					const std::vector<uint32_t>& indices = imported.LodIndices[lodIndex];
+					section.indicesStart = static_cast<uint32_t>(OutMesh.Indices.size());
+					section.numIndices = static_cast<uint32_t>(indices.size());
+					OutMesh.Indices.insert(OutMesh.Indices.end(), indices.begin(), indices.end());
+
+					section.meshletStart = static_cast<uint32_t>(OutMesh.Meshlets.size());
+					const TexturedVertex* vertices = OutMesh.Vertices.data() + imported.VertexStart;
+					std::vector<MeshletData> meshlets;
+					MeshletBuilder::BuildMeshlets(&vertices->Position.x, &vertices->Normal.x, sizeof(TexturedVertex), indices.data(), indices.size(), meshlets);
+					for (const MeshletData& meshlet : meshlets)
+					{
+						OutMesh.Meshlets.push_back(ToStaticMeshMeshlet(meshlet));
+					}
+					section.numMeshlets = static_cast<uint32_t>(OutMesh.Meshlets.size()) - section.meshletStart;
+				}
+
+				OutMesh.Sections.push_back(section);
+			}
+
+			// Error of e on a sphere of radius r covering s of a viewport H pixels high spans e / 2r * s * H pixels
+			cookedLod.MaxScreenSize = FLT_MAX;
+			if (cookedLod.Error > 0.0f)
+			{
+				cookedLod.MaxScreenSize = 2.0f * OutMesh.BoundsRadius * LodPixelError / (cookedLod.Error * StaticMeshLodReferenceHeight);
+			}
+			if (lod > 0)
+			{
+				cookedLod.MaxScreenSize = (std::min)(cookedLod.MaxScreenSize, OutMesh.Lods[lod - 1].MaxScreenSize);
+			}
+		}
+	}
+
+	auto ImportMeshData(const aiNode* InNode, const aiScene* InScene, ImportedMesh& OutMesh) -> void
+	{
+		std::vector<ImportedSection> sections;
+
+		for (size_t meshIndex = 0; meshIndex < InNode->mNumMeshes; ++meshIndex)
+		{
+			const aiMesh* mesh = InScene->mMeshes[InNode->mMeshes[meshIndex]];
+
+			std::vector<TexturedVertex> vertices;
+			vertices.reserve(mesh->mNumVertices);
+			for (size_t i = 0; i < mesh->mNumVertices; ++i) {
+				TexturedVertex v = {};
+
+				v.Position.x = mesh->mVertices[i].x;
+				v.Position.y = mesh->mVertices[i].y;
+				v.Position.z = mesh->mVertices[i].z;
+
+				v.Normal.x = mesh->mNormals[i].x;
+				v.Normal.y = mesh->mNormals[i].y;
+				v.Normal.z = mesh->mNormals[i].z;
+
+				// it seems that sometime bitanagents and tangents cannot be calculated - possibly when there're no UV's
+				if (mesh->mBitangents)
+				{
+					v.Binormal.x = mesh->mBitangents[i].x;
+					v.Binormal.y = mesh->mBitangents[i].y;
+					v.Binormal.z = mesh->mBitangents[i].z;
+				}
+
+				if (mesh->mTangents)
+				{
+					v.Tangent.x = mesh->mTangents[i].x;
+					v.Tangent.y = mesh->mTangents[i].y;
+					v.Tangent.z = mesh->mTangents[i].z;
+				}
+
+				if (mesh->mTextureCoords[0] != nullptr)
+				{
+					v.TexCoord.x = mesh->mTextureCoords[0][i].x;
+					v.TexCoord.y = mesh->mTextureCoords[0][i].y;
+				}
+
+				vertices.push_back(v);
+			}
+
+			std::vector<uint32_t> indices;
+			indices.reserve(mesh->mNumFaces * 3);
+			for (size_t i = 0; i < mesh->mNumFaces; ++i) {
+				indices.push_back(mesh->mFaces[i].mIndices[0]);
+				indices.push_back(mesh->mFaces[i].mIndices[1]);
+				indices.push_back(mesh->mFaces[i].mIndices[2]);
+			}
+
+			// Sections are drawn with their own base vertex, so each one is optimized on its own
+			OutMesh.Optimization += MeshOptimizer::OptimizeMesh(vertices, indices);
+
+			ImportedSection& section = sections.emplace_back();
+			section.MaterialIndex = mesh->mMaterialIndex;
+			section.VertexStart = static_cast<uint32_t>(OutMesh.Vertices.size());
+			section.NumVertices = static_cast<uint32_t>(vertices.size());
+			GenerateSectionLods(vertices, std::move(indices), section);
+
+			OutMesh.Vertices.insert(OutMesh.Vertices.end(), vertices.begin(), vertices.end());
+		}
+
+		BuildLodChain(sections, OutMesh);
+	}
+
+	// Indices are relative to the section base vertex, see MeshOptimizer::FitsIn16BitIndices
+	auto CanUse16BitIndices(const ImportedMesh& InMesh) -> bool
+	{
+		// LOD0 sections are in vertex order
+		for (size_t i = 0; i < InMesh.NumSectionsPerLod; ++i)
+		{
+			const uint32_t vertexEnd = i + 1 < InMesh.NumSectionsPerLod ? InMesh.Sections[i + 1].vertexStart : static_cast<uint32_t>(InMesh.Vertices.size());
+			if (!MeshOptimizer::FitsIn16BitIndices(vertexEnd - InMesh.Sections[i].vertexStart))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	auto PrintOptimizationStats(const Path& InCollectionPath, const ImportedMesh& InMesh) -> void
+	{
+		const MeshOptimizationStats& stats = InMesh.Optimization;
+		std::cout << "Optimized " << InCollectionPath.filename().string() << "/" << InMesh.Name
+			<< ": vertices " << stats.NumVerticesBefore << " -> " << stats.NumVerticesAfter
+			<< ", ACMR " << stats.CacheBefore.GetAcmr() << " -> " << stats.CacheAfter.GetAcmr()
+			<< ", ATVR " << stats.CacheBefore.GetAtvr() << " -> " << stats.CacheAfter.GetAtvr();
+
+		for (size_t lod = 1; lod < InMesh.Lods.size(); ++lod)
+		{
+			uint32_t numIndices = 0;
+			for (size_t i = 0; i < InMesh.NumSectionsPerLod; ++i)
+			{
+				numIndices += InMesh.Sections[lod * InMesh.NumSectionsPerLod + i].numIndices;
+			}
+			std::cout << ", LOD" << lod << " " << numIndices / 3 << " triangles (error " << InMesh.Lods[lod].Error << ")";
+		}
+		std::cout << std::endl;
+	}
+
+	auto IsCookedDataValid(const uint8_t* InData, size_t InSize) -> bool
+	{
+		if (InSize < sizeof(CookedMeshHeader))
+		{
+			return false;
+		}
+
+		CookedMeshHeader header;
+		std::memcpy(&header, InData, sizeof(header));
+		const CookedMeshHeader expected;
+		return header.Magic == expected.Magic && header.Version == expected.Version
+			&& header.ImportFlags == expected.ImportFlags && header.VertexSize == expected.VertexSize;
+	}
+
+	auto ElapsedMs(std::chrono::steady_clock::time_point InStart) -> float
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - InStart).count();
+	}
+}
+
+auto CookedMeshCollection::FindMesh(std::string_view InName, CookedMeshView& OutView) const -> bool
+{
+	BinaryReader reader(GetData(), GetSize());
+	const CookedMeshHeader header = reader.Read<CookedMeshHeader>();
+
+	for (uint32_t i = 0; i < header.NumMeshes && reader.IsValid(); ++i)
+	{
+		const std::string_view name = reader.ReadString();
+		const CookedMeshEntry entry = reader.Read<CookedMeshEntry>();
+		if (!reader.IsValid() || name != InName)
+		{
+			continue;
+		}
+
+		const uint64_t lodsEnd = entry.LodsOffset + uint64_t(entry.NumLods) * sizeof(CookedMeshLod);
+		const uint64_t sectionsEnd = entry.SectionsOffset + uint64_t(entry.NumSections) * entry.NumLods * sizeof(StaticMeshSection);
+		const uint64_t meshletsEnd = entry.MeshletsOffset + uint64_t(entry.NumMeshlets) * sizeof(StaticMeshMeshlet);
+		const uint32_t vertexSize = entry.VertexFormat == StaticMeshVertexFormat::Packed ? sizeof(PackedTexturedVertex) : sizeof(TexturedVertex);
+		const uint64_t verticesEnd = entry.VerticesOffset + uint64_t(entry.NumVertices) * vertexSize;
+		const uint64_t indicesEnd = entry.IndicesOffset + uint64_t(entry.NumIndices) * entry.IndexSize;
+		if ((entry.IndexSize != sizeof(uint16_t) && entry.IndexSize != sizeof(uint32_t)) || entry.NumLods == 0 || lodsEnd > GetSize() || sectionsEnd > GetSize() || meshletsEnd > GetSize() || verticesEnd > GetSize() || indicesEnd > GetSize())
+		{
+			return false;
+		}
+
+		OutView.Sections = reinterpret_cast<const StaticMeshSection*>(GetData() + entry.SectionsOffset);
+		OutView.NumSections = entry.NumSections;
+		OutView.Lods = reinterpret_cast<const CookedMeshLod*>(GetData() + entry.LodsOffset);
+		OutView.NumLods = entry.NumLods;
+		OutView.Meshlets = reinterpret_cast<const StaticMeshMeshlet*>(GetData() + entry.MeshletsOffset);
+		OutView.NumMeshlets = entry.NumMeshlets;
+		OutView.BoundsCenter = Vector3{ entry.BoundsCenter[0], entry.BoundsCenter[1], entry.BoundsCenter[2] };
+		OutView.BoundsRadius = entry.BoundsRadius;
+		OutView.Vertices = GetData() + entry.VerticesOffset;
+		OutView.NumVertices = entry.NumVertices;
+		OutView.VertexSize = vertexSize;
+		OutView.VertexFormat = entry.VertexFormat;
+		OutView.Indices = GetData() + entry.IndicesOffset;
+		OutView.NumIndices = entry.NumIndices;
+		OutView.IndexSize = entry.IndexSize;
+		return true;
+	}
+
+	return false;
+}
+
+auto CookedMeshCollection::GetMeshNames() const -> std::vector<std::string_view>
+{
+	BinaryReader reader(GetData(), GetSize());
+	const CookedMeshHeader header = reader.Read<CookedMeshHeader>();
+
+	std::vector<std::string_view> names;
+	names.reserve(header.NumMeshes);
+	for (uint32_t i = 0; i < header.NumMeshes && reader.IsValid(); ++i)
+	{
+		names.push_back(reader.ReadString());
+		reader.Skip(sizeof(CookedMeshEntry));
+	}
+
+	return names;
+}
+
+MeshCache::MeshCache(const Path& InCacheDirectory)
+	: CacheDirectory(InCacheDirectory)
+{
+	std::error_code error;
+	std::filesystem::create_directories(CacheDirectory, error);
+}
+
+auto MeshCache::Open(const Path& InCollectionPath, CookedMeshCollection& OutCollection) -> bool
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	const Path cookedPath = GetCookedPath(InCollectionPath);
+	if (cookedPath.empty())
+	{
+		return false;
+	}
+
+	std::lock_guard lock(GetCollectionMutex(InCollectionPath));
+
+	if (OutCollection.File.Open(cookedPath) && IsCookedDataValid(OutCollection.File.GetData(), OutCollection.File.GetSize()))
+	{
+		std::lock_guard statsLock(StatsMutex);
+		++CurrentStats.NumHits;
+		CurrentStats.MapMs += ElapsedMs(start);
+		return true;
+	}
+
+	OutCollection.File.Close();
+
+	BinaryWriter cooked;
+	if (!Cook(InCollectionPath, cooked))
+	{
+		return false;
+	}
+
+	if (!WriteFileAtomically(cookedPath, cooked.GetBuffer()) || !OutCollection.File.Open(cookedPath))
+	{
+		OutCollection.Buffer = cooked.GetBuffer();
+	}
+	RemoveStaleFiles(cookedPath);
+
+	const float cookMs = ElapsedMs(start);
+	std::cout << "Cooked " << InCollectionPath.string() << " in " << cookMs << " ms" << std::endl;
+
+	std::lock_guard statsLock(StatsMutex);
+	++CurrentStats.NumCooked;
+	CurrentStats.CookMs += cookMs;
+	return true;
+}
+
+auto MeshCache::GetCookedPath(const Path& InCollectionPath) const -> Path
+{
+	std::error_code error;
+	const auto writeTime = std::filesystem::last_write_time(InCollectionPath, error);
+	if (error)
+	{
+		return Path();
+	}
+	const uint64_t size = std::filesystem::file_size(InCollectionPath, error);
+	if (error)
+	{
+		return Path();
+	}
+
+	const std::string sourcePath = std::filesystem::absolute(InCollectionPath, error).lexically_normal().generic_string();
+	const uint64_t pathHash = HashBytes(sourcePath.data(), sourcePath.size());
+
+	const int64_t writeTicks = writeTime.time_since_epoch().count();
+	const uint32_t importFlags = MeshImportFlags;
+	const uint32_t version = CookedMeshVersion;
+	uint64_t stateHash = HashBytes(&writeTicks, sizeof(writeTicks));
+	stateHash = HashBytes(&size, sizeof(size), stateHash);
+	stateHash = HashBytes(&importFlags, sizeof(importFlags), stateHash);
+	stateHash = HashBytes(&version, sizeof(version), stateHash);
+
+	// The source part of the name lets RemoveStaleFiles find older versions
+	return CacheDirectory / Path(ToHex(pathHash) + "_" + ToHex(stateHash) + ".nmesh");
+}
+
+auto MeshCache::GetStats() const -> Stats
+{
+	std::lock_guard lock(StatsMutex);
+	return CurrentStats;
+}
+
+auto MeshCache::Cook(const Path& InCollectionPath, BinaryWriter& Out) const -> bool
+{
+	Assimp::Importer importer;
+	const aiScene* scene = importer.ReadFile(InCollectionPath.string(), MeshImportFlags);
+	if (scene == nullptr)
+	{
+		return false;
+	}
+
+	// Same walk as the asset manager, every node with meshes is a mesh asset named after its first mesh
+	std::vector<ImportedMesh> meshes;
+	std::vector<const aiNode*> stack;
+	stack.push_back(scene->mRootNode);
+	while (!stack.empty())
+	{
+		const aiNode* node = stack.back();
+		stack.pop_back();
+
+		stack.insert(stack.end(), node->mChildren, node->mChildren + node->mNumChildren);
+
+		if (node->mNumMeshes > 0)
+		{
+			ImportedMesh& mesh = meshes.emplace_back();
+			mesh.Name = scene->mMeshes[node->mMeshes[0]]->mName.C_Str();
+			ImportMeshData(node, scene, mesh);
+			PrintOptimizationStats(InCollectionPath, mesh);
+		}
+	}
+
+	CookedMeshHeader header;
+	header.NumMeshes = static_cast<uint32_t>(meshes.size());
+	Out.Write(header);
+
+	// Offsets are patched once the data is written
+	std::vector<size_t> entryOffsets;
+	entryOffsets.reserve(meshes.size());
+	for (const ImportedMesh& mesh : meshes)
+	{
+		Out.WriteString(mesh.Name);
+		entryOffsets.push_back(Out.GetSize());
+		Out.Write(CookedMeshEntry{});
+	}
+
+	for (size_t i = 0; i < meshes.size(); ++i)
+	{
+		const ImportedMesh& mesh = meshes[i];
+
+		CookedMeshEntry entry;
+		entry.NumSections = mesh.NumSectionsPerLod;
+		entry.NumLods = static_cast<uint32_t>(mesh.Lods.size());
+		entry.BoundsCenter[0] = mesh.BoundsCenter.x;
+		entry.BoundsCenter[1] = mesh.BoundsCenter.y;
+		entry.BoundsCenter[2] = mesh.BoundsCenter.z;
+		entry.BoundsRadius = mesh.BoundsRadius;
+		entry.NumMeshlets = static_cast<uint32_t>(mesh.Meshlets.size());
+		entry.NumVertices = static_cast<uint32_t>(mesh.Vertices.size());
+		entry.NumIndices = static_cast<uint32_t>(mesh.Indices.size());
+		entry.IndexSize = CanUse16BitIndices(mesh) ? sizeof(uint16_t) : sizeof(uint32_t);
+		entry.VertexFormat = CanPackVertices(mesh.Vertices.data(), mesh.Vertices.size()) ? StaticMeshVertexFormat::Packed : StaticMeshVertexFormat::Full;
+
+		AlignTo(Out, CookedDataAlignment);
+		entry.LodsOffset = Out.GetSize();
+		Out.WriteBytes(mesh.Lods.data(), mesh.Lods.size() * sizeof(CookedMeshLod));
+
+		AlignTo(Out, CookedDataAlignment);
+		entry.SectionsOffset = Out.GetSize();
+		Out.WriteBytes(mesh.Sections.data(), mesh.Sections.size() * sizeof(StaticMeshSection));
+
+		AlignTo(Out, CookedDataAlignment);
+		entry.MeshletsOffset = Out.GetSize();
+		if (entry.VertexFormat == StaticMeshVertexFormat::Packed)
+		{
+			// Bounds are built from the full vertices, grown so they still hold the packed ones
+			const float packingError = MeasurePackingError(mesh.Vertices.data(), mesh.Vertices.size()).Position * std::sqrt(3.0f);
+			std::vector<StaticMeshMeshlet> meshlets = mesh.Meshlets;
+			for (StaticMeshMeshlet& meshlet : meshlets)
+			{
+				meshlet.radius += packingError;
+			}
+			Out.WriteBytes(meshlets.data(), meshlets.size() * sizeof(StaticMeshMeshlet));
+		}
+		else
+		{
+			Out.WriteBytes(mesh.Meshlets.data(), mesh.Meshlets.size() * sizeof(StaticMeshMeshlet));
+		}
+
+		AlignTo(Out, CookedDataAlignment);
+		entry.VerticesOffset = Out.GetSize();
+		if (entry.VertexFormat == StaticMeshVertexFormat::Packed)
+		{
+			std::vector<PackedTexturedVertex> packedVertices;
+			packedVertices.reserve(mesh.Vertices.size());
+			for (const TexturedVertex& vertex : mesh.Vertices)
+			{
+				packedVertices.push_back(PackVertex(vertex));
+			}
+			Out.WriteBytes(packedVertices.data(), packedVertices.size() * sizeof(PackedTexturedVertex));
+		}
+		else
+		{
+			Out.WriteBytes(mesh.Vertices.data(), mesh.Vertices.size() * sizeof(TexturedVertex));
+		}
+
+		AlignTo(Out, CookedDataAlignment);
+		entry.IndicesOffset = Out.GetSize();
+		if (entry.IndexSize == sizeof(uint16_t))
+		{
+			const std::vector<uint16_t> narrowIndices(mesh.Indices.begin(), mesh.Indices.end());
+			Out.WriteBytes(narrowIndices.data(), narrowIndices.size() * sizeof(uint16_t));
+		}
+		else
+		{
+			Out.WriteBytes(mesh.Indices.data(), mesh.Indices.size() * sizeof(uint32_t));
+		}
+
+		Out.Patch(entryOffsets[i], entry);
+	}
+
+	return true;
+}
+
+auto MeshCache::RemoveStaleFiles(const Path& InCookedPath) const -> void
+{
+	const std::string fileName = InCookedPath.filename().string();
+	const std::string sourcePrefix = fileName.substr(0, fileName.find('_') + 1);
+
+	std::error_code error;
+	for (const auto& entry : std::filesystem::directory_iterator(CacheDirectory, error))
+	{
+		const std::string name = entry.path().filename().string();
+		if (name != fileName && name.rfind(sourcePrefix, 0) == 0)
+		{
+			// Still mapped by a mesh being loaded fails on Windows, it is removed next time
+			std::error_code removeError;
+			std::filesystem::remove(entry.path(), removeError);
+		}
+	}
+}
+
+auto MeshCache::GetCollectionMutex(const Path& InCollectionPath) -> std::mutex&
+{
+	std::lock_guard lock(CollectionMutexesMutex);
+	std::unique_ptr<std::mutex>& mutex = CollectionMutexes[InCollectionPath];
+	if (mutex == nullptr)
+	{
+		mutex.reset(new std::mutex());
+	}
+	return *mutex;
+}
@@ -0,0 +1,282 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+	// Forsyth's scoring, see "Linear-Speed Vertex Cache Optimisation"
+	constexpr int32_t ForsythCacheSize = 32;
+	constexpr float CacheDecayPower = 1.5f;
+	constexpr float LastTriangleScore = 0.75f;
+	constexpr float ValenceBoostScale = 2.0f;
+	constexpr float ValenceBoostPower = 0.5f;
+
+	auto GetVertexScore(int32_t InCachePosition, uint32_t InRemainingValence) -> float
+	{
+		if (InRemainingValence == 0)
+		{
+			// Not used by any remaining triangle
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (InCachePosition >= 0)
+		{
+			if (InCachePosition < 3)
+			{
+				// Used by the last triangle, a fixed score keeps it from being favoured too much
+				score = LastTriangleScore;
+			}
+			else
+			{
+				const float scaler = 1.0f / (ForsythCacheSize - 3);
+				score = std::pow(1.0f - (InCachePosition - 3) * scaler, CacheDecayPower);
+			}
+		}
+
+		// Vertices with few triangles left are finished first so they don't stay around
+		score += ValenceBoostScale * std::pow(static_cast<float>(InRemainingValence), -ValenceBoostPower);
+		return score;
+	}
+
+	struct VertexBytesHash
+	{
+		const uint8_t* Vertices;
+		size_t VertexSize;
+
+		auto operator()(uint32_t InIndex) const -> size_t
+		{
+			// FNV-1a over the raw vertex
+			const uint8_t* bytes = Vertices + InIndex * VertexSize;
+			uint64_t hash = 14695981039346656037ull;
+			for (size_t i = 0; i < VertexSize; ++i)
+			{
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	struct VertexBytesEqual
+	{
+		const uint8_t* Vertices;
+		size_t VertexSize;
+
+		auto operator()(uint32_t InA, uint32_t InB) const -> bool
+		{
+			return std::memcmp(Vertices + InA * VertexSize, Vertices + InB * VertexSize, VertexSize) == 0;
+		}
+	};
+}
+
+auto MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t>& InIndices, uint32_t InNumVertices, uint32_t InCacheSize) -> VertexCacheStats
+{
+	VertexCacheStats stats;
+	stats.NumTriangles = static_cast<uint32_t>(InIndices.size() / 3);
+
+	// A vertex is in the FIFO while fewer than InCacheSize misses happened since it was added
+	std::vector<uint32_t> addedAt(InNumVertices, 0);
+	std::vector<bool> bReferenced(InNumVertices, false);
+	uint32_t timestamp = InCacheSize + 1;
+
+	for (const uint32_t index : InIndices)
+	{
+		if (!bReferenced[index])
+		{
+			bReferenced[index] = true;
+			++stats.NumVertices;
+		}
+
+		if (timestamp - addedAt[index] > InCacheSize)
+		{
+			addedAt[index] = timestamp++;
+			++stats.NumTransformed;
+		}
+	}
+
+	return stats;
+}
+
+auto MeshOptimizer::GenerateWeldRemap(const void* InVertices, uint32_t InNumVertices, size_t InVertexSize, std::vector<uint32_t>& OutRemap) -> uint32_t
+{
+	const uint8_t* vertices = static_cast<const uint8_t*>(InVertices);
+
+	std::unordered_map<uint32_t, uint32_t, VertexBytesHash, VertexBytesEqual> uniqueVertices(InNumVertices,
+		VertexBytesHash{ vertices, InVertexSize }, VertexBytesEqual{ vertices, InVertexSize });
+
+	OutRemap.resize(InNumVertices);
+
+	uint32_t numUnique = 0;
+	for (uint32_t i = 0; i < InNumVertices; ++i)
+	{
+		auto [found, bInserted] = uniqueVertices.try_emplace(i, numUnique);
+		if (bInserted)
+		{
+			++numUnique;
+		}
+		OutRemap[i] = found->second;
+	}
+
+	return numUnique;
+}
+
+auto MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& InOutIndices, uint32_t InNumVertices) -> void
+{
+	const uint32_t numTriangles = static_cast<uint32_t>(InOutIndices.size() / 3);
+	if (numTriangles == 0)
+	{
+		return;
+	}
+
+	// Triangles of every vertex, in one array
+	std::vector<uint32_t> valence(InNumVertices, 0);
+	for (const uint32_t index : InOutIndices)
+	{
+		++valence[index];
+	}
+
+	std::vector<uint32_t> adjacencyOffsets(InNumVertices + 1, 0);
+	for (uint32_t v = 0; v < InNumVertices; ++v)
+	{
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valence[v];
+	}
+
+	std::vector<uint32_t> adjacency(InOutIndices.size());
+	{
+		std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (uint32_t t = 0; t < numTriangles; ++t)
+		{
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				adjacency[fill[InOutIndices[t * 3 + k]]++] = t;
+			}
+		}
+	}
+
+	// Valence now counts the triangles not emitted yet, adjacency of a vertex is compacted the same way
+	std::vector<int32_t> cachePosition(InNumVertices, -1);
+	std::vector<float> vertexScores(InNumVertices);
+	for (uint32_t v = 0; v < InNumVertices; ++v)
+	{
+		vertexScores[v] = GetVertexScore(-1, valence[v]);
+	}
+
+	std::vector<float> triangleScores(numTriangles);
+	std::vector<bool> bEmitted(numTriangles, false);
+	for (uint32_t t = 0; t < numTriangles; ++t)
+	{
+		triangleScores[t] = vertexScores[InOutIndices[t * 3]] + vertexScores[InOutIndices[t * 3 + 1]] + vertexScores[InOutIndices[t * 3 + 2]];
+	}
+
+	// Vertices in the simulated LRU cache, most recent first, 3 extra slots for the triangle being added
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	cache.reserve(ForsythCacheSize + 3);
+	newCache.reserve(ForsythCacheSize + 3);
+
+	std::vector<uint32_t> optimized;
+	optimized.reserve(InOutIndices.size());
+
+	uint32_t bestTriangle = static_cast<uint32_t>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+	// Next triangle to try when no triangle touching the cache is left, keeps the whole pass linear
+	uint32_t nextUnemitted = 0;
+
+	for (uint32_t emitted = 0; emitted < numTriangles; ++emitted)
+	{
+		if (bestTriangle == MeshOptimizer::InvalidVertexIndex)
+		{
+			while (bEmitted[nextUnemitted])
+			{
+				++nextUnemitted;
+			}
+			bestTriangle = nextUnemitted;
+		}
+
+		const uint32_t* triangle = &InOutIndices[bestTriangle * 3];
+		optimized.insert(optimized.end(), triangle, triangle + 3);
+		bEmitted[bestTriangle] = true;
+
+		newCache.assign(triangle, triangle + 3);
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			const uint32_t v = triangle[k];
+
+			// Drop the triangle from the adjacency of its vertices
+			uint32_t* begin = &adjacency[adjacencyOffsets[v]];
+			uint32_t* end = begin + valence[v];
+			*std::find(begin, end, bestTriangle) = *(end - 1);
+			--valence[v];
+		}
+
+		for (const uint32_t v : cache)
+		{
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+			{
+				newCache.push_back(v);
+			}
+		}
+
+		// Vertices pushed out of the cache lose their cache score
+		for (size_t i = ForsythCacheSize; i < newCache.size(); ++i)
+		{
+			cachePosition[newCache[i]] = -1;
+			vertexScores[newCache[i]] = GetVertexScore(-1, valence[newCache[i]]);
+		}
+		newCache.resize(std::min<size_t>(newCache.size(), ForsythCacheSize));
+		std::swap(cache, newCache);
+
+		for (size_t i = 0; i < cache.size(); ++i)
+		{
+			cachePosition[cache[i]] = static_cast<int32_t>(i);
+			vertexScores[cache[i]] = GetVertexScore(static_cast<int32_t>(i), valence[cache[i]]);
+		}
+
+		// Only triangles using a cached vertex changed, the best of them is next
+		bestTriangle = MeshOptimizer::InvalidVertexIndex;
+		float bestScore = -1.0f;
+		for (const uint32_t v : cache)
+		{
+			for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + valence[v]; ++a)
+			{
+				const uint32_t t = adjacency[a];
+				const float score = vertexScores[InOutIndices[t * 3]] + vertexScores[InOutIndices[t * 3 + 1]] + vertexScores[InOutIndices[t * 3 + 2]];
+				triangleScores[t] = score;
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = t;
+				}
+			}
+		}
+	}
+
+	InOutIndices = std::move(optimized);
+}
+
+auto MeshOptimizer::GenerateFetchRemap(std::vector<uint32_t>& InOutIndices, uint32_t InNumVertices, std::vector<uint32_t>& OutRemap) -> uint32_t
+{
+	OutRemap.assign(InNumVertices, InvalidVertexIndex);
+
+	uint32_t numReferenced = 0;
+	for (uint32_t& index : InOutIndices)
+	{
+		if (OutRemap[index] == InvalidVertexIndex)
+		{
+			OutRemap[index] = numReferenced++;
+		}
+		index = OutRemap[index];
+	}
+
+	return numReferenced;
+}
+
+auto MeshOptimizer::RemapIndices(std::vector<uint32_t>& InOutIndices, const std::vector<uint32_t>& InRemap) -> void
+{
+	for (uint32_t& index : InOutIndices)
+	{
+		index = InRemap[index];
+	}
+}
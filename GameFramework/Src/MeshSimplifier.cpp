@@ -0,0 +1,380 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+	struct Position
+	{
+		double x, y, z;
+	};
+
+	auto Sub(const Position& InA, const Position& InB) -> Position
+	{
+		return Position{ InA.x - InB.x, InA.y - InB.y, InA.z - InB.z };
+	}
+
+	auto Cross(const Position& InA, const Position& InB) -> Position
+	{
+		return Position{ InA.y * InB.z - InA.z * InB.y, InA.z * InB.x - InA.x * InB.z, InA.x * InB.y - InA.y * InB.x };
+	}
+
+	auto Dot(const Position& InA, const Position& InB) -> double
+	{
+		return InA.x * InB.x + InA.y * InB.y + InA.z * InB.z;
+	}
+
+	// Weighted sum of squared distances to a set of planes, as the symmetric 4x4 matrix of (a, b, c, d)
+	struct Quadric
+	{
+		double aa = 0, ab = 0, ac = 0, ad = 0;
+		double bb = 0, bc = 0, bd = 0;
+		double cc = 0, cd = 0;
+		double dd = 0;
+		double weight = 0;
+
+		auto AddPlane(const Position& InNormal, double InD, double InWeight) -> void
+		{
+			aa += InWeight * InNormal.x * InNormal.x;
+			ab += InWeight * InNormal.x * InNormal.y;
+			ac += InWeight * InNormal.x * InNormal.z;
+			ad += InWeight * InNormal.x * InD;
+			bb += InWeight * InNormal.y * InNormal.y;
+			bc += InWeight * InNormal.y * InNormal.z;
+			bd += InWeight * InNormal.y * InD;
+			cc += InWeight * InNormal.z * InNormal.z;
+			cd += InWeight * InNormal.z * InD;
+			dd += InWeight * InD * InD;
+			weight += InWeight;
+		}
+
+		auto operator+=(const Quadric& InOther) -> Quadric&
+		{
+			aa += InOther.aa; ab += InOther.ab; ac += InOther.ac; ad += InOther.ad;
+			bb += InOther.bb; bc += InOther.bc; bd += InOther.bd;
+			cc += InOther.cc; cd += InOther.cd;
+			dd += InOther.dd;
+			weight += InOther.weight;
+			return *this;
+		}
+
+		// Mean squared distance, so errors are in squared position units whatever the triangle areas
+		auto Evaluate(const Position& InPosition) const -> double
+		{
+			if (weight == 0.0)
+			{
+				return 0.0;
+			}
+
+			const double x = InPosition.x, y = InPosition.y, z = InPosition.z;
+			const double error = aa * x * x + bb * y * y + cc * z * z + dd
+				+ 2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z);
+			// Rounding can make it slightly negative
+			return (std::max)(error / weight, 0.0);
+		}
+	};
+
+	struct Collapse
+	{
+		double Cost;
+		uint32_t From;
+		uint32_t To;
+
+		auto operator<(const Collapse& InOther) const -> bool
+		{
+			// Full ordering so the result doesn't depend on the sort implementation
+			if (Cost != InOther.Cost) return Cost < InOther.Cost;
+			if (From != InOther.From) return From < InOther.From;
+			return To < InOther.To;
+		}
+	};
+
+	struct PositionHash
+	{
+		const std::vector<Position>* Positions;
+
+		auto operator()(uint32_t InIndex) const -> size_t
+		{
+			const Position& p = (*Positions)[InIndex];
+			uint64_t hash = 14695981039346656037ull;
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&p);
+			for (size_t i = 0; i < sizeof(Position); ++i)
+			{
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	struct PositionEqual
+	{
+		const std::vector<Position>* Positions;
+
+		auto operator()(uint32_t InA, uint32_t InB) const -> bool
+		{
+			const Position& a = (*Positions)[InA];
+			const Position& b = (*Positions)[InB];
+			return a.x == b.x && a.y == b.y && a.z == b.z;
+		}
+	};
+
+	// Vertices sharing a position with another vertex (attribute seams) or on an edge used by a single
+	// triangle (open borders) or more than two (non manifold) can't be moved
+	auto FindLockedVertices(const std::vector<uint32_t>& InIndices, const std::vector<uint32_t>& InPositionIds) -> std::vector<bool>
+	{
+		const size_t numVertices = InPositionIds.size();
+		std::vector<bool> bLocked(numVertices, false);
+
+		std::vector<uint32_t> numWedges(numVertices, 0);
+		for (uint32_t v = 0; v < numVertices; ++v)
+		{
+			++numWedges[InPositionIds[v]];
+		}
+
+		// Triangles per undirected edge between positions
+		std::unordered_map<uint64_t, uint32_t> edgeUses;
+		edgeUses.reserve(InIndices.size());
+		for (size_t i = 0; i < InIndices.size(); i += 3)
+		{
+			for (size_t k = 0; k < 3; ++k)
+			{
+				const uint32_t a = InPositionIds[InIndices[i + k]];
+				const uint32_t b = InPositionIds[InIndices[i + (k + 1) % 3]];
+				++edgeUses[(uint64_t((std::min)(a, b)) << 32) | (std::max)(a, b)];
+			}
+		}
+
+		std::vector<bool> bLockedPosition(numVertices, false);
+		for (const auto& [edge, uses] : edgeUses)
+		{
+			if (uses != 2)
+			{
+				bLockedPosition[edge >> 32] = true;
+				bLockedPosition[edge & 0xFFFFFFFF] = true;
+			}
+		}
+
+		for (uint32_t v = 0; v < numVertices; ++v)
+		{
+			bLocked[v] = numWedges[InPositionIds[v]] > 1 || bLockedPosition[InPositionIds[v]];
+		}
+
+		return bLocked;
+	}
+
+	auto GetTriangleNormal(const Position& InA, const Position& InB, const Position& InC) -> Position
+	{
+		return Cross(Sub(InB, InA), Sub(InC, InA));
+	}
+}
+
+auto MeshSimplifier::Simplify(const float* InPositions, size_t InPositionStride, uint32_t InNumVertices, const std::vector<uint32_t>& InIndices,
+	size_t InTargetIndexCount, float InTargetError, float* OutError) -> std::vector<uint32_t>
+{
+	std::vector<uint32_t> indices = InIndices;
+	double maxError = 0.0;
+
+	std::vector<Position> positions(InNumVertices);
+	for (uint32_t v = 0; v < InNumVertices; ++v)
+	{
+		const float* p = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(InPositions) + v * InPositionStride);
+		positions[v] = Position{ p[0], p[1], p[2] };
+	}
+
+	// First vertex at every position, quadrics are shared by all vertices at a position
+	std::vector<uint32_t> positionIds(InNumVertices);
+	{
+		std::unordered_map<uint32_t, uint32_t, PositionHash, PositionEqual> firstAtPosition(InNumVertices,
+			PositionHash{ &positions }, PositionEqual{ &positions });
+		for (uint32_t v = 0; v < InNumVertices; ++v)
+		{
+			positionIds[v] = firstAtPosition.try_emplace(v, v).first->second;
+		}
+	}
+
+	const std::vector<bool> bLocked = FindLockedVertices(indices, positionIds);
+
+	std::vector<Quadric> quadrics(InNumVertices);
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		const Position& a = positions[indices[i]];
+		const Position normal = GetTriangleNormal(a, positions[indices[i + 1]], positions[indices[i + 2]]);
+		const double length = std::sqrt(Dot(normal, normal));
+		if (length == 0.0)
+		{
+			continue;
+		}
+
+		// Weighted by area, so small triangles don't dominate
+		const Position unitNormal{ normal.x / length, normal.y / length, normal.z / length };
+		Quadric plane;
+		plane.AddPlane(unitNormal, -Dot(unitNormal, a), length * 0.5);
+		for (size_t k = 0; k < 3; ++k)
+		{
+			quadrics[positionIds[indices[i + k]]] += plane;
+		}
+	}
+
+	const double targetError = double(InTargetError) * double(InTargetError);
+
+	std::vector<uint32_t> adjacencyOffsets(InNumVertices + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<Collapse> collapses;
+	std::vector<uint32_t> remap(InNumVertices);
+	std::vector<bool> bTouched(InNumVertices);
+
+	// Every pass collapses a set of independent edges, cheapest first, then rebuilds the index buffer
+	while (indices.size() > InTargetIndexCount)
+	{
+		const size_t numTriangles = indices.size() / 3;
+
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (const uint32_t index : indices)
+		{
+			++adjacencyOffsets[index + 1];
+		}
+		for (uint32_t v = 0; v < InNumVertices; ++v)
+		{
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		}
+		adjacency.resize(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		collapses.clear();
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (size_t k = 0; k < 3; ++k)
+			{
+				const uint32_t from = indices[i + k];
+				const uint32_t to = indices[i + (k + 1) % 3];
+				for (const auto& [a, b] : { std::pair(from, to), std::pair(to, from) })
+				{
+					if (bLocked[a])
+					{
+						continue;
+					}
+
+					Quadric quadric = quadrics[positionIds[a]];
+					quadric += quadrics[positionIds[b]];
+					const double cost = quadric.Evaluate(positions[b]);
+					if (cost <= targetError)
+					{
+						collapses.push_back(Collapse{ cost, a, b });
+					}
+				}
+			}
+		}
+
+		if (collapses.empty())
+		{
+			break;
+		}
+
+		std::sort(collapses.begin(), collapses.end());
+
+		for (uint32_t v = 0; v < InNumVertices; ++v)
+		{
+			remap[v] = v;
+		}
+		std::fill(bTouched.begin(), bTouched.end(), false);
+
+		// A collapse removes two triangles of a closed surface, stop at the budget
+		const size_t numTrianglesToRemove = numTriangles - InTargetIndexCount / 3;
+		size_t numRemoved = 0;
+
+		for (const Collapse& collapse : collapses)
+		{
+			if (numRemoved >= numTrianglesToRemove)
+			{
+				break;
+			}
+			if (bTouched[collapse.From] || bTouched[collapse.To])
+			{
+				continue;
+			}
+
+			// Triangles around From that stay must not flip
+			bool bFlips = false;
+			size_t numCollapsedTriangles = 0;
+			for (uint32_t a = adjacencyOffsets[collapse.From]; a < adjacencyOffsets[collapse.From + 1]; ++a)
+			{
+				const uint32_t* triangle = &indices[adjacency[a] * 3];
+				if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+				{
+					++numCollapsedTriangles;
+					continue;
+				}
+
+				Position before[3];
+				Position after[3];
+				for (size_t k = 0; k < 3; ++k)
+				{
+					before[k] = positions[triangle[k]];
+					after[k] = triangle[k] == collapse.From ? positions[collapse.To] : before[k];
+				}
+
+				const Position normalBefore = GetTriangleNormal(before[0], before[1], before[2]);
+				const Position normalAfter = GetTriangleNormal(after[0], after[1], after[2]);
+				if (Dot(normalBefore, normalAfter) <= 0.0)
+				{
+					bFlips = true;
+					break;
+				}
+			}
+
+			if (bFlips)
+			{
+				continue;
+			}
+
+			remap[collapse.From] = collapse.To;
+			quadrics[positionIds[collapse.To]] += quadrics[positionIds[collapse.From]];
+			maxError = (std::max)(maxError, collapse.Cost);
+			numRemoved += numCollapsedTriangles;
+
+			// Everything around the collapse changed, it waits for the next pass
+			for (uint32_t a = adjacencyOffsets[collapse.From]; a < adjacencyOffsets[collapse.From + 1]; ++a)
+			{
+				const uint32_t* triangle = &indices[adjacency[a] * 3];
+				bTouched[triangle[0]] = true;
+				bTouched[triangle[1]] = true;
+				bTouched[triangle[2]] = true;
+			}
+		}
+
+		if (numRemoved == 0)
+		{
+			break;
+		}
+
+		size_t write = 0;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const uint32_t a = remap[indices[i]];
+			const uint32_t b = remap[indices[i + 1]];
+			const uint32_t c = remap[indices[i + 2]];
+			if (a != b && b != c && a != c)
+			{
+				indices[write++] = a;
+				indices[write++] = b;
+				indices[write++] = c;
+			}
+		}
+		indices.resize(write);
+	}
+
+	if (OutError)
+	{
+		*OutError = static_cast<float>(std::sqrt(maxError));
+	}
+	return indices;
+}
@@ -0,0 +1,171 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	struct Float3
+	{
+		float x;
+		float y;
+		float z;
+	};
+
+	auto Load(const float* InStream, size_t InStride, uint32_t InIndex) -> Float3
+	{
+		const float* value = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(InStream) + InIndex * InStride);
+		return Float3{ value[0], value[1], value[2] };
+	}
+
+	auto Add(const Float3& InA, const Float3& InB) -> Float3
+	{
+		return Float3{ InA.x + InB.x, InA.y + InB.y, InA.z + InB.z };
+	}
+
+	auto Sub(const Float3& InA, const Float3& InB) -> Float3
+	{
+		return Float3{ InA.x - InB.x, InA.y - InB.y, InA.z - InB.z };
+	}
+
+	auto Dot(const Float3& InA, const Float3& InB) -> float
+	{
+		return InA.x * InB.x + InA.y * InB.y + InA.z * InB.z;
+	}
+
+	auto Cross(const Float3& InA, const Float3& InB) -> Float3
+	{
+		return Float3{ InA.y * InB.z - InA.z * InB.y, InA.z * InB.x - InA.x * InB.z, InA.x * InB.y - InA.y * InB.x };
+	}
+
+	auto Normalized(const Float3& InVector) -> Float3
+	{
+		const float length = std::sqrt(Dot(InVector, InVector));
+		return length > 0.0f ? Float3{ InVector.x / length, InVector.y / length, InVector.z / length } : Float3{ 0.0f, 0.0f, 0.0f };
+	}
+}
+
+auto MeshletBuilder::ComputeMeshletBounds(const float* InPositions, const float* InNormals, size_t InVertexStride,
+	const uint32_t* InIndices, MeshletData& InOutMeshlet) -> void
+{
+	const uint32_t* indices = InIndices + InOutMeshlet.IndexOffset;
+
+	Float3 boundsMin = Load(InPositions, InVertexStride, indices[0]);
+	Float3 boundsMax = boundsMin;
+	for (uint32_t i = 1; i < InOutMeshlet.NumIndices; ++i)
+	{
+		const Float3 p = Load(InPositions, InVertexStride, indices[i]);
+		boundsMin = Float3{ (std::min)(boundsMin.x, p.x), (std::min)(boundsMin.y, p.y), (std::min)(boundsMin.z, p.z) };
+		boundsMax = Float3{ (std::max)(boundsMax.x, p.x), (std::max)(boundsMax.y, p.y), (std::max)(boundsMax.z, p.z) };
+	}
+
+	const Float3 center{ (boundsMin.x + boundsMax.x) * 0.5f, (boundsMin.y + boundsMax.y) * 0.5f, (boundsMin.z + boundsMax.z) * 0.5f };
+	float radius = 0.0f;
+	for (uint32_t i = 0; i < InOutMeshlet.NumIndices; ++i)
+	{
+		const Float3 offset = Sub(Load(InPositions, InVertexStride, indices[i]), center);
+		radius = (std::max)(radius, std::sqrt(Dot(offset, offset)));
+	}
+
+	// Face normals, oriented like the vertex normals so the cone doesn't depend on the winding convention
+	std::vector<Float3> normals;
+	normals.reserve(InOutMeshlet.NumIndices / 3);
+	Float3 axis{ 0.0f, 0.0f, 0.0f };
+	for (uint32_t i = 0; i + 2 < InOutMeshlet.NumIndices; i += 3)
+	{
+		const Float3 a = Load(InPositions, InVertexStride, indices[i]);
+		const Float3 b = Load(InPositions, InVertexStride, indices[i + 1]);
+		const Float3 c = Load(InPositions, InVertexStride, indices[i + 2]);
+
+		Float3 normal = Normalized(Cross(Sub(b, a), Sub(c, a)));
+		const Float3 vertexNormal = Add(Add(Load(InNormals, InVertexStride, indices[i]), Load(InNormals, InVertexStride, indices[i + 1])),
+			Load(InNormals, InVertexStride, indices[i + 2]));
+		if (Dot(normal, vertexNormal) < 0.0f)
+		{
+			normal = Float3{ -normal.x, -normal.y, -normal.z };
+		}
+
+		// Degenerate triangles can't be seen from any side
+		if (Dot(normal, normal) > 0.0f)
+		{
+			normals.push_back(normal);
+			axis = Add(axis, normal);
+		}
+	}
+
+	const Float3 coneAxis = Normalized(axis);
+
+	float minDot = 1.0f;
+	for (const Float3& normal : normals)
+	{
+		minDot = (std::min)(minDot, Dot(normal, coneAxis));
+	}
+
+	InOutMeshlet.Center[0] = center.x;
+	InOutMeshlet.Center[1] = center.y;
+	InOutMeshlet.Center[2] = center.z;
+	InOutMeshlet.Radius = radius;
+	InOutMeshlet.ConeAxis[0] = coneAxis.x;
+	InOutMeshlet.ConeAxis[1] = coneAxis.y;
+	InOutMeshlet.ConeAxis[2] = coneAxis.z;
+
+	// Sine of the cone half angle, widened by 90 degrees: backfacing when the view direction is inside it.
+	// Normals spread over a half space or more never allow culling, 1 makes the test always fail
+	InOutMeshlet.ConeCutoff = normals.empty() || minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+}
+
+auto MeshletBuilder::BuildMeshlets(const float* InPositions, const float* InNormals, size_t InVertexStride,
+	const uint32_t* InIndices, size_t InNumIndices, std::vector<MeshletData>& OutMeshlets) -> void
+{
+	// Vertices of the meshlet being built, a linear search is fine at 64 entries
+	uint32_t meshletVertices[MaxMeshletVertices];
+	uint32_t numMeshletVertices = 0;
+
+	auto isInMeshlet = [&](uint32_t InIndex)
+	{
+		return std::find(meshletVertices, meshletVertices + numMeshletVertices, InIndex) != meshletVertices + numMeshletVertices;
+	};
+
+	MeshletData meshlet;
+
+	for (size_t i = 0; i + 2 < InNumIndices; i += 3)
+	{
+		const uint32_t* triangle = InIndices + i;
+
+		uint32_t numNewVertices = 0;
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			const bool bRepeated = (k > 0 && triangle[k] == triangle[0]) || (k > 1 && triangle[k] == triangle[1]);
+			numNewVertices += !bRepeated && !isInMeshlet(triangle[k]) ? 1 : 0;
+		}
+
+		if (meshlet.NumIndices > 0
+			&& (numMeshletVertices + numNewVertices > MaxMeshletVertices || meshlet.NumIndices / 3 >= MaxMeshletTriangles))
+		{
+			ComputeMeshletBounds(InPositions, InNormals, InVertexStride, InIndices, meshlet);
+			OutMeshlets.push_back(meshlet);
+			meshlet = MeshletData();
+			numMeshletVertices = 0;
+		}
+
+		if (meshlet.NumIndices == 0)
+		{
+			meshlet.IndexOffset = static_cast<uint32_t>(i);
+		}
+
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			if (!isInMeshlet(triangle[k]))
+			{
+				meshletVertices[numMeshletVertices++] = triangle[k];
+			}
+		}
+		meshlet.NumIndices += 3;
+	}
+
+	if (meshlet.NumIndices > 0)
+	{
+		ComputeMeshletBounds(InPositions, InNormals, InVertexStride, InIndices, meshlet);
+		OutMeshlets.push_back(meshlet);
+	}
+}
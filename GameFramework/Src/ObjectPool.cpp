@@ -0,0 +1,163 @@
+#include "ObjectPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+FixedBlockPool::FixedBlockPool(size_t InBlockSize, size_t InBlocksPerSlab, const char* InTypeName)
+	: TypeName(InTypeName)
+	, BlockSize(std::max(InBlockSize, sizeof(FreeBlock)))
+	, BlocksPerSlab(InBlocksPerSlab)
+{
+}
+
+auto FixedBlockPool::Allocate() -> void*
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+
+	if (FreeList == nullptr)
+	{
+		AddSlab();
+	}
+
+	FreeBlock* block = FreeList;
+	FreeList = block->Next;
+
+	PeakUsedBlocks = std::max(PeakUsedBlocks, ++NumUsedBlocks);
+
+	return block;
+}
+
+auto FixedBlockPool::Free(void* InBlock) -> void
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+
+	assert(NumUsedBlocks > 0);
+
+	FreeBlock* block = static_cast<FreeBlock*>(InBlock);
+	block->Next = FreeList;
+	FreeList = block;
+
+	--NumUsedBlocks;
+}
+
+auto FixedBlockPool::GetStats() const -> Stats
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+
+	Stats stats;
+	stats.TypeName = TypeName;
+	stats.BlockSize = BlockSize;
+	stats.NumSlabs = Slabs.size();
+	stats.NumBlocks = Slabs.size() * BlocksPerSlab;
+	stats.NumUsedBlocks = NumUsedBlocks;
+	stats.PeakUsedBlocks = PeakUsedBlocks;
+	return stats;
+}
+
+auto FixedBlockPool::AddSlab() -> void
+{
+	// operator new[] for std::byte gives at least __STDCPP_DEFAULT_NEW_ALIGNMENT__ (16 bytes on x64)
+	Slabs.emplace_back(new std::byte[BlockSize * BlocksPerSlab]);
+	std::byte* slab = Slabs.back().get();
+
+	// Link blocks in address order so that consecutive spawns land next to each other
+	for (size_t i = BlocksPerSlab; i > 0; --i)
+	{
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * BlockSize);
+		block->Next = FreeList;
+		FreeList = block;
+	}
+}
+
+auto ObjectPools::GetBlockSize(size_t InSize) -> size_t
+{
+	return sizeof(BlockHeader) + ((InSize + BlockAlignment - 1) & ~(BlockAlignment - 1));
+}
+
+auto ObjectPools::Allocate(size_t InSize) -> void*
+{
+	return Allocate(InSize > MaxPooledSize ? nullptr : GetInstance()->GetSizePool(InSize), InSize);
+}
+
+auto ObjectPools::Allocate(FixedBlockPool* InPool, size_t InSize) -> void*
+{
+	BlockHeader* header = static_cast<BlockHeader*>(InPool ? InPool->Allocate() : ::operator new(GetBlockSize(InSize)));
+	header->Pool = InPool;
+	return header + 1;
+}
+
+auto ObjectPools::Free(void* InObject) -> void
+{
+	if (InObject == nullptr)
+	{
+		return;
+	}
+
+	BlockHeader* header = static_cast<BlockHeader*>(InObject) - 1;
+	if (header->Pool == nullptr)
+	{
+		::operator delete(header);
+		return;
+	}
+
+	header->Pool->Free(header);
+}
+
+auto ObjectPools::GetStats() -> std::vector<FixedBlockPool::Stats>
+{
+	ObjectPools* pools = GetInstance();
+	std::lock_guard<std::mutex> lock(pools->Mutex);
+
+	std::vector<FixedBlockPool::Stats> stats;
+	stats.reserve(pools->Pools.size());
+	for (const std::unique_ptr<FixedBlockPool>& pool : pools->Pools)
+	{
+		stats.push_back(pool->GetStats());
+	}
+
+	std::sort(stats.begin(), stats.end(),
+		[](const FixedBlockPool::Stats& a, const FixedBlockPool::Stats& b) { return a.BlockSize < b.BlockSize; });
+
+	return stats;
+}
+
+auto ObjectPools::CreateTypePool(size_t InSize, const char* InTypeName) -> FixedBlockPool*
+{
+	if (InSize > MaxPooledSize)
+	{
+		return nullptr;
+	}
+
+	const size_t blockSize = GetBlockSize(InSize);
+
+	std::lock_guard<std::mutex> lock(Mutex);
+
+	// Roughly 64KB slabs, but never less than 16 objects per slab
+	const size_t blocksPerSlab = std::max<size_t>(16, (64 * 1024) / blockSize);
+	Pools.push_back(std::make_unique<FixedBlockPool>(blockSize, blocksPerSlab, InTypeName));
+	return Pools.back().get();
+}
+
+auto ObjectPools::GetSizePool(size_t InSize) -> FixedBlockPool*
+{
+	std::atomic<FixedBlockPool*>& slot = SizePools[(InSize + BlockAlignment - 1) / BlockAlignment - 1];
+	if (FixedBlockPool* pool = slot.load(std::memory_order_acquire))
+	{
+		return pool;
+	}
+
+	const size_t blockSize = GetBlockSize(InSize);
+
+	std::lock_guard<std::mutex> lock(Mutex);
+
+	// Another thread may have created it meanwhile
+	if (FixedBlockPool* pool = slot.load(std::memory_order_relaxed))
+	{
+		return pool;
+	}
+
+	const size_t blocksPerSlab = std::max<size_t>(16, (64 * 1024) / blockSize);
+	Pools.push_back(std::make_unique<FixedBlockPool>(blockSize, blocksPerSlab));
+	slot.store(Pools.back().get(), std::memory_order_release);
+	return Pools.back().get();
+}
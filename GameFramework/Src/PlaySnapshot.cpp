@@ -0,0 +1,157 @@
+#include "PlaySnapshot.h"
+
+#include "Actor.h"
+#include "Component.h"
+#include "CreateCommon.h"
+#include "Game.h"
+#include "LightBase.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+auto PlaySnapshot::Begin(Game& InGame) -> void
+{
+	Clear();
+
+	// Epochs only grow, so objects recorded in a previous session are recorded again
+	RecordingEpoch = ++LastEpoch;
+
+	if (InGame.dr)
+	{
+		DirLightState = InGame.dr->Serialize();
+	}
+
+	ActorOrder.reserve(InGame.Actors.size());
+	for (Actor* actor : InGame.Actors)
+	{
+		ActorOrder.push_back(actor->GetId());
+
+		const bool restoreInPlace = actor->GetMonoActor() == nullptr && std::all_of(actor->Components.begin(), actor->Components.end(),
+			[](const Component* component) { return component->CanRestoreInPlace(); });
+
+		if (!restoreInPlace)
+		{
+			actor->NotifyModified();
+		}
+	}
+}
+
+auto PlaySnapshot::Restore(Game& InGame) -> void
+{
+	// Nothing done while restoring may be recorded
+	RecordingEpoch = 0;
+
+	const std::vector<std::string_view> strings(Records.GetStrings().begin(), Records.GetStrings().end());
+
+	LastStats.NumSpawnedActors = SpawnedActors.size();
+	LastStats.NumRecordedActors = ActorRecords.size();
+	LastStats.NumRecordedComponents = ComponentRecords.size();
+	LastStats.RecordedBytes = Records.GetSize();
+
+	// Newest first, like a level unload
+	for (auto it = SpawnedActors.rbegin(); it != SpawnedActors.rend(); ++it)
+	{
+		delete InGame.ResolveActor(*it);
+	}
+
+	for (const auto& [id, range] : ActorRecords)
+	{
+		delete InGame.FindActorById(id);
+
+		BinaryReader reader = MakeReader(range, strings);
+		Actor* actor = CreateActor<Actor>();
+		actor->SetUuid(reader.ReadUuid());
+		actor->DeserializeBinary(reader);
+	}
+
+	if (!ActorRecords.empty())
+	{
+		RestoreActorOrder(InGame);
+	}
+
+	// Recorded before the first change, so they also fix components of actors recorded later on
+	for (const auto& [id, range] : ComponentRecords)
+	{
+		Component* component = InGame.GetComponentHandles()->FindObjectById(id);
+		if (component == nullptr || !component->CanRestoreInPlace())
+		{
+			continue;
+		}
+
+		BinaryReader reader = MakeReader(range, strings);
+		component->DeserializeBinary(reader);
+		component->OnDeserializationCompleted();
+	}
+
+	if (InGame.dr && !DirLightState.is_null())
+	{
+		InGame.dr->Deserialize(&DirLightState);
+	}
+
+	Clear();
+}
+
+auto PlaySnapshot::RecordComponent(Component* InComponent) -> void
+{
+	const uint32_t offset = static_cast<uint32_t>(Records.GetSize());
+	InComponent->SerializeBinary(Records);
+
+	ComponentRecords.push_back({ InComponent->GetId(), BlobRange{ offset, static_cast<uint32_t>(Records.GetSize()) - offset } });
+}
+
+auto PlaySnapshot::RecordActor(Actor* InActor) -> void
+{
+	const uint32_t offset = static_cast<uint32_t>(Records.GetSize());
+	InActor->SerializeBinary(Records);
+
+	ActorRecords.push_back({ InActor->GetId(), BlobRange{ offset, static_cast<uint32_t>(Records.GetSize()) - offset } });
+}
+
+auto PlaySnapshot::OnActorSpawned(Actor* InActor) -> void
+{
+	SpawnedActors.push_back(InActor->GetHandle());
+}
+
+auto PlaySnapshot::Clear() -> void
+{
+	Records = BinaryWriter();
+	ActorRecords.clear();
+	ComponentRecords.clear();
+	SpawnedActors.clear();
+	ActorOrder.clear();
+	DirLightState = json();
+}
+
+auto PlaySnapshot::RestoreActorOrder(Game& InGame) const -> void
+{
+	// Recreated actors were appended, the others kept their relative order
+	std::vector<Actor*> ordered;
+	ordered.reserve(InGame.Actors.size());
+	for (const uuids::uuid& id : ActorOrder)
+	{
+		if (Actor* actor = InGame.FindActorById(id))
+		{
+			ordered.push_back(actor);
+		}
+	}
+
+	// Only actors that weren't there when play started are left, they stay at the end
+	if (ordered.size() != InGame.Actors.size())
+	{
+		const std::unordered_set<Actor*> placed(ordered.begin(), ordered.end());
+		for (Actor* actor : InGame.Actors)
+		{
+			if (placed.count(actor) == 0)
+			{
+				ordered.push_back(actor);
+			}
+		}
+	}
+
+	InGame.Actors.swap(ordered);
+}
+
+auto PlaySnapshot::MakeReader(const BlobRange& InRange, const std::vector<std::string_view>& InStrings) const -> BinaryReader
+{
+	return BinaryReader(Records.GetBuffer().data() + InRange.Offset, InRange.Size, &InStrings);
+}
@@ -0,0 +1,64 @@
+#include "RenderQueue.h"
+
+#include <cstring>
+
+auto RenderQueue::MakeSortKey(RenderPass InPass, const RenderDrawKey& InDrawKey) -> uint64_t
+{
+	// The bits of a non negative float sort like its value, the top 16 keep the exponent and 7 bits of mantissa
+	const float depth = InDrawKey.Depth > 0.0f ? InDrawKey.Depth : 0.0f;
+	uint32_t depthBits;
+	std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+	// Shader 0 tells the renderers without a draw key apart, ids that wrap around to it move to 1
+	const uint32_t shader = InDrawKey.ShaderId == 0 || (InDrawKey.ShaderId & 0xfff) != 0 ? InDrawKey.ShaderId & 0xfff : 1;
+
+	return (uint64_t(static_cast<uint32_t>(InPass) & 0xf) << 60)
+		| (uint64_t(shader) << 48)
+		| (uint64_t(InDrawKey.MaterialId & 0xffff) << 32)
+		| (uint64_t(InDrawKey.MeshId & 0xffff) << 16)
+		| uint64_t(depthBits >> 16);
+}
+
+auto RenderQueue::Sort() -> void
+{
+	const size_t numItems = Items.size();
+	if (numItems < 2)
+	{
+		return;
+	}
+
+	// All byte histograms in one read of the keys
+	uint32_t counts[8][256] = {};
+	for (const Item& item : Items)
+	{
+		for (uint32_t byte = 0; byte < 8; ++byte)
+		{
+			++counts[byte][(item.Key >> (byte * 8)) & 0xff];
+		}
+	}
+
+	Scratch.resize(numItems);
+	for (uint32_t byte = 0; byte < 8; ++byte)
+	{
+		// Every item has the same value in this byte, the order wouldn't change
+		const uint32_t* byteCounts = counts[byte];
+		if (byteCounts[(Items[0].Key >> (byte * 8)) & 0xff] == numItems)
+		{
+			continue;
+		}
+
+		uint32_t offsets[256];
+		uint32_t offset = 0;
+		for (uint32_t value = 0; value < 256; ++value)
+		{
+			offsets[value] = offset;
+			offset += byteCounts[value];
+		}
+
+		for (const Item& item : Items)
+		{
+			Scratch[offsets[(item.Key >> (byte * 8)) & 0xff]++] = item;
+		}
+		Items.swap(Scratch);
+	}
+}
@@ -133,7 +133,12 @@ void RenderingSystem::RegisterRenderer(Renderer* InRenderer)
 
 void RenderingSystem::UnregisterRenderer(Renderer* InRenderer)
 {
-	Renderers.erase(std::remove(Renderers.begin(), Renderers.end(), InRenderer), Renderers.end());
+	// Search from the back: renderers mostly go away in reverse creation order (level unload), which keeps that linear
+	const auto found = std::find(Renderers.rbegin(), Renderers.rend(), InRenderer);
+	if (found != Renderers.rend())
+	{
+		Renderers.erase(std::next(found).base());
+	}
 }
 
 void RenderingSystem::RegisterLight(LightBase* Light)
@@ -187,14 +192,9 @@ void RenderingSystem::PerformShadowmapPass()
 
 	RenderingSystemContext rsContext;
 	rsContext.OverridePixelShader = nullptr;
+	rsContext.View = &cam;
 
-	for (Renderer* renderer : Renderers)
-	{
-		if (renderer != nullptr && renderer->bCastShadow)
-		{
-			renderer->Render(rsContext);
-		}
-	}
+	SubmitRenderers(rsContext, RenderPass::Shadow, true);
 
 	MyGame->bIsRenderingShadowMap = false;
 }
@@ -262,11 +262,9 @@ void RenderingSystem::PerformForwardOpaquePass()
 
 	RenderingSystemContext rsContext;
 	rsContext.ShaderFlags = static_cast<int>(ShaderFlag::ForwardRendering | ShaderFlag::DirectionalLight);
+	rsContext.View = &cam;
 
-	for (Renderer* renderer : Renderers)
-	{
-		renderer->Render(rsContext);
-	}
+	SubmitRenderers(rsContext, RenderPass::Forward);
 }
 
 void RenderingSystem::PerformOpaquePass(float DeltaTime)
@@ -320,11 +318,10 @@ void RenderingSystem::PerformOpaquePass(float DeltaTime)
 
 	RenderingSystemContext rsContext;
 	rsContext.ShaderFlags = static_cast<int>(ShaderFlag::DeferredOpaque);
+	rsContext.View = &cam;
+	rsContext.bCullBackFaces = true;
 
-	for (Renderer* renderer : Renderers)
-	{
-		renderer->Render(rsContext);
-	}
+	SubmitRenderers(rsContext, RenderPass::Opaque);
 }
 
 void RenderingSystem::PerformLightingPass(float DeltaTime)
@@ -461,6 +458,44 @@ void RenderingSystem::PerformLightingPass(float DeltaTime)
 	}
 }
 
+void RenderingSystem::SubmitRenderers(const RenderingSystemContext& RSContext, RenderPass Pass, bool bShadowCastersOnly)
+{
+	renderQueue.Clear();
+	for (Renderer* renderer : Renderers)
+	{
+		if (renderer == nullptr || (bShadowCastersOnly && !renderer->bCastShadow))
+		{
+			continue;
+		}
+
+		RenderDrawKey drawKey;
+		if (!renderer->GetDrawKey(RSContext, drawKey))
+		{
+			drawKey = RenderDrawKey();
+		}
+		renderQueue.Add(RenderQueue::MakeSortKey(Pass, drawKey), renderer);
+	}
+	renderQueue.Sort();
+
+	RenderingSystemContext sortedContext = RSContext;
+	sortedContext.StateCache = &stateCache;
+	stateCache.Reset();
+
+	for (const RenderQueue::Item& item : renderQueue.GetItems())
+	{
+		if (RenderQueue::HasDrawKey(item.Key))
+		{
+			item.Owner->Render(sortedContext);
+		}
+		else
+		{
+			// Binds its own state behind the back of the cache
+			item.Owner->Render(RSContext);
+			stateCache.Reset();
+		}
+	}
+}
+
 void RenderingSystem::PerformDebugPass()
 {
 	ID3D11DeviceContext* context = MyGame->GetD3DDeviceContext().Get();
@@ -544,6 +579,9 @@ void RenderingSystem::Draw(float DeltaTime, const Camera* InCamera)
 
 	context->ClearState();
 
+	// Loaded textures and streamed mips replace the placeholders before anything is drawn with them
+	materials.Update();
+
 	PerformShadowmapPass();
 
 	PerformOpaquePass(DeltaTime);
@@ -1,7 +1,38 @@
 ﻿#include <Serializer.h>
 
+#include "Actor.h"
 #include "Component.h"
+#include "ComponentRegistry.h"
+#include "DirectoryTree.h"
 #include "Game.h"
+#include "BinaryArchive.h"
+
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+	// Walks the level data the way Game::DeserializeBinary reads it, without creating anything
+	auto ValidateBinaryLevel(BinaryReader in) -> bool
+	{
+		const uint32_t numActors = in.Read<uint32_t>();
+		in.Read<uint32_t>();
+		for (uint32_t i = 0; i < numActors && in.IsValid(); ++i)
+		{
+			if (!Actor::SkipBinary(in))
+			{
+				return false;
+			}
+		}
+
+		if (in.Read<uint8_t>() != 0)
+		{
+			in.Skip(in.Read<uint32_t>());
+		}
+
+		return in.IsValid();
+	}
+}
 
 json Serializer::Serialize(const Game* game)
 {
@@ -13,21 +44,126 @@ void Serializer::Deserialize(const json* in, Game& game, bool destructive)
 	game.Deserialize(in, destructive);
 }
 
-void Serializer::SaveToFile(Path path, const Game* game)
+bool Serializer::SaveToFile(Path path, const Game* game)
 {
-	create_directories(path.parent_path());
+	if (IsBinaryLevelPath(path))
+	{
+		return SaveToBinaryFile(path, game);
+	}
+
+	std::error_code error;
+	create_directories(path.parent_path(), error);
 
 	std::ofstream out(path);
 	out << std::setw(4) << Serialize(game) << std::endl;
 	out.close();
+	return !out.fail();
 }
 
 void Serializer::ReadFromFile(Path path, Game* game, bool destructive)
 {
 	assert(exists(path) && "Provided file doesn't exist");
 
+	if (IsBinaryLevelPath(path))
+	{
+		ReadFromBinaryFile(path, game, destructive);
+		return;
+	}
+
 	std::ifstream in(path);
 	const json data = json::parse(in);
 
 	game->Deserialize(&data, destructive);
 }
+
+bool Serializer::IsBinaryLevelPath(const Path& path)
+{
+	return path.extension() == Path(".nlevel");
+}
+
+std::vector<uint8_t> Serializer::SerializeBinary(const Game* game)
+{
+	BinaryWriter writer;
+
+	// Patched with the string table position once the level data is written
+	writer.Write(BinaryLevelHeader{});
+	game->SerializeBinary(writer);
+
+	return LevelConverter::Finish(writer);
+}
+
+bool Serializer::DeserializeBinary(const uint8_t* data, size_t size, Game& game, bool destructive)
+{
+	BinaryLevelHeader header;
+	std::vector<std::string_view> strings;
+	if (!LevelConverter::ReadStrings(data, size, header, strings))
+	{
+		std::cout << "Not a binary level, unsupported version or broken string table" << std::endl;
+		return false;
+	}
+
+	BinaryReader reader(data + sizeof(header), header.StringTableOffset - sizeof(header), &strings);
+	if (!ValidateBinaryLevel(reader))
+	{
+		std::cout << "Malformed binary level or unknown component type, the level is left as it is" << std::endl;
+		return false;
+	}
+
+	game.DeserializeBinary(reader, destructive);
+	return reader.IsValid();
+}
+
+bool Serializer::SaveToBinaryFile(Path path, const Game* game)
+{
+	std::error_code error;
+	create_directories(path.parent_path(), error);
+
+	return WriteFileAtomically(path, SerializeBinary(game));
+}
+
+bool Serializer::ReadFromBinaryFile(Path path, Game* game, bool destructive)
+{
+	MappedFile file;
+	if (!file.Open(path))
+	{
+		std::cout << "Failed to map the level file " << path.string() << std::endl;
+		return false;
+	}
+
+	return DeserializeBinary(file.GetData(), file.GetSize(), *game, destructive);
+}
+
+bool Serializer::ConvertLevel(const Path& from, const Path& to)
+{
+	if (IsBinaryLevelPath(from) == IsBinaryLevelPath(to))
+	{
+		std::error_code error;
+		return std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing, error);
+	}
+
+	if (IsBinaryLevelPath(to))
+	{
+		std::ifstream in(from);
+		const json level = json::parse(in, nullptr, false);
+		std::vector<uint8_t> data;
+		if (level.is_discarded() || !LevelConverter::JsonToBinary(level, ComponentRegistry::GetBinaryConverters(), data))
+		{
+			return false;
+		}
+
+		return WriteFileAtomically(to, data);
+	}
+
+	MappedFile file;
+	json level;
+	if (!file.Open(from) || !LevelConverter::BinaryToJson(file.GetData(), file.GetSize(), ComponentRegistry::GetBinaryConverters(), level))
+	{
+		return false;
+	}
+	level["AssetType"] = AssetType::Level;
+
+	std::stringstream out;
+	out << std::setw(4) << level << std::endl;
+	const std::string text = out.str();
+	return WriteFileAtomically(to, std::vector<uint8_t>(text.begin(), text.end()));
+}
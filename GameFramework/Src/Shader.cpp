@@ -245,3 +245,75 @@ void TexturedVertexShader::Initialize(ID3DBlob* ByteCode, ShaderFlag Flags)
 	}
 	
 }
+
+void PackedTexturedVertexShader::Initialize(ID3DBlob* ByteCode, ShaderFlag Flags)
+{
+	VertexShader::Initialize(ByteCode, Flags);
+
+	D3D11_INPUT_ELEMENT_DESC inputElements[] =
+	{
+		D3D11_INPUT_ELEMENT_DESC
+		{
+			"POSITION",
+			0,
+			DXGI_FORMAT_R16G16B16A16_FLOAT,
+			0,
+			0,
+			D3D11_INPUT_PER_VERTEX_DATA,
+			0
+		},
+		D3D11_INPUT_ELEMENT_DESC
+		{
+			"NORMAL",
+			0,
+			DXGI_FORMAT_R16G16_SNORM,
+			0,
+			D3D11_APPEND_ALIGNED_ELEMENT,
+			D3D11_INPUT_PER_VERTEX_DATA,
+			0
+		},
+		D3D11_INPUT_ELEMENT_DESC
+		{
+			"TANGENT",
+			0,
+			DXGI_FORMAT_R16G16_SNORM,
+			0,
+			D3D11_APPEND_ALIGNED_ELEMENT,
+			D3D11_INPUT_PER_VERTEX_DATA,
+			0
+		},
+		D3D11_INPUT_ELEMENT_DESC
+		{
+			"TEXCOORD",
+			0,
+			DXGI_FORMAT_R16G16_FLOAT,
+			0,
+			D3D11_APPEND_ALIGNED_ELEMENT,
+			D3D11_INPUT_PER_VERTEX_DATA,
+			0
+		}
+	};
+
+	ComPtr<ID3D11Device> device = Game::GetInstance()->GetD3DDevice();
+
+	if (Flags == ShaderFlag::None)
+	{
+		device->CreateInputLayout(
+			inputElements,
+			4,
+			ByteCode->GetBufferPointer(),
+			ByteCode->GetBufferSize(),
+			InputLayout.GetAddressOf()
+		);
+	}
+	else if ((Flags & ShaderFlag::DeferredLighting) != ShaderFlag::None)
+	{
+		device->CreateInputLayout(
+			inputElements,
+			1,
+			ByteCode->GetBufferPointer(),
+			ByteCode->GetBufferSize(),
+			PositionOnlyInputLayout.GetAddressOf()
+		);
+	}
+}
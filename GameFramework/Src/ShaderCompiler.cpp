@@ -104,6 +104,16 @@ void ShaderCompiler::AddMacro(const D3D_SHADER_MACRO& Macro)
 
 void ShaderCompiler::ClearMacros()
 {
-	Macros.clear();
+	Macros = BaseMacros;
 	Macros.push_back({ nullptr, nullptr });
 }
+
+void ShaderCompiler::AddBaseMacro(const D3D_SHADER_MACRO& Macro)
+{
+	BaseMacros.push_back(Macro);
+}
+
+void ShaderCompiler::ClearBaseMacros()
+{
+	BaseMacros.clear();
+}
@@ -1,132 +1,151 @@
 #include "StaticMesh.h"
 
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-
+#include "AssetManager.h"
 #include "Game.h"
+#include "MeshCache.h"
+
+#include <iostream>
+
+struct StaticMesh::ImportedData
+{
+	CookedMeshCollection collection;
+	CookedMeshView mesh;
+};
+
+StaticMesh::StaticMesh() = default;
+
+StaticMesh::~StaticMesh() = default;
+
+auto StaticMesh::LoadData() -> bool
+{
+	return ImportMesh();
+}
+
+auto StaticMesh::FinishLoad() -> bool
+{
+	if (importedData == nullptr)
+	{
+		return false;
+	}
+
+	const CookedMeshView& mesh = importedData->mesh;
+	AssetMemoryUsage usage;
+	usage.CpuBytes = sizeof(StaticMeshRenderData) + mesh.NumLods * (sizeof(StaticMeshLod) + mesh.NumSections * sizeof(StaticMeshSection))
+		+ mesh.NumMeshlets * sizeof(StaticMeshMeshlet);
+	usage.GpuBytes = mesh.NumVertices * mesh.VertexSize + mesh.NumIndices * mesh.IndexSize;
+
+	if (!CreateRenderData())
+	{
+		return false;
+	}
+
+	SetMemoryUsage(usage);
+	return true;
+}
 
-auto StaticMesh::CreateRenderData() -> void
+auto StaticMesh::Unload() -> void
+{
+	renderData.reset();
+	importedData.reset();
+	SetMemoryUsage({});
+}
+
+auto StaticMesh::ImportMesh() -> bool
 {
-	Assimp::Importer importer;
 	// todo: check if the asset is part of a collection first and move such functionality to Asset class
 	Path pathToCollection = GetFullPath();
 	pathToCollection._Remove_filename_and_separator();
-	const aiScene* scene = importer.ReadFile(pathToCollection.string(), aiProcess_FlipUVs | aiProcess_FlipWindingOrder | aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_CalcTangentSpace);
 
-	if (scene == nullptr)
+	std::unique_ptr<ImportedData> imported(new ImportedData());
+
+	MeshCache* meshCache = Game::GetInstance()->GetAssetManager()->GetMeshCache();
+	if (!meshCache->Open(pathToCollection, imported->collection))
+	{
+		return false;
+	}
+
+	if (!imported->collection.FindMesh(GetFullPath().filename().string(), imported->mesh))
 	{
-		return;
+		return false;
 	}
 
-	const Path name = GetFullPath().filename();
+	importedData = std::move(imported);
+	return true;
+}
 
-	std::vector<const aiNode*> stack;
-	stack.push_back(scene->mRootNode);
-	while (!stack.empty())
+auto StaticMesh::CreateRenderData() -> bool
+{
+	if (importedData == nullptr)
 	{
-		const aiNode* node = stack.back();
-		stack.pop_back();
-
-		stack.insert(stack.end(), node->mChildren, node->mChildren + node->mNumChildren);
-
-		// node: make sure to use mesh name here, not node name just like in asset manager
-		if (node->mNumMeshes > 0 && name.string()._Equal(scene->mMeshes[node->mMeshes[0]]->mName.C_Str()))
-		{
-			std::vector<TexturedVertex> vertices;
-			std::vector<UINT> indices;
-
-			renderData.reset(new StaticMeshRenderData());
-			renderData->vertexSize = sizeof(vertices[0]);
-
-			for (size_t meshIndex = 0; meshIndex < node->mNumMeshes; ++meshIndex)
-			{
-				const aiMesh* mesh = scene->mMeshes[node->mMeshes[meshIndex]];
-
-				StaticMeshSection& section = renderData->sections.emplace_back();
-				section.materialIndex = mesh->mMaterialIndex;
-				section.indicesStart = indices.size();
-				section.numIndices = mesh->mNumFaces * 3;
-				section.vertexStart = vertices.size();
-
-				for (size_t i = 0; i < mesh->mNumVertices; ++i) {
-					TexturedVertex v;
-
-					v.Position.x = mesh->mVertices[i].x;
-					v.Position.y = mesh->mVertices[i].y;
-					v.Position.z = mesh->mVertices[i].z;
-
-					v.Normal.x = mesh->mNormals[i].x;
-					v.Normal.y = mesh->mNormals[i].y;
-					v.Normal.z = mesh->mNormals[i].z;
-
-					// it seems that sometime bitanagents and tangents cannot be calculated - possibly when there're no UV's
-					if (mesh->mBitangents)
-					{
-						v.Binormal.x = mesh->mBitangents[i].x;
-						v.Binormal.y = mesh->mBitangents[i].y;
-						v.Binormal.z = mesh->mBitangents[i].z;
-					}
-
-					if (mesh->mTangents)
-					{
-						v.Tangent.x = mesh->mTangents[i].x;
-						v.Tangent.y = mesh->mTangents[i].y;
-						v.Tangent.z = mesh->mTangents[i].z;
-					}
-
-					vertices.push_back(v);
-				}
-
-				if (mesh->mTextureCoords != nullptr && mesh->mTextureCoords[0] != nullptr) {
-					for (size_t i = 0; i < mesh->mNumVertices; ++i) {
-						vertices[i].TexCoord.x = mesh->mTextureCoords[0][i].x;
-						vertices[i].TexCoord.y = mesh->mTextureCoords[0][i].y;
-					}
-				}
-
-				
-
-				for (size_t i = 0; i < mesh->mNumFaces; ++i) {
-					indices.push_back(mesh->mFaces[i].mIndices[0]);
-					indices.push_back(mesh->mFaces[i].mIndices[1]);
-					indices.push_back(mesh->mFaces[i].mIndices[2]);
-				}
-			}
-
-			D3D11_BUFFER_DESC vertexBufDesc = {};
-			vertexBufDesc.Usage = D3D11_USAGE_DEFAULT;
-			vertexBufDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-			vertexBufDesc.CPUAccessFlags = 0;
-			vertexBufDesc.MiscFlags = 0;
-			vertexBufDesc.StructureByteStride = 0;
-			vertexBufDesc.ByteWidth = vertices.size() * renderData->vertexSize;
-
-			D3D11_SUBRESOURCE_DATA vertexData = {};
-			vertexData.pSysMem = vertices.data();
-			vertexData.SysMemPitch = 0;
-			vertexData.SysMemSlicePitch = 0;
-
-			ComPtr<ID3D11Device> device = Game::GetInstance()->GetD3DDevice();
-			device->CreateBuffer(&vertexBufDesc, &vertexData, renderData->vertexBuffer.GetAddressOf());
-
-			D3D11_BUFFER_DESC indexBufDesc = {};
-			indexBufDesc.Usage = D3D11_USAGE_DEFAULT;
-			indexBufDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-			indexBufDesc.CPUAccessFlags = 0;
-			indexBufDesc.MiscFlags = 0;
-			indexBufDesc.StructureByteStride = 0;
-			indexBufDesc.ByteWidth = sizeof(indices[0]) * static_cast<UINT>(indices.size());
-
-			D3D11_SUBRESOURCE_DATA indexData = {};
-			indexData.pSysMem = indices.data();
-			indexData.SysMemPitch = 0;
-			indexData.SysMemSlicePitch = 0;
-
-			device->CreateBuffer(&indexBufDesc, &indexData, renderData->indexBuffer.GetAddressOf());
-
-			break;
-		}
+		return false;
 	}
 
+	// Uploaded straight from the mapped cache file, unmapped when this returns
+	const std::unique_ptr<ImportedData> imported = std::move(importedData);
+	const CookedMeshView& mesh = imported->mesh;
+	if (mesh.NumVertices == 0 || mesh.NumIndices == 0)
+	{
+		std::cout << "Mesh " << GetFullPath() << " has no triangles" << std::endl;
+		return false;
+	}
+
+	renderData.reset(new StaticMeshRenderData());
+	renderData->lods.resize(mesh.NumLods);
+	for (uint32_t lod = 0; lod < mesh.NumLods; ++lod)
+	{
+		const StaticMeshSection* sections = mesh.Sections + lod * mesh.NumSections;
+		renderData->lods[lod].maxScreenSize = mesh.Lods[lod].MaxScreenSize;
+		renderData->lods[lod].error = mesh.Lods[lod].Error;
+		renderData->lods[lod].sections.assign(sections, sections + mesh.NumSections);
+	}
+	renderData->meshlets.assign(mesh.Meshlets, mesh.Meshlets + mesh.NumMeshlets);
+	renderData->boundsCenter = mesh.BoundsCenter;
+	renderData->boundsRadius = mesh.BoundsRadius;
+	renderData->vertexSize = mesh.VertexSize;
+	renderData->vertexFormat = mesh.VertexFormat;
+	renderData->indexFormat = mesh.IndexSize == sizeof(uint16_t) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+	D3D11_BUFFER_DESC vertexBufDesc = {};
+	vertexBufDesc.Usage = D3D11_USAGE_DEFAULT;
+	vertexBufDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufDesc.CPUAccessFlags = 0;
+	vertexBufDesc.MiscFlags = 0;
+	vertexBufDesc.StructureByteStride = 0;
+	vertexBufDesc.ByteWidth = mesh.NumVertices * renderData->vertexSize;
+
+	D3D11_SUBRESOURCE_DATA vertexData = {};
+	vertexData.pSysMem = mesh.Vertices;
+	vertexData.SysMemPitch = 0;
+	vertexData.SysMemSlicePitch = 0;
+
+	ComPtr<ID3D11Device> device = Game::GetInstance()->GetD3DDevice();
+	HRESULT hr = device->CreateBuffer(&vertexBufDesc, &vertexData, renderData->vertexBuffer.GetAddressOf());
+	if (FAILED(hr))
+	{
+		std::cout << "Failed to create the vertex buffer of " << GetFullPath() << ", error 0x" << std::hex << hr << std::dec << std::endl;
+		renderData.reset();
+		return false;
+	}
+
+	D3D11_BUFFER_DESC indexBufDesc = {};
+	indexBufDesc.Usage = D3D11_USAGE_DEFAULT;
+	indexBufDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	indexBufDesc.CPUAccessFlags = 0;
+	indexBufDesc.MiscFlags = 0;
+	indexBufDesc.StructureByteStride = 0;
+	indexBufDesc.ByteWidth = mesh.IndexSize * mesh.NumIndices;
+
+	D3D11_SUBRESOURCE_DATA indexData = {};
+	indexData.pSysMem = mesh.Indices;
+	indexData.SysMemPitch = 0;
+	indexData.SysMemSlicePitch = 0;
+
+	hr = device->CreateBuffer(&indexBufDesc, &indexData, renderData->indexBuffer.GetAddressOf());
+	if (FAILED(hr))
+	{
+		std::cout << "Failed to create the index buffer of " << GetFullPath() << ", error 0x" << std::hex << hr << std::dec << std::endl;
+		renderData.reset();
+		return false;
+	}
+	return true;
 }
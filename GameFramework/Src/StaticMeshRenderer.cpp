@@ -1,6 +1,7 @@
 #include "StaticMeshRenderer.h"
 
 #include "AssetManager.h"
+#include "Camera.h"
 #include "Game.h"
 #include "RenderingSystemTypes.h"
 #include "Shader.h"
@@ -9,6 +10,73 @@
 #include "EngineContentRegistry.h"
 #include "AlbedoTexture.h"
 #include "NormalTexture.h"
+#include "BinaryArchive.h"
+#include "RenderQueue.h"
+#include "TextureArrayTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <limits>
+
+namespace
+{
+	// Planes of the clip volume in world space, pointing inwards
+	struct ViewFrustum
+	{
+		Vector4 Planes[6];
+
+		auto Intersects(const Vector3& InCenter, float InRadius) const -> bool
+		{
+			for (const Vector4& plane : Planes)
+			{
+				if (plane.x * InCenter.x + plane.y * InCenter.y + plane.z * InCenter.z + plane.w < -InRadius)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	auto GetViewFrustum(const Camera& InView) -> ViewFrustum
+	{
+		// Gribb and Hartmann: row vectors, so clip = world * M and every plane is a sum of columns of M
+		const Matrix m = InView.GetViewMatrix() * InView.GetProjectionMatrix();
+		const Vector4 x{ m._11, m._21, m._31, m._41 };
+		const Vector4 y{ m._12, m._22, m._32, m._42 };
+		const Vector4 z{ m._13, m._23, m._33, m._43 };
+		const Vector4 w{ m._14, m._24, m._34, m._44 };
+
+		// D3D clip space depth goes from 0 to w
+		ViewFrustum frustum;
+		frustum.Planes[0] = w + x;
+		frustum.Planes[1] = w - x;
+		frustum.Planes[2] = w + y;
+		frustum.Planes[3] = w - y;
+		frustum.Planes[4] = z;
+		frustum.Planes[5] = w - z;
+
+		for (Vector4& plane : frustum.Planes)
+		{
+			plane /= std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		}
+		return frustum;
+	}
+
+	// Remembers the value in the state cache, false when it is bound already
+	template<class T>
+	auto ShouldBind(const RenderStateCache& InState, T*& InOutBound, T* InValue) -> bool
+	{
+		if (InState.bValid && InOutBound == InValue)
+		{
+			return false;
+		}
+		InOutBound = InValue;
+		return true;
+	}
+}
 
 StaticMeshRenderer::StaticMeshRenderer()
 {
@@ -16,30 +84,90 @@ StaticMeshRenderer::StaticMeshRenderer()
 	Game::GetInstance()->MyRenderingSystem->RegisterRenderer(this);
 }
 
+StaticMeshRenderer::~StaticMeshRenderer() = default;
+
+auto StaticMeshRenderer::SetStaticMesh(StaticMesh* inStaticMesh) -> void
+{
+	NotifyModified();
+	staticMesh = inStaticMesh;
+}
+
 auto StaticMeshRenderer::Render(const RenderingSystemContext& RSContext) -> void
 {
-	if (mVertexShader == nullptr || mPixelShader == nullptr || staticMesh == nullptr || staticMesh->GetRenderData() == nullptr)
+	RefreshMaterial();
+
+	// A mesh that is still loading isn't drawn
+	if (mVertexShader == nullptr || mPixelShader == nullptr || !material || !staticMesh || staticMesh->GetRenderData() == nullptr)
+	{
+		return;
+	}
+
+	const StaticMeshRenderData* renderData = staticMesh->GetRenderData();
+	EngineContentRegistry* content = EngineContentRegistry::GetInstance();
+	if (renderData->vertexFormat == StaticMeshVertexFormat::Packed && mVertexShader != content->GetDefaultVertexShader()
+		&& mVertexShader != replacedVertexShader)
+	{
+		std::cout << "Mesh " << staticMesh->GetFullPath() << " has packed vertices, it is drawn with the packed vertex shader instead of the custom one" << std::endl;
+		replacedVertexShader = mVertexShader;
+	}
+
+	const float screenDiameter = GetScreenDiameter(*renderData, RSContext);
+	if (!CullMeshlets(*renderData, SelectLod(*renderData, screenDiameter), RSContext))
 	{
 		return;
 	}
 
 	Game* game = Game::GetInstance();
 
+	// Texture streaming loads the mips this size needs, shadow maps don't sample the textures
+	if (!game->bIsRenderingShadowMap)
+	{
+		if (material->GetAlbedoTexture() && material->GetAlbedoTexture()->IsLoaded())
+		{
+			material->GetAlbedoTexture()->RequestResolution(screenDiameter);
+		}
+		if (material->GetNormalTexture() && material->GetNormalTexture()->IsLoaded())
+		{
+			material->GetNormalTexture()->RequestResolution(screenDiameter);
+		}
+	}
+
 	ComPtr<ID3D11DeviceContext> context = game->GetD3DDeviceContext();
-	ComPtr<ID3D11SamplerState> defaultSamplerState = game->GetDefaultSamplerState();
 
-	context->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	// Draws of a sorted queue only bind what the previous one left different, a renderer drawn on its own binds everything
+	RenderStateCache unsortedState;
+	RenderStateCache& state = RSContext.StateCache != nullptr ? *RSContext.StateCache : unsortedState;
+
+	if (!state.bValid)
+	{
+		context->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		context->PSSetConstantBuffers(2, 1, game->GetPerObjectConstantBuffer().GetAddressOf());
+		context->VSSetConstantBuffers(2, 1, game->GetPerObjectConstantBuffer().GetAddressOf());
+		context->PSSetSamplers(0, 1, game->GetDefaultSamplerState().GetAddressOf());
 
-	mVertexShader->UseShader(static_cast<ShaderFlag>(RSContext.ShaderFlags));
+		// todo: render the scene with override material instead of using a bool
+		if (!game->bIsRenderingShadowMap)
+		{
+			context->PSSetShaderResources(1, 1, game->GetShadowMapSRV().GetAddressOf());
+			context->PSSetSamplers(1, 1, game->GetShadowmapSamplerState().GetAddressOf());
+		}
+	}
 
-	PixelShader* psToUse = RSContext.OverridePixelShader.value_or(mPixelShader);
-	if (psToUse == nullptr)
+	const DrawShaders shaders = SelectShaders(*renderData, RSContext);
+	if (ShouldBind(state, state.VS, shaders.VS))
 	{
-		context->PSSetShader(nullptr, nullptr, 0);
+		shaders.VS->UseShader(static_cast<ShaderFlag>(RSContext.ShaderFlags));
 	}
-	else
+	if (ShouldBind(state, state.PS, shaders.PS))
 	{
-		psToUse->UseShader(static_cast<ShaderFlag>(RSContext.ShaderFlags));
+		if (shaders.PS == nullptr)
+		{
+			context->PSSetShader(nullptr, nullptr, 0);
+		}
+		else
+		{
+			shaders.PS->UseShader(static_cast<ShaderFlag>(RSContext.ShaderFlags));
+		}
 	}
 
 	// Update constant buffer with world matrix
@@ -47,7 +175,9 @@ auto StaticMeshRenderer::Render(const RenderingSystemContext& RSContext) -> void
 	cbData.ObjectToWorld = GetTransform().GetTransformMatrixTransposed();
 	cbData.Color = mColor;
 	cbData.NormalObjectToWorld = GetTransform().GetNormalMatrixTransposed();
-	cbData.Mat = Mat;
+	cbData.Mat = materialDesc.Params;
+	cbData.AlbedoSlice = material->GetAlbedoArraySlot().Slice;
+	cbData.NormalSlice = material->GetNormalArraySlot().Slice;
 
 	D3D11_MAPPED_SUBRESOURCE resource = {};
 	auto res = context->Map(game->GetPerObjectConstantBuffer().Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &resource);
@@ -56,37 +186,205 @@ auto StaticMeshRenderer::Render(const RenderingSystemContext& RSContext) -> void
 
 	context->Unmap(game->GetPerObjectConstantBuffer().Get(), 0);
 
-	const StaticMeshRenderData* renderData = staticMesh->GetRenderData();
+	if (ShouldBind(state, state.IndexBuffer, renderData->indexBuffer.Get()))
+	{
+		context->IASetIndexBuffer(renderData->indexBuffer.Get(), renderData->indexFormat, 0);
+	}
+	if (ShouldBind(state, state.VertexBuffer, renderData->vertexBuffer.Get()))
+	{
+		UINT offsets[] = {0};
+		context->IASetVertexBuffers(0, 1, renderData->vertexBuffer.GetAddressOf(), &renderData->vertexSize, offsets);
+	}
 
-	context->IASetIndexBuffer(renderData->indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
-	UINT offsets[] = {0};
-	context->IASetVertexBuffers(0, 1, renderData->vertexBuffer.GetAddressOf(), &renderData->vertexSize, offsets);
+	// Textures, nothing samples them without a pixel shader
+	if (shaders.PS != nullptr && !(RSContext.ShaderFlags & static_cast<int>(ShaderFlag::DeferredLighting)))
+	{
+		TextureArrayTable* textureArrays = game->MyRenderingSystem->GetTextureArrayTable();
+		ID3D11ShaderResourceView* textures[] =
+		{
+			shaders.bTextureArrays ? textureArrays->GetPageSRV(material->GetAlbedoArraySlot().Page) : material->GetAlbedoSRV(),
+			shaders.bTextureArrays ? textureArrays->GetPageSRV(material->GetNormalArraySlot().Page) : material->GetNormalSRV(),
+			mSpecularSRV.Get()
+		};
+		const UINT slots[] = { 0, 2, 3 };
 
-	context->PSSetConstantBuffers(2, 1, game->GetPerObjectConstantBuffer().GetAddressOf());
-	context->VSSetConstantBuffers(2, 1, game->GetPerObjectConstantBuffer().GetAddressOf());
+		for (size_t i = 0; i < std::size(slots); ++i)
+		{
+			if (ShouldBind(state, state.PSResources[slots[i]], textures[i]))
+			{
+				context->PSSetShaderResources(slots[i], 1, &textures[i]);
+			}
+		}
+	}
 
-	// Textures
-	if (!(RSContext.ShaderFlags & static_cast<int>(ShaderFlag::DeferredLighting)))
-		context->PSSetShaderResources(0, 1, mAlbedoSRV.GetAddressOf());
-	context->PSSetSamplers(0, 1, defaultSamplerState.GetAddressOf());
+	state.bValid = true;
 
-	if (!(RSContext.ShaderFlags & static_cast<int>(ShaderFlag::DeferredLighting)))
-		context->PSSetShaderResources(2, 1, mNormalSRV.GetAddressOf());
+	for (const StaticMeshSection& range : visibleRanges)
+	{
+		context->DrawIndexed(range.numIndices, range.indicesStart, range.vertexStart);
+	}
+}
 
-	if (!(RSContext.ShaderFlags & static_cast<int>(ShaderFlag::DeferredLighting)))
-		context->PSSetShaderResources(3, 1, mSpecularSRV.GetAddressOf());
+auto StaticMeshRenderer::GetDrawKey(const RenderingSystemContext& RSContext, RenderDrawKey& OutKey) -> bool
+{
+	RefreshMaterial();
 
-	// todo: render the scene with override material instead of using a bool
-	if (!game->bIsRenderingShadowMap)
+	// Not drawn, Render returns right away
+	const StaticMeshRenderData* renderData = staticMesh ? staticMesh->GetRenderData() : nullptr;
+	if (mVertexShader == nullptr || mPixelShader == nullptr || !material || renderData == nullptr)
+	{
+		return false;
+	}
+
+	// 6 bits of each shader id, there are only a handful of shaders
+	const DrawShaders shaders = SelectShaders(*renderData, RSContext);
+	OutKey.ShaderId = (shaders.VS->GetShaderId() << 6) | (shaders.PS != nullptr ? shaders.PS->GetShaderId() & 0x3f : 0);
+	// Without a pixel shader the material isn't bound, draws of a mesh go together
+	OutKey.MaterialId = shaders.PS != nullptr ? material->GetId() : 0;
+	OutKey.MeshId = staticMesh->GetMeshId();
+	if (RSContext.View != nullptr)
+	{
+		OutKey.Depth = Vector3::Distance(Vector3::Transform(renderData->boundsCenter, GetWorldMatrix()), RSContext.View->Transform.Position);
+	}
+	return true;
+}
+
+auto StaticMeshRenderer::SelectShaders(const StaticMeshRenderData& renderData, const RenderingSystemContext& RSContext) const -> DrawShaders
+{
+	EngineContentRegistry* content = EngineContentRegistry::GetInstance();
+
+	// Packed vertices need their own input layout and decode
+	DrawShaders shaders;
+	shaders.VS = renderData.vertexFormat == StaticMeshVertexFormat::Packed ? content->GetPackedVertexShader() : mVertexShader;
+	shaders.PS = RSContext.OverridePixelShader.value_or(mPixelShader);
+
+	// With both textures in the texture arrays, materials whose textures share pages bind the same views
+	shaders.bTextureArrays = shaders.PS != nullptr && shaders.PS == content->GetDefaultPixelShader()
+		&& material->GetAlbedoArraySlot().IsValid() && material->GetNormalArraySlot().IsValid()
+		&& !(RSContext.ShaderFlags & static_cast<int>(ShaderFlag::DeferredLighting));
+	if (shaders.bTextureArrays)
+	{
+		shaders.PS = content->GetTextureArrayPixelShader();
+	}
+	return shaders;
+}
+
+auto StaticMeshRenderer::GetScreenDiameter(const StaticMeshRenderData& renderData, const RenderingSystemContext& RSContext) const -> float
+{
+	if (RSContext.View == nullptr)
+	{
+		return (std::numeric_limits<float>::max)();
+	}
+
+	const Matrix& objectToWorld = GetWorldMatrix();
+	const Vector3 center = Vector3::Transform(renderData.boundsCenter, objectToWorld);
+	const float scale = (std::max)({ objectToWorld.Right().Length(), objectToWorld.Up().Length(), objectToWorld.Backward().Length() });
+	const float radius = renderData.boundsRadius * scale;
+
+	// Clip space w of the center: the view depth for perspective projections, 1 for orthographic ones
+	const Matrix projection = RSContext.View->GetProjectionMatrix();
+	const Vector3 viewCenter = Vector3::Transform(center, RSContext.View->GetViewMatrix());
+	const float w = viewCenter.z * projection._34 + projection._44;
+	const bool bPerspective = projection._44 == 0.0f;
+	if (bPerspective && w <= radius)
+	{
+		// The view is inside or right next to the bounds
+		return (std::numeric_limits<float>::max)();
+	}
+
+	// Projected radius in NDC units, two of which span the viewport height, doubled for the diameter
+	return radius * projection._22 / w * Game::GetInstance()->GetScreenHeight();
+}
+
+auto StaticMeshRenderer::SelectLod(const StaticMeshRenderData& renderData, float screenDiameter) const -> const StaticMeshLod&
+{
+	if (renderData.lods.size() == 1)
+	{
+		return renderData.lods[0];
+	}
+
+	// Fraction of the viewport height covered by the bounding sphere, in the reference height the thresholds use
+	const float screenSize = screenDiameter / StaticMeshLodReferenceHeight;
+
+	size_t lod = 0;
+	while (lod + 1 < renderData.lods.size() && screenSize <= renderData.lods[lod + 1].maxScreenSize)
+	{
+		++lod;
+	}
+	return renderData.lods[lod];
+}
+
+auto StaticMeshRenderer::CullMeshlets(const StaticMeshRenderData& renderData, const StaticMeshLod& lod, const RenderingSystemContext& RSContext) -> bool
+{
+	visibleRanges.clear();
+	if (RSContext.View == nullptr)
+	{
+		visibleRanges.assign(lod.sections.begin(), lod.sections.end());
+		return true;
+	}
+
+	const Matrix& objectToWorld = GetWorldMatrix();
+	const float scaleX = objectToWorld.Right().Length();
+	const float scaleY = objectToWorld.Up().Length();
+	const float scaleZ = objectToWorld.Backward().Length();
+	const float maxScale = (std::max)({ scaleX, scaleY, scaleZ });
+	const float minScale = (std::min)({ scaleX, scaleY, scaleZ });
+
+	const ViewFrustum frustum = GetViewFrustum(*RSContext.View);
+	if (!frustum.Intersects(Vector3::Transform(renderData.boundsCenter, objectToWorld), renderData.boundsRadius * maxScale))
 	{
-		context->PSSetShaderResources(1, 1, game->GetShadowMapSRV().GetAddressOf());
-		context->PSSetSamplers(1, 1, game->GetShadowmapSamplerState().GetAddressOf());
+		return false;
 	}
 
-	for (const StaticMeshSection& section : renderData->sections)
+	// Normal cones only stay cones under uniform scale, and an orthographic view has no eye position to test from
+	const bool bPerspective = RSContext.View->GetProjectionMatrix()._44 == 0.0f;
+	const bool bConeCulling = RSContext.bCullBackFaces && bPerspective && minScale > 0.0f && maxScale - minScale <= 0.01f * maxScale;
+	const Vector3 eye = RSContext.View->Transform.Position;
+
+	for (const StaticMeshSection& section : lod.sections)
 	{
-		context->DrawIndexed(section.numIndices, section.indicesStart, section.vertexStart);
+		if (section.numMeshlets == 0)
+		{
+			visibleRanges.push_back(section);
+			continue;
+		}
+
+		bool bExtendsLastRange = false;
+		for (uint32_t i = section.meshletStart; i < section.meshletStart + section.numMeshlets; ++i)
+		{
+			const StaticMeshMeshlet& meshlet = renderData.meshlets[i];
+			const Vector3 center = Vector3::Transform(meshlet.center, objectToWorld);
+			const float radius = meshlet.radius * maxScale;
+
+			bool bVisible = frustum.Intersects(center, radius);
+			if (bVisible && bConeCulling)
+			{
+				const Vector3 axis = Vector3::TransformNormal(meshlet.coneAxis, objectToWorld) / maxScale;
+				const Vector3 toCenter = center - eye;
+				bVisible = toCenter.Dot(axis) < meshlet.coneCutoff * toCenter.Length() + radius;
+			}
+
+			if (!bVisible)
+			{
+				bExtendsLastRange = false;
+				continue;
+			}
+
+			if (bExtendsLastRange)
+			{
+				visibleRanges.back().numIndices += meshlet.numIndices;
+			}
+			else
+			{
+				StaticMeshSection& range = visibleRanges.emplace_back(section);
+				range.indicesStart = section.indicesStart + meshlet.indexOffset;
+				range.numIndices = meshlet.numIndices;
+			}
+			bExtendsLastRange = true;
+		}
 	}
+
+	return !visibleRanges.empty();
 }
 
 auto StaticMeshRenderer::SetMeshPath(std::string meshPath) -> void
@@ -95,81 +393,145 @@ auto StaticMeshRenderer::SetMeshPath(std::string meshPath) -> void
 	EngineContentRegistry* content = EngineContentRegistry::GetInstance();
 	SetPixelShader(content->GetDefaultPixelShader());
 	SetVertexShader(content->GetDefaultVertexShader());
-	if (!mAlbedoSRV)
-		SetAlbedoSRV(content->GetWhiteTexSRV());
-	if (!mNormalSRV)
-	SetNormalSRV(content->GetBasicNormalTexSRV());
+	UpdateMaterial();
 }
 
 auto StaticMeshRenderer::SetTexturePath(std::string texturePath) -> void
 {
-	if (texturePath == "") {
-		SetAlbedoSRV(nullptr);
-		return;
-	}
-	auto am = Game::GetInstance()->GetAssetManager();
-	this->texturePath = texturePath;
-	auto at = am->LoadAlbedoTexture(texturePath);
-	if (at) {
-		SetAlbedoSRV(at->GetSRV());
-	}
-	else
+	NotifyModified();
+	// Loaded right away for the editor, the material picks it up from the asset manager
+	if (!texturePath.empty())
 	{
-		SetAlbedoSRV(nullptr);
+		Game::GetInstance()->GetAssetManager()->LoadAlbedoTexture(texturePath);
 	}
+	materialDesc.AlbedoPath = texturePath;
+	UpdateMaterial();
 }
 
 auto StaticMeshRenderer::SetNormalPath(std::string normalPath) -> void
 {
-	if (normalPath == "") {
-		SetNormalSRV(nullptr);
-		return;
-	}
-	auto am = Game::GetInstance()->GetAssetManager();
-	this->normalPath = normalPath;
-	auto at = am->LoadNormalTexture(normalPath);
-	if (at) {
-		SetNormalSRV(at->GetSRV());
-	}
-	else
+	NotifyModified();
+	if (!normalPath.empty())
 	{
-		SetNormalSRV(nullptr);
+		Game::GetInstance()->GetAssetManager()->LoadNormalTexture(normalPath);
 	}
+	materialDesc.NormalPath = normalPath;
+	UpdateMaterial();
+}
+
+auto StaticMeshRenderer::SetMaterialParams(const LitMaterial& params) -> void
+{
+	NotifyModified();
+	materialDesc.Params = params;
+	UpdateMaterial();
 }
 
 json StaticMeshRenderer::Serialize() const
 {
+	const LitMaterial& params = materialDesc.Params;
 	auto out = Renderer::Serialize();
 	out["mesh_path"] = GetStaticMesh() ? GetStaticMesh()->GetFullPath() : "";
-	out["texture_path"] = texturePath;
-	out["normal_path"] = normalPath;
-	out["mat_ambient"] = Mat.ambientCoef;
-	out["mat_diffuse"] = Mat.diffuesCoef;
-	out["mat_specular"] = Mat.specularCoef;
-	out["mat_specular_exp"] = Mat.specularExponent;
+	out["texture_path"] = materialDesc.AlbedoPath;
+	out["normal_path"] = materialDesc.NormalPath;
+	out["mat_ambient"] = params.ambientCoef;
+	out["mat_diffuse"] = params.diffuesCoef;
+	out["mat_specular"] = params.specularCoef;
+	out["mat_specular_exp"] = params.specularExponent;
 	return out;
 }
 
 void StaticMeshRenderer::Deserialize(const json* in)
 {
-	auto path = in->at("mesh_path").get<Path>();
-	SetStaticMesh(Game::GetInstance()->GetAssetManager()->LoadStaticMesh(path));
+	LitMaterial& params = materialDesc.Params;
+	params.ambientCoef = in->at("mat_ambient");
+	params.diffuesCoef = in->at("mat_diffuse");
+	params.specularCoef = in->at("mat_specular");
+	params.specularExponent = in->at("mat_specular_exp");
+	ApplyAssetPaths(in->at("mesh_path").get<Path>(), in->at("texture_path").get<std::string>(), in->at("normal_path").get<std::string>());
+	Renderer::Deserialize(in);
+}
+
+void StaticMeshRenderer::SerializeBinary(BinaryWriter& out) const
+{
+	SerializeSceneBinary(out);
+	// Paths repeat across a level, they go to the string table
+	out.WriteStringRef(GetStaticMesh() ? GetStaticMesh()->GetFullPath().string() : "");
+	out.WriteStringRef(materialDesc.AlbedoPath);
+	out.WriteStringRef(materialDesc.NormalPath);
+	out.Write(materialDesc.Params);
+}
+
+void StaticMeshRenderer::DeserializeBinary(BinaryReader& in)
+{
+	DeserializeSceneBinary(in);
+	const std::string_view meshPath = in.ReadStringRef();
+	const std::string_view texPath = in.ReadStringRef();
+	const std::string_view normPath = in.ReadStringRef();
+	const LitMaterial params = in.Read<LitMaterial>();
+
+	if (!in.IsValid())
+	{
+		return;
+	}
+
+	materialDesc.Params = params;
+	ApplyAssetPaths(Path(meshPath), std::string(texPath), std::string(normPath));
+}
+
+void StaticMeshRenderer::ConvertJsonToBinary(const json& in, BinaryWriter& out)
+{
+	ConvertSceneJsonToBinary(in, out);
+	out.WriteStringRef(in.at("mesh_path").get<Path>().string());
+	out.WriteStringRef(in.at("texture_path").get<std::string>());
+	out.WriteStringRef(in.at("normal_path").get<std::string>());
+
+	LitMaterial params;
+	params.ambientCoef = in.at("mat_ambient");
+	params.diffuesCoef = in.at("mat_diffuse");
+	params.specularCoef = in.at("mat_specular");
+	params.specularExponent = in.at("mat_specular_exp");
+	out.Write(params);
+}
+
+json StaticMeshRenderer::ConvertBinaryToJson(BinaryReader& in)
+{
+	json out = ConvertSceneBinaryToJson(in);
+	out["mesh_path"] = Path(in.ReadStringRef());
+	out["texture_path"] = std::string(in.ReadStringRef());
+	out["normal_path"] = std::string(in.ReadStringRef());
+
+	const LitMaterial params = in.Read<LitMaterial>();
+	out["mat_ambient"] = params.ambientCoef;
+	out["mat_diffuse"] = params.diffuesCoef;
+	out["mat_specular"] = params.specularCoef;
+	out["mat_specular_exp"] = params.specularExponent;
+	return out;
+}
+
+auto StaticMeshRenderer::ApplyAssetPaths(const Path& meshPath, const std::string& texPath, const std::string& normPath) -> void
+{
 	EngineContentRegistry* content = EngineContentRegistry::GetInstance();
+
+	SetStaticMesh(Game::GetInstance()->GetAssetManager()->RequestStaticMesh(meshPath));
 	SetPixelShader(content->GetDefaultPixelShader());
 	SetVertexShader(content->GetDefaultVertexShader());
-	auto texPath = in->at("texture_path");
-	SetTexturePath(texPath);
-	if (mAlbedoSRV == nullptr) {
-		SetAlbedoSRV(content->GetWhiteTexSRV());
-	}
-	texPath = in->at("normal_path");
-	SetNormalPath(texPath);
-	if (mNormalSRV == nullptr) {
-		SetNormalSRV(content->GetBasicNormalTexSRV());
-	}
-	Mat.ambientCoef = in->at("mat_ambient");
-	Mat.diffuesCoef = in->at("mat_diffuse");
-	Mat.specularCoef = in->at("mat_specular");
-	Mat.specularExponent = in->at("mat_specular_exp");
-	Renderer::Deserialize(in);
+
+	materialDesc.AlbedoPath = texPath;
+	materialDesc.NormalPath = normPath;
+	UpdateMaterial();
+}
+
+auto StaticMeshRenderer::UpdateMaterial() -> void
+{
+	materialDesc.VS = mVertexShader;
+	materialDesc.PS = mPixelShader;
+	material = Game::GetInstance()->MyRenderingSystem->GetMaterialRegistry()->Acquire(materialDesc);
+}
+
+auto StaticMeshRenderer::RefreshMaterial() -> void
+{
+	if (!material || materialDesc.VS != mVertexShader || materialDesc.PS != mPixelShader)
+	{
+		UpdateMaterial();
+	}
 }
@@ -0,0 +1,128 @@
+#include "StreamedTexture.h"
+#include "AssetManager.h"
+#include "BinaryArchive.h"
+#include "DdsFile.h"
+#include "Game.h"
+#include "RenderingSystem.h"
+#include "TextureStreamer.h"
+#include "TextureUtils.h"
+
+auto StreamedTexture::RequestResolution(float InPixels) -> void
+{
+	if (Streamer != nullptr)
+	{
+		Streamer->RequestResolution(StreamingId, InPixels);
+	}
+}
+
+auto StreamedTexture::LoadCookedTexture(ID3D11Device* InDevice, const Path& InCookedPath) -> bool
+{
+	LoadedCookedPath.clear();
+	LoadedMipBytes.clear();
+
+	MappedFile file;
+	DdsTextureInfo info;
+	if (!file.Open(InCookedPath) || !ParseDdsTexture(file.GetData(), file.GetSize(), info))
+	{
+		// Loaded whole, DDSTextureLoader knows more kinds of files
+		const HRESULT hr = LoadDdsTexture(InDevice, InCookedPath, LoadedTex.GetAddressOf(), LoadedTexSRV.GetAddressOf());
+		return SUCCEEDED(hr) && LoadedTexSRV != nullptr;
+	}
+
+	// Read only here, the residency settings are changed before textures load
+	const TextureResidency& residency = Game::GetInstance()->GetAssetManager()->GetTextureStreamer()->GetResidency();
+	const uint32_t tailMip = residency.GetTailMip(info.Width, info.Height, info.MipLevels, GetDdsMaxFirstMip(info));
+
+	const HRESULT hr = CreateTextureFromDds(InDevice, info, tailMip, LoadedTex.GetAddressOf(), LoadedTexSRV.GetAddressOf());
+	if (FAILED(hr) || LoadedTexSRV == nullptr)
+	{
+		return false;
+	}
+
+	// Small textures are all tail
+	if (tailMip > 0)
+	{
+		LoadedCookedPath = InCookedPath;
+		LoadedWidth = info.Width;
+		LoadedHeight = info.Height;
+		LoadedTailMip = tailMip;
+		LoadedMipBytes.assign(info.MipLevels, 0);
+		for (size_t i = 0; i < info.Subresources.size(); ++i)
+		{
+			LoadedMipBytes[i % info.MipLevels] += info.Subresources[i].SlicePitch;
+		}
+	}
+	return true;
+}
+
+auto StreamedTexture::FinishLoad() -> bool
+{
+	// A reload starts over from the tail of the new file
+	StopStreaming();
+
+	Tex = std::move(LoadedTex);
+	TexSRV = std::move(LoadedTexSRV);
+
+	if (!LoadedCookedPath.empty() && TexSRV != nullptr)
+	{
+		Streamer = Game::GetInstance()->GetAssetManager()->GetTextureStreamer();
+		StreamingId = Streamer->Register(this, LoadedCookedPath, LoadedWidth, LoadedHeight, std::move(LoadedMipBytes), LoadedTailMip);
+	}
+	LoadedCookedPath.clear();
+	LoadedMipBytes.clear();
+	UpdateArraySlot();
+	UpdateMemoryUsage();
+
+	return TexSRV != nullptr;
+}
+
+auto StreamedTexture::Unload() -> void
+{
+	StopStreaming();
+	Tex.Reset();
+	TexSRV.Reset();
+	UpdateArraySlot();
+	SetMemoryUsage({});
+}
+
+auto StreamedTexture::PublishMips(ComPtr<ID3D11Resource> InTex, ComPtr<ID3D11ShaderResourceView> InTexSRV) -> void
+{
+	Tex = std::move(InTex);
+	TexSRV = std::move(InTexSRV);
+	UpdateArraySlot();
+	UpdateMemoryUsage();
+	BumpGeneration();
+}
+
+auto StreamedTexture::StopStreaming() -> void
+{
+	if (Streamer != nullptr)
+	{
+		Streamer->Unregister(StreamingId);
+	}
+	Streamer = nullptr;
+	StreamingId = TextureResidency::InvalidId;
+}
+
+auto StreamedTexture::UpdateArraySlot() -> void
+{
+	TextureArrayTable* arrays = Game::GetInstance()->MyRenderingSystem->GetTextureArrayTable();
+
+	// Added before the old slice is freed, a texture alone in its page keeps the page when its size didn't change
+	TextureArraySlot slot;
+	if (Tex != nullptr && !IsStreamed())
+	{
+		arrays->Add(Tex.Get(), slot);
+	}
+	arrays->Remove(ArraySlot);
+	ArraySlot = slot;
+}
+
+auto StreamedTexture::UpdateMemoryUsage() -> void
+{
+	const TextureArrayTable* arrays = Game::GetInstance()->MyRenderingSystem->GetTextureArrayTable();
+
+	AssetMemoryUsage usage;
+	usage.GpuBytes = GetTextureMemorySize(Tex.Get()) + arrays->GetSliceMemorySize(ArraySlot);
+	SetMemoryUsage(usage);
+}
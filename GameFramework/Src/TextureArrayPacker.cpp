@@ -0,0 +1,104 @@
+#include "TextureArrayPacker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+TextureArrayPacker::TextureArrayPacker(uint32_t InInitialSlicesPerPage, uint32_t InMaxSlicesPerPage)
+	: InitialSlicesPerPage((std::max)(InInitialSlicesPerPage, 1u))
+	, MaxSlicesPerPage((std::max)(InMaxSlicesPerPage, (std::max)(InInitialSlicesPerPage, 1u)))
+{
+}
+
+auto TextureArrayPacker::Allocate(const TextureArrayKey& InKey, TextureArraySlot& OutSlot) -> bool
+{
+	uint32_t bestPage = TextureArraySlot::InvalidPage;
+	for (uint32_t i = 0; i < Pages.size(); ++i)
+	{
+		const Page& page = Pages[i];
+		if (page.bInUse && page.Key == InKey && page.NumUsed < page.NumSlices
+			&& (bestPage == TextureArraySlot::InvalidPage || page.NumUsed > Pages[bestPage].NumUsed))
+		{
+			bestPage = i;
+		}
+	}
+
+	const bool bNewPage = bestPage == TextureArraySlot::InvalidPage;
+	if (bNewPage)
+	{
+		bestPage = CreatePage(InKey);
+	}
+
+	// Kept sorted high to low, the back is the lowest free slice
+	Page& page = Pages[bestPage];
+	OutSlot.Page = bestPage;
+	OutSlot.Slice = page.FreeSlices.back();
+	page.FreeSlices.pop_back();
+	++page.NumUsed;
+	return bNewPage;
+}
+
+auto TextureArrayPacker::Free(const TextureArraySlot& InSlot) -> bool
+{
+	if (!InSlot.IsValid() || InSlot.Page >= Pages.size())
+	{
+		return false;
+	}
+
+	Page& page = Pages[InSlot.Page];
+	assert(page.bInUse && page.NumUsed > 0);
+
+	const auto it = std::lower_bound(page.FreeSlices.begin(), page.FreeSlices.end(), InSlot.Slice, std::greater<uint32_t>());
+	page.FreeSlices.insert(it, InSlot.Slice);
+	if (--page.NumUsed > 0)
+	{
+		return false;
+	}
+
+	page = Page();
+	return true;
+}
+
+auto TextureArrayPacker::CreatePage(const TextureArrayKey& InKey) -> uint32_t
+{
+	uint32_t numSlices = InitialSlicesPerPage;
+	for (const Page& page : Pages)
+	{
+		if (page.bInUse && page.Key == InKey)
+		{
+			numSlices = (std::min)((std::max)(numSlices, page.NumSlices * 2), MaxSlicesPerPage);
+		}
+	}
+
+	auto it = std::find_if(Pages.begin(), Pages.end(), [](const Page& page) { return !page.bInUse; });
+	if (it == Pages.end())
+	{
+		it = Pages.emplace(Pages.end());
+	}
+
+	it->Key = InKey;
+	it->NumSlices = numSlices;
+	it->NumUsed = 0;
+	it->bInUse = true;
+	it->FreeSlices.resize(numSlices);
+	for (uint32_t i = 0; i < numSlices; ++i)
+	{
+		it->FreeSlices[i] = numSlices - 1 - i;
+	}
+	return static_cast<uint32_t>(it - Pages.begin());
+}
+
+auto TextureArrayPacker::GetStats() const -> Stats
+{
+	Stats stats;
+	for (const Page& page : Pages)
+	{
+		if (page.bInUse)
+		{
+			++stats.NumPages;
+			stats.NumSlices += page.NumSlices;
+			stats.NumUsedSlices += page.NumUsed;
+		}
+	}
+	return stats;
+}
@@ -0,0 +1,105 @@
+#include "TextureArrayTable.h"
+
+#include "Game.h"
+#include "TextureUtils.h"
+
+using Microsoft::WRL::ComPtr;
+
+auto TextureArrayTable::Add(ID3D11Resource* InTexture, TextureArraySlot& OutSlot) -> bool
+{
+	OutSlot = TextureArraySlot();
+
+	ComPtr<ID3D11Texture2D> texture;
+	if (InTexture == nullptr || FAILED(InTexture->QueryInterface(IID_PPV_ARGS(texture.GetAddressOf()))))
+	{
+		return false;
+	}
+
+	D3D11_TEXTURE2D_DESC desc;
+	texture->GetDesc(&desc);
+	if (desc.ArraySize != 1 || (desc.MiscFlags & D3D11_RESOURCE_MISC_TEXTURECUBE) || desc.SampleDesc.Count != 1)
+	{
+		return false;
+	}
+
+	const TextureArrayKey key{ static_cast<uint32_t>(desc.Format), desc.Width, desc.Height, desc.MipLevels };
+	TextureArraySlot slot;
+	if (Packer.Allocate(key, slot) && !CreatePage(slot.Page))
+	{
+		Packer.Free(slot);
+		return false;
+	}
+
+	ID3D11DeviceContext* context = Game::GetInstance()->GetD3DDeviceContext().Get();
+	const PageResources& page = Pages[slot.Page];
+	for (UINT mip = 0; mip < desc.MipLevels; ++mip)
+	{
+		context->CopySubresourceRegion(page.Texture.Get(), D3D11CalcSubresource(mip, slot.Slice, desc.MipLevels), 0, 0, 0,
+			texture.Get(), D3D11CalcSubresource(mip, 0, desc.MipLevels), nullptr);
+	}
+
+	OutSlot = slot;
+	return true;
+}
+
+auto TextureArrayTable::Remove(TextureArraySlot& InOutSlot) -> void
+{
+	if (!InOutSlot.IsValid())
+	{
+		return;
+	}
+
+	if (Packer.Free(InOutSlot))
+	{
+		PageResources& page = Pages[InOutSlot.Page];
+		MemorySize -= page.MemorySize;
+		page = PageResources();
+	}
+	InOutSlot = TextureArraySlot();
+}
+
+auto TextureArrayTable::GetPageSRV(uint32_t InPage) const -> ID3D11ShaderResourceView*
+{
+	return InPage < Pages.size() ? Pages[InPage].SRV.Get() : nullptr;
+}
+
+auto TextureArrayTable::GetSliceMemorySize(const TextureArraySlot& InSlot) const -> size_t
+{
+	if (!InSlot.IsValid() || InSlot.Page >= Pages.size())
+	{
+		return 0;
+	}
+	return Pages[InSlot.Page].MemorySize / Packer.GetPage(InSlot.Page).NumSlices;
+}
+
+auto TextureArrayTable::CreatePage(uint32_t InPage) -> bool
+{
+	const TextureArrayPacker::Page& packerPage = Packer.GetPage(InPage);
+	if (Pages.size() <= InPage)
+	{
+		Pages.resize(InPage + 1);
+	}
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = packerPage.Key.Width;
+	desc.Height = packerPage.Key.Height;
+	desc.MipLevels = packerPage.Key.MipLevels;
+	desc.ArraySize = packerPage.NumSlices;
+	desc.Format = static_cast<DXGI_FORMAT>(packerPage.Key.Format);
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	ID3D11Device* device = Game::GetInstance()->GetD3DDevice().Get();
+	PageResources page;
+	if (FAILED(device->CreateTexture2D(&desc, nullptr, page.Texture.GetAddressOf()))
+		|| FAILED(device->CreateShaderResourceView(page.Texture.Get(), nullptr, page.SRV.GetAddressOf())))
+	{
+		return false;
+	}
+
+	page.MemorySize = GetTextureMemorySize(page.Texture.Get());
+	MemorySize += page.MemorySize;
+	Pages[InPage] = std::move(page);
+	return true;
+}
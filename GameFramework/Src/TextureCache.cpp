@@ -0,0 +1,333 @@
+#include "TextureCache.h"
+
+#include "BinaryArchive.h"
+
+#include <d3d11.h>
+#include <wincodec.h>
+#include <wrl/client.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+	// Bump when the cooked output changes
+	constexpr uint32_t CookedTextureVersion = 1;
+
+	constexpr uint32_t DdsMagic = 0x20534444; // "DDS "
+	constexpr uint32_t DdsFourCCDx10 = 0x30315844; // "DX10"
+
+	// Layouts from the DDS documentation, see also DDSTextureLoader
+	struct DdsPixelFormat
+	{
+		uint32_t Size = sizeof(DdsPixelFormat);
+		uint32_t Flags = 0x4; // DDPF_FOURCC
+		uint32_t FourCC = DdsFourCCDx10;
+		uint32_t RgbBitCount = 0;
+		uint32_t RBitMask = 0;
+		uint32_t GBitMask = 0;
+		uint32_t BBitMask = 0;
+		uint32_t ABitMask = 0;
+	};
+
+	struct DdsHeader
+	{
+		uint32_t Size = sizeof(DdsHeader);
+		// Caps, height, width, pixel format, mip count and linear size
+		uint32_t Flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+		uint32_t Height = 0;
+		uint32_t Width = 0;
+		uint32_t PitchOrLinearSize = 0;
+		uint32_t Depth = 0;
+		uint32_t MipMapCount = 0;
+		uint32_t Reserved1[11] = {};
+		DdsPixelFormat PixelFormat;
+		// Texture, mipmap and complex
+		uint32_t Caps = 0x1000 | 0x400000 | 0x8;
+		uint32_t Caps2 = 0;
+		uint32_t Caps3 = 0;
+		uint32_t Caps4 = 0;
+		uint32_t Reserved2 = 0;
+	};
+
+	struct DdsHeaderDx10
+	{
+		DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+		uint32_t ResourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+		uint32_t MiscFlag = 0;
+		uint32_t ArraySize = 1;
+		uint32_t MiscFlags2 = 0;
+	};
+
+	static_assert(sizeof(DdsHeader) == 124, "DDS header layout");
+	static_assert(sizeof(DdsHeaderDx10) == 20, "DDS DX10 header layout");
+
+	// FNV-1a, stable between runs unlike std::hash
+	auto HashBytes(const void* InData, size_t InSize, uint64_t InHash = 14695981039346656037ull) -> uint64_t
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(InData);
+		for (size_t i = 0; i < InSize; ++i)
+		{
+			InHash = (InHash ^ bytes[i]) * 1099511628211ull;
+		}
+		return InHash;
+	}
+
+	auto ToHex(uint64_t InValue) -> std::string
+	{
+		constexpr char digits[] = "0123456789abcdef";
+		std::string out(16, '0');
+		for (int i = 15; i >= 0; --i, InValue >>= 4)
+		{
+			out[i] = digits[InValue & 0xF];
+		}
+		return out;
+	}
+
+	auto GetDxgiFormat(TextureCompressionFormat InFormat, bool bInSrgb) -> DXGI_FORMAT
+	{
+		switch (InFormat)
+		{
+		case TextureCompressionFormat::BC1: return bInSrgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+		case TextureCompressionFormat::BC3: return bInSrgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+		case TextureCompressionFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+		case TextureCompressionFormat::BC7: return bInSrgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+		}
+		return DXGI_FORMAT_UNKNOWN;
+	}
+
+	// Any format WIC reads, converted to 8 bit RGBA
+	auto DecodeImage(const Path& InPath, TextureImage& OutImage) -> bool
+	{
+		ComPtr<IWICImagingFactory> factory;
+		if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(factory.GetAddressOf()))))
+		{
+			return false;
+		}
+
+		ComPtr<IWICBitmapDecoder> decoder;
+		ComPtr<IWICBitmapFrameDecode> frame;
+		ComPtr<IWICFormatConverter> converter;
+		if (FAILED(factory->CreateDecoderFromFilename(InPath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf()))
+			|| FAILED(decoder->GetFrame(0, frame.GetAddressOf()))
+			|| FAILED(factory->CreateFormatConverter(converter.GetAddressOf()))
+			|| FAILED(converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom)))
+		{
+			return false;
+		}
+
+		UINT width;
+		UINT height;
+		if (FAILED(converter->GetSize(&width, &height)) || width == 0 || height == 0
+			|| width > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION || height > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION)
+		{
+			return false;
+		}
+
+		OutImage.Width = width;
+		OutImage.Height = height;
+		OutImage.Pixels.resize(size_t(width) * height * 4);
+		return SUCCEEDED(converter->CopyPixels(nullptr, width * 4, static_cast<UINT>(OutImage.Pixels.size()), OutImage.Pixels.data()));
+	}
+
+	auto HasAlpha(const TextureImage& InImage) -> bool
+	{
+		for (size_t i = 3; i < InImage.Pixels.size(); i += 4)
+		{
+			if (InImage.Pixels[i] != 255)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	auto ElapsedMs(std::chrono::steady_clock::time_point InStart) -> float
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - InStart).count();
+	}
+}
+
+TextureCache::TextureCache(const Path& InCacheDirectory)
+	: CacheDirectory(InCacheDirectory)
+{
+	std::error_code error;
+	std::filesystem::create_directories(CacheDirectory, error);
+}
+
+auto TextureCache::Open(const Path& InSourcePath, TextureUsage InUsage, Path& OutCookedPath) -> bool
+{
+	std::string extension = InSourcePath.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	if (extension == ".dds")
+	{
+		OutCookedPath = InSourcePath;
+		return true;
+	}
+
+	const Path cookedPath = GetCookedPath(InSourcePath, InUsage);
+	if (cookedPath.empty())
+	{
+		return false;
+	}
+
+	std::lock_guard lock(GetSourceMutex(cookedPath));
+
+	std::error_code error;
+	if (std::filesystem::is_regular_file(cookedPath, error))
+	{
+		std::lock_guard statsLock(StatsMutex);
+		++CurrentStats.NumHits;
+		OutCookedPath = cookedPath;
+		return true;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::vector<uint8_t> dds;
+	if (!Cook(InSourcePath, InUsage, dds) || !WriteFileAtomically(cookedPath, dds))
+	{
+		return false;
+	}
+	RemoveStaleFiles(cookedPath);
+
+	const float cookMs = ElapsedMs(start);
+	std::cout << "Cooked " << InSourcePath.string() << " in " << cookMs << " ms" << std::endl;
+
+	std::lock_guard statsLock(StatsMutex);
+	++CurrentStats.NumCooked;
+	CurrentStats.CookMs += cookMs;
+	OutCookedPath = cookedPath;
+	return true;
+}
+
+auto TextureCache::GetCookedPath(const Path& InSourcePath, TextureUsage InUsage) const -> Path
+{
+	std::error_code error;
+	const auto writeTime = std::filesystem::last_write_time(InSourcePath, error);
+	if (error)
+	{
+		return Path();
+	}
+	const uint64_t size = std::filesystem::file_size(InSourcePath, error);
+	if (error)
+	{
+		return Path();
+	}
+
+	// Usage is part of the source name so both cooked versions of a file survive RemoveStaleFiles
+	const std::string sourcePath = std::filesystem::absolute(InSourcePath, error).lexically_normal().generic_string();
+	const uint64_t sourceHash = HashBytes(&InUsage, sizeof(InUsage), HashBytes(sourcePath.data(), sourcePath.size()));
+
+	const int64_t writeTicks = writeTime.time_since_epoch().count();
+	const uint32_t version = CookedTextureVersion;
+	uint64_t stateHash = HashBytes(&writeTicks, sizeof(writeTicks));
+	stateHash = HashBytes(&size, sizeof(size), stateHash);
+	stateHash = HashBytes(&version, sizeof(version), stateHash);
+	stateHash = HashBytes(&Filter, sizeof(Filter), stateHash);
+	if (InUsage == TextureUsage::Albedo)
+	{
+		stateHash = HashBytes(&AlbedoFormat, sizeof(AlbedoFormat), stateHash);
+	}
+
+	return CacheDirectory / Path(ToHex(sourceHash) + "_" + ToHex(stateHash) + ".dds");
+}
+
+auto TextureCache::GetStats() const -> Stats
+{
+	std::lock_guard lock(StatsMutex);
+	return CurrentStats;
+}
+
+auto TextureCache::Cook(const Path& InSourcePath, TextureUsage InUsage, std::vector<uint8_t>& OutDds) -> bool
+{
+	TextureImage image;
+	if (!DecodeImage(InSourcePath, image))
+	{
+		return false;
+	}
+
+	MipChainSettings settings;
+	settings.Filter = Filter;
+	settings.bSrgb = InUsage == TextureUsage::Albedo;
+	settings.bNormalMap = InUsage == TextureUsage::Normal;
+
+	TextureCompressionFormat format = TextureCompressionFormat::BC5;
+	if (InUsage == TextureUsage::Albedo)
+	{
+		format = AlbedoFormat == TextureCompressionFormat::BC1 && HasAlpha(image) ? TextureCompressionFormat::BC3 : AlbedoFormat;
+	}
+
+	// D3D11 needs the top level of block compressed textures to be made of whole blocks
+	const uint32_t width = (image.Width + 3) & ~3u;
+	const uint32_t height = (image.Height + 3) & ~3u;
+	const std::vector<TextureImage> mips = GenerateMipChain(ResizeImage(image, width, height, settings), settings);
+
+	DdsHeader header;
+	header.Width = width;
+	header.Height = height;
+	header.MipMapCount = static_cast<uint32_t>(mips.size());
+	header.PitchOrLinearSize = static_cast<uint32_t>(GetCompressedSize(width, height, format));
+
+	DdsHeaderDx10 headerDx10;
+	headerDx10.Format = GetDxgiFormat(format, settings.bSrgb);
+
+	BinaryWriter out;
+	out.Write(DdsMagic);
+	out.Write(header);
+	out.Write(headerDx10);
+
+	size_t uncompressedBytes = 0;
+	for (const TextureImage& mip : mips)
+	{
+		const std::vector<uint8_t> blocks = CompressImage(mip, format);
+		out.WriteBytes(blocks.data(), blocks.size());
+		uncompressedBytes += mip.Pixels.size();
+	}
+
+	OutDds = out.GetBuffer();
+
+	std::lock_guard statsLock(StatsMutex);
+	CurrentStats.UncompressedBytes += uncompressedBytes;
+	CurrentStats.CompressedBytes += OutDds.size();
+	return true;
+}
+
+auto TextureCache::RemoveStaleFiles(const Path& InCookedPath) const -> void
+{
+	const std::string fileName = InCookedPath.filename().string();
+	const std::string sourcePrefix = fileName.substr(0, fileName.find('_') + 1);
+
+	std::error_code error;
+	for (const auto& entry : std::filesystem::directory_iterator(CacheDirectory, error))
+	{
+		const std::string name = entry.path().filename().string();
+		if (name != fileName && name.rfind(sourcePrefix, 0) == 0)
+		{
+			// Fails while a loader still reads it, it is removed next time
+			std::error_code removeError;
+			std::filesystem::remove(entry.path(), removeError);
+		}
+	}
+}
+
+auto TextureCache::GetSourceMutex(const Path& InCookedPath) -> std::mutex&
+{
+	// Keyed by the source and usage part of the cooked name
+	const std::string fileName = InCookedPath.filename().string();
+	const std::string sourceKey = fileName.substr(0, fileName.find('_'));
+
+	std::lock_guard lock(SourceMutexesMutex);
+	std::unique_ptr<std::mutex>& mutex = SourceMutexes[sourceKey];
+	if (mutex == nullptr)
+	{
+		mutex.reset(new std::mutex());
+	}
+	return *mutex;
+}
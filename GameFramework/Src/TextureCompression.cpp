@@ -0,0 +1,1096 @@
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+	constexpr float Pi = 3.14159265f;
+
+	// nvtt's defaults for mip generation
+	constexpr float KaiserWidth = 3.0f;
+	constexpr float KaiserAlpha = 4.0f;
+
+	// Refinement passes of the endpoint least squares fit
+	constexpr int NumRefineIterations = 2;
+
+	// RGBA as floats, sRGB decoded and normal maps in [-1, 1]
+	struct FloatImage
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<float> Pixels;
+	};
+
+	auto SrgbToLinear(float InValue) -> float
+	{
+		return InValue <= 0.04045f ? InValue / 12.92f : std::pow((InValue + 0.055f) / 1.055f, 2.4f);
+	}
+
+	auto LinearToSrgb(float InValue) -> float
+	{
+		return InValue <= 0.0031308f ? InValue * 12.92f : 1.055f * std::pow(InValue, 1.0f / 2.4f) - 0.055f;
+	}
+
+	auto ToUnorm8(float InValue) -> uint8_t
+	{
+		return static_cast<uint8_t>(std::lround(std::clamp(InValue, 0.0f, 1.0f) * 255.0f));
+	}
+
+	auto ToFloatImage(const TextureImage& InImage, const MipChainSettings& InSettings) -> FloatImage
+	{
+		float srgbTable[256];
+		for (int i = 0; i < 256; ++i)
+		{
+			srgbTable[i] = SrgbToLinear(i / 255.0f);
+		}
+
+		FloatImage out;
+		out.Width = InImage.Width;
+		out.Height = InImage.Height;
+		out.Pixels.resize(InImage.Pixels.size());
+		for (size_t i = 0; i < InImage.Pixels.size(); ++i)
+		{
+			const uint8_t value = InImage.Pixels[i];
+			const bool bAlpha = i % 4 == 3;
+			if (!bAlpha && InSettings.bNormalMap)
+			{
+				out.Pixels[i] = value / 127.5f - 1.0f;
+			}
+			else if (!bAlpha && InSettings.bSrgb)
+			{
+				out.Pixels[i] = srgbTable[value];
+			}
+			else
+			{
+				out.Pixels[i] = value / 255.0f;
+			}
+		}
+		return out;
+	}
+
+	auto ToTextureImage(const FloatImage& InImage, const MipChainSettings& InSettings) -> TextureImage
+	{
+		TextureImage out;
+		out.Width = InImage.Width;
+		out.Height = InImage.Height;
+		out.Pixels.resize(InImage.Pixels.size());
+		for (size_t i = 0; i < InImage.Pixels.size(); ++i)
+		{
+			const float value = InImage.Pixels[i];
+			const bool bAlpha = i % 4 == 3;
+			if (!bAlpha && InSettings.bNormalMap)
+			{
+				out.Pixels[i] = ToUnorm8(value * 0.5f + 0.5f);
+			}
+			else if (!bAlpha && InSettings.bSrgb)
+			{
+				out.Pixels[i] = ToUnorm8(LinearToSrgb(std::clamp(value, 0.0f, 1.0f)));
+			}
+			else
+			{
+				out.Pixels[i] = ToUnorm8(value);
+			}
+		}
+		return out;
+	}
+
+	// Modified Bessel function of the first kind, the series converges quickly for the alpha used
+	auto BesselI0(float InX) -> float
+	{
+		float sum = 1.0f;
+		float term = 1.0f;
+		for (int k = 1; k < 20; ++k)
+		{
+			term *= (InX * 0.5f / k) * (InX * 0.5f / k);
+			sum += term;
+		}
+		return sum;
+	}
+
+	auto EvaluateKaiser(float InX) -> float
+	{
+		const float t = InX / KaiserWidth;
+		if (std::abs(t) >= 1.0f)
+		{
+			return 0.0f;
+		}
+		const float sinc = InX == 0.0f ? 1.0f : std::sin(Pi * InX) / (Pi * InX);
+		return sinc * BesselI0(KaiserAlpha * std::sqrt(1.0f - t * t)) / BesselI0(KaiserAlpha);
+	}
+
+	struct FilterTap
+	{
+		uint32_t Source;
+		float Weight;
+	};
+
+	// Taps of every destination pixel along one axis, the edges are clamped
+	auto GetFilterTaps(uint32_t InSourceSize, uint32_t InDestSize, MipFilter InFilter, std::vector<uint32_t>& OutOffsets) -> std::vector<FilterTap>
+	{
+		std::vector<FilterTap> taps;
+		OutOffsets.assign(1, 0);
+
+		// Magnification keeps the filter at its unit width
+		const float scale = float(InSourceSize) / InDestSize;
+		const float filterScale = (std::max)(scale, 1.0f);
+		const float support = InFilter == MipFilter::Box ? scale * 0.5f : KaiserWidth * filterScale;
+
+		for (uint32_t dest = 0; dest < InDestSize; ++dest)
+		{
+			const float center = (dest + 0.5f) * scale;
+			const size_t firstTap = taps.size();
+			float totalWeight = 0.0f;
+
+			const int32_t begin = static_cast<int32_t>(std::floor(center - support));
+			const int32_t end = static_cast<int32_t>(std::ceil(center + support));
+			for (int32_t source = begin; source < end; ++source)
+			{
+				float weight;
+				if (InFilter == MipFilter::Box)
+				{
+					// Coverage of the source pixel by the destination one
+					weight = (std::max)(0.0f, (std::min)(source + 1.0f, center + support) - (std::max)(float(source), center - support));
+				}
+				else
+				{
+					weight = EvaluateKaiser((source + 0.5f - center) / filterScale);
+				}
+
+				if (weight != 0.0f)
+				{
+					taps.push_back({ static_cast<uint32_t>(std::clamp<int32_t>(source, 0, InSourceSize - 1)), weight });
+					totalWeight += weight;
+				}
+			}
+
+			for (size_t i = firstTap; i < taps.size(); ++i)
+			{
+				taps[i].Weight /= totalWeight;
+			}
+			OutOffsets.push_back(static_cast<uint32_t>(taps.size()));
+		}
+
+		return taps;
+	}
+
+	// Separable, rows first
+	auto Resample(const FloatImage& InImage, uint32_t InWidth, uint32_t InHeight, MipFilter InFilter) -> FloatImage
+	{
+		std::vector<uint32_t> rowOffsets;
+		const std::vector<FilterTap> rowTaps = GetFilterTaps(InImage.Width, InWidth, InFilter, rowOffsets);
+		std::vector<uint32_t> columnOffsets;
+		const std::vector<FilterTap> columnTaps = GetFilterTaps(InImage.Height, InHeight, InFilter, columnOffsets);
+
+		std::vector<float> rows(size_t(InWidth) * InImage.Height * 4, 0.0f);
+		for (uint32_t y = 0; y < InImage.Height; ++y)
+		{
+			for (uint32_t x = 0; x < InWidth; ++x)
+			{
+				float* out = &rows[(size_t(y) * InWidth + x) * 4];
+				for (uint32_t t = rowOffsets[x]; t < rowOffsets[x + 1]; ++t)
+				{
+					const float* in = &InImage.Pixels[(size_t(y) * InImage.Width + rowTaps[t].Source) * 4];
+					for (int c = 0; c < 4; ++c)
+					{
+						out[c] += in[c] * rowTaps[t].Weight;
+					}
+				}
+			}
+		}
+
+		FloatImage out;
+		out.Width = InWidth;
+		out.Height = InHeight;
+		out.Pixels.assign(size_t(InWidth) * InHeight * 4, 0.0f);
+		for (uint32_t y = 0; y < InHeight; ++y)
+		{
+			for (uint32_t t = columnOffsets[y]; t < columnOffsets[y + 1]; ++t)
+			{
+				const float* in = &rows[size_t(columnTaps[t].Source) * InWidth * 4];
+				float* outRow = &out.Pixels[size_t(y) * InWidth * 4];
+				for (uint32_t i = 0; i < InWidth * 4; ++i)
+				{
+					outRow[i] += in[i] * columnTaps[t].Weight;
+				}
+			}
+		}
+		return out;
+	}
+
+	auto Downsample(const FloatImage& InImage, MipFilter InFilter) -> FloatImage
+	{
+		return Resample(InImage, (std::max)(InImage.Width / 2, 1u), (std::max)(InImage.Height / 2, 1u), InFilter);
+	}
+
+	auto RenormalizeNormals(FloatImage& InOutImage) -> void
+	{
+		for (size_t i = 0; i < InOutImage.Pixels.size(); i += 4)
+		{
+			float* n = &InOutImage.Pixels[i];
+			const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if (length > 0.0f)
+			{
+				n[0] /= length;
+				n[1] /= length;
+				n[2] /= length;
+			}
+			else
+			{
+				n[0] = 0.0f;
+				n[1] = 0.0f;
+				n[2] = 1.0f;
+			}
+		}
+	}
+
+	// Principal axis of InCount points of InDimensions floats, by power iteration on the covariance
+	auto GetPrincipalAxis(const float* InPoints, int InCount, int InDimensions, float* OutMean, float* OutAxis) -> void
+	{
+		for (int d = 0; d < InDimensions; ++d)
+		{
+			OutMean[d] = 0.0f;
+			for (int i = 0; i < InCount; ++i)
+			{
+				OutMean[d] += InPoints[i * InDimensions + d];
+			}
+			OutMean[d] /= InCount;
+		}
+
+		float covariance[4][4] = {};
+		for (int i = 0; i < InCount; ++i)
+		{
+			for (int a = 0; a < InDimensions; ++a)
+			{
+				for (int b = 0; b < InDimensions; ++b)
+				{
+					covariance[a][b] += (InPoints[i * InDimensions + a] - OutMean[a]) * (InPoints[i * InDimensions + b] - OutMean[b]);
+				}
+			}
+		}
+
+		for (int d = 0; d < InDimensions; ++d)
+		{
+			OutAxis[d] = 1.0f;
+		}
+		for (int iteration = 0; iteration < 8; ++iteration)
+		{
+			float next[4] = {};
+			float length = 0.0f;
+			for (int a = 0; a < InDimensions; ++a)
+			{
+				for (int b = 0; b < InDimensions; ++b)
+				{
+					next[a] += covariance[a][b] * OutAxis[b];
+				}
+				length = (std::max)(length, std::abs(next[a]));
+			}
+			if (length == 0.0f)
+			{
+				return;
+			}
+			for (int d = 0; d < InDimensions; ++d)
+			{
+				OutAxis[d] = next[d] / length;
+			}
+		}
+	}
+
+	// Endpoints at the extremes of the projection of the points on their principal axis
+	auto GetAxisEndpoints(const float* InPoints, int InCount, int InDimensions, float* OutLow, float* OutHigh) -> void
+	{
+		float mean[4];
+		float axis[4];
+		GetPrincipalAxis(InPoints, InCount, InDimensions, mean, axis);
+
+		float minT = std::numeric_limits<float>::max();
+		float maxT = std::numeric_limits<float>::lowest();
+		for (int i = 0; i < InCount; ++i)
+		{
+			float t = 0.0f;
+			for (int d = 0; d < InDimensions; ++d)
+			{
+				t += (InPoints[i * InDimensions + d] - mean[d]) * axis[d];
+			}
+			minT = (std::min)(minT, t);
+			maxT = (std::max)(maxT, t);
+		}
+
+		float axisLengthSquared = 0.0f;
+		for (int d = 0; d < InDimensions; ++d)
+		{
+			axisLengthSquared += axis[d] * axis[d];
+		}
+		if (axisLengthSquared > 0.0f)
+		{
+			minT /= axisLengthSquared;
+			maxT /= axisLengthSquared;
+		}
+		else
+		{
+			minT = maxT = 0.0f;
+		}
+
+		for (int d = 0; d < InDimensions; ++d)
+		{
+			OutLow[d] = std::clamp(mean[d] + axis[d] * minT, 0.0f, 255.0f);
+			OutHigh[d] = std::clamp(mean[d] + axis[d] * maxT, 0.0f, 255.0f);
+		}
+	}
+
+	// Endpoints minimizing the squared error for fixed weights of the high endpoint, false when they are undetermined
+	auto FitEndpoints(const float* InPoints, const float* InWeights, int InCount, int InDimensions, float* OutLow, float* OutHigh) -> bool
+	{
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		float ax[4] = {}, bx[4] = {};
+		for (int i = 0; i < InCount; ++i)
+		{
+			const float b = InWeights[i];
+			const float a = 1.0f - b;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for (int d = 0; d < InDimensions; ++d)
+			{
+				ax[d] += a * InPoints[i * InDimensions + d];
+				bx[d] += b * InPoints[i * InDimensions + d];
+			}
+		}
+
+		const float determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		for (int d = 0; d < InDimensions; ++d)
+		{
+			OutLow[d] = std::clamp((ax[d] * bb - bx[d] * ab) / determinant, 0.0f, 255.0f);
+			OutHigh[d] = std::clamp((bx[d] * aa - ax[d] * ab) / determinant, 0.0f, 255.0f);
+		}
+		return true;
+	}
+
+	// BC1 color block
+
+	auto Expand5(uint32_t InValue) -> int32_t { return (InValue << 3) | (InValue >> 2); }
+	auto Expand6(uint32_t InValue) -> int32_t { return (InValue << 2) | (InValue >> 4); }
+
+	auto PackRgb565(const float InColor[3]) -> uint16_t
+	{
+		const uint32_t r = static_cast<uint32_t>(std::lround(std::clamp(InColor[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+		const uint32_t g = static_cast<uint32_t>(std::lround(std::clamp(InColor[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+		const uint32_t b = static_cast<uint32_t>(std::lround(std::clamp(InColor[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	auto UnpackRgb565(uint16_t InColor, int32_t OutColor[3]) -> void
+	{
+		OutColor[0] = Expand5((InColor >> 11) & 31);
+		OutColor[1] = Expand6((InColor >> 5) & 63);
+		OutColor[2] = Expand5(InColor & 31);
+	}
+
+	// Palette of a color block, the 3 color mode is only used by BC1 when color0 <= color1
+	auto GetColorPalette(uint16_t InColor0, uint16_t InColor1, bool bInFourColors, int32_t OutPalette[4][4]) -> void
+	{
+		UnpackRgb565(InColor0, OutPalette[0]);
+		UnpackRgb565(InColor1, OutPalette[1]);
+		OutPalette[0][3] = 255;
+		OutPalette[1][3] = 255;
+		for (int c = 0; c < 3; ++c)
+		{
+			if (bInFourColors)
+			{
+				OutPalette[2][c] = (2 * OutPalette[0][c] + OutPalette[1][c]) / 3;
+				OutPalette[3][c] = (OutPalette[0][c] + 2 * OutPalette[1][c]) / 3;
+			}
+			else
+			{
+				OutPalette[2][c] = (OutPalette[0][c] + OutPalette[1][c]) / 2;
+				OutPalette[3][c] = 0;
+			}
+		}
+		OutPalette[2][3] = 255;
+		OutPalette[3][3] = bInFourColors ? 255 : 0;
+	}
+
+	// Picks the nearest palette entry for every pixel, returns the squared error
+	auto SelectColorIndices(const float InColors[16 * 3], uint16_t InColor0, uint16_t InColor1, uint32_t& OutIndices) -> float
+	{
+		int32_t palette[4][4];
+		GetColorPalette(InColor0, InColor1, true, palette);
+
+		float totalError = 0.0f;
+		OutIndices = 0;
+		for (int i = 0; i < 16; ++i)
+		{
+			float bestError = std::numeric_limits<float>::max();
+			uint32_t bestIndex = 0;
+			for (uint32_t p = 0; p < 4; ++p)
+			{
+				float error = 0.0f;
+				for (int c = 0; c < 3; ++c)
+				{
+					const float delta = InColors[i * 3 + c] - palette[p][c];
+					error += delta * delta;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					bestIndex = p;
+				}
+			}
+			OutIndices |= bestIndex << (i * 2);
+			totalError += bestError;
+		}
+		return totalError;
+	}
+
+	// Always in 4 color mode, so the block decodes the same in BC1 and BC3
+	auto CompressColorBlock(const uint8_t InPixels[64], uint8_t OutBlock[8]) -> void
+	{
+		float colors[16 * 3];
+		for (int i = 0; i < 16; ++i)
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				colors[i * 3 + c] = InPixels[i * 4 + c];
+			}
+		}
+
+		float low[3];
+		float high[3];
+		GetAxisEndpoints(colors, 16, 3, low, high);
+
+		uint16_t color0 = PackRgb565(high);
+		uint16_t color1 = PackRgb565(low);
+		uint32_t indices;
+		float error = SelectColorIndices(colors, color0, color1, indices);
+
+		// Weights of color1 for the indices 0 to 3
+		constexpr float paletteWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+		for (int iteration = 0; iteration < NumRefineIterations; ++iteration)
+		{
+			float weights[16];
+			for (int i = 0; i < 16; ++i)
+			{
+				weights[i] = paletteWeights[(indices >> (i * 2)) & 3];
+			}
+
+			float fitted0[3];
+			float fitted1[3];
+			if (!FitEndpoints(colors, weights, 16, 3, fitted0, fitted1))
+			{
+				break;
+			}
+
+			const uint16_t refined0 = PackRgb565(fitted0);
+			const uint16_t refined1 = PackRgb565(fitted1);
+			uint32_t refinedIndices;
+			const float refinedError = SelectColorIndices(colors, refined0, refined1, refinedIndices);
+			if (refinedError >= error)
+			{
+				break;
+			}
+			color0 = refined0;
+			color1 = refined1;
+			indices = refinedIndices;
+			error = refinedError;
+		}
+
+		if (color0 < color1)
+		{
+			// 4 color mode needs color0 > color1, swapping the endpoints swaps 0 with 1 and 2 with 3
+			std::swap(color0, color1);
+			indices ^= 0x55555555;
+		}
+		else if (color0 == color1)
+		{
+			indices = 0;
+		}
+
+		std::memcpy(OutBlock, &color0, 2);
+		std::memcpy(OutBlock + 2, &color1, 2);
+		std::memcpy(OutBlock + 4, &indices, 4);
+	}
+
+	auto DecompressColorBlock(const uint8_t InBlock[8], bool bInAllowThreeColors, uint8_t OutPixels[64]) -> void
+	{
+		uint16_t color0;
+		uint16_t color1;
+		uint32_t indices;
+		std::memcpy(&color0, InBlock, 2);
+		std::memcpy(&color1, InBlock + 2, 2);
+		std::memcpy(&indices, InBlock + 4, 4);
+
+		int32_t palette[4][4];
+		GetColorPalette(color0, color1, !bInAllowThreeColors || color0 > color1, palette);
+		for (int i = 0; i < 16; ++i)
+		{
+			const int32_t* color = palette[(indices >> (i * 2)) & 3];
+			for (int c = 0; c < 4; ++c)
+			{
+				OutPixels[i * 4 + c] = static_cast<uint8_t>(color[c]);
+			}
+		}
+	}
+
+	// BC4 single channel block, the alpha of BC3 and both channels of BC5
+
+	auto GetChannelPalette(uint8_t InValue0, uint8_t InValue1, int32_t OutPalette[8]) -> void
+	{
+		OutPalette[0] = InValue0;
+		OutPalette[1] = InValue1;
+		if (InValue0 > InValue1)
+		{
+			for (int i = 1; i < 7; ++i)
+			{
+				OutPalette[i + 1] = ((7 - i) * InValue0 + i * InValue1) / 7;
+			}
+		}
+		else
+		{
+			for (int i = 1; i < 5; ++i)
+			{
+				OutPalette[i + 1] = ((5 - i) * InValue0 + i * InValue1) / 5;
+			}
+			OutPalette[6] = 0;
+			OutPalette[7] = 255;
+		}
+	}
+
+	auto SelectChannelIndices(const uint8_t InValues[16], uint8_t InValue0, uint8_t InValue1, uint64_t& OutIndices) -> int32_t
+	{
+		int32_t palette[8];
+		GetChannelPalette(InValue0, InValue1, palette);
+
+		int32_t totalError = 0;
+		OutIndices = 0;
+		for (int i = 0; i < 16; ++i)
+		{
+			int32_t bestError = std::numeric_limits<int32_t>::max();
+			uint64_t bestIndex = 0;
+			for (uint64_t p = 0; p < 8; ++p)
+			{
+				const int32_t error = (InValues[i] - palette[p]) * (InValues[i] - palette[p]);
+				if (error < bestError)
+				{
+					bestError = error;
+					bestIndex = p;
+				}
+			}
+			OutIndices |= bestIndex << (i * 3);
+			totalError += bestError;
+		}
+		return totalError;
+	}
+
+	auto CompressChannelBlock(const uint8_t InValues[16], uint8_t OutBlock[8]) -> void
+	{
+		const uint8_t minValue = *std::min_element(InValues, InValues + 16);
+		const uint8_t maxValue = *std::max_element(InValues, InValues + 16);
+
+		uint8_t bestValue0 = maxValue;
+		uint8_t bestValue1 = minValue;
+		uint64_t bestIndices;
+		int32_t bestError = SelectChannelIndices(InValues, bestValue0, bestValue1, bestIndices);
+
+		auto tryEndpoints = [&](int32_t InValue0, int32_t InValue1)
+		{
+			const uint8_t value0 = static_cast<uint8_t>(std::clamp(InValue0, 0, 255));
+			const uint8_t value1 = static_cast<uint8_t>(std::clamp(InValue1, 0, 255));
+			uint64_t indices;
+			const int32_t error = SelectChannelIndices(InValues, value0, value1, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestValue0 = value0;
+				bestValue1 = value1;
+				bestIndices = indices;
+			}
+		};
+
+		// Ranges slightly inside the extremes often fit the interpolated values better
+		for (int32_t high = -2; high <= 2 && bestError > 0; ++high)
+		{
+			for (int32_t low = -2; low <= 2; ++low)
+			{
+				if (maxValue + high > minValue + low)
+				{
+					tryEndpoints(maxValue + high, minValue + low);
+				}
+			}
+		}
+
+		// 6 value mode, 0 and 255 come for free so the range only has to cover the other values
+		if (bestError > 0)
+		{
+			uint8_t innerMin = 255;
+			uint8_t innerMax = 0;
+			for (int i = 0; i < 16; ++i)
+			{
+				if (InValues[i] != 0 && InValues[i] != 255)
+				{
+					innerMin = (std::min)(innerMin, InValues[i]);
+					innerMax = (std::max)(innerMax, InValues[i]);
+				}
+			}
+			if (innerMin <= innerMax)
+			{
+				tryEndpoints(innerMin, innerMax);
+			}
+		}
+
+		OutBlock[0] = bestValue0;
+		OutBlock[1] = bestValue1;
+		for (int i = 0; i < 6; ++i)
+		{
+			OutBlock[2 + i] = static_cast<uint8_t>(bestIndices >> (i * 8));
+		}
+	}
+
+	auto DecompressChannelBlock(const uint8_t InBlock[8], uint8_t OutValues[16]) -> void
+	{
+		int32_t palette[8];
+		GetChannelPalette(InBlock[0], InBlock[1], palette);
+
+		uint64_t indices = 0;
+		for (int i = 0; i < 6; ++i)
+		{
+			indices |= uint64_t(InBlock[2 + i]) << (i * 8);
+		}
+		for (int i = 0; i < 16; ++i)
+		{
+			OutValues[i] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 7]);
+		}
+	}
+
+	// BC7 mode 6: one subset, RGBA endpoints of 7 bits and a p-bit each, 4 bit indices
+
+	constexpr int32_t Bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	auto InterpolateBc7(int32_t InValue0, int32_t InValue1, int32_t InWeight) -> int32_t
+	{
+		return ((64 - InWeight) * InValue0 + InWeight * InValue1 + 32) >> 6;
+	}
+
+	struct Bc7Mode6Endpoints
+	{
+		// 7 bit values
+		uint8_t Values[2][4];
+		uint8_t PBits[2];
+
+		auto Get(int InEndpoint, int InChannel) const -> int32_t { return (Values[InEndpoint][InChannel] << 1) | PBits[InEndpoint]; }
+	};
+
+	auto QuantizeBc7Mode6(const float InLow[4], const float InHigh[4], uint8_t InPBit0, uint8_t InPBit1) -> Bc7Mode6Endpoints
+	{
+		Bc7Mode6Endpoints endpoints;
+		endpoints.PBits[0] = InPBit0;
+		endpoints.PBits[1] = InPBit1;
+		for (int c = 0; c < 4; ++c)
+		{
+			endpoints.Values[0][c] = static_cast<uint8_t>(std::clamp<long>(std::lround((InLow[c] - InPBit0) * 0.5f), 0, 127));
+			endpoints.Values[1][c] = static_cast<uint8_t>(std::clamp<long>(std::lround((InHigh[c] - InPBit1) * 0.5f), 0, 127));
+		}
+		return endpoints;
+	}
+
+	auto SelectBc7Mode6Indices(const uint8_t InPixels[64], const Bc7Mode6Endpoints& InEndpoints, uint8_t OutIndices[16]) -> int64_t
+	{
+		int32_t palette[16][4];
+		for (int w = 0; w < 16; ++w)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				palette[w][c] = InterpolateBc7(InEndpoints.Get(0, c), InEndpoints.Get(1, c), Bc7Weights4[w]);
+			}
+		}
+
+		int64_t totalError = 0;
+		for (int i = 0; i < 16; ++i)
+		{
+			int32_t bestError = std::numeric_limits<int32_t>::max();
+			for (uint8_t w = 0; w < 16; ++w)
+			{
+				int32_t error = 0;
+				for (int c = 0; c < 4; ++c)
+				{
+					const int32_t delta = InPixels[i * 4 + c] - palette[w][c];
+					error += delta * delta;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					OutIndices[i] = w;
+				}
+			}
+			totalError += bestError;
+		}
+		return totalError;
+	}
+
+	// Best of the four p-bit combinations for the endpoints
+	auto FindBc7Mode6Endpoints(const uint8_t InPixels[64], const float InLow[4], const float InHigh[4], Bc7Mode6Endpoints& OutEndpoints, uint8_t OutIndices[16]) -> int64_t
+	{
+		int64_t bestError = std::numeric_limits<int64_t>::max();
+		for (uint8_t p = 0; p < 4; ++p)
+		{
+			const Bc7Mode6Endpoints endpoints = QuantizeBc7Mode6(InLow, InHigh, p & 1, p >> 1);
+			uint8_t indices[16];
+			const int64_t error = SelectBc7Mode6Indices(InPixels, endpoints, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				OutEndpoints = endpoints;
+				std::memcpy(OutIndices, indices, 16);
+			}
+		}
+		return bestError;
+	}
+
+	// Writes bits from the least significant bit of the block up
+	struct BlockBitWriter
+	{
+		uint8_t* Block;
+		uint32_t Offset = 0;
+
+		auto Write(uint32_t InValue, uint32_t InNumBits) -> void
+		{
+			for (uint32_t i = 0; i < InNumBits; ++i, ++Offset)
+			{
+				Block[Offset >> 3] |= static_cast<uint8_t>(((InValue >> i) & 1) << (Offset & 7));
+			}
+		}
+	};
+
+	struct BlockBitReader
+	{
+		const uint8_t* Block;
+		uint32_t Offset = 0;
+
+		auto Read(uint32_t InNumBits) -> uint32_t
+		{
+			uint32_t value = 0;
+			for (uint32_t i = 0; i < InNumBits; ++i, ++Offset)
+			{
+				value |= uint32_t((Block[Offset >> 3] >> (Offset & 7)) & 1) << i;
+			}
+			return value;
+		}
+	};
+
+	// Copies the 4x4 block at InBlockX, InBlockY, pixels past the edges repeat the last row and column
+	auto GatherBlock(const TextureImage& InImage, uint32_t InBlockX, uint32_t InBlockY, uint8_t OutPixels[64]) -> void
+	{
+		for (uint32_t y = 0; y < 4; ++y)
+		{
+			const uint32_t sourceY = (std::min)(InBlockY * 4 + y, InImage.Height - 1);
+			for (uint32_t x = 0; x < 4; ++x)
+			{
+				const uint32_t sourceX = (std::min)(InBlockX * 4 + x, InImage.Width - 1);
+				std::memcpy(&OutPixels[(y * 4 + x) * 4], &InImage.Pixels[(size_t(sourceY) * InImage.Width + sourceX) * 4], 4);
+			}
+		}
+	}
+}
+
+auto GenerateMipChain(const TextureImage& InImage, const MipChainSettings& InSettings) -> std::vector<TextureImage>
+{
+	std::vector<TextureImage> levels;
+	levels.push_back(InImage);
+	if (InImage.Width == 0 || InImage.Height == 0)
+	{
+		return levels;
+	}
+
+	// Every level is filtered from the float version of the previous one, so rounding doesn't add up
+	FloatImage current = ToFloatImage(InImage, InSettings);
+	while (current.Width > 1 || current.Height > 1)
+	{
+		current = Downsample(current, InSettings.Filter);
+		if (InSettings.bNormalMap)
+		{
+			RenormalizeNormals(current);
+		}
+		levels.push_back(ToTextureImage(current, InSettings));
+	}
+	return levels;
+}
+
+auto ResizeImage(const TextureImage& InImage, uint32_t InWidth, uint32_t InHeight, const MipChainSettings& InSettings) -> TextureImage
+{
+	if (InImage.Width == 0 || InImage.Height == 0 || (InImage.Width == InWidth && InImage.Height == InHeight))
+	{
+		return InImage;
+	}
+
+	FloatImage resized = Resample(ToFloatImage(InImage, InSettings), InWidth, InHeight, InSettings.Filter);
+	if (InSettings.bNormalMap)
+	{
+		RenormalizeNormals(resized);
+	}
+	return ToTextureImage(resized, InSettings);
+}
+
+auto GetCompressedBlockSize(TextureCompressionFormat InFormat) -> size_t
+{
+	return InFormat == TextureCompressionFormat::BC1 ? 8 : 16;
+}
+
+auto GetCompressedSize(uint32_t InWidth, uint32_t InHeight, TextureCompressionFormat InFormat) -> size_t
+{
+	const size_t blocksX = (std::max)((InWidth + 3) / 4, 1u);
+	const size_t blocksY = (std::max)((InHeight + 3) / 4, 1u);
+	return blocksX * blocksY * GetCompressedBlockSize(InFormat);
+}
+
+auto CompressBlockBC1(const uint8_t InPixels[64], uint8_t OutBlock[8]) -> void
+{
+	CompressColorBlock(InPixels, OutBlock);
+}
+
+auto CompressBlockBC3(const uint8_t InPixels[64], uint8_t OutBlock[16]) -> void
+{
+	uint8_t alpha[16];
+	for (int i = 0; i < 16; ++i)
+	{
+		alpha[i] = InPixels[i * 4 + 3];
+	}
+	CompressChannelBlock(alpha, OutBlock);
+	CompressColorBlock(InPixels, OutBlock + 8);
+}
+
+auto CompressBlockBC5(const uint8_t InPixels[64], uint8_t OutBlock[16]) -> void
+{
+	for (int c = 0; c < 2; ++c)
+	{
+		uint8_t values[16];
+		for (int i = 0; i < 16; ++i)
+		{
+			values[i] = InPixels[i * 4 + c];
+		}
+		CompressChannelBlock(values, OutBlock + c * 8);
+	}
+}
+
+auto CompressBlockBC7(const uint8_t InPixels[64], uint8_t OutBlock[16]) -> void
+{
+	float points[16 * 4];
+	for (int i = 0; i < 64; ++i)
+	{
+		points[i] = InPixels[i];
+	}
+
+	float low[4];
+	float high[4];
+	GetAxisEndpoints(points, 16, 4, low, high);
+
+	Bc7Mode6Endpoints endpoints;
+	uint8_t indices[16];
+	int64_t error = FindBc7Mode6Endpoints(InPixels, low, high, endpoints, indices);
+
+	for (int iteration = 0; iteration < NumRefineIterations && error > 0; ++iteration)
+	{
+		float weights[16];
+		for (int i = 0; i < 16; ++i)
+		{
+			weights[i] = Bc7Weights4[indices[i]] / 64.0f;
+		}
+		if (!FitEndpoints(points, weights, 16, 4, low, high))
+		{
+			break;
+		}
+
+		Bc7Mode6Endpoints refinedEndpoints;
+		uint8_t refinedIndices[16];
+		const int64_t refinedError = FindBc7Mode6Endpoints(InPixels, low, high, refinedEndpoints, refinedIndices);
+		if (refinedError >= error)
+		{
+			break;
+		}
+		error = refinedError;
+		endpoints = refinedEndpoints;
+		std::memcpy(indices, refinedIndices, 16);
+	}
+
+	// The first index is stored without its top bit, swapping the endpoints clears it
+	if (indices[0] & 8)
+	{
+		std::swap(endpoints.Values[0], endpoints.Values[1]);
+		std::swap(endpoints.PBits[0], endpoints.PBits[1]);
+		for (uint8_t& index : indices)
+		{
+			index = 15 - index;
+		}
+	}
+
+	std::memset(OutBlock, 0, 16);
+	BlockBitWriter writer{ OutBlock };
+	writer.Write(1 << 6, 7);
+	for (int c = 0; c < 4; ++c)
+	{
+		writer.Write(endpoints.Values[0][c], 7);
+		writer.Write(endpoints.Values[1][c], 7);
+	}
+	writer.Write(endpoints.PBits[0], 1);
+	writer.Write(endpoints.PBits[1], 1);
+	for (int i = 0; i < 16; ++i)
+	{
+		writer.Write(indices[i], i == 0 ? 3 : 4);
+	}
+}
+
+auto DecompressBlockBC1(const uint8_t InBlock[8], uint8_t OutPixels[64]) -> void
+{
+	DecompressColorBlock(InBlock, true, OutPixels);
+}
+
+auto DecompressBlockBC3(const uint8_t InBlock[16], uint8_t OutPixels[64]) -> void
+{
+	DecompressColorBlock(InBlock + 8, false, OutPixels);
+
+	uint8_t alpha[16];
+	DecompressChannelBlock(InBlock, alpha);
+	for (int i = 0; i < 16; ++i)
+	{
+		OutPixels[i * 4 + 3] = alpha[i];
+	}
+}
+
+auto DecompressBlockBC5(const uint8_t InBlock[16], uint8_t OutPixels[64]) -> void
+{
+	uint8_t red[16];
+	uint8_t green[16];
+	DecompressChannelBlock(InBlock, red);
+	DecompressChannelBlock(InBlock + 8, green);
+	for (int i = 0; i < 16; ++i)
+	{
+		OutPixels[i * 4 + 0] = red[i];
+		OutPixels[i * 4 + 1] = green[i];
+		OutPixels[i * 4 + 2] = 0;
+		OutPixels[i * 4 + 3] = 255;
+	}
+}
+
+auto DecompressBlockBC7(const uint8_t InBlock[16], uint8_t OutPixels[64]) -> void
+{
+	std::memset(OutPixels, 0, 64);
+
+	BlockBitReader reader{ InBlock };
+	if (reader.Read(7) != (1 << 6))
+	{
+		return;
+	}
+
+	Bc7Mode6Endpoints endpoints;
+	for (int c = 0; c < 4; ++c)
+	{
+		endpoints.Values[0][c] = static_cast<uint8_t>(reader.Read(7));
+		endpoints.Values[1][c] = static_cast<uint8_t>(reader.Read(7));
+	}
+	endpoints.PBits[0] = static_cast<uint8_t>(reader.Read(1));
+	endpoints.PBits[1] = static_cast<uint8_t>(reader.Read(1));
+
+	for (int i = 0; i < 16; ++i)
+	{
+		const int32_t weight = Bc7Weights4[reader.Read(i == 0 ? 3 : 4)];
+		for (int c = 0; c < 4; ++c)
+		{
+			OutPixels[i * 4 + c] = static_cast<uint8_t>(InterpolateBc7(endpoints.Get(0, c), endpoints.Get(1, c), weight));
+		}
+	}
+}
+
+auto CompressImage(const TextureImage& InImage, TextureCompressionFormat InFormat) -> std::vector<uint8_t>
+{
+	std::vector<uint8_t> out(GetCompressedSize(InImage.Width, InImage.Height, InFormat));
+	if (InImage.Width == 0 || InImage.Height == 0)
+	{
+		return out;
+	}
+
+	const uint32_t blocksX = (InImage.Width + 3) / 4;
+	const uint32_t blocksY = (InImage.Height + 3) / 4;
+	const size_t blockSize = GetCompressedBlockSize(InFormat);
+
+	uint8_t pixels[64];
+	uint8_t* block = out.data();
+	for (uint32_t by = 0; by < blocksY; ++by)
+	{
+		for (uint32_t bx = 0; bx < blocksX; ++bx, block += blockSize)
+		{
+			GatherBlock(InImage, bx, by, pixels);
+			switch (InFormat)
+			{
+			case TextureCompressionFormat::BC1: CompressBlockBC1(pixels, block); break;
+			case TextureCompressionFormat::BC3: CompressBlockBC3(pixels, block); break;
+			case TextureCompressionFormat::BC5: CompressBlockBC5(pixels, block); break;
+			case TextureCompressionFormat::BC7: CompressBlockBC7(pixels, block); break;
+			}
+		}
+	}
+	return out;
+}
+
+auto DecompressImage(const uint8_t* InData, uint32_t InWidth, uint32_t InHeight, TextureCompressionFormat InFormat) -> TextureImage
+{
+	TextureImage out;
+	out.Width = InWidth;
+	out.Height = InHeight;
+	out.Pixels.resize(size_t(InWidth) * InHeight * 4);
+
+	const uint32_t blocksX = (InWidth + 3) / 4;
+	const uint32_t blocksY = (InHeight + 3) / 4;
+	const size_t blockSize = GetCompressedBlockSize(InFormat);
+
+	uint8_t pixels[64];
+	const uint8_t* block = InData;
+	for (uint32_t by = 0; by < blocksY; ++by)
+	{
+		for (uint32_t bx = 0; bx < blocksX; ++bx, block += blockSize)
+		{
+			switch (InFormat)
+			{
+			case TextureCompressionFormat::BC1: DecompressBlockBC1(block, pixels); break;
+			case TextureCompressionFormat::BC3: DecompressBlockBC3(block, pixels); break;
+			case TextureCompressionFormat::BC5: DecompressBlockBC5(block, pixels); break;
+			case TextureCompressionFormat::BC7: DecompressBlockBC7(block, pixels); break;
+			}
+
+			for (uint32_t y = 0; y < 4 && by * 4 + y < InHeight; ++y)
+			{
+				for (uint32_t x = 0; x < 4 && bx * 4 + x < InWidth; ++x)
+				{
+					std::memcpy(&out.Pixels[((size_t(by) * 4 + y) * InWidth + bx * 4 + x) * 4], &pixels[(y * 4 + x) * 4], 4);
+				}
+			}
+		}
+	}
+	return out;
+}
+
+auto ComputePsnr(const TextureImage& InA, const TextureImage& InB, uint32_t InChannelMask) -> float
+{
+	double squaredError = 0.0;
+	size_t numValues = 0;
+	const size_t size = (std::min)(InA.Pixels.size(), InB.Pixels.size());
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (InChannelMask & (1u << (i % 4)))
+		{
+			const double delta = double(InA.Pixels[i]) - InB.Pixels[i];
+			squaredError += delta * delta;
+			++numValues;
+		}
+	}
+
+	if (squaredError == 0.0 || numValues == 0)
+	{
+		return std::numeric_limits<float>::infinity();
+	}
+	return static_cast<float>(10.0 * std::log10(255.0 * 255.0 * numValues / squaredError));
+}
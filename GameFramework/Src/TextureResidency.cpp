@@ -0,0 +1,333 @@
+#include "TextureResidency.h"
+
+#include <algorithm>
+#include <cmath>
+
+auto TextureResidency::GetBytes(const TextureState& InState, uint32_t InFirstMip) -> size_t
+{
+	size_t bytes = 0;
+	for (size_t mip = InFirstMip; mip < InState.MipBytes.size(); ++mip)
+	{
+		bytes += InState.MipBytes[mip];
+	}
+	return bytes;
+}
+
+auto TextureResidency::GetCommittedBytes(const TextureState& InState) -> size_t
+{
+	return GetBytes(InState, InState.bPending ? (std::min)(InState.ResidentMip, InState.PendingMip) : InState.ResidentMip);
+}
+
+auto TextureResidency::CanStartChange(const TextureState& InState) const -> bool
+{
+	return !InState.bPending && InState.NumFailures < MaxFailures && Frame >= InState.RetryFrame;
+}
+
+auto TextureResidency::GetTailMip(uint32_t InWidth, uint32_t InHeight, uint32_t InMipLevels, uint32_t InMaxFirstMip) const -> uint32_t
+{
+	uint32_t mip = 0;
+	while (mip + 1 < InMipLevels && (std::max)(InWidth >> mip, InHeight >> mip) > MinResidentSize)
+	{
+		++mip;
+	}
+	return (std::min)(mip, InMaxFirstMip);
+}
+
+auto TextureResidency::AddTexture(uint32_t InWidth, uint32_t InHeight, std::vector<size_t> InMipBytes, uint32_t InTailMip) -> uint32_t
+{
+	if (InMipBytes.empty())
+	{
+		return InvalidId;
+	}
+
+	TextureState state;
+	state.Size = (std::max)(InWidth, InHeight);
+	state.MipBytes = std::move(InMipBytes);
+	state.TailMip = (std::min)(InTailMip, static_cast<uint32_t>(state.MipBytes.size() - 1));
+	state.ResidentMip = state.TailMip;
+	state.WantedMip = state.TailMip;
+	state.RequestedMip = state.TailMip;
+	state.LastRequestFrame = Frame;
+
+	const uint32_t id = NextId++;
+	Textures.emplace(id, std::move(state));
+	return id;
+}
+
+auto TextureResidency::RemoveTexture(uint32_t InId) -> void
+{
+	const auto it = Textures.find(InId);
+	if (it == Textures.end())
+	{
+		return;
+	}
+
+	NumPending -= it->second.bPending ? 1 : 0;
+	Textures.erase(it);
+}
+
+auto TextureResidency::RequestResolution(uint32_t InId, float InPixels) -> void
+{
+	const auto it = Textures.find(InId);
+	if (it == Textures.end())
+	{
+		return;
+	}
+
+	TextureState& state = it->second;
+	uint32_t mip = state.TailMip;
+	if (InPixels > 0.0f)
+	{
+		// Mip whose size matches the pixels covered, the texture is assumed to be mapped across the surface once
+		const float level = std::floor(std::log2(static_cast<float>(state.Size) / InPixels) + MipBias);
+		mip = level <= 0.0f ? 0 : static_cast<uint32_t>((std::min)(level, static_cast<float>(state.TailMip)));
+	}
+
+	state.RequestedMip = (std::min)(state.RequestedMip, mip);
+	state.bRequested = true;
+}
+
+auto TextureResidency::StartChange(uint32_t InId, TextureState& InState, uint32_t InFirstMip, std::vector<Change>& OutChanges) -> void
+{
+	InState.bPending = true;
+	InState.PendingMip = InFirstMip;
+	++NumPending;
+	OutChanges.push_back({ InId, InFirstMip });
+}
+
+auto TextureResidency::TrimUnwanted(size_t InBytes, std::vector<Change>& OutChanges) -> size_t
+{
+	std::vector<uint32_t> victims;
+	for (const auto& [id, state] : Textures)
+	{
+		if (CanStartChange(state) && state.ResidentMip < state.WantedMip)
+		{
+			victims.push_back(id);
+		}
+	}
+
+	std::sort(victims.begin(), victims.end(), [this](uint32_t a, uint32_t b)
+		{
+			const TextureState& stateA = Textures.at(a);
+			const TextureState& stateB = Textures.at(b);
+			if (stateA.LastRequestFrame != stateB.LastRequestFrame)
+			{
+				return stateA.LastRequestFrame < stateB.LastRequestFrame;
+			}
+			return a < b;
+		});
+
+	size_t freed = 0;
+	for (uint32_t id : victims)
+	{
+		if (freed >= InBytes || NumPending >= MaxPendingChanges)
+		{
+			break;
+		}
+
+		TextureState& state = Textures.at(id);
+		freed += GetBytes(state, state.ResidentMip) - GetBytes(state, state.WantedMip);
+		StartChange(id, state, state.WantedMip, OutChanges);
+	}
+	return freed;
+}
+
+auto TextureResidency::Update(std::vector<Change>& OutChanges) -> void
+{
+	++Frame;
+
+	// Memory the budget also has to hold, like the texture arrays
+	const size_t budget = MemoryBudget > ReservedBytes ? MemoryBudget - ReservedBytes : 0;
+	size_t committed = 0;
+	// Bytes of changes in flight that make textures smaller
+	size_t freeing = 0;
+	for (auto& [id, state] : Textures)
+	{
+		if (state.bRequested)
+		{
+			state.WantedMip = state.RequestedMip;
+			state.LastRequestFrame = Frame;
+		}
+		else if (Frame - state.LastRequestFrame > KeepFrames)
+		{
+			state.WantedMip = state.TailMip;
+		}
+		state.RequestedMip = state.TailMip;
+		state.bRequested = false;
+
+		committed += GetCommittedBytes(state);
+		if (state.bPending && state.PendingMip > state.ResidentMip)
+		{
+			freeing += GetBytes(state, state.ResidentMip) - GetBytes(state, state.PendingMip);
+		}
+	}
+
+	// Over budget, after a budget change or with more wanted than fits: mips nobody wants go first,
+	// then visible textures lose a mip each, least recently requested first
+	if (committed > budget + freeing)
+	{
+		const size_t excess = committed - budget - freeing;
+		size_t freed = TrimUnwanted(excess, OutChanges);
+
+		std::vector<uint32_t> degradable;
+		for (const auto& [id, state] : Textures)
+		{
+			if (CanStartChange(state) && state.ResidentMip < state.TailMip)
+			{
+				degradable.push_back(id);
+			}
+		}
+		std::sort(degradable.begin(), degradable.end(), [this](uint32_t a, uint32_t b)
+			{
+				const TextureState& stateA = Textures.at(a);
+				const TextureState& stateB = Textures.at(b);
+				if (stateA.LastRequestFrame != stateB.LastRequestFrame)
+				{
+					return stateA.LastRequestFrame < stateB.LastRequestFrame;
+				}
+				return a < b;
+			});
+
+		for (uint32_t id : degradable)
+		{
+			if (freed >= excess || NumPending >= MaxPendingChanges)
+			{
+				break;
+			}
+
+			TextureState& state = Textures.at(id);
+			freed += state.MipBytes[state.ResidentMip];
+			StartChange(id, state, state.ResidentMip + 1, OutChanges);
+		}
+		// All of it goes to the excess, what is left over can make room for stream ins
+		freeing = freed > excess ? freed - excess : 0;
+	}
+
+	// Stream ins, the textures missing the most mips first
+	std::vector<uint32_t> candidates;
+	for (const auto& [id, state] : Textures)
+	{
+		if (CanStartChange(state) && state.WantedMip < state.ResidentMip)
+		{
+			candidates.push_back(id);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b)
+		{
+			const TextureState& stateA = Textures.at(a);
+			const TextureState& stateB = Textures.at(b);
+			const uint32_t missingA = stateA.ResidentMip - stateA.WantedMip;
+			const uint32_t missingB = stateB.ResidentMip - stateB.WantedMip;
+			if (missingA != missingB)
+			{
+				return missingA > missingB;
+			}
+			return a < b;
+		});
+
+	for (uint32_t id : candidates)
+	{
+		if (NumPending >= MaxPendingChanges)
+		{
+			break;
+		}
+
+		TextureState& state = Textures.at(id);
+		const size_t residentBytes = GetBytes(state, state.ResidentMip);
+		const size_t available = budget > committed ? budget - committed : 0;
+		const size_t needed = GetBytes(state, state.WantedMip) - residentBytes;
+
+		uint32_t firstMip = state.WantedMip;
+		if (needed > available)
+		{
+			// Make room for the next frames, the memory is only free once the owner swapped the smaller textures in
+			const size_t shortfall = needed - available;
+			if (freeing < shortfall)
+			{
+				freeing += TrimUnwanted(shortfall - freeing, OutChanges);
+			}
+			freeing = freeing > shortfall ? freeing - shortfall : 0;
+
+			// Meanwhile as many mips as fit now
+			firstMip = state.ResidentMip;
+			while (firstMip > state.WantedMip && GetBytes(state, firstMip - 1) - residentBytes <= available)
+			{
+				--firstMip;
+			}
+			if (firstMip == state.ResidentMip || NumPending >= MaxPendingChanges)
+			{
+				continue;
+			}
+		}
+
+		committed += GetBytes(state, firstMip) - residentBytes;
+		StartChange(id, state, firstMip, OutChanges);
+	}
+}
+
+auto TextureResidency::CompleteChange(uint32_t InId, bool bInSucceeded) -> void
+{
+	const auto it = Textures.find(InId);
+	if (it == Textures.end() || !it->second.bPending)
+	{
+		return;
+	}
+
+	TextureState& state = it->second;
+	state.bPending = false;
+	--NumPending;
+
+	if (bInSucceeded)
+	{
+		++(state.PendingMip < state.ResidentMip ? NumStreamedIn : NumStreamedOut);
+		state.ResidentMip = state.PendingMip;
+		state.NumFailures = 0;
+		return;
+	}
+
+	// Retrying right away would fail the same way every frame
+	++NumFailed;
+	++state.NumFailures;
+	state.RetryFrame = Frame + (uint64_t(RetryFrames) << (std::min)(state.NumFailures - 1, 16u));
+}
+
+auto TextureResidency::GetResidentMip(uint32_t InId) const -> uint32_t
+{
+	const auto it = Textures.find(InId);
+	return it != Textures.end() ? it->second.ResidentMip : 0;
+}
+
+auto TextureResidency::GetWantedMip(uint32_t InId) const -> uint32_t
+{
+	const auto it = Textures.find(InId);
+	return it != Textures.end() ? it->second.WantedMip : 0;
+}
+
+auto TextureResidency::IsPending(uint32_t InId) const -> bool
+{
+	const auto it = Textures.find(InId);
+	return it != Textures.end() && it->second.bPending;
+}
+
+auto TextureResidency::IsStreamable(uint32_t InId) const -> bool
+{
+	const auto it = Textures.find(InId);
+	return it != Textures.end() && it->second.NumFailures < MaxFailures;
+}
+
+auto TextureResidency::GetStats() const -> Stats
+{
+	Stats stats;
+	stats.NumTextures = static_cast<uint32_t>(Textures.size());
+	stats.NumPending = NumPending;
+	stats.NumStreamedIn = NumStreamedIn;
+	stats.NumStreamedOut = NumStreamedOut;
+	stats.NumFailed = NumFailed;
+	for (const auto& [id, state] : Textures)
+	{
+		stats.NumUnstreamable += state.NumFailures >= MaxFailures ? 1 : 0;
+		stats.ResidentBytes += GetBytes(state, state.ResidentMip);
+		stats.WantedBytes += GetBytes(state, state.WantedMip);
+	}
+	return stats;
+}
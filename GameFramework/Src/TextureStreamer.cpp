@@ -0,0 +1,128 @@
+#include "TextureStreamer.h"
+
+#include "BinaryArchive.h"
+#include "DdsFile.h"
+#include "Game.h"
+#include "RenderingSystem.h"
+#include "StreamedTexture.h"
+#include "TextureUtils.h"
+
+#include <algorithm>
+
+TextureStreamer::TextureStreamer(uint32_t InNumThreads)
+{
+	for (uint32_t i = 0; i < (std::max)(InNumThreads, 1u); ++i)
+	{
+		Threads.emplace_back(&TextureStreamer::ThreadLoop, this);
+	}
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	{
+		std::lock_guard lock(Mutex);
+		bStopRequested = true;
+	}
+	WorkCondition.notify_all();
+
+	for (std::thread& thread : Threads)
+	{
+		thread.join();
+	}
+}
+
+auto TextureStreamer::Register(StreamedTexture* InTexture, const Path& InCookedPath, uint32_t InWidth, uint32_t InHeight,
+	std::vector<size_t> InMipBytes, uint32_t InTailMip) -> uint32_t
+{
+	const uint32_t id = Residency.AddTexture(InWidth, InHeight, std::move(InMipBytes), InTailMip);
+	if (id != TextureResidency::InvalidId)
+	{
+		Entries.insert({ id, Entry{ InTexture, InCookedPath } });
+	}
+	return id;
+}
+
+auto TextureStreamer::Unregister(uint32_t InId) -> void
+{
+	Residency.RemoveTexture(InId);
+	Entries.erase(InId);
+}
+
+auto TextureStreamer::Tick() -> void
+{
+	std::deque<Result> finished;
+	{
+		std::lock_guard lock(Mutex);
+		finished.swap(Finished);
+	}
+
+	for (Result& result : finished)
+	{
+		// Ids aren't reused, an unregistered texture never gets the result of an older registration
+		const auto it = Entries.find(result.Id);
+		if (it == Entries.end())
+		{
+			continue;
+		}
+
+		const bool bSucceeded = result.TexSRV != nullptr;
+		if (bSucceeded)
+		{
+			it->second.Texture->PublishMips(std::move(result.Tex), std::move(result.TexSRV));
+		}
+		Residency.CompleteChange(result.Id, bSucceeded);
+	}
+
+	// The texture arrays share the video memory the streamed textures get
+	RenderingSystem* rendering = Game::GetInstance()->MyRenderingSystem;
+	Residency.SetReservedBytes(rendering != nullptr ? rendering->GetTextureArrayTable()->GetMemorySize() : 0);
+
+	Changes.clear();
+	Residency.Update(Changes);
+	if (Changes.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard lock(Mutex);
+		for (const TextureResidency::Change& change : Changes)
+		{
+			Queued.push_back({ change.Id, Entries.at(change.Id).CookedPath, change.FirstMip });
+		}
+	}
+	WorkCondition.notify_all();
+}
+
+auto TextureStreamer::ThreadLoop() -> void
+{
+	while (true)
+	{
+		Request request;
+		{
+			std::unique_lock lock(Mutex);
+			WorkCondition.wait(lock, [this] { return bStopRequested || !Queued.empty(); });
+			if (bStopRequested)
+			{
+				break;
+			}
+			request = std::move(Queued.front());
+			Queued.pop_front();
+		}
+
+		// The device is free threaded, the new texture is uploaded straight from the mapping
+		Result result{ request.Id };
+		MappedFile file;
+		DdsTextureInfo info;
+		if (file.Open(request.CookedPath) && ParseDdsTexture(file.GetData(), file.GetSize(), info) && request.FirstMip < info.MipLevels)
+		{
+			ID3D11Device* device = Game::GetInstance()->GetD3DDevice().Get();
+			CreateTextureFromDds(device, info, request.FirstMip, result.Tex.GetAddressOf(), result.TexSRV.GetAddressOf());
+		}
+
+		{
+			std::lock_guard lock(Mutex);
+			Finished.push_back(std::move(result));
+		}
+	}
+}
@@ -0,0 +1,207 @@
+#include "TextureUtils.h"
+#include "BinaryArchive.h"
+#include "DdsFile.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <DDSTextureLoader.h>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+	// Bytes per 4x4 block for block compressed formats, 0 otherwise
+	auto GetBlockSize(DXGI_FORMAT InFormat) -> size_t
+	{
+		switch (InFormat)
+		{
+		case DXGI_FORMAT_BC1_TYPELESS:
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_TYPELESS:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC4_SNORM:
+			return 8;
+
+		case DXGI_FORMAT_BC2_TYPELESS:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_TYPELESS:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_TYPELESS:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC5_SNORM:
+		case DXGI_FORMAT_BC6H_TYPELESS:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+		case DXGI_FORMAT_BC7_TYPELESS:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return 16;
+
+		default:
+			return 0;
+		}
+	}
+
+	auto GetBytesPerPixel(DXGI_FORMAT InFormat) -> size_t
+	{
+		switch (InFormat)
+		{
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_UINT:
+			return 16;
+
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		case DXGI_FORMAT_R16G16B16A16_UNORM:
+		case DXGI_FORMAT_R32G32_FLOAT:
+			return 8;
+
+		case DXGI_FORMAT_R8G8_UNORM:
+		case DXGI_FORMAT_R16_FLOAT:
+		case DXGI_FORMAT_R16_UNORM:
+		case DXGI_FORMAT_B5G6R5_UNORM:
+		case DXGI_FORMAT_B5G5R5A1_UNORM:
+			return 2;
+
+		case DXGI_FORMAT_R8_UNORM:
+		case DXGI_FORMAT_A8_UNORM:
+			return 1;
+
+		// RGBA8, BGRA8, R10G10B10A2, R32 and most of what WIC produces
+		default:
+			return 4;
+		}
+	}
+}
+
+auto GetTextureMemorySize(ID3D11Resource* InResource) -> size_t
+{
+	if (InResource == nullptr)
+	{
+		return 0;
+	}
+
+	ComPtr<ID3D11Texture2D> texture;
+	if (FAILED(InResource->QueryInterface(IID_PPV_ARGS(texture.GetAddressOf()))))
+	{
+		return 0;
+	}
+
+	D3D11_TEXTURE2D_DESC desc;
+	texture->GetDesc(&desc);
+
+	const size_t blockSize = GetBlockSize(desc.Format);
+	const size_t bytesPerPixel = GetBytesPerPixel(desc.Format);
+
+	size_t size = 0;
+	for (UINT mip = 0; mip < desc.MipLevels; ++mip)
+	{
+		const size_t width = (std::max)(desc.Width >> mip, 1u);
+		const size_t height = (std::max)(desc.Height >> mip, 1u);
+
+		size += blockSize != 0
+			? ((width + 3) / 4) * ((height + 3) / 4) * blockSize
+			: width * height * bytesPerPixel;
+	}
+
+	return size * desc.ArraySize;
+}
+
+auto CreateTextureFromDds(ID3D11Device* InDevice, const DdsTextureInfo& InInfo, uint32_t InFirstMip,
+	ID3D11Resource** OutTexture, ID3D11ShaderResourceView** OutTextureSRV) -> HRESULT
+{
+	if (InDevice == nullptr || OutTexture == nullptr || InInfo.Subresources.empty() || InFirstMip >= InInfo.MipLevels)
+	{
+		return E_INVALIDARG;
+	}
+
+	const uint32_t mipLevels = InInfo.MipLevels - InFirstMip;
+	const DdsSubresource& top = InInfo.Subresources[InFirstMip];
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = top.Width;
+	desc.Height = top.Height;
+	desc.MipLevels = mipLevels;
+	desc.ArraySize = InInfo.ArraySize;
+	desc.Format = InInfo.Format;
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.MiscFlags = InInfo.bCubeMap ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0;
+
+	std::vector<D3D11_SUBRESOURCE_DATA> initData;
+	initData.reserve(size_t(InInfo.ArraySize) * mipLevels);
+	for (uint32_t slice = 0; slice < InInfo.ArraySize; ++slice)
+	{
+		for (uint32_t mip = InFirstMip; mip < InInfo.MipLevels; ++mip)
+		{
+			const DdsSubresource& subresource = InInfo.Subresources[size_t(slice) * InInfo.MipLevels + mip];
+			D3D11_SUBRESOURCE_DATA& data = initData.emplace_back();
+			data.pSysMem = subresource.Data;
+			data.SysMemPitch = static_cast<UINT>(subresource.RowPitch);
+			data.SysMemSlicePitch = static_cast<UINT>(subresource.SlicePitch);
+		}
+	}
+
+	ComPtr<ID3D11Texture2D> texture;
+	HRESULT hr = InDevice->CreateTexture2D(&desc, initData.data(), texture.GetAddressOf());
+	if (FAILED(hr))
+	{
+		return hr;
+	}
+
+	if (OutTextureSRV != nullptr)
+	{
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+		srvDesc.Format = InInfo.Format;
+		if (InInfo.bCubeMap && InInfo.ArraySize > 6)
+		{
+			srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBEARRAY;
+			srvDesc.TextureCubeArray.MipLevels = mipLevels;
+			srvDesc.TextureCubeArray.NumCubes = InInfo.ArraySize / 6;
+		}
+		else if (InInfo.bCubeMap)
+		{
+			srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+			srvDesc.TextureCube.MipLevels = mipLevels;
+		}
+		else if (InInfo.ArraySize > 1)
+		{
+			srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+			srvDesc.Texture2DArray.MipLevels = mipLevels;
+			srvDesc.Texture2DArray.ArraySize = InInfo.ArraySize;
+		}
+		else
+		{
+			srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+			srvDesc.Texture2D.MipLevels = mipLevels;
+		}
+
+		hr = InDevice->CreateShaderResourceView(texture.Get(), &srvDesc, OutTextureSRV);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+	}
+
+	*OutTexture = texture.Detach();
+	return S_OK;
+}
+
+auto LoadDdsTexture(ID3D11Device* InDevice, const Path& InPath,
+	ID3D11Resource** OutTexture, ID3D11ShaderResourceView** OutTextureSRV) -> HRESULT
+{
+	// The mapping only has to live until CreateTexture2D has copied the data
+	MappedFile file;
+	DdsTextureInfo info;
+	if (file.Open(InPath) && ParseDdsTexture(file.GetData(), file.GetSize(), info))
+	{
+		return CreateTextureFromDds(InDevice, info, 0, OutTexture, OutTextureSRV);
+	}
+
+	return DirectX::CreateDDSTextureFromFile(InDevice, InPath.wstring().c_str(), OutTexture, OutTextureSRV);
+}
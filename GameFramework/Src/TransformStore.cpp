@@ -0,0 +1,315 @@
+#include "TransformStore.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <type_traits>
+
+using namespace DirectX;
+
+namespace
+{
+	auto ComputeLocalMatrix(const Vector3& Position, const Quaternion& Rotation, const Vector3& Scale) -> XMMATRIX
+	{
+		// Same as Transform::GetTransformMatrix(): scale * rotate * translate
+		return XMMatrixAffineTransformation(XMLoadFloat3(&Scale), XMVectorZero(), XMLoadFloat4(&Rotation), XMLoadFloat3(&Position));
+	}
+}
+
+auto TransformStore::Allocate() -> Handle
+{
+	Handle handle;
+	if (!FreeHandles.empty())
+	{
+		handle = FreeHandles.back();
+		FreeHandles.pop_back();
+	}
+	else
+	{
+		handle = static_cast<Handle>(HandleToDense.size());
+		HandleToDense.push_back(InvalidHandle);
+	}
+
+	// New entries are roots, so appending them keeps parents before children
+	HandleToDense[handle] = static_cast<uint32_t>(Positions.size());
+
+	Positions.push_back(Vector3::Zero);
+	Rotations.push_back(Quaternion::Identity);
+	Scales.push_back(Vector3::One);
+	WorldMatrices.push_back(Matrix::Identity);
+	WorldTransforms.emplace_back();
+	ParentHandles.push_back(InvalidHandle);
+	ParentIndices.push_back(InvalidHandle);
+	Flags.push_back(WorldMatrixDirty | WorldTransformDirty);
+	DenseToHandle.push_back(handle);
+
+	return handle;
+}
+
+auto TransformStore::Release(Handle InHandle) -> void
+{
+	assert(InHandle < HandleToDense.size() && HandleToDense[InHandle] != InvalidHandle);
+
+	const uint32_t dense = HandleToDense[InHandle];
+	const uint32_t last = static_cast<uint32_t>(Positions.size()) - 1;
+
+	if (dense != last)
+	{
+		Positions[dense] = Positions[last];
+		Rotations[dense] = Rotations[last];
+		Scales[dense] = Scales[last];
+		WorldMatrices[dense] = WorldMatrices[last];
+		WorldTransforms[dense] = WorldTransforms[last];
+		ParentHandles[dense] = ParentHandles[last];
+		Flags[dense] = Flags[last];
+		DenseToHandle[dense] = DenseToHandle[last];
+		HandleToDense[DenseToHandle[dense]] = dense;
+
+		// The moved entry may now go before its parent and its children point to a stale index
+		bNeedsRelayout = true;
+	}
+
+	Positions.pop_back();
+	Rotations.pop_back();
+	Scales.pop_back();
+	WorldMatrices.pop_back();
+	WorldTransforms.pop_back();
+	ParentHandles.pop_back();
+	ParentIndices.pop_back();
+	Flags.pop_back();
+	DenseToHandle.pop_back();
+
+	HandleToDense[InHandle] = InvalidHandle;
+	FreeHandles.push_back(InHandle);
+}
+
+auto TransformStore::SetParent(Handle InHandle, Handle InParent) -> void
+{
+	const uint32_t dense = HandleToDense[InHandle];
+	ParentHandles[dense] = InParent;
+
+	if (InParent == InvalidHandle)
+	{
+		ParentIndices[dense] = InvalidHandle;
+	}
+	else
+	{
+		const uint32_t parentDense = HandleToDense[InParent];
+		ParentIndices[dense] = parentDense;
+
+		// Entry (and its children) have to be moved after the new parent, relayout handles all of it at once
+		if (parentDense > dense)
+		{
+			bNeedsRelayout = true;
+		}
+	}
+
+	Flags[dense] |= WorldMatrixDirty | WorldTransformDirty;
+}
+
+auto TransformStore::SetRelativeTransform(Handle InHandle, const Transform& InTransform) -> void
+{
+	const uint32_t dense = HandleToDense[InHandle];
+	Positions[dense] = InTransform.Position;
+	Rotations[dense] = InTransform.Rotation.GetQuaterion();
+	Scales[dense] = InTransform.Scale;
+	Flags[dense] |= WorldMatrixDirty | WorldTransformDirty;
+}
+
+auto TransformStore::GetRelativeTransform(Handle InHandle) const -> Transform
+{
+	const uint32_t dense = HandleToDense[InHandle];
+	return Transform(Positions[dense], Rotator(Rotations[dense]), Scales[dense]);
+}
+
+auto TransformStore::SetRelativePosition(Handle InHandle, const Vector3& InPosition) -> void
+{
+	const uint32_t dense = HandleToDense[InHandle];
+	Positions[dense] = InPosition;
+	Flags[dense] |= WorldMatrixDirty | WorldTransformDirty;
+}
+
+auto TransformStore::SetRelativeRotation(Handle InHandle, const Quaternion& InRotation) -> void
+{
+	const uint32_t dense = HandleToDense[InHandle];
+	Rotations[dense] = InRotation;
+	Flags[dense] |= WorldMatrixDirty | WorldTransformDirty;
+}
+
+auto TransformStore::SetRelativeScale(Handle InHandle, const Vector3& InScale) -> void
+{
+	const uint32_t dense = HandleToDense[InHandle];
+	Scales[dense] = InScale;
+	Flags[dense] |= WorldMatrixDirty | WorldTransformDirty;
+}
+
+auto TransformStore::MarkDirty(Handle InHandle) -> void
+{
+	Flags[HandleToDense[InHandle]] |= WorldMatrixDirty | WorldTransformDirty;
+}
+
+auto TransformStore::GetWorldMatrix(Handle InHandle) -> const Matrix&
+{
+	const uint32_t dense = HandleToDense[InHandle];
+	if (Flags[dense] & WorldMatrixDirty)
+	{
+		UpdateWorldMatrix(dense);
+	}
+
+	return WorldMatrices[dense];
+}
+
+auto TransformStore::GetWorldTransform(Handle InHandle) -> const Transform&
+{
+	const uint32_t dense = HandleToDense[InHandle];
+	if (Flags[dense] & WorldMatrixDirty)
+	{
+		UpdateWorldMatrix(dense);
+	}
+
+	if (Flags[dense] & WorldTransformDirty)
+	{
+		if (ParentHandles[dense] == InvalidHandle)
+		{
+			// Avoid decomposition precision loss for roots
+			WorldTransforms[dense] = Transform(Positions[dense], Rotator(Rotations[dense]), Scales[dense]);
+		}
+		else
+		{
+			WorldTransforms[dense].SetFromMatrix(WorldMatrices[dense]);
+		}
+
+		Flags[dense] &= static_cast<uint8_t>(~WorldTransformDirty);
+	}
+
+	return WorldTransforms[dense];
+}
+
+auto TransformStore::UpdateWorldMatrix(uint32_t InDense) -> void
+{
+	// Collect dirty ancestors first and resolve them top-down, deep chains would overflow the stack with recursion.
+	// The scratch vector keeps its capacity, reads after a move don't allocate.
+	std::vector<uint32_t>& chain = ChainScratch;
+	chain.clear();
+	for (uint32_t dense = InDense; dense != InvalidHandle && (Flags[dense] & WorldMatrixDirty);)
+	{
+		chain.push_back(dense);
+
+		const Handle parent = ParentHandles[dense];
+		dense = parent == InvalidHandle ? InvalidHandle : HandleToDense[parent];
+	}
+
+	for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+	{
+		const uint32_t dense = *it;
+		const XMMATRIX local = ComputeLocalMatrix(Positions[dense], Rotations[dense], Scales[dense]);
+
+		const Handle parent = ParentHandles[dense];
+		if (parent == InvalidHandle)
+		{
+			XMStoreFloat4x4(&WorldMatrices[dense], local);
+		}
+		else
+		{
+			XMStoreFloat4x4(&WorldMatrices[dense], XMMatrixMultiply(local, XMLoadFloat4x4(&WorldMatrices[HandleToDense[parent]])));
+		}
+
+		Flags[dense] = static_cast<uint8_t>((Flags[dense] & ~WorldMatrixDirty) | WorldTransformDirty);
+	}
+}
+
+auto TransformStore::UpdateWorldMatrices() -> void
+{
+	if (bNeedsRelayout)
+	{
+		Relayout();
+	}
+
+	const size_t num = Positions.size();
+	for (size_t i = 0; i < num; ++i)
+	{
+		const uint32_t parent = ParentIndices[i];
+
+		// Parents are always processed first, so a moved parent has already dirtied this entry through its owner
+		if (!(Flags[i] & WorldMatrixDirty))
+		{
+			continue;
+		}
+
+		const XMMATRIX local = ComputeLocalMatrix(Positions[i], Rotations[i], Scales[i]);
+		if (parent == InvalidHandle)
+		{
+			XMStoreFloat4x4(&WorldMatrices[i], local);
+		}
+		else
+		{
+			XMStoreFloat4x4(&WorldMatrices[i], XMMatrixMultiply(local, XMLoadFloat4x4(&WorldMatrices[parent])));
+		}
+
+		Flags[i] = static_cast<uint8_t>((Flags[i] & ~WorldMatrixDirty) | WorldTransformDirty);
+	}
+}
+
+auto TransformStore::Relayout() -> void
+{
+	const uint32_t num = static_cast<uint32_t>(Positions.size());
+
+	// Hierarchy depth of every entry, resolved iteratively with memoization
+	std::vector<uint32_t> depths(num, InvalidHandle);
+	std::vector<uint32_t> chain;
+	for (uint32_t i = 0; i < num; ++i)
+	{
+		uint32_t dense = i;
+		while (dense != InvalidHandle && depths[dense] == InvalidHandle)
+		{
+			chain.push_back(dense);
+
+			const Handle parent = ParentHandles[dense];
+			dense = parent == InvalidHandle ? InvalidHandle : HandleToDense[parent];
+		}
+
+		uint32_t depth = dense == InvalidHandle ? 0 : depths[dense] + 1;
+		for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+		{
+			depths[*it] = depth++;
+		}
+		chain.clear();
+	}
+
+	std::vector<uint32_t> order(num);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&depths](uint32_t a, uint32_t b) { return depths[a] < depths[b]; });
+
+	auto permute = [&order](auto& arr)
+	{
+		std::remove_reference_t<decltype(arr)> sorted;
+		sorted.reserve(arr.size());
+		for (const uint32_t from : order)
+		{
+			sorted.push_back(arr[from]);
+		}
+		arr.swap(sorted);
+	};
+
+	permute(Positions);
+	permute(Rotations);
+	permute(Scales);
+	permute(WorldMatrices);
+	permute(WorldTransforms);
+	permute(ParentHandles);
+	permute(Flags);
+	permute(DenseToHandle);
+
+	for (uint32_t i = 0; i < num; ++i)
+	{
+		HandleToDense[DenseToHandle[i]] = i;
+	}
+
+	for (uint32_t i = 0; i < num; ++i)
+	{
+		const Handle parent = ParentHandles[i];
+		ParentIndices[i] = parent == InvalidHandle ? InvalidHandle : HandleToDense[parent];
+	}
+
+	bNeedsRelayout = false;
+}
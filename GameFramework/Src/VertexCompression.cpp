@@ -0,0 +1,130 @@
+#include "VertexCompression.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	auto Dot(const Vector3& InA, const Vector3& InB) -> float
+	{
+		return InA.x * InB.x + InA.y * InB.y + InA.z * InB.z;
+	}
+
+	auto Cross(const Vector3& InA, const Vector3& InB) -> Vector3
+	{
+		return Vector3{ InA.y * InB.z - InA.z * InB.y, InA.z * InB.x - InA.x * InB.z, InA.x * InB.y - InA.y * InB.x };
+	}
+
+	auto Normalized(const Vector3& InVector) -> Vector3
+	{
+		const float length = std::sqrt(Dot(InVector, InVector));
+		return length > 0.0f ? Vector3{ InVector.x / length, InVector.y / length, InVector.z / length } : Vector3{ 0.0f, 0.0f, 0.0f };
+	}
+
+	auto AngleDegrees(const Vector3& InA, const Vector3& InB) -> float
+	{
+		const Vector3 a = Normalized(InA);
+		const Vector3 b = Normalized(InB);
+		if (Dot(a, a) == 0.0f || Dot(b, b) == 0.0f)
+		{
+			return 0.0f;
+		}
+		return std::acos(std::clamp(Dot(a, b), -1.0f, 1.0f)) * 57.2957795f;
+	}
+}
+
+auto OctahedralEncode(const Vector3& InDirection, int16_t OutEncoded[2]) -> void
+{
+	OctahedralEncode(InDirection.x, InDirection.y, InDirection.z, OutEncoded);
+}
+
+auto OctahedralDecode(const int16_t InEncoded[2]) -> Vector3
+{
+	float direction[3];
+	OctahedralDecode(InEncoded, direction);
+	return Vector3{ direction[0], direction[1], direction[2] };
+}
+
+auto PackVertex(const TexturedVertex& InVertex) -> PackedTexturedVertex
+{
+	PackedTexturedVertex out;
+
+	const Vector3 normal = Normalized(InVertex.Normal);
+	const Vector3 tangent = Normalized(InVertex.Tangent);
+	const float binormalSign = Dot(Cross(normal, tangent), InVertex.Binormal) < 0.0f ? -1.0f : 1.0f;
+
+	out.Position[0] = FloatToHalf(InVertex.Position.x);
+	out.Position[1] = FloatToHalf(InVertex.Position.y);
+	out.Position[2] = FloatToHalf(InVertex.Position.z);
+	out.Position[3] = FloatToHalf(binormalSign);
+
+	OctahedralEncode(normal, out.Normal);
+	OctahedralEncode(tangent, out.Tangent);
+
+	out.TexCoord[0] = FloatToHalf(InVertex.TexCoord.x);
+	out.TexCoord[1] = FloatToHalf(InVertex.TexCoord.y);
+
+	return out;
+}
+
+auto UnpackVertex(const PackedTexturedVertex& InVertex) -> TexturedVertex
+{
+	TexturedVertex out;
+
+	out.Position = Vector3{ HalfToFloat(InVertex.Position[0]), HalfToFloat(InVertex.Position[1]), HalfToFloat(InVertex.Position[2]) };
+	out.Normal = OctahedralDecode(InVertex.Normal);
+	out.Tangent = OctahedralDecode(InVertex.Tangent);
+
+	const Vector3 binormal = Cross(out.Normal, out.Tangent);
+	const float binormalSign = HalfToFloat(InVertex.Position[3]);
+	out.Binormal = Vector3{ binormal.x * binormalSign, binormal.y * binormalSign, binormal.z * binormalSign };
+
+	out.TexCoord = Vector2{ HalfToFloat(InVertex.TexCoord[0]), HalfToFloat(InVertex.TexCoord[1]) };
+
+	return out;
+}
+
+auto MeasurePackingError(const TexturedVertex* InVertices, size_t InNumVertices) -> VertexPackingError
+{
+	VertexPackingError error;
+	for (size_t i = 0; i < InNumVertices; ++i)
+	{
+		const TexturedVertex& vertex = InVertices[i];
+		const TexturedVertex unpacked = UnpackVertex(PackVertex(vertex));
+
+		error.Position = (std::max)({ error.Position,
+			std::abs(vertex.Position.x - unpacked.Position.x),
+			std::abs(vertex.Position.y - unpacked.Position.y),
+			std::abs(vertex.Position.z - unpacked.Position.z) });
+		error.TexCoord = (std::max)({ error.TexCoord,
+			std::abs(vertex.TexCoord.x - unpacked.TexCoord.x),
+			std::abs(vertex.TexCoord.y - unpacked.TexCoord.y) });
+		error.NormalDegrees = (std::max)(error.NormalDegrees, AngleDegrees(vertex.Normal, unpacked.Normal));
+		error.TangentDegrees = (std::max)(error.TangentDegrees, AngleDegrees(vertex.Tangent, unpacked.Tangent));
+	}
+	return error;
+}
+
+auto CanPackVertices(const TexturedVertex* InVertices, size_t InNumVertices) -> bool
+{
+	if (InNumVertices == 0)
+	{
+		return false;
+	}
+
+	Vector3 boundsMin = InVertices[0].Position;
+	Vector3 boundsMax = InVertices[0].Position;
+	for (size_t i = 1; i < InNumVertices; ++i)
+	{
+		const Vector3& position = InVertices[i].Position;
+		boundsMin = Vector3{ (std::min)(boundsMin.x, position.x), (std::min)(boundsMin.y, position.y), (std::min)(boundsMin.z, position.z) };
+		boundsMax = Vector3{ (std::max)(boundsMax.x, position.x), (std::max)(boundsMax.y, position.y), (std::max)(boundsMax.z, position.z) };
+	}
+
+	const Vector3 extent{ boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z };
+	const float diagonal = std::sqrt(Dot(extent, extent));
+
+	const VertexPackingError error = MeasurePackingError(InVertices, InNumVertices);
+	return std::isfinite(error.Position) && error.Position <= MaxPackedPositionError * diagonal
+		&& std::isfinite(error.TexCoord) && error.TexCoord <= MaxPackedTexCoordError;
+}
@@ -0,0 +1,118 @@
+#include "VertexQuantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	auto SignNotZero(float InValue) -> float
+	{
+		return InValue >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	// Same as the DXGI snorm conversion rules
+	auto ToSnorm16(float InValue) -> int16_t
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(InValue, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	auto FromSnorm16(int16_t InValue) -> float
+	{
+		return (std::max)(InValue / 32767.0f, -1.0f);
+	}
+}
+
+auto FloatToHalf(float InValue) -> uint16_t
+{
+	uint32_t bits;
+	std::memcpy(&bits, &InValue, sizeof(bits));
+
+	const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+	const uint32_t absBits = bits & 0x7FFFFFFF;
+
+	if (absBits >= 0x7F800000)
+	{
+		// Inf stays inf, NaN stays a quiet NaN
+		return sign | (absBits > 0x7F800000 ? 0x7E00 : 0x7C00);
+	}
+	if (absBits >= 0x477FF000)
+	{
+		// Rounds to 65520 or more
+		return sign | 0x7C00;
+	}
+	if (absBits < 0x38800000)
+	{
+		// Half denormals are multiples of 2^-24, the scale is exact so only the rounding is lossy
+		float absValue;
+		std::memcpy(&absValue, &absBits, sizeof(absValue));
+		return sign | static_cast<uint16_t>(std::nearbyint(absValue * 16777216.0f));
+	}
+
+	// Round to nearest even on the 13 dropped mantissa bits, then rebias the exponent from 127 to 15
+	const uint32_t rounded = absBits + 0xFFF + ((absBits >> 13) & 1);
+	return sign | static_cast<uint16_t>((rounded - 0x38000000) >> 13);
+}
+
+auto HalfToFloat(uint16_t InValue) -> float
+{
+	const uint32_t sign = uint32_t(InValue & 0x8000) << 16;
+	const uint32_t exponent = (InValue >> 10) & 0x1F;
+	const uint32_t mantissa = InValue & 0x3FF;
+
+	if (exponent == 0)
+	{
+		const float value = mantissa / 16777216.0f;
+		return sign ? -value : value;
+	}
+
+	const uint32_t bits = exponent == 0x1F
+		? sign | 0x7F800000 | (mantissa << 13)
+		: sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+	float out;
+	std::memcpy(&out, &bits, sizeof(out));
+	return out;
+}
+
+auto OctahedralEncode(float InX, float InY, float InZ, int16_t OutEncoded[2]) -> void
+{
+	const float l1 = std::abs(InX) + std::abs(InY) + std::abs(InZ);
+	if (l1 == 0.0f)
+	{
+		OutEncoded[0] = 0;
+		OutEncoded[1] = 0;
+		return;
+	}
+
+	float x = InX / l1;
+	float y = InY / l1;
+	if (InZ < 0.0f)
+	{
+		// Lower hemisphere is folded over the diagonals
+		const float foldedX = (1.0f - std::abs(y)) * SignNotZero(x);
+		const float foldedY = (1.0f - std::abs(x)) * SignNotZero(y);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	OutEncoded[0] = ToSnorm16(x);
+	OutEncoded[1] = ToSnorm16(y);
+}
+
+auto OctahedralDecode(const int16_t InEncoded[2], float OutDirection[3]) -> void
+{
+	float x = FromSnorm16(InEncoded[0]);
+	float y = FromSnorm16(InEncoded[1]);
+	const float z = 1.0f - std::abs(x) - std::abs(y);
+
+	// Branchless unfold, matches OctahedralDecode in TexturedShader.hlsl
+	const float t = std::clamp(-z, 0.0f, 1.0f);
+	x += x >= 0.0f ? -t : t;
+	y += y >= 0.0f ? -t : t;
+
+	const float length = std::sqrt(x * x + y * y + z * z);
+	OutDirection[0] = x / length;
+	OutDirection[1] = y / length;
+	OutDirection[2] = z / length;
+}
@@ -8,55 +8,48 @@
 #include "MovementComponent.h"
 #include "RenderingSystem.h"
 #include "UUIDGenerator.h"
+#include "ComponentUpdateLists.h"
+#include "ArchetypeStorage.h"
+#include "BinaryArchive.h"
+#include "LevelJsonLoader.h"
 
 void Actor::Update(float DeltaTime)
 {
-	if (true)
-	{
-		for (auto component : Components)
-		{
-			if (RigidBodyComponent* comp = dynamic_cast<RigidBodyComponent*>(component))
-			{
-				comp->Update(DeltaTime);
-			}
-		}
-
-		for (auto component : Components)
-		{
-			if (dynamic_cast<RigidBodyComponent*>(component) == nullptr)
-			{
-				component->Update(DeltaTime);
-			}
-		}
-	}
-	else
-	{
-		for (auto component : Components)
-		{
-			component->Update(DeltaTime);
-		}
-	}
-
+	// Components are updated per type by the Game's ComponentUpdateLists
 	if(mMonoActor)
 	{
 		mMonoActor->Update(DeltaTime);
 	}
-	
 }
 
 Actor::Actor()
 : id(Game::GetInstance()->GetUuidGenerator()->generate())
 {
+	mHandle = Game::GetInstance()->GetActorHandles()->Add(this, id);
 
+	mPlaySnapshotEpoch = PlaySnapshot::GetRecordingEpoch();
+	if (mPlaySnapshotEpoch != 0)
+	{
+		Game::GetInstance()->GetPlaySnapshot()->OnActorSpawned(this);
+	}
 }
 
 Actor::~Actor()
 {
+	NotifyModified();
+
 	delete(mMonoActor);
 
 	auto game = Game::GetInstance();
 	game->Actors.erase(std::remove(game->Actors.begin(), game->Actors.end(), this), game->Actors.end());
+	game->GetActorHandles()->Remove(mHandle);
+
+	if (ArchetypeStorage* storage = game->GetArchetypeStorage())
+	{
+		storage->RemoveActor(this);
+	}
 	
+	// Components unregister from the update lists in their destructor
 	for (auto comp : Components) {
 		delete(comp);
 	}
@@ -83,6 +76,16 @@ void Actor::OnComponentAdded(Component* component)
 	component->mOwner = this;
 }
 
+void Actor::RegisterComponentForUpdate(Component* component)
+{
+	Game::GetInstance()->GetComponentUpdateLists()->Register(component);
+}
+
+void Actor::UnregisterComponentForUpdate(Component* component)
+{
+	Game::GetInstance()->GetComponentUpdateLists()->Unregister(component);
+}
+
 void Actor::AddOrphanComponent(Component* component)
 {
 	if (auto scc = dynamic_cast<SceneComponent*>(component))
@@ -106,12 +109,64 @@ auto Actor::RemoveComponent(Component* InComponent) -> void
 		return;
 	}
 
+	NotifyModified();
 	Components.erase(remove(Components.begin(), Components.end(), InComponent), Components.end());
+	UnregisterComponentForUpdate(InComponent);
+	RefreshComponentIndex();
+}
+
+auto Actor::RefreshComponentIndex() -> void
+{
+	std::fill(std::begin(ComponentsByType), std::end(ComponentsByType), nullptr);
+	for (Component* component : Components)
+	{
+		const ComponentType type = component->GetComponentType();
+		if (type != Undefined && ComponentsByType[type] == nullptr)
+		{
+			ComponentsByType[type] = component;
+		}
+	}
+
+	if (ArchetypeStorage* storage = Game::GetInstance()->GetArchetypeStorage())
+	{
+		const Component* componentsByType[Last];
+		std::copy(std::begin(ComponentsByType), std::end(ComponentsByType), componentsByType);
+		storage->SetActorComponents(this, componentsByType);
+	}
+}
+
+auto Actor::RemoveComponentsOfType(ComponentType InType) -> void
+{
+	if (GetComponentOfType(InType) == nullptr)
+	{
+		return;
+	}
+
+	NotifyModified();
+
+	for (auto component : Components)
+	{
+		if (component->GetComponentType() == InType)
+		{
+			UnregisterComponentForUpdate(component);
+		}
+	}
+
+	Components.erase(remove_if(Components.begin(), Components.end(),
+		[InType](Component* comp) { return comp->GetComponentType() == InType; }), Components.end());
+	RefreshComponentIndex();
+}
+
+void Actor::RecordForPlaySnapshot(uint32_t epoch)
+{
+	mPlaySnapshotEpoch = epoch;
+	Game::GetInstance()->GetPlaySnapshot()->RecordActor(this);
 }
 
 void Actor::SetUuid(uuid idIn)
 {
 	id = idIn;
+	Game::GetInstance()->GetActorHandles()->SetId(mHandle, id);
 }
 
 void Actor::InitializeMonoActor(const char* className)
@@ -142,11 +197,8 @@ void Actor::UseDebugRendererOnly()
 	is_debug_renderer_enabled = true;
 	if (is_mesh_renderer_enabled)
 	{
-		auto mesh_renderer = std::find_if(Components.begin(), Components.end(),
-			[](Component* comp) {return dynamic_cast<MeshRenderer*>(comp); }
-		);
 		Game::GetInstance()->MyRenderingSystem->UnregisterRenderer(
-			dynamic_cast<MeshRenderer*>(*mesh_renderer)
+			GetComponentOfType<MeshRenderer>(MeshRendererType)
 		);
 		is_mesh_renderer_enabled = false;
 	}
@@ -215,82 +267,223 @@ void Actor::Deserialize(const json* in, bool destructive)
 	assert(in->is_object());
 
 	if(in->contains("mono")) {
-		auto monoObj = in->at("mono");
+		const json& monoObj = in->at("mono");
 		auto namespaceStr = monoObj.at("namespace").get<std::string>();
 		auto classnameStr = monoObj.at("class").get<std::string>();
 		InitializeMonoActor(namespaceStr.c_str(), classnameStr.c_str(), false);
 	}
 
-	auto componentArr = in->at("components");
+	const json& componentArr = in->at("components");
 	assert(componentArr.is_array());
 
- 	std::vector<std::pair<SceneComponent*, uuid>> shouldBeBound;
-
-	for (auto wrapper : componentArr) {
-		auto id = wrapper.at("id").get<uuid>();
-
-		bool exists = false;
-		for (auto component : Components) {
-			if(component->GetId() == id) {
-				exists = true;
-
-				auto data = wrapper.at("data");
-				component->Deserialize(&data);
-				component->OnDeserializationCompleted();
-			}
-		}
+ 	PendingAttachments shouldBeBound;
+	Components.reserve(Components.size() + componentArr.size());
 
-		if(!exists) {
-			auto name = wrapper.at("name").get<std::string>();
+	LevelJsonLoader::LoadComponents(componentArr,
+		[this](const uuid& id) { return FindOwnComponentById(id); },
+		[](Component* component, const json& data) {
+			component->Deserialize(&data);
+			component->OnDeserializationCompleted();
+		},
+		[this, &shouldBeBound](const std::string& name, const uuid& id, const json& data, const uuid* parentId) {
 			Component* component = ComponentRegistry::CreateByName(name);
 
 			assert(component != nullptr && "Component was not registered");
 
-			auto data = wrapper.at("data");
 			component->SetId(id);
 			component->Deserialize(&data);
 
-			if (SceneComponent* sc = dynamic_cast<SceneComponent*>(component)) {
-				if(wrapper.contains("parent")) {
-					auto parentId = wrapper.at("parent").get<uuid>();
-					shouldBeBound.push_back(std::make_pair(sc, parentId));
-				} else {
-					OnComponentAdded(component);
-					AddOrphanComponent(component);
-					component->OnDeserializationCompleted();
-				}
+			AddDeserializedComponent(component, parentId, shouldBeBound);
+		});
+
+	BindDeserializedComponents(shouldBeBound);
+
+	RefreshComponentIndex();
+
+	if (in->contains("mono")) {
+		mMonoActor->Init();
+	}
+
+	Name = in->at("name");
+}
+
+void Actor::SerializeBinary(BinaryWriter& out) const
+{
+	out.WriteUuid(id);
+	out.WriteString(Name);
+
+	out.Write<uint8_t>(mMonoActor != nullptr);
+	if (mMonoActor != nullptr) {
+		out.WriteStringRef(mMonoActor->GetNamespace());
+		out.WriteStringRef(mMonoActor->GetClassname());
+	}
+
+	out.Write(static_cast<uint32_t>(Components.size()));
+	for (auto component : Components) {
+		const auto type = component->GetComponentType();
+		assert(type != Undefined && "Abstract components can't be serialized.");
+
+		// The type name goes to the string table, so it's stored once per level
+		out.WriteStringRef(ComponentRegistry::GetNameByType(type));
+		out.WriteUuid(component->GetId());
+
+		const SceneComponent* sc = dynamic_cast<SceneComponent*>(component);
+		const SceneComponent* parent = sc ? sc->GetAttachmentParent() : nullptr;
+		out.Write<uint8_t>(parent != nullptr);
+		if (parent != nullptr) {
+			out.WriteUuid(parent->GetId());
+		}
+
+		// Size prefixed, so a component reading less or more than it should can't break the rest of the level
+		const size_t sizeOffset = out.GetSize();
+		out.Write<uint32_t>(0);
+		component->SerializeBinary(out);
+		out.Patch(sizeOffset, static_cast<uint32_t>(out.GetSize() - sizeOffset - sizeof(uint32_t)));
+	}
+}
+
+void Actor::DeserializeBinary(BinaryReader& in)
+{
+	const std::string name(in.ReadString());
+
+	const bool hasMono = in.Read<uint8_t>() != 0;
+	if (hasMono) {
+		const std::string namespaceStr(in.ReadStringRef());
+		const std::string classnameStr(in.ReadStringRef());
+		if (in.IsValid()) {
+			InitializeMonoActor(namespaceStr.c_str(), classnameStr.c_str(), false);
+		}
+	}
+
+	const uint32_t numComponents = in.Read<uint32_t>();
+	PendingAttachments shouldBeBound;
+	// Type, id, parent flag and size are the least a component takes
+	Components.reserve(Components.size() + in.ClampCount(numComponents, 25));
+
+	for (uint32_t i = 0; i < numComponents && in.IsValid(); ++i) {
+		std::string typeName(in.ReadStringRef());
+		const uuid componentId = in.ReadUuid();
+		const bool hasParent = in.Read<uint8_t>() != 0;
+		const uuid parentId = hasParent ? in.ReadUuid() : uuid();
+
+		const uint32_t dataSize = in.Read<uint32_t>();
+		const uint8_t* data = in.ReadView(dataSize);
+		if (data == nullptr) {
+			break;
+		}
+
+		BinaryReader dataReader(data, dataSize, in.GetStrings());
+
+		if (Component* component = FindOwnComponentById(componentId)) {
+			component->DeserializeBinary(dataReader);
+			component->OnDeserializationCompleted();
+		}
+		else {
+			Component* component = ComponentRegistry::CreateByName(typeName);
+
+			assert(component != nullptr && "Component was not registered");
+			if (component == nullptr) {
+				continue;
 			}
 
-			Components.push_back(component);
+			component->SetId(componentId);
+			component->DeserializeBinary(dataReader);
+
+			AddDeserializedComponent(component, hasParent ? &parentId : nullptr, shouldBeBound);
 		}
+
+		assert(dataReader.GetRemaining() == 0 && "Component binary data wasn't read completely");
 	}
 
+	BindDeserializedComponents(shouldBeBound);
+
+	RefreshComponentIndex();
+
+	if (hasMono && mMonoActor) {
+		mMonoActor->Init();
+	}
+
+	Name = name;
+}
+
+bool Actor::SkipBinary(BinaryReader& in)
+{
+	in.ReadUuid();
+	in.ReadString();
+
+	if (in.Read<uint8_t>() != 0) {
+		in.ReadStringRef();
+		in.ReadStringRef();
+	}
+
+	const uint32_t numComponents = in.Read<uint32_t>();
+	for (uint32_t i = 0; i < numComponents && in.IsValid(); ++i) {
+		std::string typeName(in.ReadStringRef());
+		if (in.IsValid() && ComponentRegistry::GetTypeByName(typeName) == Undefined) {
+			return false;
+		}
+
+		in.ReadUuid();
+		if (in.Read<uint8_t>() != 0) {
+			in.ReadUuid();
+		}
+		in.Skip(in.Read<uint32_t>());
+	}
+
+	return in.IsValid();
+}
+
+void Actor::AddDeserializedComponent(Component* component, const uuid* parentId, PendingAttachments& shouldBeBound)
+{
+	if (SceneComponent* sc = dynamic_cast<SceneComponent*>(component)) {
+		if (parentId != nullptr) {
+			shouldBeBound.push_back(std::make_pair(sc, *parentId));
+		} else {
+			OnComponentAdded(component);
+			AddOrphanComponent(component);
+			component->OnDeserializationCompleted();
+		}
+	}
+
+	Components.push_back(component);
+	RegisterComponentForUpdate(component);
+}
+
+void Actor::BindDeserializedComponents(const PendingAttachments& shouldBeBound)
+{
 	//Done with extra loop because some of parent tree may not be initialized too
 	for (auto child : shouldBeBound) {
-		for (auto component : Components) {
-			if(component->GetId() == child.second) {
-				if(SceneComponent* parent = dynamic_cast<SceneComponent*>(component)) {
-					child.first->SetAttachmentParent(parent);
-					OnComponentAdded(child.first);
-					child.first->OnDeserializationCompleted();
-				} else {
-					assert(false && "Provided parent id belongs to an object which is not a SceneComponent");
-				}
-
-				goto nextChild;
-			}
+		Component* component = FindOwnComponentById(child.second);
+		if (component == nullptr) {
+			assert(false && "No parent found with provided id");
+			continue;
 		}
 
-		assert(false && "No parent found with provided id");
+		if(SceneComponent* parent = dynamic_cast<SceneComponent*>(component)) {
+			child.first->SetAttachmentParent(parent);
+			OnComponentAdded(child.first);
+			child.first->OnDeserializationCompleted();
+		} else {
+			assert(false && "Provided parent id belongs to an object which is not a SceneComponent");
+		}
+	}
+}
 
-		nextChild:;
+Component* Actor::FindOwnComponentById(const uuid& InId) const
+{
+	Component* component = Game::GetInstance()->GetComponentHandles()->FindObjectById(InId);
+	if (component == nullptr)
+	{
+		return nullptr;
 	}
 
-	if (in->contains("mono")) {
-		mMonoActor->Init();
+	// Components pushed during deserialization may not have their owner set yet
+	if (component->GetOwner() == this || std::find(Components.begin(), Components.end(), component) != Components.end())
+	{
+		return component;
 	}
 
-	Name = in->at("name");
+	return nullptr;
 }
 
 uuid Actor::GetId() const
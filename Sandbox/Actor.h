@@ -13,13 +13,14 @@
 #include "MeshRenderer.h"
 #include "uuid.h"
 #include "AudioComponent.h"
+#include "ObjectPool.h"
 
 
 class LineRenderer;
 class MeshRenderer;
 class RigidBodyComponent;
 
-class Actor final : public Object
+class Actor final : public Object, public PoolAllocated
 {
 public:
 
@@ -39,53 +40,77 @@ public:
 	{
 		static_assert(std::is_base_of_v<Component, T>, "Only components can be added to an actor");
 
+		NotifyModified();
+
 		T* component = nullptr;
 
-		component = new T();
+		component = ObjectPools::New<T>();
 		Components.push_back(component);
+		RegisterComponentForUpdate(component);
 
 		OnComponentAdded(component);
 		AddOrphanComponent(component);
+		RefreshComponentIndex();
 
 		return component;
 	}
 
 	auto AddComponent(Component* component) -> Component* {
+		NotifyModified();
 		Components.push_back(component);
+		RegisterComponentForUpdate(component);
 
 		OnComponentAdded(component);
 		AddOrphanComponent(component);
+		RefreshComponentIndex();
 
 		return component;
 	}
 
-	template<typename T>
-	void RemoveComponentsOfClass()
+	// First component of the type, O(1) through the actor's component index.
+	// Abstract components (Undefined) aren't indexed.
+	auto GetComponentOfType(ComponentType InType) const -> Component*
 	{
-		Components.erase(remove_if(Components.begin(), Components.end(),
-			[](Component* comp) {return dynamic_cast<T*>(comp); }), Components.end());
+		return InType > Undefined && InType < Last ? ComponentsByType[InType] : nullptr;
 	}
 
+	// T has to be the class the components of InType are, or a base of it
 	template<typename T>
-	T* GetComponentOfClass()
+	auto GetComponentOfType(ComponentType InType) const -> T*
 	{
-		auto comp = std::find_if(Components.begin(), Components.end(),
-			[](Component* comp) {return dynamic_cast<T*>(comp); });
-
-		if (comp != Components.end())
-			return dynamic_cast<T*>(*comp);
-
-		return nullptr;
+		static_assert(std::is_base_of_v<Component, T>, "Only components can be looked up");
+		return static_cast<T*>(GetComponentOfType(InType));
 	}
 
+	auto RemoveComponentsOfType(ComponentType InType) -> void;
+
 	auto RemoveComponent(Component* InComponent) -> void;
 
+	// Rebuilds the per type component index and moves the actor to the archetype matching its components,
+	// when the Game uses ArchetypeStorage.
+	// Called automatically when components are added or removed, call it when a component changes its type.
+	auto RefreshComponentIndex() -> void;
+
 	auto GetComponentsArray()->const std::vector<Component*> { return Components; };
 
 	void RemoveChild(Actor* Child);
 
 	void SetUuid(uuid in);
 
+	// Call before changing the actor itself or its set of components,
+	// a running play session then records the whole actor as it was before play
+	void NotifyModified()
+	{
+		const uint32_t epoch = PlaySnapshot::GetRecordingEpoch();
+		if (epoch != 0 && mPlaySnapshotEpoch != epoch)
+		{
+			RecordForPlaySnapshot(epoch);
+		}
+	}
+
+	// Weak reference to this actor, resolve it through Game::ResolveActor
+	auto GetHandle() const -> ActorHandle { return mHandle; }
+
 	void InitializeMonoActor(const char* className = "Actor");
 	void InitializeMonoActor(const char* nameSpace, const char* className, bool initComponents = true);
 
@@ -105,18 +130,36 @@ public:
 
 	json Serialize() const;
 	void Deserialize(const json* in, bool destructive = false);
+	// Same data as Serialize/Deserialize in the binary level format
+	void SerializeBinary(BinaryWriter& out) const;
+	void DeserializeBinary(BinaryReader& in);
+	// Moves past what SerializeBinary wrote without creating anything,
+	// false when the data is malformed or names a component type that isn't registered
+	static bool SkipBinary(BinaryReader& in);
 	uuid GetId() const;
 	void Overlap(Actor* otherActor);
 
 private:
 	void OnComponentAdded(Component* component);
 	void AddOrphanComponent(Component* component);
+	void RegisterComponentForUpdate(Component* component);
+	void UnregisterComponentForUpdate(Component* component);
+	void RecordForPlaySnapshot(uint32_t epoch);
+	// O(1) through the Game's component index, only returns components of this actor
+	Component* FindOwnComponentById(const uuid& InId) const;
+
+	// Component creation steps shared by the json and the binary deserialization
+	using PendingAttachments = std::vector<std::pair<SceneComponent*, uuid>>;
+	void AddDeserializedComponent(Component* component, const uuid* parentId, PendingAttachments& shouldBeBound);
+	void BindDeserializedComponents(const PendingAttachments& shouldBeBound);
 
 	Actor* Parent = nullptr;
 
 	// todo: Think about being able to update Root at Runtime
 	SceneComponent* RootComponent = nullptr;
 	std::vector<Component*> Components;
+	// First component of every type, also what the actor is filed under in ArchetypeStorage
+	Component* ComponentsByType[Last] = {};
 
 	MonoActor* mMonoActor = nullptr;
 	
@@ -127,6 +170,10 @@ public:
 
 private:
 	uuids::uuid id;
+	ActorHandle mHandle;
+	// Play session this actor was recorded in (or spawned in)
+	uint32_t mPlaySnapshotEpoch = 0;
 	friend class Game;
 	friend class Component;
+	friend class PlaySnapshot;
 };
\ No newline at end of file
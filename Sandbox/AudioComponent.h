@@ -30,12 +30,14 @@ public:
 
 	json Serialize() const override;
 	void Deserialize(const json* in) override;
+	// Deserialize loads the sound again, a play session restores the whole actor instead
+	bool CanRestoreInPlace() const override { return false; }
 
 	ComponentType GetComponentType() override;
 
 	static Component* Create()
 	{
-		return new AudioComponent();
+		return ObjectPools::New<AudioComponent>();
 	}
 
 private:
@@ -1,7 +1,55 @@
 #include "Component.h"
 #include "Game.h"
+#include "ComponentUpdateLists.h"
+#include "BinaryArchive.h"
+#include "Actor.h"
 
 Component::Component(): id(Game::GetInstance()->GetUuidGenerator()->generate())
 {
-	
+	mHandle = Game::GetInstance()->GetComponentHandles()->Add(this, id);
+	// Components created during play are destroyed with their actor, there is nothing to record
+	mPlaySnapshotEpoch = PlaySnapshot::GetRecordingEpoch();
 }
+
+Component::~Component()
+{
+	Game::GetInstance()->GetComponentUpdateLists()->Unregister(this);
+	Game::GetInstance()->GetComponentHandles()->Remove(mHandle);
+}
+
+void Component::SetId(uuid idIn)
+{
+	id = idIn;
+	Game::GetInstance()->GetComponentHandles()->SetId(mHandle, id);
+}
+
+
+void Component::SerializeBinary(BinaryWriter& out) const
+{
+	out.WriteJson(Serialize());
+}
+
+void Component::DeserializeBinary(BinaryReader& in)
+{
+	const json data = in.ReadJson();
+	if (in.IsValid())
+	{
+		Deserialize(&data);
+	}
+}
+
+void Component::RecordForPlaySnapshot(uint32_t epoch)
+{
+	mPlaySnapshotEpoch = epoch;
+
+	if (!CanRestoreInPlace())
+	{
+		if (mOwner)
+		{
+			mOwner->NotifyModified();
+		}
+		return;
+	}
+
+	Game::GetInstance()->GetPlaySnapshot()->RecordComponent(this);
+}
\ No newline at end of file
@@ -1,28 +1,38 @@
 #pragma once
 
 #include <assert.h>
+#include <cstdint>
 
 #include "ComponentsEnum.h"
 #include "../External/assimp/code/AssetLib/FBX/FBXDocument.h"
 #include "JsonInclude.h"
+#include "ObjectPool.h"
+#include "HandleRegistry.h"
+#include "PlaySnapshot.h"
 //#include "MonoObjects/MonoComponent.h"
 
 class Component;
 class MonoComponent;
 class Actor;
 class Game;
+class BinaryWriter;
+class BinaryReader;
 
 //typedef std::string name;
 
-class Component
+class Component : public PoolAllocated
 {
 	friend Actor;
 	friend Game;
+	friend class ComponentUpdateLists;
+	template<class T>
+	friend class UpdateList;
 
 public:
 	Component();
 
 	void SetName(const std::string &name) {
+		NotifyModified();
 		this->name = name;
 	}
 
@@ -58,12 +68,12 @@ public:
 
 	Actor* GetOwner() const { return mOwner; }
 	uuid GetId() const { return id; }
-	void SetId(uuid idIn)
-	{
-		id = idIn;
-	}
+	void SetId(uuid idIn);
+
+	// Weak reference to this component, resolve it through Game::GetComponentHandles
+	auto GetHandle() const -> ObjectHandle<Component> { return mHandle; }
 
-	virtual ~Component() = default;
+	virtual ~Component();
 
 	virtual json Serialize() const
 	{
@@ -77,12 +87,41 @@ public:
 	virtual void OnDeserializationCompleted()
 	{
 	}
+
+	// Binary level format, by default the Serialize() json is stored as MessagePack.
+	// Override both together for a native layout, keep it in sync with the json one.
+	virtual void SerializeBinary(BinaryWriter& out) const;
+	virtual void DeserializeBinary(BinaryReader& in);
+
+	// Call before changing serialized state, a running play session then records the state from before play
+	void NotifyModified()
+	{
+		const uint32_t epoch = PlaySnapshot::GetRecordingEpoch();
+		if (epoch != 0 && mPlaySnapshotEpoch != epoch)
+		{
+			RecordForPlaySnapshot(epoch);
+		}
+	}
+
+	// Whether DeserializeBinary can rewind the live component to a recorded state.
+	// Components owning simulation objects (physics, sounds) can't, their actor is recreated instead.
+	virtual bool CanRestoreInPlace() const { return true; }
 private:
+	void RecordForPlaySnapshot(uint32_t epoch);
+
 	static std::unordered_map<std::string, ComponentType> TYPE_BY_NAME;
 	static std::unordered_map<ComponentType, std::string> NAME_BY_TYPE;
 
-	Actor* mOwner;
+	Actor* mOwner = nullptr;
 	uuid id;
+	ObjectHandle<Component> mHandle;
+	// Play session this component was recorded in (or created in)
+	uint32_t mPlaySnapshotEpoch = 0;
 
 	std::string name;
+
+	// Slot in the Game's ComponentUpdateLists
+	static constexpr uint32_t InvalidUpdateListIndex = UINT32_MAX;
+	ComponentType mUpdateListType = Undefined;
+	uint32_t mUpdateListIndex = InvalidUpdateListIndex;
 };
\ No newline at end of file
@@ -15,9 +15,22 @@ public:
     }
 
 private:
-    static Transform ActorGetTransform(Actor* actor){return actor->GetTransform();}
-    static void ActorSetTransform(Actor* actor, Transform transform){actor->SetTransform(transform);}
-    static void ActorDestroy(Actor* actor){ delete actor; }
+    // C# keeps a packed ActorHandle as CppInstance, a destroyed actor resolves to nullptr
+    static Actor* ResolveActor(uint64_t handle){return Game::GetInstance()->ResolveActor(ActorHandle::FromPacked(handle));}
+
+    static Transform ActorGetTransform(uint64_t handle)
+    {
+        const Actor* actor = ResolveActor(handle);
+        return actor ? actor->GetTransform() : Transform::Identity;
+    }
+    static void ActorSetTransform(uint64_t handle, Transform transform)
+    {
+        if (Actor* actor = ResolveActor(handle))
+        {
+            actor->SetTransform(transform);
+        }
+    }
+    static void ActorDestroy(uint64_t handle){ delete ResolveActor(handle); }
     
     static MonoObject* InstantiateActor(MonoObject* ns, MonoObject* name)
     {
@@ -20,8 +20,14 @@ public:
     }
 
 private:
-    static Component* CreateComponent(Actor* actor, int compType)
+    static Component* CreateComponent(uint64_t actorHandle, int compType)
     {
+        Actor* actor = Game::GetInstance()->ResolveActor(ActorHandle::FromPacked(actorHandle));
+        if (actor == nullptr)
+        {
+            return nullptr;
+        }
+
         auto* cmp = ComponentRegistry::CreateByType(static_cast<ComponentType>(compType));
         return actor->AddComponent(cmp);
        
@@ -10,8 +10,10 @@ MonoActor::MonoActor(Actor* actor, const char* nameSpace, const char* className)
     auto klass = mono->FindClass(nameSpace, ClassName.c_str());
     
     Owner = actor;
+    // C# side only gets the handle, so calls on a destroyed actor can be detected
+    uint64_t ownerHandle = actor->GetHandle().ToPacked();
     void *args [1];
-    args [0] = &Owner;
+    args [0] = &ownerHandle;
 
     auto csInstance = mono->CreateClassInstance(klass, false);
     Handle =  mono_gchandle_new(csInstance, true);
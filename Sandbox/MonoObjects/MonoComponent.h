@@ -1,8 +1,9 @@
 ﻿#pragma once
 #include "..\MonoSystem.h"
 #include "..\Component.h"
+#include "ObjectPool.h"
 
-class MonoComponent
+class MonoComponent : public PoolAllocated
 {
 public:
     void ConstructFromCsInstance(MonoObject* instance, Component* component);
@@ -1,5 +1,6 @@
 #include "RigidBodyComponent.h"
 #include "Game.h"
+#include "Actor.h"
 
 RigidBodyComponent::RigidBodyComponent()
 {
@@ -167,6 +168,12 @@ void RigidBodyComponent::SetRigidBodyUsage(RigidBodyUsage usage)
 void RigidBodyComponent::SetCollisionShapeType(CollisionShapeType type)
 {
     ShapeType = type;
+
+    // Shape type defines the component type
+    if (Actor* owner = GetOwner())
+    {
+        owner->RefreshComponentIndex();
+    }
 }
 
 void RigidBodyComponent::CreateShape(Vector3 scale)
@@ -205,6 +212,11 @@ void RigidBodyComponent::SetCollisionShape(CollisionShapeType type, Vector3 scal
         ShapeType = type;
         CreateShape(scale);
 
+        if (Actor* owner = GetOwner())
+        {
+            owner->RefreshComponentIndex();
+        }
+
         auto world = PhysicsModuleData::GetInstance()->GetDynamicsWorld();
         if (isPhysicsSimulationEnabled)
             world->removeRigidBody(rigidBody.Body);
@@ -83,13 +83,15 @@ public:
 
 	json Serialize() const override;
 	void Deserialize(const json* in) override;
+	// Deserialize creates a new Bullet body, a play session restores the whole actor instead
+	bool CanRestoreInPlace() const override { return false; }
 
 	auto EnablePhysicsSimulation() -> void;
 	auto DisablePhysicsSimulation() -> void;
 
 	static Component* Create()
 	{
-		return new RigidBodyComponent();
+		return ObjectPools::New<RigidBodyComponent>();
 	}
 
 protected:
@@ -106,7 +108,7 @@ protected:
 	RigidBodyUsage Usage;
 	CollisionShapeType ShapeType;
 
-	MonoPhysicsComponent* mMonoComponent = new MonoPhysicsComponent;
+	MonoPhysicsComponent* mMonoComponent = ObjectPools::New<MonoPhysicsComponent>();
 
 	// todo: do we need this? - we can query type using Body->isKinematicObject(), Body->isStaticObject()
 	RigidBodyType rbType;
@@ -24,6 +24,7 @@
 #include "ImGuiInclude.h"
 #include "StaticMeshRenderer.h"
 #include "AssetManager.h"
+#include "ComponentUpdateLists.h"
 
 
 #include "CreateCommon.h"
@@ -457,18 +458,10 @@ void Sandbox::Update(float DeltaTime)
 		// Temporary block just to check how sound works
 		if (prevPlayState == PlayState::Editor || prevPlayState == PlayState::Paused)
 		{
-			// platform->GetComponentOfClass<AudioComponent>()->Play();
+			// platform->GetComponentOfType<AudioComponent>(AudioComponentType)->Play();
 		}
 
-		// Physics Simulation
-		auto physics = PhysicsModuleData::GetInstance();
-		physics->OnUpdate(DeltaTime);
-		// create a copy of the Actors array to avoid iterator invalidation
-		std::vector<Actor*> actors = Actors;
-		for (auto actor : actors)
-		{
-			actor->Update(DeltaTime);
-		}
+		// The physics step and the component and actor updates are engine ticks, see Game::RegisterEngineTicks
 	}
 	else
 	{
@@ -514,11 +507,11 @@ void Sandbox::Update(float DeltaTime)
 		}
 		if (keyboard->IsDown(KEY_ONE))
 		{
-			//sphere->GetComponentOfClass<AudioComponent>()->Play();
+			//sphere->GetComponentOfType<AudioComponent>(AudioComponentType)->Play();
 		}		
 		if (input.GetKeyboard()->IsDown(KEY_TWO))
 		{
-			//sphere->GetComponentOfClass<AudioComponent>()->StopChannel();
+			//sphere->GetComponentOfType<AudioComponent>(AudioComponentType)->StopChannel();
 		}
 	}
 }
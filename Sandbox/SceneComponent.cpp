@@ -1,27 +1,128 @@
 #include "SceneComponent.h"
 #include "Serializer.h"
+#include "Game.h"
+#include "BinaryArchive.h"
+#include "Actor.h"
+
+SceneComponent::SceneComponent()
+{
+	mTransformHandle = Game::GetInstance()->GetTransformStore()->Allocate();
+}
+
+SceneComponent::~SceneComponent()
+{
+	// Detach children first so that they don't keep pointing to this component or its transform handle
+	const std::vector<SceneComponent*> children = AttachedChildren;
+	for (SceneComponent* child : children)
+	{
+		child->SetAttachmentParent(nullptr);
+	}
+
+	SetAttachmentParent(nullptr);
+
+	Game::GetInstance()->GetTransformStore()->Release(mTransformHandle);
+}
 
 auto SceneComponent::SetTransform(const Transform& InTransform, TeleportType InTeleportType/* = ETeleportType::TeleportPhysics*/) -> void
 {
 	// Calculate relative transform
 	if (SceneComponent* sceneComp = GetAttachmentParent())
 	{
-		mTransform = InTransform.GetTransformMatrix() * sceneComp->GetTransform().GetInverseTransformMatrix();
+		SetRelativeTransform(InTransform.GetTransformMatrix() * sceneComp->GetWorldMatrix().Invert());
 	}
 	else
 	{
-		mTransform = InTransform;
+		SetRelativeTransform(InTransform);
 	}
 }
 
 auto SceneComponent::GetTransform() const -> const Transform&
 {
-	if (mAttachmentParent == nullptr)
+	return Game::GetInstance()->GetTransformStore()->GetWorldTransform(mTransformHandle);
+}
+
+auto SceneComponent::GetWorldMatrix() const -> const Matrix&
+{
+	return Game::GetInstance()->GetTransformStore()->GetWorldMatrix(mTransformHandle);
+}
+
+auto SceneComponent::GetRelativeTransform() const -> Transform
+{
+	return Game::GetInstance()->GetTransformStore()->GetRelativeTransform(mTransformHandle);
+}
+
+auto SceneComponent::SetRelativeTransform(const Transform& InTransform) -> void
+{
+	NotifyModified();
+	Game::GetInstance()->GetTransformStore()->SetRelativeTransform(mTransformHandle, InTransform);
+	MarkTransformDirty();
+}
+
+auto SceneComponent::SetRelativePosition(const Vector3& InPosition) -> void
+{
+	NotifyModified();
+	Game::GetInstance()->GetTransformStore()->SetRelativePosition(mTransformHandle, InPosition);
+	MarkTransformDirty();
+}
+
+auto SceneComponent::GetRelativePosition() const -> Vector3
+{
+	return Game::GetInstance()->GetTransformStore()->GetRelativePosition(mTransformHandle);
+}
+
+auto SceneComponent::SetRelativeScale(const Vector3& InScale) -> void
+{
+	NotifyModified();
+	Game::GetInstance()->GetTransformStore()->SetRelativeScale(mTransformHandle, InScale);
+	MarkTransformDirty();
+}
+
+auto SceneComponent::GetRelativeScale() const -> Vector3
+{
+	return Game::GetInstance()->GetTransformStore()->GetRelativeScale(mTransformHandle);
+}
+
+auto SceneComponent::SetRelativeEulerDegrees(const Vector3& InEulerDegrees) -> void
+{
+	NotifyModified();
+	const Quaternion rotation = Rotator(InEulerDegrees).GetQuaterion();
+	Game::GetInstance()->GetTransformStore()->SetRelativeRotation(mTransformHandle, rotation);
+	MarkTransformDirty();
+
+	mRelativeEulerDegrees = InEulerDegrees;
+	mRelativeEulerRotation = rotation;
+	bHasRelativeEulerDegrees = true;
+}
+
+auto SceneComponent::GetRelativeEulerDegrees() const -> Vector3
+{
+	const Quaternion rotation = Game::GetInstance()->GetTransformStore()->GetRelativeRotation(mTransformHandle);
+
+	// Any other way of setting the rotation leaves a different quaternion behind
+	if (bHasRelativeEulerDegrees && rotation == mRelativeEulerRotation)
+	{
+		return mRelativeEulerDegrees;
+	}
+
+	return Rotator(rotation).GetEulerDegrees();
+}
+
+auto SceneComponent::MarkTransformDirty() -> void
+{
+	TransformStore* store = Game::GetInstance()->GetTransformStore();
+
+	// A clean entry always has clean parents, so a dirty one already has all of its children dirty
+	if (store->IsDirty(mTransformHandle))
 	{
-		return mTransform;
+		return;
 	}
 
-	return mTransform.TransformToWorld(mAttachmentParent->GetTransform());
+	store->MarkDirty(mTransformHandle);
+
+	for (SceneComponent* child : AttachedChildren)
+	{
+		child->MarkTransformDirty();
+	}
 }
 
 auto SceneComponent::SetAttachmentParent(SceneComponent* InAttachmentParent, std::string InAttachSocketName) -> void
@@ -33,6 +134,12 @@ auto SceneComponent::SetAttachmentParent(SceneComponent* InAttachmentParent, std
 
 	// todo: Check for loops when attaching
 
+	// Attachments are restored together with the whole actor
+	if (Actor* owner = GetOwner())
+	{
+		owner->NotifyModified();
+	}
+
 	if (mAttachmentParent != nullptr)
 	{
 		mAttachmentParent->AttachedChildren.erase(
@@ -45,12 +152,18 @@ auto SceneComponent::SetAttachmentParent(SceneComponent* InAttachmentParent, std
 	{
 		mAttachmentParent->AttachedChildren.push_back(this);
 	}
+
+	// Dirty the subtree before the store marks this entry, otherwise the children would be skipped
+	MarkTransformDirty();
+
+	Game::GetInstance()->GetTransformStore()->SetParent(mTransformHandle,
+		mAttachmentParent ? mAttachmentParent->mTransformHandle : TransformStore::InvalidHandle);
 }
 
 json SceneComponent::Serialize() const
 {
 	json out = json::object();
-	out["transform"] = mTransform;
+	out["transform"] = GetRelativeTransform();
 	out["name"] = GetName();
 	return out;
 }
@@ -59,10 +172,109 @@ void SceneComponent::Deserialize(const json* in)
 {
 	assert(in->is_object());
 
-	mTransform = in->at("transform");
+	SetRelativeTransform(in->at("transform"));
 	SetName(in->at("name"));
 }
 
+void SceneComponent::SerializeBinary(BinaryWriter& out) const
+{
+	SerializeSceneBinary(out);
+
+	// Empty for a plain scene component, subclasses keep their own fields here
+	json extras = Serialize();
+	extras.erase("transform");
+	if (extras.contains("name") && extras.at("name") == GetName())
+	{
+		extras.erase("name");
+	}
+	out.WriteJson(extras);
+}
+
+void SceneComponent::DeserializeBinary(BinaryReader& in)
+{
+	DeserializeSceneBinary(in);
+	json data = in.ReadJson();
+	if (!in.IsValid() || data.empty())
+	{
+		return;
+	}
+
+	// Subclasses read their fields in Deserialize, together with the transform and name
+	data["transform"] = GetRelativeTransform();
+	if (!data.contains("name"))
+	{
+		data["name"] = GetName();
+	}
+	Deserialize(&data);
+}
+
+void SceneComponent::ConvertJsonToBinary(const json& in, BinaryWriter& out)
+{
+	ConvertSceneJsonToBinary(in, out);
+
+	json extras = in;
+	extras.erase("transform");
+	extras.erase("name");
+	out.WriteJson(extras);
+}
+
+json SceneComponent::ConvertBinaryToJson(BinaryReader& in)
+{
+	json out = ConvertSceneBinaryToJson(in);
+	const json extras = in.ReadJson();
+	if (extras.is_object())
+	{
+		out.update(extras);
+	}
+	return out;
+}
+
+auto SceneComponent::SerializeSceneBinary(BinaryWriter& out) const -> void
+{
+	const Transform transform = GetRelativeTransform();
+	out.Write(transform.Position);
+	out.Write(transform.Rotation.GetQuaterion());
+	out.Write(transform.Scale);
+	out.WriteString(GetName());
+}
+
+auto SceneComponent::DeserializeSceneBinary(BinaryReader& in) -> void
+{
+	Transform transform;
+	transform.Position = in.Read<Vector3>();
+	transform.Rotation = Rotator(in.Read<Quaternion>());
+	transform.Scale = in.Read<Vector3>();
+	const std::string_view name = in.ReadString();
+
+	if (in.IsValid())
+	{
+		SetRelativeTransform(transform);
+		SetName(std::string(name));
+	}
+}
+
+auto SceneComponent::ConvertSceneJsonToBinary(const json& in, BinaryWriter& out) -> void
+{
+	const Transform transform = in.at("transform");
+	out.Write(transform.Position);
+	out.Write(transform.Rotation.GetQuaterion());
+	out.Write(transform.Scale);
+	out.WriteString(in.at("name").get<std::string>());
+}
+
+auto SceneComponent::ConvertSceneBinaryToJson(BinaryReader& in) -> json
+{
+	Transform transform;
+	transform.Position = in.Read<Vector3>();
+	transform.Rotation = Rotator(in.Read<Quaternion>());
+	transform.Scale = in.Read<Vector3>();
+
+	json out = json::object();
+	out["transform"] = transform;
+	out["name"] = std::string(in.ReadString());
+	return out;
+}
+
 auto SceneComponent::GetAttahcmentRoot() -> SceneComponent*
 {
 	SceneComponent* sceneComp;
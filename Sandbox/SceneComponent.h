@@ -2,6 +2,7 @@
 
 #include "Component.h"
 #include "Transform.h"
+#include "TransformStore.h"
 #include "JsonInclude.h"
 
 #include <string>
@@ -20,11 +21,16 @@ class SceneComponent : public Component
 public:
 
 	friend class ImGuiSubsystem;
+
+	SceneComponent();
+	~SceneComponent() override;
 	
 	// todo: add funcions to set world transform of scene components
 	// Transform get/update funcions
 	virtual auto SetTransform(const Transform& InTransform, TeleportType InTeleportType = TeleportType::TeleportPhysics) -> void;
 	auto GetTransform() const -> const Transform&;
+	// World transform matrix, cached in the TransformStore together with GetTransform()
+	auto GetWorldMatrix() const -> const Matrix&;
 
 	//auto SetPosition(const Vector3& InPosition) -> void;
 	auto GetPosition() const -> const Vector3& { return GetTransform().Position; }
@@ -34,22 +40,27 @@ public:
 
 	//auto SetEulerDegrees(const Vector3& InEulerDegrees) -> void;
 	//auto SetEulerDegrees(float InYaw, float InPitch, float InRoll) -> void;
-	auto GetEulerDegrees() const -> const Vector3& { return GetTransform().Rotation.GetEulerDegrees(); }
+	// Derived from the world rotation quaternion, angles may come back as an equivalent set
+	auto GetEulerDegrees() const -> Vector3 { return GetTransform().Rotation.GetEulerDegrees(); }
 
 	
 public: // Relative transform get/update funcions
-	auto GetRelativeTransform() const -> const Transform& { return mTransform; }
-	auto SetRelativeTransform(const Transform& InTransform) -> void { mTransform = InTransform; }
+	auto GetRelativeTransform() const -> Transform;
+	auto SetRelativeTransform(const Transform& InTransform) -> void;
+
+	auto SetRelativePosition(const Vector3& InPosition) -> void;
+	auto GetRelativePosition() const -> Vector3;
 
-	auto SetRelativePosition(const Vector3& InPosition) -> void { mTransform.Position = InPosition; }
-	auto GetRelativePosition() const -> const Vector3& { return mTransform.Position; }
+	auto SetRelativeScale(const Vector3& InScale) -> void;
+	auto GetRelativeScale() const -> Vector3;
 
-	auto SetRelativeScale(const Vector3& InScale) -> void { mTransform.Scale = InScale; }
-	auto GetRelativeScale() const -> const Vector3& { return mTransform.Scale; }
+	auto SetRelativeEulerDegrees(const Vector3& InEulerDegrees) -> void;
+	auto SetRelativeEulerDegrees(float InYaw, float InPitch, float InRoll) -> void { SetRelativeEulerDegrees({ InYaw, InPitch, InRoll }); }
+	// The angles last set, as long as the rotation wasn't changed otherwise since.
+	// Only the quaternion is stored and serialized, other rotations and loaded ones are converted back from it.
+	auto GetRelativeEulerDegrees() const -> Vector3;
 
-	auto SetRelativeEulerDegrees(const Vector3& InEulerDegrees) -> void { mTransform.Rotation = Rotator(InEulerDegrees); }
-	auto SetRelativeEulerDegrees(float InYaw, float InPitch, float InRoll) -> void { mTransform.Rotation = Rotator({ InYaw, InPitch, InRoll }); }
-	auto GetRelativeEulerDegrees() const -> const Vector3& { return mTransform.Rotation.GetEulerDegrees(); }
+	auto GetTransformHandle() const -> TransformStore::Handle { return mTransformHandle; }
 
 	
 public: // Attachment related fucntions
@@ -64,20 +75,44 @@ public: // Attachment related fucntions
 	//Serialization Part
 	json Serialize() const override;
 	void Deserialize(const json* in) override;
+	// Transform and name in the native layout, then whatever a subclass adds to Serialize as MessagePack
+	void SerializeBinary(BinaryWriter& out) const override;
+	void DeserializeBinary(BinaryReader& in) override;
+	// Level conversion between the Serialize json and the SerializeBinary layout, see ComponentRegistry
+	static void ConvertJsonToBinary(const json& in, BinaryWriter& out);
+	static json ConvertBinaryToJson(BinaryReader& in);
 
 	static Component* Create()
 	{
-		return new SceneComponent();
+		return ObjectPools::New<SceneComponent>();
 	}
+
+protected:
+	// Native binary layout of the data SceneComponent::Serialize writes, for subclasses that override SerializeBinary
+	auto SerializeSceneBinary(BinaryWriter& out) const -> void;
+	auto DeserializeSceneBinary(BinaryReader& in) -> void;
+	// The same layout converted from and to the Serialize json, for the level converters of those subclasses
+	static auto ConvertSceneJsonToBinary(const json& in, BinaryWriter& out) -> void;
+	static auto ConvertSceneBinaryToJson(BinaryReader& in) -> json;
+
 private:
 
 	ComponentType mType = SceneComponentType;
-	MonoSceneComponent* mMonoComponent = new MonoSceneComponent;
+	MonoSceneComponent* mMonoComponent = ObjectPools::New<MonoSceneComponent>();
 private:
 	auto GetAttahcmentRoot() -> SceneComponent*;
 
+	// Invalidates cached world transform of this component and all of its attached children
+	auto MarkTransformDirty() -> void;
+
 private:
-	Transform mTransform;
+	// Relative transform and world transform cache live in the Game's TransformStore
+	TransformStore::Handle mTransformHandle = TransformStore::InvalidHandle;
+
+	// Angles given to SetRelativeEulerDegrees and the rotation they made, to hand them back without a round trip
+	Vector3 mRelativeEulerDegrees;
+	Quaternion mRelativeEulerRotation;
+	bool bHasRelativeEulerDegrees = false;
 
 	SceneComponent* mAttachmentParent = nullptr;
 	std::vector<SceneComponent*> AttachedChildren;
@@ -25,6 +25,9 @@ cbuffer CBPerObject : register(b2)
 	matrix NormalO2W;
 	float4 Color;
 	Material Mat;
+	uint AlbedoSlice;
+	uint NormalSlice;
+	float2 pad2;
 };
 
 #endif // __COMMON_HLSL__
\ No newline at end of file
@@ -1,5 +1,15 @@
 struct VS_IN
 {
+#if defined(PACKED_VERTEX)
+	// PackedTexturedVertex, w - bitangent sign
+	float4 pos : POSITION0;
+#if !defined(DEFERRED_LIGHTING)
+	// Octahedral
+	float2 normal : NORMAL0;
+	float2 tangent : TANGENT0;
+	float2 uv : TEXCOORD0;
+#endif
+#else
 	float3 pos : POSITION0;
 #if !defined(DEFERRED_LIGHTING)
 	float3 normal : NORMAL0;
@@ -7,6 +17,7 @@ struct VS_IN
 	float3 tangent : TANGENT0;
 	float2 uv : TEXCOORD0;
 #endif
+#endif
 };
 
 struct PS_IN
@@ -28,6 +39,17 @@ struct PS_IN
 // Shader code
 //////////////////////////////////////////////////////
 
+#if defined(PACKED_VERTEX)
+// Same as OctahedralDecode in VertexCompression.cpp
+float3 OctahedralDecode(float2 e)
+{
+	float3 v = float3(e, 1.0f - abs(e.x) - abs(e.y));
+	float t = saturate(-v.z);
+	v.xy += v.xy >= 0.0f ? -t : t;
+	return normalize(v);
+}
+#endif
+
 PS_IN VSMain(
 #if defined(QUAD_ONLY)
 	uint id: SV_VertexID
@@ -39,13 +61,22 @@ PS_IN VSMain(
 	PS_IN output = (PS_IN)0;
 
 #if !defined(DEFERRED_LIGHTING) & !defined(QUAD_ONLY)
+#if defined(PACKED_VERTEX)
+	float3 normal = OctahedralDecode(input.normal);
+	float3 tangent = OctahedralDecode(input.tangent);
+	float3 binormal = cross(normal, tangent) * input.pos.w;
+#else
+	float3 normal = input.normal;
+	float3 tangent = input.tangent;
+	float3 binormal = input.binormal;
+#endif
 	matrix objectToClip = mul(ObjectToWorld, WorldToClip);
-	output.pos = mul(float4(input.pos, 1.0f), objectToClip);
+	output.pos = mul(float4(input.pos.xyz, 1.0f), objectToClip);
 	output.uv = input.uv;
-	output.normal = mul(input.normal, NormalO2W);
-	output.binormal = normalize(mul(float4(input.binormal.xyz, 0.0f), NormalO2W));
-	output.tangent = normalize(mul(float4(input.tangent.xyz, 0.0f), NormalO2W));
-	output.worldPos = mul(float4(input.pos, 1.0f), ObjectToWorld).xyz;
+	output.normal = mul(normal, NormalO2W);
+	output.binormal = normalize(mul(float4(binormal, 0.0f), NormalO2W));
+	output.tangent = normalize(mul(float4(tangent, 0.0f), NormalO2W));
+	output.worldPos = mul(float4(input.pos.xyz, 1.0f), ObjectToWorld).xyz;
 #elif defined(QUAD_ONLY)
 	float2 inds = float2(id & 1, (id & 2) >> 1);
 	output.pos = float4(inds * float2(2, -2) + float2(-1, 1), 0, 1);
@@ -58,8 +89,14 @@ PS_IN VSMain(
 }
 
 #if defined(FORWARD_RENDERING) | defined(DEFERRED_OPAQUE) | defined(DEFERRED_LIGHTING)
+#if defined(TEXTURE_ARRAYS) & !defined(DEFERRED_LIGHTING)
+// Shared by many materials, CBPerObject has the slices
+Texture2DArray DiffuseMap : register(t0);
+Texture2DArray NormalMap : register(t2);
+#else
 Texture2D DiffuseMap : register(t0);
 Texture2D NormalMap : register(t2);
+#endif
 #if !defined(DEFERRED_LIGHTING)
 Texture2D SpecularMap : register(t3);
 #else
@@ -93,9 +130,14 @@ PSOutput PSMain(PS_IN input) : SV_Target
 	PSOutput ret = (PSOutput)0;
 #if !defined(DEFERRED_LIGHTING)
 #if defined(FORWARD_RENDERING) | defined(DEFERRED_OPAQUE)
+#if defined(TEXTURE_ARRAYS)
+	float4 col = DiffuseMap.Sample(DefaultSampler, float3(input.uv, AlbedoSlice)) * Color;
+	float3 normal = NormalMap.Sample(DefaultSampler, float3(input.uv, NormalSlice)).xyz;
+#else
 	float4 col = DiffuseMap.Sample(DefaultSampler, input.uv) * Color;
-	float specular = SpecularMap.Sample(DefaultSampler, input.uv.xy).r;
 	float3 normal = NormalMap.Sample(DefaultSampler, input.uv.xy).xyz;
+#endif
+	float specular = SpecularMap.Sample(DefaultSampler, input.uv.xy).r;
 
 	float3 pixelPos = input.worldPos;
 	Material mat = Mat;
@@ -117,7 +159,11 @@ PSOutput PSMain(PS_IN input) : SV_Target
 	float3 N = normalize(input.normal.xyz);
 	float3x3 TBN = float3x3(T, B, N);
 
-	float3 unpackedNormal = normalize(normal * 2.0f - 1.0f);
+	// Cooked normal maps are BC5 with X and Y only, Z is rebuilt for them and uncompressed ones alike
+	float3 unpackedNormal;
+	unpackedNormal.xy = normal.xy * 2.0f - 1.0f;
+	unpackedNormal.z = sqrt(saturate(1.0f - dot(unpackedNormal.xy, unpackedNormal.xy)));
+	unpackedNormal = normalize(unpackedNormal);
 	// This is here because the normal maps I have have a non-inverted y (which is okay for OpenGL, but not for DirectX)
 	unpackedNormal.g = -1.0f * unpackedNormal.g;
 
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Minimal registry of headless tests and benchmarks, every TEST_CASE is its own ctest entry.
+// Benchmarks live in the EngineBenchmarks executable and are run by hand.
+namespace Testing
+{
+	struct Case
+	{
+		const char* Name;
+		std::function<void()> Function;
+	};
+
+	auto GetTests() -> std::vector<Case>&;
+	auto GetBenchmarks() -> std::vector<Case>&;
+
+	// Set by failing checks of the running test
+	auto GetNumFailures() -> uint32_t&;
+
+	struct Registrar
+	{
+		Registrar(std::vector<Case>& InCases, const char* InName, std::function<void()> InFunction)
+		{
+			InCases.push_back({ InName, std::move(InFunction) });
+		}
+	};
+
+	inline auto ReportFailure(const char* InFile, int InLine, const std::string& InMessage) -> void
+	{
+		std::cerr << InFile << "(" << InLine << "): check failed: " << InMessage << std::endl;
+		++GetNumFailures();
+	}
+
+	// Milliseconds InFunction takes, best of InRepeats runs
+	inline auto MeasureMs(uint32_t InRepeats, const std::function<void()>& InFunction) -> double
+	{
+		double best = 1e30;
+		for (uint32_t i = 0; i < InRepeats; ++i)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			InFunction();
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			best = ms < best ? ms : best;
+		}
+		return best;
+	}
+}
+
+#define TESTING_CONCAT_IMPL(A, B) A##B
+#define TESTING_CONCAT(A, B) TESTING_CONCAT_IMPL(A, B)
+
+#define TEST_CASE(Name) \
+	static void Name(); \
+	static Testing::Registrar TESTING_CONCAT(Name, Registrar)(Testing::GetTests(), #Name, &Name); \
+	static void Name()
+
+#define BENCHMARK(Name) \
+	static void Name(); \
+	static Testing::Registrar TESTING_CONCAT(Name, Registrar)(Testing::GetBenchmarks(), #Name, &Name); \
+	static void Name()
+
+#define CHECK(Expr) \
+	do { if (!(Expr)) { Testing::ReportFailure(__FILE__, __LINE__, #Expr); } } while (false)
+
+#define CHECK_EQ(A, B) \
+	do { if (!((A) == (B))) { Testing::ReportFailure(__FILE__, __LINE__, #A " == " #B); } } while (false)
+
+// Stops the test on failure, for checks later code relies on
+#define REQUIRE(Expr) \
+	do { if (!(Expr)) { Testing::ReportFailure(__FILE__, __LINE__, #Expr); return; } } while (false)
@@ -0,0 +1,155 @@
+#include "TestFramework.h"
+
+#include "ArchetypeStorage.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// Polymorphic like the engine components, spread over the heap the way spawning over time leaves them
+	struct FakeComponent
+	{
+		virtual ~FakeComponent() = default;
+		ComponentType Type = Undefined;
+		float Position[3] = {};
+		float Padding[24] = {};
+	};
+
+	struct FakeActor
+	{
+		std::vector<FakeComponent*> Components;
+		const Component* ComponentsByType[Last] = {};
+	};
+
+	constexpr uint32_t NumActors = 100000;
+
+	struct World
+	{
+		std::vector<std::unique_ptr<FakeComponent>> Components;
+		std::vector<std::unique_ptr<FakeActor>> Actors;
+	};
+
+	// Every actor has a scene component, half of them a mesh renderer and a tenth a light
+	auto MakeWorld() -> World
+	{
+		World world;
+		std::mt19937 random(11);
+		for (uint32_t i = 0; i < NumActors; ++i)
+		{
+			auto actor = std::make_unique<FakeActor>();
+			for (const ComponentType type : { SceneComponentType, StaticMeshRendererType, LightPointType })
+			{
+				if ((type == StaticMeshRendererType && i % 2 != 0) || (type == LightPointType && i % 10 != 0))
+				{
+					continue;
+				}
+
+				auto component = std::make_unique<FakeComponent>();
+				component->Type = type;
+				component->Position[0] = static_cast<float>(random() % 100);
+				actor->Components.push_back(component.get());
+				actor->ComponentsByType[type] = reinterpret_cast<const Component*>(component.get());
+				world.Components.push_back(std::move(component));
+			}
+			world.Actors.push_back(std::move(actor));
+		}
+
+		// Components end up in no particular order, like a level that grew over time
+		std::shuffle(world.Components.begin(), world.Components.end(), random);
+		return world;
+	}
+}
+
+// Sums a field of the scene component of every actor with a mesh renderer,
+// once through each actor's component list and once through the archetype chunks
+BENCHMARK(ArchetypeStorage_Iteration)
+{
+	World world = MakeWorld();
+	ArchetypeStorage storage;
+	for (const auto& actor : world.Actors)
+	{
+		storage.SetActorComponents(reinterpret_cast<Actor*>(actor.get()), actor->ComponentsByType);
+	}
+
+	float listSum = 0.0f;
+	const double listMs = Testing::MeasureMs(10, [&]()
+	{
+		listSum = 0.0f;
+		for (const auto& actor : world.Actors)
+		{
+			const FakeComponent* scene = nullptr;
+			bool bHasMesh = false;
+			for (const FakeComponent* component : actor->Components)
+			{
+				scene = component->Type == SceneComponentType ? component : scene;
+				bHasMesh |= component->Type == StaticMeshRendererType;
+			}
+			if (bHasMesh && scene != nullptr)
+			{
+				listSum += scene->Position[0];
+			}
+		}
+	});
+
+	float chunkSum = 0.0f;
+	const double chunkMs = Testing::MeasureMs(10, [&]()
+	{
+		chunkSum = 0.0f;
+		storage.ForEachChunk({ SceneComponentType, StaticMeshRendererType }, [&](const ArchetypeStorage::ChunkView& InView)
+		{
+			FakeComponent* const* scenes = InView.GetColumnAs<FakeComponent>(SceneComponentType);
+			for (uint32_t row = 0; row < InView.GetNum(); ++row)
+			{
+				chunkSum += scenes[row]->Position[0];
+			}
+		});
+	});
+
+	// Whole numbers far below 2^24, the sums are exact in any order
+	CHECK(listSum == chunkSum);
+	std::cout << "  " << NumActors << " actors, " << storage.GetNumArchetypes() << " archetypes: component lists " << listMs
+		<< " ms, chunks " << chunkMs << " ms" << std::endl;
+}
+
+// Adding and removing a component moves the actor between archetypes, despawning removes its row
+BENCHMARK(ArchetypeStorage_Churn)
+{
+	World world = MakeWorld();
+	ArchetypeStorage storage;
+	for (const auto& actor : world.Actors)
+	{
+		storage.SetActorComponents(reinterpret_cast<Actor*>(actor.get()), actor->ComponentsByType);
+	}
+
+	FakeComponent audio;
+	std::mt19937 random(5);
+	constexpr uint32_t numChanges = 100000;
+
+	const double moveMs = Testing::MeasureMs(1, [&]()
+	{
+		for (uint32_t i = 0; i < numChanges; ++i)
+		{
+			FakeActor& actor = *world.Actors[random() % NumActors];
+			const Component*& slot = actor.ComponentsByType[AudioComponentType];
+			slot = slot ? nullptr : reinterpret_cast<const Component*>(&audio);
+			storage.SetActorComponents(reinterpret_cast<Actor*>(&actor), actor.ComponentsByType);
+		}
+	});
+
+	const double respawnMs = Testing::MeasureMs(1, [&]()
+	{
+		for (uint32_t i = 0; i < numChanges; ++i)
+		{
+			FakeActor& actor = *world.Actors[random() % NumActors];
+			storage.RemoveActor(reinterpret_cast<Actor*>(&actor));
+			storage.SetActorComponents(reinterpret_cast<Actor*>(&actor), actor.ComponentsByType);
+		}
+	});
+
+	CHECK_EQ(storage.GetNumActors(), size_t(NumActors));
+	std::cout << "  " << numChanges << " archetype moves " << moveMs << " ms, " << numChanges << " despawn + spawn "
+		<< respawnMs << " ms" << std::endl;
+}
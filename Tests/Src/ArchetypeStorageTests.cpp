@@ -0,0 +1,155 @@
+#include "TestFramework.h"
+
+#include "ArchetypeStorage.h"
+
+#include <set>
+#include <vector>
+
+namespace
+{
+	// The storage only keeps pointers, any object stands in for actors and components
+	struct FakeActor
+	{
+		const Component* ComponentsByType[Last] = {};
+	};
+
+	struct FakeComponent
+	{
+		int Value = 0;
+	};
+
+	auto AsActor(FakeActor& InActor) -> Actor* { return reinterpret_cast<Actor*>(&InActor); }
+	auto AsComponent(FakeComponent& InComponent) -> const Component* { return reinterpret_cast<const Component*>(&InComponent); }
+
+	// Actors seen by a query, with the value of the InType component of each
+	auto Collect(const ArchetypeStorage& InStorage, std::initializer_list<ComponentType> InTypes, ComponentType InType)
+		-> std::vector<std::pair<Actor*, int>>
+	{
+		std::vector<std::pair<Actor*, int>> rows;
+		InStorage.ForEachChunk(InTypes, [&](const ArchetypeStorage::ChunkView& InView)
+		{
+			FakeComponent* const* column = InView.GetColumnAs<FakeComponent>(InType);
+			for (uint32_t row = 0; row < InView.GetNum(); ++row)
+			{
+				rows.push_back({ InView.GetActors()[row], column[row]->Value });
+			}
+		});
+		return rows;
+	}
+}
+
+TEST_CASE(ArchetypeStorage_GroupsByComponentSet)
+{
+	std::vector<FakeActor> actors(300);
+	std::vector<FakeComponent> scenes(300);
+	std::vector<FakeComponent> meshes(300);
+
+	ArchetypeStorage storage;
+	for (size_t i = 0; i < actors.size(); ++i)
+	{
+		scenes[i].Value = static_cast<int>(i);
+		actors[i].ComponentsByType[SceneComponentType] = AsComponent(scenes[i]);
+		// Every third actor also draws a mesh
+		if (i % 3 == 0)
+		{
+			actors[i].ComponentsByType[StaticMeshRendererType] = AsComponent(meshes[i]);
+		}
+		storage.SetActorComponents(AsActor(actors[i]), actors[i].ComponentsByType);
+	}
+
+	CHECK_EQ(storage.GetNumArchetypes(), size_t(2));
+	CHECK_EQ(storage.GetNumActors(), size_t(300));
+	CHECK_EQ(Collect(storage, { SceneComponentType }, SceneComponentType).size(), size_t(300));
+
+	const auto drawn = Collect(storage, { SceneComponentType, StaticMeshRendererType }, SceneComponentType);
+	REQUIRE(drawn.size() == 100);
+	for (const auto& [actor, value] : drawn)
+	{
+		CHECK(actor == AsActor(actors[value]));
+		CHECK_EQ(value % 3, 0);
+	}
+
+	CHECK(Collect(storage, { AudioComponentType }, AudioComponentType).empty());
+}
+
+// Removal fills holes with the last row, every actor stays reachable exactly once
+TEST_CASE(ArchetypeStorage_RemoveKeepsRowsConsistent)
+{
+	std::vector<FakeActor> actors(1000);
+	std::vector<FakeComponent> scenes(1000);
+
+	ArchetypeStorage storage;
+	for (size_t i = 0; i < actors.size(); ++i)
+	{
+		scenes[i].Value = static_cast<int>(i);
+		actors[i].ComponentsByType[SceneComponentType] = AsComponent(scenes[i]);
+		storage.SetActorComponents(AsActor(actors[i]), actors[i].ComponentsByType);
+	}
+
+	std::set<int> remaining;
+	for (size_t i = 0; i < actors.size(); ++i)
+	{
+		if (i % 7 == 0 || i % 2 == 0)
+		{
+			storage.RemoveActor(AsActor(actors[i]));
+		}
+		else
+		{
+			remaining.insert(static_cast<int>(i));
+		}
+	}
+	// Removing twice is harmless
+	storage.RemoveActor(AsActor(actors[0]));
+
+	const auto rows = Collect(storage, { SceneComponentType }, SceneComponentType);
+	CHECK_EQ(rows.size(), remaining.size());
+	CHECK_EQ(storage.GetNumActors(), remaining.size());
+
+	std::set<int> seen;
+	for (const auto& [actor, value] : rows)
+	{
+		CHECK(actor == AsActor(actors[value]));
+		seen.insert(value);
+	}
+	CHECK(seen == remaining);
+
+	// All chunks but the last are full
+	uint32_t numChunks = 0;
+	uint32_t numPartial = 0;
+	storage.ForEachChunk({ SceneComponentType }, [&](const ArchetypeStorage::ChunkView& InView)
+	{
+		++numChunks;
+		numPartial += InView.GetNum() < ArchetypeStorage::ChunkCapacity ? 1 : 0;
+	});
+	CHECK_EQ(numChunks, uint32_t((remaining.size() + ArchetypeStorage::ChunkCapacity - 1) / ArchetypeStorage::ChunkCapacity));
+	CHECK(numPartial <= 1);
+}
+
+TEST_CASE(ArchetypeStorage_MovesBetweenArchetypes)
+{
+	FakeActor actor;
+	FakeComponent scene{ 1 };
+	FakeComponent mesh{ 2 };
+	FakeComponent otherScene{ 3 };
+
+	ArchetypeStorage storage;
+	actor.ComponentsByType[SceneComponentType] = AsComponent(scene);
+	storage.SetActorComponents(AsActor(actor), actor.ComponentsByType);
+
+	actor.ComponentsByType[StaticMeshRendererType] = AsComponent(mesh);
+	storage.SetActorComponents(AsActor(actor), actor.ComponentsByType);
+	CHECK_EQ(storage.GetNumActors(), size_t(1));
+	CHECK_EQ(Collect(storage, { StaticMeshRendererType }, StaticMeshRendererType).size(), size_t(1));
+
+	// Same set with a replaced component updates the row in place
+	actor.ComponentsByType[SceneComponentType] = AsComponent(otherScene);
+	storage.SetActorComponents(AsActor(actor), actor.ComponentsByType);
+	const auto rows = Collect(storage, { SceneComponentType }, SceneComponentType);
+	REQUIRE(rows.size() == 1);
+	CHECK_EQ(rows[0].second, 3);
+
+	actor.ComponentsByType[StaticMeshRendererType] = nullptr;
+	storage.SetActorComponents(AsActor(actor), actor.ComponentsByType);
+	CHECK(Collect(storage, { StaticMeshRendererType }, StaticMeshRendererType).empty());
+	CHECK_EQ(Collect(storage, { SceneComponentType }, SceneComponentType).size(), size_t(1));
+}
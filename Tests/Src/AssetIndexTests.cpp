@@ -0,0 +1,207 @@
+#include "TestFramework.h"
+
+#include "AssetIndex.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+	// Fresh asset directory with a few files under the system temp directory, removed again at the end of the test
+	struct TempAssets
+	{
+		explicit TempAssets(const char* InName)
+			: Root(std::filesystem::temp_directory_path() / InName)
+		{
+			std::filesystem::remove_all(Root);
+			std::filesystem::create_directories(Root / "Assets" / "Textures");
+			WriteFile("Assets/level.json", "{}");
+			WriteFile("Assets/Textures/a.png", "aaaa");
+			WriteFile("Assets/Textures/b.png", "bbbbbbbb");
+		}
+
+		~TempAssets()
+		{
+			std::error_code error;
+			std::filesystem::remove_all(Root, error);
+		}
+
+		auto WriteFile(const char* InRelativePath, const std::string& InContent) const -> void
+		{
+			std::ofstream out(Root / InRelativePath, std::ios::binary | std::ios::trunc);
+			out << InContent;
+		}
+
+		auto GetAssets() const -> Path { return Root / "Assets"; }
+		auto GetIndex() const -> Path { return Root / "Cache" / "AssetIndex.bin"; }
+
+		Path Root;
+	};
+
+	auto CountingScan(std::atomic<uint32_t>& OutNumScans) -> AssetIndex::ScanFunction
+	{
+		return [&OutNumScans](const Path& InFilePath, AssetIndexEntry& OutEntry)
+		{
+			++OutNumScans;
+			OutEntry.Type = InFilePath.extension() == Path(".json") ? AssetType::Level : AssetType::Unspecified;
+		};
+	}
+}
+
+TEST_CASE(AssetIndex_ScansOnlyNewAndChangedFiles)
+{
+	TempAssets assets("NamelessEngineTests_AssetIndex");
+	JobSystem jobs(2);
+	std::atomic<uint32_t> numScans = 0;
+
+	{
+		AssetIndex index(assets.GetIndex());
+		CHECK(!index.Load());
+		index.Update(assets.GetAssets(), CountingScan(numScans), jobs);
+		CHECK_EQ(numScans.load(), 3u);
+		CHECK_EQ(index.GetStats().NumFiles, 3u);
+		CHECK_EQ(index.GetItems().size(), 4u);
+
+		const AssetIndexEntry* level = index.FindEntry("level.json");
+		REQUIRE(level != nullptr);
+		CHECK(level->Type == AssetType::Level);
+	}
+
+	numScans = 0;
+	{
+		AssetIndex index(assets.GetIndex());
+		CHECK(index.Load());
+		index.Update(assets.GetAssets(), CountingScan(numScans), jobs);
+		CHECK_EQ(numScans.load(), 0u);
+		REQUIRE(index.FindEntry("level.json") != nullptr);
+		CHECK(index.FindEntry("level.json")->Type == AssetType::Level);
+
+		// A different size is a change even with the same write time resolution
+		assets.WriteFile("Assets/Textures/a.png", "aaaaaaaaaaaa");
+		std::filesystem::remove(assets.GetAssets() / "Textures" / "b.png");
+		index.UpdatePaths(assets.GetAssets(), { Path("Textures/a.png"), Path("Textures/b.png") }, CountingScan(numScans), jobs);
+		CHECK_EQ(numScans.load(), 1u);
+		CHECK_EQ(index.GetStats().NumRemoved, 1u);
+		CHECK(index.FindEntry("Textures/b.png") == nullptr);
+		CHECK(index.FindEntry("Textures/a.png") != nullptr);
+	}
+}
+
+TEST_CASE(AssetIndex_BrokenIndexIsRebuilt)
+{
+	TempAssets assets("NamelessEngineTests_AssetIndexBroken");
+	JobSystem jobs(2);
+	std::atomic<uint32_t> numScans = 0;
+
+	{
+		AssetIndex index(assets.GetIndex());
+		index.Load();
+		index.Update(assets.GetAssets(), CountingScan(numScans), jobs);
+	}
+
+	// Valid header claiming billions of entries, followed by garbage
+	{
+		std::fstream file(assets.GetIndex(), std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(8);
+		const uint32_t numEntries = 0xffffffffu;
+		file.write(reinterpret_cast<const char*>(&numEntries), sizeof(numEntries));
+		file.seekp(20);
+		file.write("\xff\xff\xff\xff", 4);
+	}
+
+	numScans = 0;
+	{
+		AssetIndex index(assets.GetIndex());
+		CHECK(!index.Load());
+		index.Update(assets.GetAssets(), CountingScan(numScans), jobs);
+		CHECK_EQ(numScans.load(), 3u);
+	}
+
+	// The rebuild replaced the broken file even though the directory didn't change
+	numScans = 0;
+	{
+		AssetIndex index(assets.GetIndex());
+		CHECK(index.Load());
+		index.Update(assets.GetAssets(), CountingScan(numScans), jobs);
+		CHECK_EQ(numScans.load(), 0u);
+	}
+}
+
+TEST_CASE(AssetIndex_MissingPathsDontThrow)
+{
+	TempAssets assets("NamelessEngineTests_AssetIndexMissing");
+	JobSystem jobs(1);
+	std::atomic<uint32_t> numScans = 0;
+
+	uint32_t numVisited = 0;
+	WalkDirectory(assets.Root / "DoesNotExist", [&numVisited](const std::filesystem::directory_entry&) { ++numVisited; });
+	CHECK_EQ(numVisited, 0u);
+
+	AssetIndex index(assets.GetIndex());
+	index.Update(assets.Root / "DoesNotExist", CountingScan(numScans), jobs);
+	CHECK_EQ(index.GetItems().size(), 0u);
+
+	index.Update(assets.GetAssets(), CountingScan(numScans), jobs);
+	std::filesystem::remove_all(assets.GetAssets() / "Textures");
+	index.UpdatePaths(assets.GetAssets(), { Path("Textures") }, CountingScan(numScans), jobs);
+	CHECK_EQ(index.GetStats().NumRemoved, 2u);
+}
+
+TEST_CASE(AssetIndex_BeginUpdateDoesntWaitForScans)
+{
+	TempAssets assets("NamelessEngineTests_AssetIndexAsync");
+	JobSystem jobs(2);
+	std::atomic<uint32_t> numScans = 0;
+
+	AssetIndex index(assets.GetIndex());
+	index.Update(assets.GetAssets(), CountingScan(numScans), jobs);
+
+	// Scans are held back until released, the index must not change before TryFinishUpdate succeeds
+	std::atomic<bool> bRelease = false;
+	const AssetIndex::ScanFunction blockedScan = [&](const Path& InFilePath, AssetIndexEntry& OutEntry)
+	{
+		while (!bRelease.load())
+		{
+			std::this_thread::yield();
+		}
+		OutEntry.SubAssets.push_back("scanned");
+	};
+
+	assets.WriteFile("Assets/Textures/a.png", "changed content");
+	assets.WriteFile("Assets/Textures/c.png", "new");
+	index.BeginUpdatePaths(assets.GetAssets(), { Path("Textures") }, blockedScan, jobs);
+	CHECK(index.IsUpdating());
+	CHECK(!index.TryFinishUpdate());
+	CHECK(index.FindEntry("Textures/c.png") == nullptr);
+	REQUIRE(index.FindEntry("Textures/a.png") != nullptr);
+	CHECK(index.FindEntry("Textures/a.png")->SubAssets.empty());
+
+	bRelease = true;
+	while (!index.TryFinishUpdate())
+	{
+		std::this_thread::yield();
+	}
+	CHECK(!index.IsUpdating());
+	CHECK_EQ(index.GetStats().NumScanned, 2u);
+	CHECK_EQ(index.GetChangedPaths().size(), 2u);
+	REQUIRE(index.FindEntry("Textures/c.png") != nullptr);
+	CHECK_EQ(index.FindEntry("Textures/c.png")->SubAssets.size(), 1u);
+	CHECK_EQ(index.FindEntry("Textures/a.png")->SubAssets.size(), 1u);
+}
+
+TEST_CASE(AssetIndex_DestroyedWhileScanning)
+{
+	TempAssets assets("NamelessEngineTests_AssetIndexDestroy");
+	JobSystem jobs(2);
+	std::atomic<uint32_t> numScans = 0;
+
+	{
+		AssetIndex index(assets.GetIndex());
+		index.BeginUpdate(assets.GetAssets(), CountingScan(numScans), jobs);
+	}
+	CHECK_EQ(numScans.load(), 3u);
+}
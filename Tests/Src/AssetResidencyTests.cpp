@@ -0,0 +1,159 @@
+#include "TestFramework.h"
+
+#include "AssetResidency.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	// Loads without files, holding InCpuBytes in system memory and half of it in video memory
+	class FakeAsset : public Asset
+	{
+	public:
+		explicit FakeAsset(size_t InCpuBytes) : CpuBytes(InCpuBytes) {}
+
+		auto LoadData() -> bool override { return true; }
+		auto FinishLoad() -> bool override { SetMemoryUsage({ CpuBytes, CpuBytes / 2 }); return true; }
+		auto Unload() -> void override { ++NumUnloads; Asset::Unload(); }
+		auto GetTypeName() const -> const char* override { return "FakeAsset"; }
+
+		size_t CpuBytes;
+		uint32_t NumUnloads = 0;
+	};
+
+	constexpr size_t MB = size_t(1) << 20;
+
+	auto MakeAssets(uint32_t InCount, size_t InCpuBytes) -> std::vector<std::unique_ptr<FakeAsset>>
+	{
+		std::vector<std::unique_ptr<FakeAsset>> assets;
+		for (uint32_t i = 0; i < InCount; ++i)
+		{
+			assets.push_back(std::make_unique<FakeAsset>(InCpuBytes));
+		}
+		return assets;
+	}
+
+	auto GetPointers(const std::vector<std::unique_ptr<FakeAsset>>& InAssets) -> std::vector<Asset*>
+	{
+		std::vector<Asset*> pointers;
+		for (const std::unique_ptr<FakeAsset>& asset : InAssets)
+		{
+			pointers.push_back(asset.get());
+		}
+		return pointers;
+	}
+}
+
+// Streams through 16 times the budget, one asset used and let go per frame like a level walking past them
+TEST_CASE(AssetResidency_StaysWithinBudget)
+{
+	const uint32_t numAssets = 1024;
+	const uint32_t numResident = 64;
+	std::vector<std::unique_ptr<FakeAsset>> assets = MakeAssets(numAssets, MB);
+	const std::vector<Asset*> pointers = GetPointers(assets);
+
+	AssetResidency residency;
+	residency.SetMemoryBudget(numResident * MB, numResident * MB);
+
+	size_t peakCpuBytes = 0;
+	for (const std::unique_ptr<FakeAsset>& asset : assets)
+	{
+		{
+			AssetRef<FakeAsset> ref(asset.get());
+			REQUIRE(ref->LoadSynchronously());
+			residency.Update(pointers);
+			CHECK(ref->IsLoaded());
+		}
+		residency.Update(pointers);
+		peakCpuBytes = (std::max)(peakCpuBytes, residency.GetTotalMemoryStats().CpuBytes);
+		CHECK(residency.GetTotalMemoryStats().CpuBytes <= residency.GetCpuMemoryBudget());
+	}
+
+	CHECK_EQ(peakCpuBytes, numResident * MB);
+	CHECK_EQ(residency.GetTotalMemoryStats().NumResident, numResident);
+	CHECK_EQ(residency.GetMemoryStatsByType().at("FakeAsset").NumResident, numResident);
+	CHECK_EQ(residency.GetNumEvicted(), uint64_t(numAssets - numResident));
+
+	// The most recently released ones stay
+	for (uint32_t i = 0; i < numAssets; ++i)
+	{
+		CHECK_EQ(assets[i]->IsLoaded(), i >= numAssets - numResident);
+		CHECK_EQ(assets[i]->NumUnloads, i >= numAssets - numResident ? 0u : 1u);
+	}
+}
+
+TEST_CASE(AssetResidency_KeepsReferencedAssets)
+{
+	std::vector<std::unique_ptr<FakeAsset>> assets = MakeAssets(8, MB);
+	const std::vector<Asset*> pointers = GetPointers(assets);
+
+	AssetResidency residency;
+	residency.SetMemoryBudget(2 * MB, 2 * MB);
+
+	std::vector<AssetRef<FakeAsset>> refs;
+	for (const std::unique_ptr<FakeAsset>& asset : assets)
+	{
+		refs.emplace_back(asset.get());
+		asset->LoadSynchronously();
+	}
+	residency.Update(pointers);
+
+	// Over budget, but nothing can go
+	CHECK_EQ(residency.GetTotalMemoryStats().NumResident, 8u);
+	CHECK_EQ(residency.GetNumEvicted(), 0u);
+
+	// Releasing them evicts down to the budget, first released first
+	refs.clear();
+	residency.Update(pointers);
+	CHECK_EQ(residency.GetTotalMemoryStats().NumResident, 2u);
+	CHECK(assets[6]->IsLoaded());
+	CHECK(assets[7]->IsLoaded());
+}
+
+// The video memory budget evicts on its own
+TEST_CASE(AssetResidency_GpuBudget)
+{
+	std::vector<std::unique_ptr<FakeAsset>> assets = MakeAssets(8, 2 * MB);
+	const std::vector<Asset*> pointers = GetPointers(assets);
+
+	AssetResidency residency;
+	residency.SetMemoryBudget(64 * MB, 3 * MB);
+	for (const std::unique_ptr<FakeAsset>& asset : assets)
+	{
+		asset->LoadSynchronously();
+	}
+	residency.Update(pointers);
+
+	CHECK_EQ(residency.GetTotalMemoryStats().NumResident, 3u);
+	CHECK(residency.GetTotalMemoryStats().GpuBytes <= 3 * MB);
+}
+
+TEST_CASE(AssetResidency_EvictedAssetsLoadAgain)
+{
+	std::vector<std::unique_ptr<FakeAsset>> assets = MakeAssets(2, MB);
+	const std::vector<Asset*> pointers = GetPointers(assets);
+
+	AssetResidency residency;
+	residency.SetMemoryBudget(MB, MB);
+	assets[0]->LoadSynchronously();
+	assets[1]->LoadSynchronously();
+	residency.Update(pointers);
+	CHECK(residency.IsUpToDate());
+
+	FakeAsset* evicted = assets[0]->IsLoaded() ? assets[1].get() : assets[0].get();
+	CHECK_EQ(evicted->GetLoadState(), AssetLoadState::Unloaded);
+	CHECK_EQ(evicted->GetMemoryUsage().CpuBytes, size_t(0));
+
+	const uint32_t generation = evicted->GetGeneration();
+	AssetRef<FakeAsset> ref(evicted);
+	CHECK(evicted->LoadSynchronously());
+	CHECK(evicted->GetGeneration() == generation + 1);
+	CHECK(!residency.IsUpToDate());
+
+	residency.Update(pointers);
+	CHECK(evicted->IsLoaded());
+	CHECK_EQ(residency.GetTotalMemoryStats().NumResident, 1u);
+	CHECK_EQ(residency.GetNumEvicted(), 2u);
+}
@@ -0,0 +1,213 @@
+#include "TestFramework.h"
+
+#include "BinaryArchive.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct Sample
+	{
+		float X;
+		uint32_t Y;
+		uint8_t Z[4];
+	};
+
+	auto WriteSample(BinaryWriter& Out) -> void
+	{
+		Out.Write<uint32_t>(0xdeadbeef);
+		Out.Write(Sample{ 1.5f, 7u, { 1, 2, 3, 4 } });
+		Out.WriteString("inline string");
+		Out.WriteStringRef("shared/path.fbx");
+		Out.WriteStringRef("other/path.png");
+		Out.WriteStringRef("shared/path.fbx");
+		Out.WriteJson(json{ { "name", "light" }, { "values", { 1, 2, 3 } } });
+		Out.Write<uint8_t>(42);
+	}
+
+	// Table a reader resolves string references with, backed by the writer's strings
+	auto MakeStringViews(const BinaryWriter& InWriter) -> std::vector<std::string_view>
+	{
+		std::vector<std::string_view> views;
+		for (const std::string& str : InWriter.GetStrings())
+		{
+			views.push_back(str);
+		}
+		return views;
+	}
+}
+
+TEST_CASE(BinaryArchive_RoundTrip)
+{
+	BinaryWriter writer;
+	WriteSample(writer);
+	CHECK_EQ(writer.GetStrings().size(), 2u);
+
+	const std::vector<std::string_view> strings = MakeStringViews(writer);
+	BinaryReader reader(writer.GetBuffer().data(), writer.GetSize(), &strings);
+
+	CHECK_EQ(reader.Read<uint32_t>(), 0xdeadbeefu);
+	const Sample sample = reader.Read<Sample>();
+	CHECK(sample.X == 1.5f && sample.Y == 7u && sample.Z[3] == 4);
+	CHECK(reader.ReadString() == "inline string");
+	CHECK(reader.ReadStringRef() == "shared/path.fbx");
+	CHECK(reader.ReadStringRef() == "other/path.png");
+	CHECK(reader.ReadStringRef() == "shared/path.fbx");
+	const json blob = reader.ReadJson();
+	CHECK(blob.at("name") == "light" && blob.at("values").size() == 3);
+	CHECK_EQ(reader.Read<uint8_t>(), 42);
+
+	CHECK(reader.IsValid());
+	CHECK_EQ(reader.GetRemaining(), 0u);
+}
+
+TEST_CASE(BinaryArchive_PatchOverwritesEarlierValue)
+{
+	BinaryWriter writer;
+	writer.Write<uint32_t>(0);
+	writer.WriteString("payload");
+	writer.Patch(0, static_cast<uint32_t>(writer.GetSize()));
+
+	BinaryReader reader(writer.GetBuffer().data(), writer.GetSize());
+	CHECK_EQ(reader.Read<uint32_t>(), writer.GetSize());
+}
+
+TEST_CASE(BinaryArchive_TruncatedDataFailsAtEveryLength)
+{
+	BinaryWriter writer;
+	WriteSample(writer);
+	const std::vector<std::string_view> strings = MakeStringViews(writer);
+
+	// Every cut of the data has to fail cleanly with zeroed values instead of reading out of bounds
+	uint32_t numFalsePasses = 0;
+	for (size_t size = 0; size < writer.GetSize(); ++size)
+	{
+		std::vector<uint8_t> truncated(writer.GetBuffer().begin(), writer.GetBuffer().begin() + size);
+		BinaryReader reader(truncated.data(), truncated.size(), &strings);
+
+		reader.Read<uint32_t>();
+		reader.Read<Sample>();
+		reader.ReadString();
+		reader.ReadStringRef();
+		reader.ReadStringRef();
+		reader.ReadStringRef();
+		reader.ReadJson();
+		const uint8_t last = reader.Read<uint8_t>();
+
+		numFalsePasses += reader.IsValid() ? 1 : 0;
+		CHECK_EQ(last, 0);
+	}
+	CHECK_EQ(numFalsePasses, 0u);
+}
+
+TEST_CASE(BinaryArchive_FailureIsSticky)
+{
+	const uint8_t data[8] = { 1, 0, 0, 0, 2, 0, 0, 0 };
+	BinaryReader reader(data, sizeof(data));
+
+	CHECK_EQ(reader.Read<uint32_t>(), 1u);
+	reader.Read<uint64_t>();
+	CHECK(!reader.IsValid());
+
+	// The rest of the data is not readable any more either
+	CHECK_EQ(reader.Read<uint32_t>(), 0u);
+	CHECK_EQ(reader.GetRemaining(), 0u);
+}
+
+TEST_CASE(BinaryArchive_BadStringReferences)
+{
+	BinaryWriter writer;
+	writer.Write<uint32_t>(5);
+
+	std::vector<std::string_view> strings = { "only one" };
+	BinaryReader outOfRange(writer.GetBuffer().data(), writer.GetSize(), &strings);
+	CHECK(outOfRange.ReadStringRef().empty());
+	CHECK(!outOfRange.IsValid());
+
+	BinaryReader noTable(writer.GetBuffer().data(), writer.GetSize());
+	CHECK(noTable.ReadStringRef().empty());
+	CHECK(!noTable.IsValid());
+}
+
+TEST_CASE(BinaryArchive_MalformedJson)
+{
+	BinaryWriter writer;
+	const uint8_t garbage[] = { 0xc1, 0xc1, 0xc1 };
+	writer.Write(static_cast<uint32_t>(sizeof(garbage)));
+	writer.WriteBytes(garbage, sizeof(garbage));
+
+	BinaryReader reader(writer.GetBuffer().data(), writer.GetSize());
+	CHECK(reader.ReadJson().is_null());
+	CHECK(!reader.IsValid());
+}
+
+TEST_CASE(BinaryArchive_HugeLengthsDontAllocate)
+{
+	// A string or blob length larger than the data must fail before anything is allocated for it
+	BinaryWriter writer;
+	writer.Write<uint32_t>(0xffffffffu);
+	writer.WriteString("x");
+
+	BinaryReader stringReader(writer.GetBuffer().data(), writer.GetSize());
+	CHECK(stringReader.ReadString().empty());
+	CHECK(!stringReader.IsValid());
+
+	BinaryReader jsonReader(writer.GetBuffer().data(), writer.GetSize());
+	CHECK(jsonReader.ReadJson().is_null());
+	CHECK(!jsonReader.IsValid());
+}
+
+TEST_CASE(BinaryArchive_ClampCount)
+{
+	const uint8_t data[100] = {};
+	BinaryReader reader(data, sizeof(data));
+
+	CHECK_EQ(reader.ClampCount(0xffffffffu, 25), 4u);
+	CHECK_EQ(reader.ClampCount(3, 25), 3u);
+	CHECK_EQ(reader.ClampCount(1000, 0), 100u);
+
+	reader.Skip(90);
+	CHECK_EQ(reader.ClampCount(0xffffffffu, 4), 2u);
+}
+
+TEST_CASE(BinaryArchive_FileRoundTrip)
+{
+	const Path path = std::filesystem::temp_directory_path() / "NamelessEngineTests_BinaryArchive.bin";
+
+	BinaryWriter writer;
+	WriteSample(writer);
+	REQUIRE(WriteFileAtomically(path, writer.GetBuffer()));
+	CHECK(!std::filesystem::exists(Path(path) += ".tmp"));
+
+	{
+		MappedFile file;
+		REQUIRE(file.Open(path));
+		CHECK_EQ(file.GetSize(), writer.GetSize());
+		CHECK(std::equal(writer.GetBuffer().begin(), writer.GetBuffer().end(), file.GetData()));
+	}
+
+	// Rewriting a file that is mapped elsewhere keeps the old mapping intact
+	MappedFile oldFile;
+	REQUIRE(oldFile.Open(path));
+	REQUIRE(WriteFileAtomically(path, std::vector<uint8_t>(16, 0xab)));
+	CHECK_EQ(oldFile.GetSize(), writer.GetSize());
+	CHECK_EQ(oldFile.GetData()[0], 0xef);
+	oldFile.Close();
+
+	MappedFile newFile;
+	REQUIRE(newFile.Open(path));
+	CHECK_EQ(newFile.GetSize(), 16u);
+	newFile.Close();
+
+	std::filesystem::remove(path);
+	MappedFile missing;
+	CHECK(!missing.Open(path));
+}
+
+TEST_CASE(BinaryArchive_WriteToMissingDirectoryFails)
+{
+	const Path path = std::filesystem::temp_directory_path() / "NamelessEngineTests_Missing" / "level.nlevel";
+	CHECK(!WriteFileAtomically(path, std::vector<uint8_t>(4, 0)));
+}
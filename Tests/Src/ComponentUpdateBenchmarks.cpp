@@ -0,0 +1,159 @@
+#include "TestFramework.h"
+
+#include "ComponentsEnum.h"
+#include "UpdateList.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// Polymorphic like the engine components, the rigid body is its own class for the dynamic_cast pass
+	struct FakeComponent
+	{
+		virtual ~FakeComponent() = default;
+		virtual auto GetComponentType() const -> ComponentType { return Type; }
+		virtual auto Update(float DeltaTime) -> void { Position[0] += DeltaTime; }
+
+		uint32_t mUpdateListIndex = UpdateList<FakeComponent>::InvalidIndex;
+		ComponentType Type = Undefined;
+		float Position[3] = {};
+		float Padding[24] = {};
+	};
+
+	struct FakeRigidBody : FakeComponent
+	{
+		auto Update(float DeltaTime) -> void override { Position[1] += DeltaTime; }
+	};
+
+	struct FakeActor
+	{
+		std::vector<FakeComponent*> Components;
+		FakeComponent* ComponentsByType[Last] = {};
+	};
+
+	constexpr uint32_t NumActors = 10000;
+	constexpr ComponentType ActorComponentTypes[] = { SceneComponentType, StaticMeshRendererType, RigidBodyCubeType, AudioComponentType, MovementComponentType };
+
+	struct World
+	{
+		std::vector<std::unique_ptr<FakeComponent>> Components;
+		std::vector<std::unique_ptr<FakeActor>> Actors;
+		std::array<UpdateList<FakeComponent>, Last> Lists;
+	};
+
+	auto MakeWorld() -> World
+	{
+		World world;
+		for (uint32_t i = 0; i < NumActors; ++i)
+		{
+			auto actor = std::make_unique<FakeActor>();
+			for (const ComponentType type : ActorComponentTypes)
+			{
+				std::unique_ptr<FakeComponent> component = type == RigidBodyCubeType ? std::make_unique<FakeRigidBody>() : std::make_unique<FakeComponent>();
+				component->Type = type;
+				actor->Components.push_back(component.get());
+				actor->ComponentsByType[type] = component.get();
+				world.Lists[type].Add(component.get());
+				world.Components.push_back(std::move(component));
+			}
+			world.Actors.push_back(std::move(actor));
+		}
+
+		// Components end up in no particular order, like a level that grew over time
+		std::shuffle(world.Components.begin(), world.Components.end(), std::mt19937(3));
+		return world;
+	}
+}
+
+// 10k actors with 5 components each, updated the way Actor::Update did before the per type lists:
+// rigid bodies first through dynamic_cast, then the rest, actor by actor.
+// Then every component type in one loop, rigid bodies first, as ComponentUpdateLists does.
+BENCHMARK(ComponentUpdate_PerActorAndPerType)
+{
+	World world = MakeWorld();
+
+	const double perActorMs = Testing::MeasureMs(10, [&]()
+	{
+		for (const auto& actor : world.Actors)
+		{
+			for (FakeComponent* component : actor->Components)
+			{
+				if (FakeRigidBody* rigidBody = dynamic_cast<FakeRigidBody*>(component))
+				{
+					rigidBody->Update(0.016f);
+				}
+			}
+
+			for (FakeComponent* component : actor->Components)
+			{
+				if (dynamic_cast<FakeRigidBody*>(component) == nullptr)
+				{
+					component->Update(0.016f);
+				}
+			}
+		}
+	});
+
+	const double perTypeMs = Testing::MeasureMs(10, [&]()
+	{
+		world.Lists[RigidBodyCubeType].ForEach([](FakeComponent* InComponent) { InComponent->Update(0.016f); });
+		for (size_t type = 0; type < world.Lists.size(); ++type)
+		{
+			if (type != RigidBodyCubeType)
+			{
+				world.Lists[type].ForEach([](FakeComponent* InComponent) { InComponent->Update(0.016f); });
+			}
+		}
+	});
+
+	std::cout << "  " << NumActors << " actors x " << std::size(ActorComponentTypes) << " components: per actor with dynamic_cast "
+		<< perActorMs << " ms, per type lists " << perTypeMs << " ms" << std::endl;
+
+	// Both ways updated every component equally often
+	const FakeComponent* first = world.Actors.front()->ComponentsByType[SceneComponentType];
+	const FakeComponent* last = world.Actors.back()->ComponentsByType[SceneComponentType];
+	CHECK(first->Position[0] == last->Position[0]);
+}
+
+// Finding a component of a type on every actor: scanning the components with a virtual call each,
+// as Actor::GetComponentOfType did, against the actor's per type index
+BENCHMARK(ComponentUpdate_LookupByType)
+{
+	World world = MakeWorld();
+
+	size_t scanFound = 0;
+	const double scanMs = Testing::MeasureMs(10, [&]()
+	{
+		scanFound = 0;
+		for (const auto& actor : world.Actors)
+		{
+			for (const ComponentType type : ActorComponentTypes)
+			{
+				const auto found = std::find_if(actor->Components.begin(), actor->Components.end(),
+					[type](const FakeComponent* InComponent) { return InComponent->GetComponentType() == type; });
+				scanFound += found != actor->Components.end() ? 1 : 0;
+			}
+		}
+	});
+
+	size_t indexFound = 0;
+	const double indexMs = Testing::MeasureMs(10, [&]()
+	{
+		indexFound = 0;
+		for (const auto& actor : world.Actors)
+		{
+			for (const ComponentType type : ActorComponentTypes)
+			{
+				indexFound += actor->ComponentsByType[type] != nullptr ? 1 : 0;
+			}
+		}
+	});
+
+	CHECK_EQ(scanFound, indexFound);
+	std::cout << "  " << NumActors << " actors x " << std::size(ActorComponentTypes) << " lookups: scan " << scanMs << " ms, index "
+		<< indexMs << " ms" << std::endl;
+}
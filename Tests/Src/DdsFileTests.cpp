@@ -0,0 +1,173 @@
+#include "TestFramework.h"
+
+#include "DdsFile.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t FourCCDx10 = 0x30315844; // "DX10"
+	constexpr uint32_t FourCCDxt1 = 0x31545844; // "DXT1"
+
+	auto Put(std::vector<uint8_t>& InOutData, uint32_t InValue) -> void
+	{
+		for (int byte = 0; byte < 4; ++byte)
+		{
+			InOutData.push_back(uint8_t(InValue >> (byte * 8)));
+		}
+	}
+
+	// A .dds file with a DX10 header when bInDx10 is set (InFormat is a DXGI_FORMAT), otherwise InFormat is the FourCC
+	auto MakeDds(bool bInDx10, uint32_t InWidth, uint32_t InHeight, uint32_t InMipLevels, uint32_t InFormat, uint32_t InArraySize,
+		bool bInCubeMap, size_t InDataBytes) -> std::vector<uint8_t>
+	{
+		std::vector<uint8_t> data;
+		Put(data, 0x20534444);
+		Put(data, 124);
+		Put(data, 0x1007);
+		Put(data, InHeight);
+		Put(data, InWidth);
+		Put(data, 0);
+		Put(data, 0);
+		Put(data, InMipLevels);
+		for (int i = 0; i < 11; ++i)
+		{
+			Put(data, 0);
+		}
+
+		// Pixel format: size, FourCC flag, FourCC and unused masks
+		Put(data, 32);
+		Put(data, 0x4);
+		Put(data, bInDx10 ? FourCCDx10 : InFormat);
+		for (int i = 0; i < 5; ++i)
+		{
+			Put(data, 0);
+		}
+
+		Put(data, 0x1000);
+		Put(data, !bInDx10 && bInCubeMap ? 0xFE00 : 0);
+		Put(data, 0);
+		Put(data, 0);
+		Put(data, 0);
+
+		if (bInDx10)
+		{
+			Put(data, InFormat);
+			Put(data, 3);
+			Put(data, bInCubeMap ? 0x4 : 0);
+			Put(data, InArraySize);
+			Put(data, 0);
+		}
+
+		data.resize(data.size() + InDataBytes, 0xAB);
+		return data;
+	}
+
+	auto GetBc7Bytes(uint32_t InWidth, uint32_t InHeight, uint32_t InMipLevels) -> size_t
+	{
+		size_t bytes = 0;
+		for (uint32_t mip = 0; mip < InMipLevels; ++mip)
+		{
+			const uint32_t width = (std::max)(InWidth >> mip, 1u);
+			const uint32_t height = (std::max)(InHeight >> mip, 1u);
+			bytes += size_t((width + 3) / 4) * ((height + 3) / 4) * 16;
+		}
+		return bytes;
+	}
+}
+
+TEST_CASE(DdsFile_ParsesDx10MipChainInPlace)
+{
+	const std::vector<uint8_t> file = MakeDds(true, 256, 128, 9, DXGI_FORMAT_BC7_UNORM_SRGB, 1, false, GetBc7Bytes(256, 128, 9));
+	DdsTextureInfo info;
+	REQUIRE(ParseDdsTexture(file.data(), file.size(), info));
+	CHECK_EQ(info.Format, DXGI_FORMAT_BC7_UNORM_SRGB);
+	CHECK_EQ(info.MipLevels, 9u);
+	CHECK_EQ(info.ArraySize, 1u);
+	REQUIRE(info.Subresources.size() == 9);
+
+	// Magic, header and DX10 header come first, the last mip ends with the file
+	CHECK(info.Subresources[0].Data == file.data() + 148);
+	CHECK_EQ(info.Subresources[0].RowPitch, size_t(64 * 16));
+	CHECK_EQ(info.Subresources[8].Width, 1u);
+	CHECK(info.Subresources[8].Data + 16 == file.data() + file.size());
+}
+
+TEST_CASE(DdsFile_RejectsShortData)
+{
+	const std::vector<uint8_t> file = MakeDds(true, 256, 128, 9, DXGI_FORMAT_BC7_UNORM, 1, false, GetBc7Bytes(256, 128, 9));
+	DdsTextureInfo info;
+	CHECK(!ParseDdsTexture(file.data(), file.size() - 1, info));
+	CHECK(info.Subresources.empty());
+	CHECK(!ParseDdsTexture(file.data(), 10, info));
+	CHECK(!ParseDdsTexture(nullptr, 0, info));
+}
+
+TEST_CASE(DdsFile_RejectsBadHeaders)
+{
+	DdsTextureInfo info;
+
+	// More mips than the size has
+	const std::vector<uint8_t> tooManyMips = MakeDds(true, 256, 128, 10, DXGI_FORMAT_BC7_UNORM, 1, false, GetBc7Bytes(256, 128, 9) + 16);
+	CHECK(!ParseDdsTexture(tooManyMips.data(), tooManyMips.size(), info));
+
+	const std::vector<uint8_t> unknownFormat = MakeDds(true, 8, 8, 1, 999, 1, false, 4096);
+	CHECK(!ParseDdsTexture(unknownFormat.data(), unknownFormat.size(), info));
+
+	const std::vector<uint8_t> tooWide = MakeDds(true, 1u << 20, 4, 1, DXGI_FORMAT_R8_UNORM, 1, false, 16);
+	CHECK(!ParseDdsTexture(tooWide.data(), tooWide.size(), info));
+
+	const std::vector<uint8_t> noSlices = MakeDds(true, 8, 8, 1, DXGI_FORMAT_R8_UNORM, 0, false, 64);
+	CHECK(!ParseDdsTexture(noSlices.data(), noSlices.size(), info));
+}
+
+TEST_CASE(DdsFile_ParsesCubeMaps)
+{
+	DdsTextureInfo info;
+
+	const std::vector<uint8_t> legacy = MakeDds(false, 4, 4, 0, FourCCDxt1, 1, true, 6 * 8);
+	REQUIRE(ParseDdsTexture(legacy.data(), legacy.size(), info));
+	CHECK(info.bCubeMap);
+	CHECK_EQ(info.ArraySize, 6u);
+	CHECK_EQ(info.MipLevels, 1u);
+	CHECK_EQ(info.Format, DXGI_FORMAT_BC1_UNORM);
+
+	const std::vector<uint8_t> cubeArray = MakeDds(true, 8, 8, 1, DXGI_FORMAT_R8G8B8A8_UNORM, 2, true, 12 * 8 * 8 * 4);
+	REQUIRE(ParseDdsTexture(cubeArray.data(), cubeArray.size(), info));
+	CHECK_EQ(info.ArraySize, 12u);
+	CHECK_EQ(info.Subresources.size(), size_t(12));
+}
+
+TEST_CASE(DdsFile_RejectsCubeCountThatWrapsAround)
+{
+	// 715827883 * 6 wraps around to 2 faces in 32 bits
+	const std::vector<uint8_t> file = MakeDds(true, 8, 8, 1, DXGI_FORMAT_R8_UNORM, 715827883u, true, 2 * 64);
+	DdsTextureInfo info;
+	CHECK(!ParseDdsTexture(file.data(), file.size(), info));
+
+	// The largest cube array D3D11 can create still parses
+	const std::vector<uint8_t> largest = MakeDds(true, 1, 1, 1, DXGI_FORMAT_R8_UNORM, 2048 / 6, true, 2048 / 6 * 6);
+	CHECK(ParseDdsTexture(largest.data(), largest.size(), info));
+	const std::vector<uint8_t> tooLarge = MakeDds(true, 1, 1, 1, DXGI_FORMAT_R8_UNORM, 2048 / 6 + 1, true, (2048 / 6 + 1) * 6);
+	CHECK(!ParseDdsTexture(tooLarge.data(), tooLarge.size(), info));
+}
+
+TEST_CASE(DdsFile_MaxFirstMip)
+{
+	DdsTextureInfo info;
+
+	// Block compressed mips stop being multiples of 4 below 8x4
+	const std::vector<uint8_t> bc7 = MakeDds(true, 256, 128, 9, DXGI_FORMAT_BC7_UNORM_SRGB, 1, false, GetBc7Bytes(256, 128, 9));
+	REQUIRE(ParseDdsTexture(bc7.data(), bc7.size(), info));
+	CHECK_EQ(GetDdsMaxFirstMip(info), 5u);
+
+	const std::vector<uint8_t> bc1 = MakeDds(true, 12, 12, 2, DXGI_FORMAT_BC1_UNORM, 1, false, 9 * 8 + 4 * 8);
+	REQUIRE(ParseDdsTexture(bc1.data(), bc1.size(), info));
+	CHECK_EQ(GetDdsMaxFirstMip(info), 0u);
+
+	const std::vector<uint8_t> rgba = MakeDds(true, 8, 8, 4, DXGI_FORMAT_R8G8B8A8_UNORM, 1, false, (64 + 16 + 4 + 1) * 4);
+	REQUIRE(ParseDdsTexture(rgba.data(), rgba.size(), info));
+	CHECK_EQ(GetDdsMaxFirstMip(info), 3u);
+}
@@ -0,0 +1,175 @@
+#include "TestFramework.h"
+
+#include "FrameScheduler.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	auto MakeTick(const char* InName, TickResourceMask InReads, TickResourceMask InWrites, std::function<void(float)> InFunction) -> TickFunction
+	{
+		TickFunction tick;
+		tick.Name = InName;
+		tick.Phase = FramePhase::Script;
+		tick.Reads = InReads;
+		tick.Writes = InWrites;
+		tick.Function = std::move(InFunction);
+		return tick;
+	}
+}
+
+TEST_CASE(FrameScheduler_ConflictingTicksKeepOrder)
+{
+	JobSystem jobs(4);
+	FrameScheduler scheduler(&jobs);
+
+	std::vector<std::string> order;
+	scheduler.RegisterTick(MakeTick("A", TickResourceTransforms, TickResourceTransforms, [&order](float) { order.push_back("A"); }));
+	// Reads what A writes
+	scheduler.RegisterTick(MakeTick("B", TickResourceTransforms, TickResourceRenderers, [&order](float) { order.push_back("B"); }));
+	// Writes what B writes
+	scheduler.RegisterTick(MakeTick("C", TickResourceNone, TickResourceRenderers, [&order](float) { order.push_back("C"); }));
+	// Defaults conflict with everything
+	scheduler.RegisterTick(MakeTick("D", TickResourceAll, TickResourceAll, [&order](float) { order.push_back("D"); }));
+
+	for (uint32_t frame = 0; frame < 3; ++frame)
+	{
+		order.clear();
+		scheduler.Tick(0.016f);
+		CHECK((order == std::vector<std::string>{ "A", "B", "C", "D" }));
+	}
+	CHECK_EQ(scheduler.GetNumWaves(FramePhase::Script), 4u);
+}
+
+TEST_CASE(FrameScheduler_IndependentTicksShareWave)
+{
+	JobSystem jobs(4);
+	FrameScheduler scheduler(&jobs);
+
+	std::atomic<uint32_t> numRuns = 0;
+	const TickResourceMask resources[] = { TickResourceAudio, TickResourceNavigation, TickResourceDebugDraw, TickResourceScripts };
+	for (const TickResourceMask resource : resources)
+	{
+		TickFunction tick = MakeTick("Independent", TickResourceTransforms, resource, [&numRuns](float) { ++numRuns; });
+		tick.bMainThreadOnly = false;
+		scheduler.RegisterTick(std::move(tick));
+	}
+
+	// Only reads what the others read, and the other phase is scheduled on its own
+	scheduler.RegisterTick(MakeTick("Reader", TickResourceTransforms, TickResourceNone, [&numRuns](float) { ++numRuns; }));
+	TickFunction physics = MakeTick("Physics", TickResourceAll, TickResourceAll, [&numRuns](float) { ++numRuns; });
+	physics.Phase = FramePhase::Physics;
+	scheduler.RegisterTick(std::move(physics));
+
+	scheduler.Tick(0.016f);
+
+	CHECK_EQ(numRuns.load(), 6u);
+	CHECK_EQ(scheduler.GetNumWaves(FramePhase::Script), 1u);
+	CHECK_EQ(scheduler.GetNumWaves(FramePhase::Physics), 1u);
+	CHECK_EQ(scheduler.GetNumWaves(FramePhase::PreRender), 0u);
+}
+
+TEST_CASE(FrameScheduler_PhasesRunInOrder)
+{
+	FrameScheduler scheduler(nullptr);
+
+	std::vector<FramePhase> order;
+	const FramePhase phases[] = { FramePhase::PreRender, FramePhase::Script, FramePhase::PrePhysics, FramePhase::PostPhysics, FramePhase::Physics };
+	for (const FramePhase phase : phases)
+	{
+		TickFunction tick = MakeTick("Phase", TickResourceNone, TickResourceNone, [&order, phase](float) { order.push_back(phase); });
+		tick.Phase = phase;
+		scheduler.RegisterTick(std::move(tick));
+	}
+
+	scheduler.Tick(0.016f);
+
+	CHECK((order == std::vector<FramePhase>{ FramePhase::PrePhysics, FramePhase::Physics, FramePhase::PostPhysics, FramePhase::Script, FramePhase::PreRender }));
+}
+
+TEST_CASE(FrameScheduler_DeferredChangesFromTicks)
+{
+	JobSystem jobs(2);
+	FrameScheduler scheduler(&jobs);
+
+	uint32_t numAddedRuns = 0;
+	uint32_t numRemovedRuns = 0;
+	uint32_t numSpawnerRuns = 0;
+
+	FrameScheduler::TickHandle removedHandle = 0;
+	removedHandle = scheduler.RegisterTick(MakeTick("Removed", TickResourceAll, TickResourceAll, [&](float)
+	{
+		// Unregistering itself only takes effect next frame
+		++numRemovedRuns;
+		scheduler.UnregisterTick(removedHandle);
+	}));
+
+	scheduler.RegisterTick(MakeTick("Spawner", TickResourceAll, TickResourceAll, [&](float)
+	{
+		if (numSpawnerRuns++ == 0)
+		{
+			scheduler.RegisterTick(MakeTick("Added", TickResourceAll, TickResourceAll, [&numAddedRuns](float) { ++numAddedRuns; }));
+		}
+	}));
+
+	scheduler.Tick(0.016f);
+	CHECK_EQ(numRemovedRuns, 1u);
+	CHECK_EQ(numAddedRuns, 0u);
+
+	scheduler.Tick(0.016f);
+	scheduler.Tick(0.016f);
+	CHECK_EQ(numRemovedRuns, 1u);
+	CHECK_EQ(numAddedRuns, 2u);
+	CHECK_EQ(numSpawnerRuns, 3u);
+	CHECK_EQ(scheduler.GetNumWaves(FramePhase::Script), 2u);
+}
+
+TEST_CASE(FrameScheduler_MainThreadOnlyTicks)
+{
+	JobSystem jobs(4);
+	FrameScheduler scheduler(&jobs);
+
+	std::mutex mutex;
+	std::vector<std::thread::id> mainThreadOnlyIds;
+	std::atomic<uint32_t> numWorkerTicks = 0;
+
+	// One wave of independent ticks, half of them bound to the main thread
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		const TickResourceMask resource = TickResourceMask(1) << (8 + i);
+		const bool bMainThreadOnly = i % 2 == 0;
+		TickFunction tick = MakeTick("Tick", TickResourceNone, resource, [&, bMainThreadOnly](float)
+		{
+			if (bMainThreadOnly)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				mainThreadOnlyIds.push_back(std::this_thread::get_id());
+			}
+			else
+			{
+				++numWorkerTicks;
+			}
+		});
+		tick.bMainThreadOnly = bMainThreadOnly;
+		scheduler.RegisterTick(std::move(tick));
+	}
+
+	for (uint32_t frame = 0; frame < 20; ++frame)
+	{
+		scheduler.Tick(0.016f);
+	}
+
+	CHECK_EQ(scheduler.GetNumWaves(FramePhase::Script), 1u);
+	CHECK_EQ(numWorkerTicks.load(), 8u * 20u);
+	REQUIRE(mainThreadOnlyIds.size() == 8u * 20u);
+	for (const std::thread::id id : mainThreadOnlyIds)
+	{
+		CHECK(id == std::this_thread::get_id());
+	}
+}
@@ -0,0 +1,122 @@
+#include "TestFramework.h"
+
+#include "HandleRegistry.h"
+
+#include <random>
+
+namespace
+{
+	struct FakeObject
+	{
+		int Value = 0;
+	};
+
+	using Registry = HandleRegistry<FakeObject>;
+
+	auto MakeIds() -> uuids::uuid_random_generator
+	{
+		static std::mt19937 random(7);
+		return uuids::uuid_random_generator(random);
+	}
+}
+
+TEST_CASE(HandleRegistry_StaleHandleAfterReuse)
+{
+	Registry registry;
+	auto ids = MakeIds();
+
+	FakeObject first;
+	FakeObject second;
+	const Registry::Handle firstHandle = registry.Add(&first, ids());
+	CHECK(registry.Get(firstHandle) == &first);
+
+	registry.Remove(firstHandle);
+	CHECK(registry.Get(firstHandle) == nullptr);
+	CHECK_EQ(registry.GetNum(), 0u);
+
+	// Same slot, newer generation
+	const Registry::Handle secondHandle = registry.Add(&second, ids());
+	CHECK_EQ(secondHandle.Index, firstHandle.Index);
+	CHECK(secondHandle != firstHandle);
+	CHECK(registry.Get(firstHandle) == nullptr);
+	CHECK(registry.Get(secondHandle) == &second);
+
+	// Removing through the stale handle leaves the new object alone
+	registry.Remove(firstHandle);
+	CHECK(registry.Get(secondHandle) == &second);
+	CHECK_EQ(registry.GetNum(), 1u);
+
+	CHECK(registry.Get(Registry::Handle{}) == nullptr);
+	CHECK(registry.Get(Registry::Handle{ 1000, 0 }) == nullptr);
+}
+
+TEST_CASE(HandleRegistry_SetIdRekeys)
+{
+	Registry registry;
+	auto ids = MakeIds();
+
+	FakeObject object;
+	const uuids::uuid oldId = ids();
+	const uuids::uuid newId = ids();
+	const Registry::Handle handle = registry.Add(&object, oldId);
+	CHECK(registry.FindObjectById(oldId) == &object);
+
+	registry.SetId(handle, newId);
+	CHECK(registry.FindObjectById(newId) == &object);
+	CHECK(registry.FindObjectById(oldId) == nullptr);
+	CHECK(!registry.FindById(oldId).IsSet());
+
+	// Stale handles can't re-key the slot's new owner
+	registry.Remove(handle);
+	FakeObject other;
+	const uuids::uuid otherId = ids();
+	const Registry::Handle otherHandle = registry.Add(&other, otherId);
+	registry.SetId(handle, oldId);
+	CHECK(registry.FindById(otherId) == otherHandle);
+	CHECK(registry.FindObjectById(oldId) == nullptr);
+}
+
+TEST_CASE(HandleRegistry_RemoveKeepsNewerEntryOfSameId)
+{
+	Registry registry;
+	auto ids = MakeIds();
+
+	// A copy deserialized with the id of an object that is still alive takes over the id
+	const uuids::uuid id = ids();
+	FakeObject original;
+	FakeObject copy;
+	const Registry::Handle originalHandle = registry.Add(&original, id);
+	const Registry::Handle copyHandle = registry.Add(&copy, id);
+	CHECK(registry.FindById(id) == copyHandle);
+
+	registry.Remove(originalHandle);
+	CHECK(registry.FindObjectById(id) == &copy);
+
+	registry.Remove(copyHandle);
+	CHECK(registry.FindObjectById(id) == nullptr);
+}
+
+TEST_CASE(HandleRegistry_PackedRoundTrip)
+{
+	Registry registry;
+	auto ids = MakeIds();
+
+	FakeObject objects[3];
+	Registry::Handle handle;
+	for (FakeObject& object : objects)
+	{
+		// Churn the slot so the generation isn't 0
+		handle = registry.Add(&object, ids());
+		registry.Remove(handle);
+	}
+	handle = registry.Add(&objects[0], ids());
+	CHECK(handle.Generation == 3u);
+
+	const Registry::Handle unpacked = Registry::Handle::FromPacked(handle.ToPacked());
+	CHECK(unpacked == handle);
+	CHECK(registry.Get(unpacked) == &objects[0]);
+
+	const Registry::Handle extremes{ 0xfffffffeu, 0xffffffffu };
+	CHECK(Registry::Handle::FromPacked(extremes.ToPacked()) == extremes);
+	CHECK(!Registry::Handle::FromPacked(Registry::Handle{}.ToPacked()).IsSet());
+}
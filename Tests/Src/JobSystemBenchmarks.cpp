@@ -0,0 +1,71 @@
+#include "TestFramework.h"
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	auto GetWorkerCounts() -> std::vector<uint32_t>
+	{
+		const uint32_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<uint32_t> counts;
+		for (uint32_t count = 1; count < maxWorkers; count *= 2)
+		{
+			counts.push_back(count);
+		}
+		counts.push_back(maxWorkers);
+		return counts;
+	}
+}
+
+// Compute bound ParallelFor, the time should drop close to linearly with the worker count
+BENCHMARK(JobSystem_ParallelForScaling)
+{
+	constexpr uint32_t numItems = 1 << 20;
+	std::vector<float> values(numItems, 1.0f);
+
+	double baseMs = 0.0;
+	for (const uint32_t numWorkers : GetWorkerCounts())
+	{
+		JobSystem jobs(numWorkers);
+		const double ms = Testing::MeasureMs(5, [&]()
+		{
+			jobs.ParallelFor(numItems, 4096, [&values](uint32_t InBegin, uint32_t InEnd)
+			{
+				for (uint32_t i = InBegin; i < InEnd; ++i)
+				{
+					values[i] = std::sqrt(values[i] * 1.0001f + std::sin(float(i)));
+				}
+			});
+		});
+		baseMs = numWorkers == 1 ? ms : baseMs;
+		std::cout << "  " << numWorkers << " workers: " << ms << " ms, speedup " << baseMs / ms << std::endl;
+	}
+}
+
+// Many tiny jobs, measures the scheduling overhead per job
+BENCHMARK(JobSystem_SmallJobOverhead)
+{
+	constexpr uint32_t numJobs = 200000;
+
+	for (const uint32_t numWorkers : GetWorkerCounts())
+	{
+		JobSystem jobs(numWorkers);
+		std::atomic<uint32_t> sum = 0;
+		const double ms = Testing::MeasureMs(3, [&]()
+		{
+			JobCounter counter;
+			for (uint32_t i = 0; i < numJobs; ++i)
+			{
+				jobs.Run([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+			}
+			jobs.Wait(counter);
+		});
+		std::cout << "  " << numWorkers << " workers: " << ms << " ms, " << ms * 1e6 / numJobs << " ns per job" << std::endl;
+	}
+}
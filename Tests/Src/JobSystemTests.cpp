@@ -0,0 +1,205 @@
+#include "TestFramework.h"
+
+#include "JobSystem.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_CASE(JobSystem_RunsEveryJobOnce)
+{
+	JobSystem jobs(4);
+
+	constexpr uint32_t numJobs = 100000;
+	std::vector<std::atomic<uint32_t>> runs(numJobs);
+
+	JobCounter counter;
+	for (uint32_t i = 0; i < numJobs; ++i)
+	{
+		jobs.Run([&runs, i]() { runs[i].fetch_add(1, std::memory_order_relaxed); }, &counter);
+	}
+	jobs.Wait(counter);
+
+	CHECK(counter.IsDone());
+	uint32_t numWrong = 0;
+	for (const std::atomic<uint32_t>& run : runs)
+	{
+		numWrong += run.load() == 1 ? 0 : 1;
+	}
+	CHECK_EQ(numWrong, 0u);
+}
+
+TEST_CASE(JobSystem_DependencyRunsAfterItsCounter)
+{
+	JobSystem jobs(4);
+
+	for (uint32_t round = 0; round < 200; ++round)
+	{
+		std::atomic<uint32_t> numFirst = 0;
+		std::atomic<uint32_t> numSeenTooEarly = 0;
+
+		JobCounter first;
+		JobCounter second;
+		for (uint32_t i = 0; i < 64; ++i)
+		{
+			jobs.Run([&numFirst]() { numFirst.fetch_add(1); }, &first);
+		}
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			jobs.Run([&numFirst, &numSeenTooEarly]() { numSeenTooEarly += numFirst.load() == 64 ? 0 : 1; }, &second, &first);
+		}
+		jobs.Wait(second);
+
+		CHECK_EQ(numSeenTooEarly.load(), 0u);
+		CHECK(first.IsDone());
+	}
+}
+
+TEST_CASE(JobSystem_NestedJobs)
+{
+	JobSystem jobs(4);
+
+	// Every job of the first level spawns more jobs from whatever worker runs it, and waits for them
+	std::atomic<uint32_t> numLeaves = 0;
+	JobCounter counter;
+	for (uint32_t i = 0; i < 256; ++i)
+	{
+		jobs.Run([&jobs, &numLeaves]()
+		{
+			JobCounter children;
+			for (uint32_t j = 0; j < 64; ++j)
+			{
+				jobs.Run([&numLeaves]() { numLeaves.fetch_add(1, std::memory_order_relaxed); }, &children);
+			}
+			jobs.Wait(children);
+		}, &counter);
+	}
+	jobs.Wait(counter);
+
+	CHECK_EQ(numLeaves.load(), 256u * 64u);
+}
+
+TEST_CASE(JobSystem_ParallelForCoversRangeOnce)
+{
+	JobSystem jobs(4);
+
+	const uint32_t counts[] = { 0, 1, 7, 64, 1000, 4097 };
+	const uint32_t batchSizes[] = { 0, 1, 3, 64, 5000 };
+	for (const uint32_t count : counts)
+	{
+		for (const uint32_t batchSize : batchSizes)
+		{
+			std::vector<std::atomic<uint32_t>> runs(count);
+			std::atomic<bool> bBadRange = false;
+			jobs.ParallelFor(count, batchSize, [&](uint32_t InBegin, uint32_t InEnd)
+			{
+				if (InBegin >= InEnd || InEnd > count)
+				{
+					bBadRange = true;
+					return;
+				}
+				for (uint32_t i = InBegin; i < InEnd; ++i)
+				{
+					runs[i].fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+
+			CHECK(!bBadRange.load());
+			uint32_t numWrong = 0;
+			for (const std::atomic<uint32_t>& run : runs)
+			{
+				numWrong += run.load() == 1 ? 0 : 1;
+			}
+			CHECK_EQ(numWrong, 0u);
+		}
+	}
+}
+
+TEST_CASE(JobSystem_ParallelForInsideJobs)
+{
+	JobSystem jobs(3);
+
+	std::atomic<uint64_t> sum = 0;
+	JobCounter counter;
+	for (uint32_t i = 0; i < 32; ++i)
+	{
+		jobs.Run([&jobs, &sum]()
+		{
+			jobs.ParallelFor(1000, 16, [&sum](uint32_t InBegin, uint32_t InEnd)
+			{
+				uint64_t local = 0;
+				for (uint32_t j = InBegin; j < InEnd; ++j)
+				{
+					local += j;
+				}
+				sum.fetch_add(local, std::memory_order_relaxed);
+			});
+		}, &counter);
+	}
+	jobs.Wait(counter);
+
+	CHECK_EQ(sum.load(), 32ull * (999ull * 1000ull / 2));
+}
+
+TEST_CASE(JobSystem_WorkerIndices)
+{
+	JobSystem jobs(4);
+	CHECK_EQ(jobs.GetNumWorkers(), 4u);
+	CHECK_EQ(jobs.GetCurrentWorkerIndex(), 0u);
+
+	std::atomic<uint32_t> numOutOfRange = 0;
+	JobCounter counter;
+	for (uint32_t i = 0; i < 10000; ++i)
+	{
+		jobs.Run([&jobs, &numOutOfRange]() { numOutOfRange += jobs.GetCurrentWorkerIndex() < 4 ? 0 : 1; }, &counter);
+	}
+	jobs.Wait(counter);
+
+	CHECK_EQ(numOutOfRange.load(), 0u);
+}
+
+TEST_CASE(JobSystem_NestedJobSystems)
+{
+	// Workers of the big system push to and wait on the small one, their indices don't exist there
+	JobSystem outer(8);
+	JobSystem inner(2);
+
+	std::atomic<uint32_t> numInnerJobs = 0;
+	std::atomic<uint32_t> numOutOfRange = 0;
+	JobCounter outerCounter;
+	for (uint32_t i = 0; i < 64; ++i)
+	{
+		outer.Run([&]()
+		{
+			numOutOfRange += inner.GetCurrentWorkerIndex() < inner.GetNumWorkers() ? 0 : 1;
+
+			JobCounter innerCounter;
+			for (uint32_t j = 0; j < 16; ++j)
+			{
+				inner.Run([&numInnerJobs]() { ++numInnerJobs; }, &innerCounter);
+			}
+			inner.Wait(innerCounter);
+		}, &outerCounter);
+	}
+	outer.Wait(outerCounter);
+
+	CHECK_EQ(numInnerJobs.load(), 64u * 16u);
+	CHECK_EQ(numOutOfRange.load(), 0u);
+}
+
+TEST_CASE(JobSystem_CreateAndDestroy)
+{
+	// Workers going to sleep and shutting down right away must not hang
+	for (uint32_t i = 0; i < 200; ++i)
+	{
+		JobSystem jobs(1 + i % 4);
+		if (i % 2 == 0)
+		{
+			JobCounter counter;
+			jobs.Run([]() {}, &counter);
+			jobs.Wait(counter);
+		}
+	}
+	CHECK(true);
+}
@@ -0,0 +1,241 @@
+#include "TestFramework.h"
+
+#include "LevelConverter.h"
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Native layout like the scene components: three floats and the name inline
+	auto ConvertFakeJsonToBinary(const json& in, BinaryWriter& out) -> void
+	{
+		const json& position = in.at("position");
+		out.Write(position.at(0).get<float>());
+		out.Write(position.at(1).get<float>());
+		out.Write(position.at(2).get<float>());
+		out.WriteString(in.at("name").get<std::string>());
+	}
+
+	auto ConvertFakeBinaryToJson(BinaryReader& in) -> json
+	{
+		json out = json::object();
+		const float x = in.Read<float>();
+		const float y = in.Read<float>();
+		const float z = in.Read<float>();
+		out["position"] = { x, y, z };
+		out["name"] = std::string(in.ReadString());
+		return out;
+	}
+
+	auto MakeConverters() -> LevelConverter::ComponentConverters
+	{
+		LevelConverter::ComponentConverters converters;
+		converters["FakeScene"] = { &ConvertFakeJsonToBinary, &ConvertFakeBinaryToJson };
+		return converters;
+	}
+
+	constexpr const char* ActorId = "00112233-4455-6677-8899-aabbccddeeff";
+	constexpr const char* RootId = "10000000-0000-4000-8000-000000000001";
+	constexpr const char* ChildId = "10000000-0000-4000-8000-000000000002";
+
+	auto MakeComponent(const char* InName, const char* InId, json InData) -> json
+	{
+		json wrapper = json::object();
+		wrapper["name"] = InName;
+		wrapper["id"] = InId;
+		wrapper["data"] = std::move(InData);
+		return wrapper;
+	}
+
+	// Two actors, one of them scripted, a converted component, a json fallback one attached to it and a directional light
+	auto MakeLevel() -> json
+	{
+		json root = MakeComponent("FakeScene", RootId, { { "position", { 1.5, -2.0, 0.25 } }, { "name", "Root" } });
+		json child = MakeComponent("Unconverted", ChildId, { { "volume", 0.5 }, { "tags", { "a", "b" } } });
+		child["parent"] = RootId;
+
+		json scripted = json::object();
+		scripted["id"] = ActorId;
+		scripted["name"] = "Scripted";
+		scripted["mono"] = { { "namespace", "Game" }, { "class", "Player" } };
+		scripted["components"] = json::array({ root, child });
+
+		json empty = json::object();
+		empty["id"] = "20000000-0000-4000-8000-000000000000";
+		empty["name"] = "Empty";
+		empty["components"] = json::array();
+
+		json level = json::object();
+		level["actors"] = json::array({ scripted, empty });
+		level["dirlight"] = { { "Intensity", 2.0 } };
+		return level;
+	}
+
+	auto AppendBytes(std::vector<uint8_t>& Out, const void* InData, size_t InSize) -> void
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(InData);
+		Out.insert(Out.end(), bytes, bytes + InSize);
+	}
+
+	template<class T>
+	auto Append(std::vector<uint8_t>& Out, const T& InValue) -> void
+	{
+		AppendBytes(Out, &InValue, sizeof(T));
+	}
+
+	auto AppendString(std::vector<uint8_t>& Out, const std::string& InString) -> void
+	{
+		Append(Out, static_cast<uint32_t>(InString.size()));
+		AppendBytes(Out, InString.data(), InString.size());
+	}
+
+	auto AppendUuid(std::vector<uint8_t>& Out, const char* InId) -> void
+	{
+		AppendBytes(Out, uuid::from_string(InId).value().as_bytes().data(), 16);
+	}
+}
+
+TEST_CASE(LevelConverter_JsonBinaryJsonRoundTrip)
+{
+	const LevelConverter::ComponentConverters converters = MakeConverters();
+	const json level = MakeLevel();
+
+	std::vector<uint8_t> data;
+	REQUIRE(LevelConverter::JsonToBinary(level, converters, data));
+
+	json converted;
+	REQUIRE(LevelConverter::BinaryToJson(data.data(), data.size(), converters, converted));
+	CHECK(converted == level);
+
+	// And back gives the same bytes
+	std::vector<uint8_t> again;
+	REQUIRE(LevelConverter::JsonToBinary(converted, converters, again));
+	CHECK(again == data);
+}
+
+TEST_CASE(LevelConverter_ComponentsWithoutConverterKeepTheirJson)
+{
+	std::vector<uint8_t> data;
+	REQUIRE(LevelConverter::JsonToBinary(MakeLevel(), {}, data));
+
+	json converted;
+	REQUIRE(LevelConverter::BinaryToJson(data.data(), data.size(), {}, converted));
+	CHECK(converted == MakeLevel());
+
+	// Reading with a converter the data wasn't written with doesn't pass as a level
+	CHECK(!LevelConverter::BinaryToJson(data.data(), data.size(), MakeConverters(), converted));
+}
+
+// The bytes of a small level spelled out, a change to the file layout has to bump BinaryLevelVersion
+TEST_CASE(LevelConverter_BinaryLayoutIsStable)
+{
+	json level = json::object();
+	json actor = json::object();
+	actor["id"] = ActorId;
+	actor["name"] = "A";
+	actor["components"] = json::array({ MakeComponent("FakeScene", RootId, { { "position", { 1.0, 2.0, 3.0 } }, { "name", "Root" } }) });
+	level["actors"] = json::array({ actor });
+
+	std::vector<uint8_t> data;
+	REQUIRE(LevelConverter::JsonToBinary(level, MakeConverters(), data));
+
+	std::vector<uint8_t> expected;
+	AppendBytes(expected, "NLVL", 4);
+	Append<uint32_t>(expected, 1);
+	Append<uint64_t>(expected, 0);
+	Append<uint32_t>(expected, 1);
+	Append<uint32_t>(expected, 0);
+	CHECK_EQ(expected.size(), sizeof(BinaryLevelHeader));
+
+	Append<uint32_t>(expected, 1);
+	Append<uint32_t>(expected, 1);
+	AppendUuid(expected, ActorId);
+	AppendString(expected, "A");
+	Append<uint8_t>(expected, 0);
+	Append<uint32_t>(expected, 1);
+
+	Append<uint32_t>(expected, 0);
+	AppendUuid(expected, RootId);
+	Append<uint8_t>(expected, 0);
+	Append<uint32_t>(expected, 3 * sizeof(float) + sizeof(uint32_t) + 4);
+	Append(expected, 1.0f);
+	Append(expected, 2.0f);
+	Append(expected, 3.0f);
+	AppendString(expected, "Root");
+	Append<uint8_t>(expected, 0);
+
+	const uint64_t stringTableOffset = expected.size();
+	std::memcpy(expected.data() + offsetof(BinaryLevelHeader, StringTableOffset), &stringTableOffset, sizeof(stringTableOffset));
+	AppendString(expected, "FakeScene");
+
+	CHECK_EQ(data.size(), expected.size());
+	CHECK(data == expected);
+}
+
+TEST_CASE(LevelConverter_MalformedJsonIsRejected)
+{
+	const LevelConverter::ComponentConverters converters = MakeConverters();
+	std::vector<uint8_t> data;
+
+	CHECK(!LevelConverter::JsonToBinary(json::array(), converters, data));
+	CHECK(!LevelConverter::JsonToBinary(json::object(), converters, data));
+	CHECK(!LevelConverter::JsonToBinary({ { "actors", "none" } }, converters, data));
+
+	// Every edit breaks one field the conversion relies on
+	const std::vector<void (*)(json&)> breakages = {
+		[](json& level) { level["actors"][0] = 5; },
+		[](json& level) { level["actors"][0].erase("components"); },
+		[](json& level) { level["actors"][0]["components"] = json::object(); },
+		[](json& level) { level["actors"][0].erase("id"); },
+		[](json& level) { level["actors"][0]["id"] = "not a uuid"; },
+		[](json& level) { level["actors"][0]["name"] = 3; },
+		[](json& level) { level["actors"][0]["mono"] = "Game.Player"; },
+		[](json& level) { level["actors"][0]["mono"].erase("class"); },
+		[](json& level) { level["actors"][0]["components"][0] = json::array(); },
+		[](json& level) { level["actors"][0]["components"][0].erase("data"); },
+		[](json& level) { level["actors"][0]["components"][0]["id"] = 12; },
+		[](json& level) { level["actors"][0]["components"][0]["name"] = json(); },
+		[](json& level) { level["actors"][0]["components"][1]["parent"] = "0000"; },
+		// Caught from the component converter
+		[](json& level) { level["actors"][0]["components"][0]["data"].erase("position"); },
+		[](json& level) { level["actors"][0]["components"][0]["data"]["position"] = { "x", "y", "z" }; },
+	};
+
+	for (size_t i = 0; i < breakages.size(); ++i)
+	{
+		json level = MakeLevel();
+		breakages[i](level);
+		data.clear();
+		const bool bConverted = LevelConverter::JsonToBinary(level, converters, data);
+		CHECK(!bConverted && data.empty());
+		if (bConverted)
+		{
+			std::cerr << "  breakage " << i << " was converted" << std::endl;
+		}
+	}
+}
+
+TEST_CASE(LevelConverter_TruncatedBinaryIsRejected)
+{
+	const LevelConverter::ComponentConverters converters = MakeConverters();
+	std::vector<uint8_t> data;
+	REQUIRE(LevelConverter::JsonToBinary(MakeLevel(), converters, data));
+
+	BinaryLevelHeader header;
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	// Cutting into the string table or the level data, the header then points past the end or the data runs short
+	for (size_t size = 0; size < data.size(); ++size)
+	{
+		json level;
+		CHECK(!LevelConverter::BinaryToJson(data.data(), size, converters, level));
+	}
+
+	std::vector<uint8_t> wrongVersion = data;
+	wrongVersion[4] = 2;
+	json level;
+	CHECK(!LevelConverter::BinaryToJson(wrongVersion.data(), wrongVersion.size(), converters, level));
+}
@@ -0,0 +1,262 @@
+#include "TestFramework.h"
+
+#include "HandleRegistry.h"
+#include "JsonInclude.h"
+#include "LevelJsonLoader.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// The headless part of Game::Deserialize and Actor::Deserialize: the level json walk and the uuid lookups of
+// actors and components, through the same LevelJsonLoader. Creating the real actors needs the D3D device, Mono
+// and the asset manager, fake ones stand in for them and only read the fields the real components read.
+namespace
+{
+	struct FakeComponent
+	{
+		uuid Id;
+		std::string Type;
+		std::string Name;
+		float Position[3] = {};
+		float Rotation[4] = {};
+		std::string MeshPath;
+		std::string TexturePath;
+		float Mass = 0.0f;
+		FakeComponent* Parent = nullptr;
+	};
+
+	struct FakeActor
+	{
+		uuid Id;
+		std::string Name;
+		std::vector<FakeComponent*> Components;
+	};
+
+	struct FakeLevel
+	{
+		std::vector<std::unique_ptr<FakeActor>> Actors;
+		std::vector<std::unique_ptr<FakeComponent>> Components;
+		HandleRegistry<FakeActor> ActorHandles;
+		HandleRegistry<FakeComponent> ComponentHandles;
+	};
+
+	auto ToUuid(const json& InValue) -> uuid
+	{
+		return LevelJsonLoader::ToUuid(InValue);
+	}
+
+	// What SceneComponent::Serialize writes, the other components add their fields to it
+	auto MakeSceneData(const std::string& InName, float InX) -> json
+	{
+		return {
+			{ "transform", { { "pos", { InX, 0.0f, 1.0f } }, { "rot", { 0.0f, 0.0f, 0.0f, 1.0f } }, { "scale", { 1.0f, 1.0f, 1.0f } } } },
+			{ "name", InName }
+		};
+	}
+
+	// A scene component root with a static mesh renderer and a rigid body attached, in the schema
+	// Actor::Serialize and the component Serialize functions write
+	auto MakeLevelText(uint32_t InNumActors) -> std::string
+	{
+		std::mt19937 random(3);
+		uuids::uuid_random_generator generator(random);
+
+		json actors = json::array();
+		for (uint32_t i = 0; i < InNumActors; ++i)
+		{
+			const std::string sceneId = uuids::to_string(generator());
+
+			json components = json::array();
+			components.push_back({ { "name", "SceneComponent" }, { "id", sceneId }, { "data", MakeSceneData("Root", float(i)) } });
+
+			json mesh = MakeSceneData("Mesh", 0.0f);
+			mesh["mesh_path"] = "Meshes/box.fbx";
+			mesh["texture_path"] = "Textures/box_albedo.dds";
+			mesh["normal_path"] = "";
+			mesh["mat_ambient"] = 0.1f;
+			mesh["mat_diffuse"] = 0.9f;
+			mesh["mat_specular"] = 0.5f;
+			mesh["mat_specular_exp"] = 32.0f;
+			components.push_back({ { "name", "StaticMeshRenderer" }, { "id", uuids::to_string(generator()) }, { "parent", sceneId }, { "data", mesh } });
+
+			json body = MakeSceneData("Body", 0.0f);
+			body["mass"] = 1.0f;
+			body["type"] = 1;
+			body["physics_simulation"] = true;
+			body["need_physics"] = true;
+			body["usage"] = 2;
+			body["shape_type"] = 0;
+			components.push_back({ { "name", "RigidBodyCubeComponent" }, { "id", uuids::to_string(generator()) }, { "parent", sceneId }, { "data", body } });
+
+			actors.push_back({ { "id", uuids::to_string(generator()) }, { "components", components }, { "name", "Actor" + std::to_string(i) } });
+		}
+
+		return json{ { "actors", actors } }.dump();
+	}
+
+	// The fields SceneComponent, StaticMeshRenderer and RigidBodyComponent::Deserialize read
+	auto FillComponent(FakeComponent& InComponent, const json& InData) -> void
+	{
+		const json& transform = InData.at("transform");
+		const json& position = transform.at("pos");
+		const json& rotation = transform.at("rot");
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			InComponent.Position[axis] = position[axis].get<float>();
+		}
+		for (int axis = 0; axis < 4; ++axis)
+		{
+			InComponent.Rotation[axis] = rotation[axis].get<float>();
+		}
+		InComponent.Name = InData.at("name").get<std::string>();
+
+		if (const auto meshPath = InData.find("mesh_path"); meshPath != InData.end())
+		{
+			InComponent.MeshPath = meshPath->get<std::string>();
+			InComponent.TexturePath = InData.at("texture_path").get<std::string>();
+		}
+		if (const auto mass = InData.find("mass"); mass != InData.end())
+		{
+			InComponent.Mass = mass->get<float>();
+		}
+	}
+
+	// Actor::Deserialize: components through LevelJsonLoader, parents bound once all of them exist
+	auto DeserializeActor(FakeActor& InActor, FakeLevel& InLevel, const json& InActorObj) -> void
+	{
+		const json& componentArr = InActorObj.at("components");
+		InActor.Components.reserve(InActor.Components.size() + componentArr.size());
+
+		std::vector<std::pair<FakeComponent*, uuid>> shouldBeBound;
+		LevelJsonLoader::LoadComponents(componentArr,
+			[&InLevel](const uuid& InId) { return InLevel.ComponentHandles.FindObjectById(InId); },
+			[](FakeComponent* InComponent, const json& InData) { FillComponent(*InComponent, InData); },
+			[&](const std::string& InName, const uuid& InId, const json& InData, const uuid* InParentId)
+			{
+				InLevel.Components.push_back(std::make_unique<FakeComponent>());
+				FakeComponent* component = InLevel.Components.back().get();
+				component->Id = InId;
+				component->Type = InName;
+				FillComponent(*component, InData);
+				InLevel.ComponentHandles.Add(component, InId);
+				InActor.Components.push_back(component);
+				if (InParentId != nullptr)
+				{
+					shouldBeBound.emplace_back(component, *InParentId);
+				}
+			});
+
+		for (const auto& [child, parentId] : shouldBeBound)
+		{
+			child->Parent = InLevel.ComponentHandles.FindObjectById(parentId);
+		}
+
+		InActor.Name = InActorObj.at("name").get<std::string>();
+	}
+
+	// Game::Deserialize: reserve for the whole level, then the actors through LevelJsonLoader
+	auto DeserializeLevel(FakeLevel& InLevel, const json& InLevelJson) -> void
+	{
+		const json& actorsArr = InLevelJson.at("actors");
+
+		const size_t numComponents = LevelJsonLoader::CountComponents(actorsArr);
+		InLevel.Actors.reserve(InLevel.Actors.size() + actorsArr.size());
+		InLevel.Components.reserve(InLevel.Components.size() + numComponents);
+		InLevel.ActorHandles.Reserve(InLevel.ActorHandles.GetNum() + actorsArr.size());
+		InLevel.ComponentHandles.Reserve(InLevel.ComponentHandles.GetNum() + numComponents);
+
+		LevelJsonLoader::LoadActors(actorsArr,
+			[&InLevel](const uuid& InId) { return InLevel.ActorHandles.FindObjectById(InId); },
+			[&InLevel](const uuid& InId)
+			{
+				InLevel.Actors.push_back(std::make_unique<FakeActor>());
+				FakeActor* actor = InLevel.Actors.back().get();
+				actor->Id = InId;
+				InLevel.ActorHandles.Add(actor, InId);
+				return actor;
+			},
+			[&InLevel](FakeActor* InActor, const json& InActorObj) { DeserializeActor(*InActor, InLevel, InActorObj); });
+	}
+
+	// The load before it was made linear: json copied per actor and component, existing actors searched linearly
+	auto DeserializeLevelLinearSearch(FakeLevel& InLevel, const json& InLevelJson) -> void
+	{
+		const json& actorsArr = InLevelJson.at("actors");
+		for (size_t i = 0; i < actorsArr.size(); ++i)
+		{
+			const json actorObj = actorsArr[i];
+			const uuid id = ToUuid(actorObj.at("id"));
+
+			FakeActor* actor = nullptr;
+			for (const std::unique_ptr<FakeActor>& existing : InLevel.Actors)
+			{
+				if (existing->Id == id)
+				{
+					actor = existing.get();
+					break;
+				}
+			}
+			if (actor == nullptr)
+			{
+				InLevel.Actors.push_back(std::make_unique<FakeActor>());
+				actor = InLevel.Actors.back().get();
+				actor->Id = id;
+				InLevel.ActorHandles.Add(actor, id);
+			}
+
+			const json componentArr = actorObj.at("components");
+			for (size_t j = 0; j < componentArr.size(); ++j)
+			{
+				const json wrapper = componentArr[j];
+				const uuid componentId = ToUuid(wrapper.at("id"));
+				FakeComponent* component = InLevel.ComponentHandles.FindObjectById(componentId);
+				if (component == nullptr)
+				{
+					InLevel.Components.push_back(std::make_unique<FakeComponent>());
+					component = InLevel.Components.back().get();
+					component->Id = componentId;
+					component->Type = wrapper.at("name").get<std::string>();
+					InLevel.ComponentHandles.Add(component, componentId);
+					actor->Components.push_back(component);
+				}
+				FillComponent(*component, wrapper.at("data"));
+			}
+
+			actor->Name = actorObj.at("name").get<std::string>();
+		}
+	}
+}
+
+// Fresh load and reload (every actor found again) of levels of 10k, 50k and 100k actors, three components each
+BENCHMARK(LevelLoad_Scaling)
+{
+	for (const uint32_t numActors : { 10000u, 50000u, 100000u })
+	{
+		const std::string text = MakeLevelText(numActors);
+
+		json levelJson;
+		const double parseMs = Testing::MeasureMs(1, [&]() { levelJson = json::parse(text); });
+
+		FakeLevel level;
+		const double loadMs = Testing::MeasureMs(1, [&]() { DeserializeLevel(level, levelJson); });
+		const double reloadMs = Testing::MeasureMs(1, [&]() { DeserializeLevel(level, levelJson); });
+		CHECK_EQ(level.Actors.size(), size_t(numActors));
+		CHECK_EQ(level.ComponentHandles.GetNum(), size_t(numActors) * 3);
+		CHECK(level.Components[1]->Parent == level.Components[0].get());
+		CHECK_EQ(level.Components[1]->MeshPath, std::string("Meshes/box.fbx"));
+
+		std::cout << "  " << numActors << " actors (" << text.size() / (1024 * 1024) << " MB): parse " << parseMs << " ms, load "
+			<< loadMs << " ms, reload " << reloadMs << " ms, " << 1000.0 * (parseMs + loadMs) / numActors << " us per actor" << std::endl;
+
+		// Quadratic, only run at the smallest size
+		if (numActors == 10000)
+		{
+			FakeLevel linearLevel;
+			DeserializeLevelLinearSearch(linearLevel, levelJson);
+			const double linearReloadMs = Testing::MeasureMs(1, [&]() { DeserializeLevelLinearSearch(linearLevel, levelJson); });
+			std::cout << "    reload with copies and linear actor search: " << linearReloadMs << " ms" << std::endl;
+		}
+	}
+}
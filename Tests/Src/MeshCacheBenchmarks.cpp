@@ -0,0 +1,64 @@
+#include "TestFramework.h"
+
+#include "MeshCache.h"
+
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+	auto FindMeshSources(const Path& InDirectory) -> std::vector<Path>
+	{
+		std::vector<Path> sources;
+		std::error_code error;
+		for (auto it = std::filesystem::recursive_directory_iterator(InDirectory, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+		{
+			const Path extension = it->path().extension();
+			if (extension == ".fbx" || extension == ".obj")
+			{
+				sources.push_back(it->path());
+			}
+		}
+		return sources;
+	}
+}
+
+// Every mesh collection under Assets, first cooked into an empty cache and then mapped from it.
+// Cold is the Assimp import, optimization, LODs and meshlets, warm is what every later load pays.
+BENCHMARK(MeshCache_ColdAndWarmLoad)
+{
+	const std::vector<Path> sources = FindMeshSources(Path(ENGINE_ASSETS_DIR));
+	const Path cacheDirectory = std::filesystem::temp_directory_path() / "MeshCacheBenchmark";
+
+	for (const Path& source : sources)
+	{
+		std::filesystem::remove_all(cacheDirectory);
+		MeshCache cache(cacheDirectory);
+
+		CookedMeshCollection cold;
+		const double coldMs = Testing::MeasureMs(1, [&]() { cache.Open(source, cold); });
+
+		// Every mesh of the collection is looked up, as the loaders do
+		const double warmMs = Testing::MeasureMs(20, [&]()
+		{
+			CookedMeshCollection warm;
+			cache.Open(source, warm);
+			for (const std::string_view name : warm.GetMeshNames())
+			{
+				CookedMeshView view;
+				warm.FindMesh(name, view);
+			}
+		});
+
+		std::cout << "  " << source.filename().string() << ": cold " << coldMs << " ms, warm " << warmMs << " ms, "
+			<< cold.GetSize() / 1024 << " KB cooked" << std::endl;
+
+		const MeshCache::Stats stats = cache.GetStats();
+		std::cout << "    " << stats.NumCooked << " cooked in " << stats.CookMs << " ms, " << stats.NumHits << " hits mapped in "
+			<< stats.MapMs << " ms" << std::endl;
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(cacheDirectory, error);
+}
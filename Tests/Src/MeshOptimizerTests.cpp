@@ -0,0 +1,198 @@
+#include "TestFramework.h"
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct TestVertex
+	{
+		float Position[3];
+		float Uv[2];
+	};
+
+	struct TestMesh
+	{
+		std::vector<TestVertex> Vertices;
+		std::vector<uint32_t> Indices;
+	};
+
+	// InSize x InSize quads on a shared (InSize + 1)^2 vertex grid, two triangles each
+	auto MakeGrid(uint32_t InSize) -> TestMesh
+	{
+		TestMesh mesh;
+		for (uint32_t y = 0; y <= InSize; ++y)
+		{
+			for (uint32_t x = 0; x <= InSize; ++x)
+			{
+				mesh.Vertices.push_back({ { float(x), float(y), 0.0f }, { float(x) / InSize, float(y) / InSize } });
+			}
+		}
+
+		for (uint32_t y = 0; y < InSize; ++y)
+		{
+			for (uint32_t x = 0; x < InSize; ++x)
+			{
+				const uint32_t v = y * (InSize + 1) + x;
+				mesh.Indices.insert(mesh.Indices.end(), { v, v + 1, v + InSize + 1, v + 1, v + InSize + 2, v + InSize + 1 });
+			}
+		}
+		return mesh;
+	}
+
+	// Triangles in random order, the worst case a cache optimizer gets from an importer
+	auto ShuffleTriangles(std::vector<uint32_t>& InOutIndices, uint32_t InSeed) -> void
+	{
+		std::vector<std::array<uint32_t, 3>> triangles(InOutIndices.size() / 3);
+		std::memcpy(triangles.data(), InOutIndices.data(), InOutIndices.size() * sizeof(uint32_t));
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(InSeed));
+		std::memcpy(InOutIndices.data(), triangles.data(), InOutIndices.size() * sizeof(uint32_t));
+	}
+
+	// Triangles rotated to start at their smallest index and sorted, the winding is kept
+	auto GetSortedTriangles(const std::vector<uint32_t>& InIndices) -> std::vector<std::array<uint32_t, 3>>
+	{
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (size_t i = 0; i < InIndices.size(); i += 3)
+		{
+			std::array<uint32_t, 3> triangle = { InIndices[i], InIndices[i + 1], InIndices[i + 2] };
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+}
+
+TEST_CASE(MeshOptimizer_WeldMergesBitwiseIdenticalVertices)
+{
+	// Every quad with its own four corners, as an importer splitting by face would give
+	const TestMesh grid = MakeGrid(4);
+	std::vector<TestVertex> vertices;
+	for (const uint32_t index : grid.Indices)
+	{
+		vertices.push_back(grid.Vertices[index]);
+	}
+	// Equal as floats but not bitwise, stays a vertex of its own
+	TestVertex negativeZero = grid.Vertices[0];
+	negativeZero.Position[2] = -0.0f;
+	vertices.push_back(negativeZero);
+
+	std::vector<uint32_t> remap;
+	const uint32_t numUnique = MeshOptimizer::GenerateWeldRemap(vertices.data(), static_cast<uint32_t>(vertices.size()), sizeof(TestVertex), remap);
+	CHECK_EQ(numUnique, grid.Vertices.size() + 1);
+	REQUIRE(remap.size() == vertices.size());
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		CHECK(remap[i] < numUnique);
+		for (size_t j = 0; j < i; ++j)
+		{
+			const bool bIdentical = std::memcmp(&vertices[i], &vertices[j], sizeof(TestVertex)) == 0;
+			CHECK_EQ(remap[i] == remap[j], bIdentical);
+		}
+	}
+
+	// The welded vertices are the unique ones, every index still points at the same data
+	std::vector<uint32_t> indices(vertices.size());
+	for (uint32_t i = 0; i < indices.size(); ++i)
+	{
+		indices[i] = i;
+	}
+	std::vector<TestVertex> welded = vertices;
+	MeshOptimizer::RemapIndices(indices, remap);
+	MeshOptimizer::RemapVertices(welded, remap, numUnique);
+	CHECK_EQ(welded.size(), numUnique);
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		CHECK(std::memcmp(&welded[indices[i]], &vertices[i], sizeof(TestVertex)) == 0);
+	}
+}
+
+TEST_CASE(MeshOptimizer_VertexCacheOrderIsTrianglePermutation)
+{
+	TestMesh grid = MakeGrid(32);
+	ShuffleTriangles(grid.Indices, 1);
+	const std::vector<uint32_t> original = grid.Indices;
+
+	MeshOptimizer::OptimizeVertexCache(grid.Indices, static_cast<uint32_t>(grid.Vertices.size()));
+
+	CHECK_EQ(grid.Indices.size(), original.size());
+	CHECK(GetSortedTriangles(grid.Indices) == GetSortedTriangles(original));
+}
+
+TEST_CASE(MeshOptimizer_CacheStatsImproveOnShuffledGrid)
+{
+	TestMesh grid = MakeGrid(64);
+	ShuffleTriangles(grid.Indices, 2);
+	const uint32_t numVertices = static_cast<uint32_t>(grid.Vertices.size());
+
+	const VertexCacheStats before = MeshOptimizer::AnalyzeVertexCache(grid.Indices, numVertices);
+	MeshOptimizer::OptimizeVertexCache(grid.Indices, numVertices);
+	const VertexCacheStats after = MeshOptimizer::AnalyzeVertexCache(grid.Indices, numVertices);
+
+	CHECK_EQ(before.NumTriangles, after.NumTriangles);
+	CHECK_EQ(after.NumVertices, numVertices);
+	// Random order misses on almost every vertex, a cache friendly one gets close to one vertex per triangle or better
+	CHECK(before.GetAcmr() > 2.0f);
+	CHECK(after.GetAcmr() < 1.0f);
+	CHECK(after.GetAtvr() < before.GetAtvr() * 0.5f);
+	CHECK(after.GetAtvr() >= 1.0f);
+}
+
+TEST_CASE(MeshOptimizer_FetchRemapNumbersVerticesInFirstUseOrder)
+{
+	TestMesh grid = MakeGrid(16);
+	ShuffleTriangles(grid.Indices, 3);
+	// Vertices the index buffer never uses
+	const uint32_t numUsed = static_cast<uint32_t>(grid.Vertices.size());
+	grid.Vertices.resize(numUsed + 5, grid.Vertices[0]);
+	const std::vector<uint32_t> original = grid.Indices;
+
+	std::vector<uint32_t> remap;
+	const uint32_t numReferenced = MeshOptimizer::GenerateFetchRemap(grid.Indices, static_cast<uint32_t>(grid.Vertices.size()), remap);
+	CHECK_EQ(numReferenced, numUsed);
+
+	// Every index is one already seen or the next new one
+	uint32_t nextNew = 0;
+	for (size_t i = 0; i < grid.Indices.size(); ++i)
+	{
+		CHECK(grid.Indices[i] <= nextNew);
+		nextNew = (std::max)(nextNew, grid.Indices[i] + 1);
+		CHECK_EQ(grid.Indices[i], remap[original[i]]);
+	}
+	CHECK_EQ(nextNew, numReferenced);
+
+	for (uint32_t v = numUsed; v < remap.size(); ++v)
+	{
+		CHECK_EQ(remap[v], MeshOptimizer::InvalidVertexIndex);
+	}
+
+	MeshOptimizer::RemapVertices(grid.Vertices, remap, numReferenced);
+	CHECK_EQ(grid.Vertices.size(), numReferenced);
+}
+
+TEST_CASE(MeshOptimizer_LargeMeshesStayOn32BitIndices)
+{
+	CHECK(MeshOptimizer::FitsIn16BitIndices(0xFFFE));
+	CHECK(!MeshOptimizer::FitsIn16BitIndices(0xFFFF));
+
+	// 256 x 256 vertices, one more than 16 bit indices without the strip cut value can address
+	TestMesh grid = MakeGrid(255);
+	REQUIRE(grid.Vertices.size() == 65536u);
+	ShuffleTriangles(grid.Indices, 4);
+
+	const MeshOptimizationStats stats = MeshOptimizer::OptimizeMesh(grid.Vertices, grid.Indices);
+	CHECK_EQ(stats.NumVerticesBefore, 65536u);
+	CHECK_EQ(stats.NumVerticesAfter, 65536u);
+	CHECK(!MeshOptimizer::FitsIn16BitIndices(stats.NumVerticesAfter));
+	CHECK(stats.CacheAfter.GetAcmr() < stats.CacheBefore.GetAcmr());
+
+	// Nothing was narrowed on the way, the highest vertex is still addressed
+	CHECK_EQ(*std::max_element(grid.Indices.begin(), grid.Indices.end()), 65535u);
+}
@@ -0,0 +1,201 @@
+#include "TestFramework.h"
+
+#include "MeshSimplifier.h"
+
+#include <cmath>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct TestMesh
+	{
+		std::vector<float> Positions;
+		std::vector<uint32_t> Indices;
+
+		auto GetNumVertices() const -> uint32_t { return static_cast<uint32_t>(Positions.size() / 3); }
+	};
+
+	// Unit icosphere, every subdivision quadruples the 20 triangles
+	auto MakeIcosphere(int InSubdivisions) -> TestMesh
+	{
+		const float t = (1.0f + std::sqrt(5.0f)) / 2.0f;
+		TestMesh mesh;
+		mesh.Positions = { -1, t, 0, 1, t, 0, -1, -t, 0, 1, -t, 0, 0, -1, t, 0, 1, t, 0, -1, -t, 0, 1, -t, t, 0, -1, t, 0, 1, -t, 0, -1, -t, 0, 1 };
+		mesh.Indices = { 0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+			3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9, 4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1 };
+
+		auto Normalize = [&](uint32_t InVertex)
+		{
+			float* p = &mesh.Positions[InVertex * 3];
+			const float length = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+			p[0] /= length;
+			p[1] /= length;
+			p[2] /= length;
+		};
+		for (uint32_t v = 0; v < mesh.GetNumVertices(); ++v)
+		{
+			Normalize(v);
+		}
+
+		for (int level = 0; level < InSubdivisions; ++level)
+		{
+			std::map<std::pair<uint32_t, uint32_t>, uint32_t> midpoints;
+			auto Midpoint = [&](uint32_t InA, uint32_t InB) -> uint32_t
+			{
+				const auto key = std::make_pair((std::min)(InA, InB), (std::max)(InA, InB));
+				const auto found = midpoints.find(key);
+				if (found != midpoints.end())
+				{
+					return found->second;
+				}
+				const uint32_t vertex = mesh.GetNumVertices();
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					mesh.Positions.push_back((mesh.Positions[InA * 3 + axis] + mesh.Positions[InB * 3 + axis]) * 0.5f);
+				}
+				Normalize(vertex);
+				midpoints.emplace(key, vertex);
+				return vertex;
+			};
+
+			std::vector<uint32_t> indices;
+			for (size_t i = 0; i < mesh.Indices.size(); i += 3)
+			{
+				const uint32_t a = mesh.Indices[i];
+				const uint32_t b = mesh.Indices[i + 1];
+				const uint32_t c = mesh.Indices[i + 2];
+				const uint32_t ab = Midpoint(a, b);
+				const uint32_t bc = Midpoint(b, c);
+				const uint32_t ca = Midpoint(c, a);
+				indices.insert(indices.end(), { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca });
+			}
+			mesh.Indices = std::move(indices);
+		}
+		return mesh;
+	}
+
+	// InSize x InSize quads in the XZ plane, open on all four sides
+	auto MakeGrid(uint32_t InSize) -> TestMesh
+	{
+		TestMesh mesh;
+		for (uint32_t z = 0; z <= InSize; ++z)
+		{
+			for (uint32_t x = 0; x <= InSize; ++x)
+			{
+				mesh.Positions.insert(mesh.Positions.end(), { float(x), 0.0f, float(z) });
+			}
+		}
+		for (uint32_t z = 0; z < InSize; ++z)
+		{
+			for (uint32_t x = 0; x < InSize; ++x)
+			{
+				const uint32_t v = z * (InSize + 1) + x;
+				mesh.Indices.insert(mesh.Indices.end(), { v, v + InSize + 1, v + 1, v + 1, v + InSize + 1, v + InSize + 2 });
+			}
+		}
+		return mesh;
+	}
+
+	auto Simplify(const TestMesh& InMesh, size_t InTargetIndexCount, float InTargetError, float* OutError = nullptr) -> std::vector<uint32_t>
+	{
+		return MeshSimplifier::Simplify(InMesh.Positions.data(), sizeof(float) * 3, InMesh.GetNumVertices(), InMesh.Indices,
+			InTargetIndexCount, InTargetError, OutError);
+	}
+
+	// Largest distance from the unit sphere of the centroids of the triangles
+	auto GetSphereDeviation(const TestMesh& InMesh, const std::vector<uint32_t>& InIndices) -> float
+	{
+		float deviation = 0.0f;
+		for (size_t i = 0; i < InIndices.size(); i += 3)
+		{
+			float centroid[3] = {};
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					centroid[axis] += InMesh.Positions[InIndices[i + corner] * 3 + axis] / 3.0f;
+				}
+			}
+			const float length = std::sqrt(centroid[0] * centroid[0] + centroid[1] * centroid[1] + centroid[2] * centroid[2]);
+			deviation = (std::max)(deviation, 1.0f - length);
+		}
+		return deviation;
+	}
+}
+
+TEST_CASE(MeshSimplifier_MeetsTriangleBudget)
+{
+	const TestMesh sphere = MakeIcosphere(5);
+	REQUIRE(sphere.Indices.size() == 20480 * 3);
+
+	for (const size_t targetTriangles : { 10240, 2560, 640 })
+	{
+		const std::vector<uint32_t> indices = Simplify(sphere, targetTriangles * 3, 1.0f);
+		CHECK(indices.size() <= targetTriangles * 3);
+		// A closed mesh without locked vertices reaches the budget, not far below it
+		CHECK(indices.size() >= targetTriangles * 3 * 9 / 10);
+		CHECK_EQ(indices.size() % 3, size_t(0));
+	}
+}
+
+TEST_CASE(MeshSimplifier_ErrorBoundsDeviation)
+{
+	const TestMesh sphere = MakeIcosphere(4);
+	const float originalDeviation = GetSphereDeviation(sphere, sphere.Indices);
+
+	float error = 0.0f;
+	const std::vector<uint32_t> indices = Simplify(sphere, sphere.Indices.size() / 8, 1.0f, &error);
+	const float deviation = GetSphereDeviation(sphere, indices) - originalDeviation;
+	CHECK(error > 0.0f);
+	// Quadrics measure the distance to the original planes, which is close to the distance to the sphere
+	CHECK(deviation <= error * 2.0f);
+	CHECK(deviation >= error * 0.25f);
+}
+
+TEST_CASE(MeshSimplifier_StopsAtTargetError)
+{
+	const TestMesh sphere = MakeIcosphere(4);
+	const float targetError = 0.01f;
+
+	float error = 0.0f;
+	const std::vector<uint32_t> indices = Simplify(sphere, 0, targetError, &error);
+	CHECK(error <= targetError);
+	CHECK(indices.size() < sphere.Indices.size());
+	CHECK(GetSphereDeviation(sphere, indices) - GetSphereDeviation(sphere, sphere.Indices) <= targetError * 2.0f);
+
+	// A larger error allows more collapses
+	const std::vector<uint32_t> coarser = Simplify(sphere, 0, targetError * 4.0f);
+	CHECK(coarser.size() < indices.size());
+}
+
+TEST_CASE(MeshSimplifier_IsDeterministic)
+{
+	const TestMesh sphere = MakeIcosphere(4);
+	const std::vector<uint32_t> first = Simplify(sphere, sphere.Indices.size() / 4, 1.0f);
+	const std::vector<uint32_t> second = Simplify(sphere, sphere.Indices.size() / 4, 1.0f);
+	CHECK(first == second);
+}
+
+TEST_CASE(MeshSimplifier_KeepsOpenBorders)
+{
+	const uint32_t size = 16;
+	const TestMesh grid = MakeGrid(size);
+
+	float error = 1.0f;
+	const std::vector<uint32_t> indices = Simplify(grid, 0, 0.01f, &error);
+	CHECK(indices.size() < grid.Indices.size() / 2);
+	CHECK(error < 1e-3f);
+
+	// Every border vertex is still used, the outline doesn't move
+	const std::set<uint32_t> used(indices.begin(), indices.end());
+	for (uint32_t i = 0; i <= size; ++i)
+	{
+		CHECK(used.count(i) == 1);
+		CHECK(used.count(size * (size + 1) + i) == 1);
+		CHECK(used.count(i * (size + 1)) == 1);
+		CHECK(used.count(i * (size + 1) + size) == 1);
+	}
+}
@@ -0,0 +1,283 @@
+#include "TestFramework.h"
+
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+	struct TestVertex
+	{
+		float Position[3];
+		float Normal[3];
+		float Uv[2];
+	};
+
+	struct TestMesh
+	{
+		std::vector<TestVertex> Vertices;
+		std::vector<uint32_t> Indices;
+
+		auto Build(size_t InFirstIndex, size_t InNumIndices, std::vector<MeshletData>& OutMeshlets) const -> void
+		{
+			MeshletBuilder::BuildMeshlets(Vertices[0].Position, Vertices[0].Normal, sizeof(TestVertex), Indices.data() + InFirstIndex, InNumIndices, OutMeshlets);
+		}
+	};
+
+	auto Sub(const float* InA, const float* InB) -> std::array<float, 3>
+	{
+		return { InA[0] - InB[0], InA[1] - InB[1], InA[2] - InB[2] };
+	}
+
+	auto Dot(const std::array<float, 3>& InA, const std::array<float, 3>& InB) -> float
+	{
+		return InA[0] * InB[0] + InA[1] * InB[1] + InA[2] * InB[2];
+	}
+
+	auto Cross(const std::array<float, 3>& InA, const std::array<float, 3>& InB) -> std::array<float, 3>
+	{
+		return { InA[1] * InB[2] - InA[2] * InB[1], InA[2] * InB[0] - InA[0] * InB[2], InA[0] * InB[1] - InA[1] * InB[0] };
+	}
+
+	// Unit UV sphere wound counter clockwise seen from outside, without the zero area triangles at the poles
+	auto MakeSphere(uint32_t InStacks, uint32_t InSlices) -> TestMesh
+	{
+		const float pi = 3.14159265f;
+		TestMesh mesh;
+		for (uint32_t i = 0; i <= InStacks; ++i)
+		{
+			const float theta = pi * i / InStacks;
+			for (uint32_t j = 0; j <= InSlices; ++j)
+			{
+				const float phi = 2.0f * pi * j / InSlices;
+				const float p[3] = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+				mesh.Vertices.push_back({ { p[0], p[1], p[2] }, { p[0], p[1], p[2] }, { float(j) / InSlices, float(i) / InStacks } });
+			}
+		}
+
+		auto addTriangle = [&mesh](uint32_t InA, uint32_t InB, uint32_t InC)
+		{
+			const float* a = mesh.Vertices[InA].Position;
+			const std::array<float, 3> normal = Cross(Sub(mesh.Vertices[InB].Position, a), Sub(mesh.Vertices[InC].Position, a));
+			if (Dot(normal, normal) < 1e-12f)
+			{
+				return;
+			}
+			const std::array<float, 3> outward = { a[0], a[1], a[2] };
+			if (Dot(normal, outward) > 0.0f)
+			{
+				mesh.Indices.insert(mesh.Indices.end(), { InA, InB, InC });
+			}
+			else
+			{
+				mesh.Indices.insert(mesh.Indices.end(), { InA, InC, InB });
+			}
+		};
+
+		for (uint32_t i = 0; i < InStacks; ++i)
+		{
+			for (uint32_t j = 0; j < InSlices; ++j)
+			{
+				const uint32_t v = i * (InSlices + 1) + j;
+				addTriangle(v, v + 1, v + InSlices + 1);
+				addTriangle(v + 1, v + InSlices + 2, v + InSlices + 1);
+			}
+		}
+		return mesh;
+	}
+
+	auto ShuffleTriangles(std::vector<uint32_t>& InOutIndices, uint32_t InSeed) -> void
+	{
+		std::vector<std::array<uint32_t, 3>> triangles(InOutIndices.size() / 3);
+		std::memcpy(triangles.data(), InOutIndices.data(), InOutIndices.size() * sizeof(uint32_t));
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(InSeed));
+		std::memcpy(InOutIndices.data(), triangles.data(), InOutIndices.size() * sizeof(uint32_t));
+	}
+
+	// The meshlet test of StaticMeshRenderer's culling with an unscaled transform, true when the meshlet is culled
+	auto IsConeCulled(const MeshletData& InMeshlet, const float* InEye) -> bool
+	{
+		const std::array<float, 3> toCenter = Sub(InMeshlet.Center, InEye);
+		const std::array<float, 3> axis = { InMeshlet.ConeAxis[0], InMeshlet.ConeAxis[1], InMeshlet.ConeAxis[2] };
+		return !(Dot(toCenter, axis) < InMeshlet.ConeCutoff * std::sqrt(Dot(toCenter, toCenter)) + InMeshlet.Radius);
+	}
+
+	// Eyes all around and inside the meshes, which fit the unit sphere
+	auto MakeEyes(uint32_t InCount) -> std::vector<std::array<float, 3>>
+	{
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> coordinate(-6.0f, 6.0f);
+		std::vector<std::array<float, 3>> eyes(InCount);
+		for (std::array<float, 3>& eye : eyes)
+		{
+			eye = { coordinate(random), coordinate(random), coordinate(random) };
+		}
+		return eyes;
+	}
+
+	// Checks the meshlets of one index range: they follow each other from the start to the end of the range
+	// and stay within the vertex and triangle limits
+	auto CheckTiling(const std::vector<MeshletData>& InMeshlets, const uint32_t* InIndices, size_t InNumIndices) -> void
+	{
+		uint32_t nextOffset = 0;
+		for (const MeshletData& meshlet : InMeshlets)
+		{
+			CHECK_EQ(meshlet.IndexOffset, nextOffset);
+			CHECK(meshlet.NumIndices > 0 && meshlet.NumIndices % 3 == 0);
+			CHECK(meshlet.NumIndices / 3 <= MaxMeshletTriangles);
+
+			const std::unordered_set<uint32_t> vertices(InIndices + meshlet.IndexOffset, InIndices + meshlet.IndexOffset + meshlet.NumIndices);
+			CHECK(vertices.size() <= MaxMeshletVertices);
+
+			nextOffset += meshlet.NumIndices;
+		}
+		CHECK_EQ(nextOffset, InNumIndices);
+	}
+}
+
+TEST_CASE(MeshletBuilder_MeshletsTileIndexRanges)
+{
+	TestMesh sphere = MakeSphere(24, 48);
+	MeshOptimizer::OptimizeVertexCache(sphere.Indices, static_cast<uint32_t>(sphere.Vertices.size()));
+
+	// Two sections built into the same array, offsets are relative to each section's indices
+	const size_t split = sphere.Indices.size() / 3 / 2 * 3;
+	std::vector<MeshletData> meshlets;
+	sphere.Build(0, split, meshlets);
+	const size_t numFirst = meshlets.size();
+	sphere.Build(split, sphere.Indices.size() - split, meshlets);
+
+	CHECK(numFirst > 1 && meshlets.size() > numFirst);
+	CheckTiling(std::vector<MeshletData>(meshlets.begin(), meshlets.begin() + numFirst), sphere.Indices.data(), split);
+	CheckTiling(std::vector<MeshletData>(meshlets.begin() + numFirst, meshlets.end()), sphere.Indices.data() + split, sphere.Indices.size() - split);
+
+	// Random order fills meshlets up to the vertex limit
+	TestMesh shuffled = MakeSphere(24, 48);
+	ShuffleTriangles(shuffled.Indices, 5);
+	meshlets.clear();
+	shuffled.Build(0, shuffled.Indices.size(), meshlets);
+	CheckTiling(meshlets, shuffled.Indices.data(), shuffled.Indices.size());
+
+	// The same few vertices over and over fill meshlets up to the triangle limit
+	TestMesh repeated{ { sphere.Vertices[30], sphere.Vertices[31], sphere.Vertices[80] } };
+	for (uint32_t i = 0; i < 300; ++i)
+	{
+		repeated.Indices.insert(repeated.Indices.end(), { 0, 1, 2 });
+	}
+	meshlets.clear();
+	repeated.Build(0, repeated.Indices.size(), meshlets);
+	CheckTiling(meshlets, repeated.Indices.data(), repeated.Indices.size());
+	REQUIRE(meshlets.size() == 3u);
+	CHECK_EQ(meshlets[0].NumIndices, MaxMeshletTriangles * 3);
+}
+
+TEST_CASE(MeshletBuilder_SpheresContainTheirVertices)
+{
+	TestMesh sphere = MakeSphere(24, 48);
+	MeshOptimizer::OptimizeVertexCache(sphere.Indices, static_cast<uint32_t>(sphere.Vertices.size()));
+	std::vector<MeshletData> meshlets;
+	sphere.Build(0, sphere.Indices.size(), meshlets);
+
+	for (const MeshletData& meshlet : meshlets)
+	{
+		CHECK(meshlet.Radius > 0.0f);
+		for (uint32_t i = meshlet.IndexOffset; i < meshlet.IndexOffset + meshlet.NumIndices; ++i)
+		{
+			const std::array<float, 3> offset = Sub(sphere.Vertices[sphere.Indices[i]].Position, meshlet.Center);
+			CHECK(std::sqrt(Dot(offset, offset)) <= meshlet.Radius * (1.0f + 1e-5f));
+		}
+	}
+}
+
+// Whenever the renderer's cone test culls a meshlet, every one of its triangles faces away from the eye
+TEST_CASE(MeshletBuilder_ConeCulledMeshletsAreBackFacing)
+{
+	TestMesh sphere = MakeSphere(24, 48);
+	MeshOptimizer::OptimizeVertexCache(sphere.Indices, static_cast<uint32_t>(sphere.Vertices.size()));
+	std::vector<MeshletData> meshlets;
+	sphere.Build(0, sphere.Indices.size(), meshlets);
+
+	uint32_t numCulled = 0;
+	uint32_t numTests = 0;
+	for (const std::array<float, 3>& eye : MakeEyes(500))
+	{
+		for (const MeshletData& meshlet : meshlets)
+		{
+			++numTests;
+			if (!IsConeCulled(meshlet, eye.data()))
+			{
+				continue;
+			}
+			++numCulled;
+
+			for (uint32_t i = meshlet.IndexOffset; i < meshlet.IndexOffset + meshlet.NumIndices; i += 3)
+			{
+				const float* a = sphere.Vertices[sphere.Indices[i]].Position;
+				const float* b = sphere.Vertices[sphere.Indices[i + 1]].Position;
+				const float* c = sphere.Vertices[sphere.Indices[i + 2]].Position;
+				// Counter clockwise triangles are front facing from the side their normal points to
+				const std::array<float, 3> normal = Cross(Sub(b, a), Sub(c, a));
+				CHECK(Dot(normal, Sub(eye.data(), a)) <= 0.0f);
+			}
+		}
+	}
+
+	// About half of a sphere faces away from an outside eye, the conservative cone test still finds part of it
+	CHECK(numCulled > numTests / 20);
+}
+
+TEST_CASE(MeshletBuilder_DegenerateAndWideMeshletsAreNeverCulled)
+{
+	const std::vector<std::array<float, 3>> eyes = MakeEyes(500);
+	auto checkNeverCulled = [&eyes](const TestMesh& InMesh)
+	{
+		MeshletData meshlet;
+		meshlet.NumIndices = static_cast<uint32_t>(InMesh.Indices.size());
+		MeshletBuilder::ComputeMeshletBounds(InMesh.Vertices[0].Position, InMesh.Vertices[0].Normal, sizeof(TestVertex), InMesh.Indices.data(), meshlet);
+
+		CHECK_EQ(meshlet.ConeCutoff, 1.0f);
+		for (const std::array<float, 3>& eye : eyes)
+		{
+			CHECK(!IsConeCulled(meshlet, eye.data()));
+		}
+	};
+
+	// Zero area triangles only, along a line and collapsed to a point
+	TestMesh degenerate{ {
+		{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+		{ { 0.5f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+		{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+	} };
+	degenerate.Indices = { 0, 1, 2, 2, 1, 0, 1, 1, 1 };
+	checkNeverCulled(degenerate);
+
+	// Normals of the cube faces point everywhere
+	TestMesh cube;
+	for (uint32_t corner = 0; corner < 8; ++corner)
+	{
+		const float x = corner & 1 ? 0.5f : -0.5f;
+		const float y = corner & 2 ? 0.5f : -0.5f;
+		const float z = corner & 4 ? 0.5f : -0.5f;
+		cube.Vertices.push_back({ { x, y, z }, { x, y, z } });
+	}
+	cube.Indices = { 0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5 };
+	checkNeverCulled(cube);
+
+	// A ridge with faces tilted slightly below the horizontal on both sides, the normals span more than a half space
+	TestMesh wedge{ {
+		{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { 0.05f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+		{ { -0.05f, 1.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },
+	} };
+	wedge.Indices = { 0, 1, 2, 0, 3, 1, 0, 1, 4 };
+	checkNeverCulled(wedge);
+}
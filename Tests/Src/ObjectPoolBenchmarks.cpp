@@ -0,0 +1,104 @@
+#include "TestFramework.h"
+
+#include "ObjectPool.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// Component sized objects of three types, on the heap and in the pools
+	template<class Base, size_t Size>
+	class ChurnObject : public Base
+	{
+	public:
+		virtual ~ChurnObject() = default;
+		std::byte Data[Size] = {};
+	};
+
+	class HeapBase
+	{
+	public:
+		virtual ~HeapBase() = default;
+	};
+
+	class PooledBase : public PoolAllocated
+	{
+	public:
+		virtual ~PooledBase() = default;
+	};
+
+	constexpr uint32_t NumLive = 20000;
+	constexpr uint32_t NumFrames = 100;
+	// Despawned and spawned again every frame
+	constexpr uint32_t NumChurn = NumLive / 10;
+
+	template<class Base, class Spawn>
+	auto RunChurn(const Spawn& InSpawn) -> double
+	{
+		std::vector<Base*> objects(NumLive);
+		for (uint32_t i = 0; i < NumLive; ++i)
+		{
+			objects[i] = InSpawn(i % 3);
+		}
+
+		std::mt19937 random(7);
+		const double ms = Testing::MeasureMs(5, [&]()
+		{
+			for (uint32_t frame = 0; frame < NumFrames; ++frame)
+			{
+				for (uint32_t i = 0; i < NumChurn; ++i)
+				{
+					const uint32_t index = random() % NumLive;
+					delete objects[index];
+					objects[index] = InSpawn(index % 3);
+				}
+			}
+		});
+
+		for (Base* object : objects)
+		{
+			delete object;
+		}
+		return ms;
+	}
+}
+
+// Spawn and despawn of actor and component sized objects: 10% of 20k live objects replaced per frame, best of 5 runs
+BENCHMARK(ObjectPool_SpawnDespawnChurn)
+{
+	const double heapMs = RunChurn<HeapBase>([](uint32_t InType) -> HeapBase*
+	{
+		switch (InType)
+		{
+		case 0: return new ChurnObject<HeapBase, 200>();
+		case 1: return new ChurnObject<HeapBase, 450>();
+		default: return new ChurnObject<HeapBase, 900>();
+		}
+	});
+
+	const double sizePoolMs = RunChurn<PooledBase>([](uint32_t InType) -> PooledBase*
+	{
+		switch (InType)
+		{
+		case 0: return new ChurnObject<PooledBase, 200>();
+		case 1: return new ChurnObject<PooledBase, 450>();
+		default: return new ChurnObject<PooledBase, 900>();
+		}
+	});
+
+	const double typePoolMs = RunChurn<PooledBase>([](uint32_t InType) -> PooledBase*
+	{
+		switch (InType)
+		{
+		case 0: return ObjectPools::New<ChurnObject<PooledBase, 200>>();
+		case 1: return ObjectPools::New<ChurnObject<PooledBase, 450>>();
+		default: return ObjectPools::New<ChurnObject<PooledBase, 900>>();
+		}
+	});
+
+	const uint32_t numOperations = NumFrames * NumChurn;
+	std::cout << "  " << numOperations << " despawn + spawn: heap " << heapMs << " ms, size pools " << sizePoolMs
+		<< " ms, type pools " << typePoolMs << " ms" << std::endl;
+}
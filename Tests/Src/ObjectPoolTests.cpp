@@ -0,0 +1,109 @@
+#include "TestFramework.h"
+
+#include "ObjectPool.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	class PooledBase : public PoolAllocated
+	{
+	public:
+		virtual ~PooledBase() = default;
+		float Values[6] = {};
+	};
+
+	// Same size, different types
+	class PooledA : public PooledBase {};
+	class PooledB : public PooledBase {};
+
+	class PooledHuge : public PooledBase
+	{
+	public:
+		std::byte Data[ObjectPools::MaxPooledSize] = {};
+	};
+
+	auto FindStats(const char* InTypeName) -> FixedBlockPool::Stats
+	{
+		for (const FixedBlockPool::Stats& stats : ObjectPools::GetStats())
+		{
+			if (stats.TypeName != nullptr && std::strcmp(stats.TypeName, InTypeName) == 0)
+			{
+				return stats;
+			}
+		}
+		return {};
+	}
+}
+
+TEST_CASE(ObjectPool_PoolPerType)
+{
+	PooledBase* a = ObjectPools::New<PooledA>();
+	PooledBase* b = ObjectPools::New<PooledB>();
+
+	const FixedBlockPool::Stats statsA = FindStats(typeid(PooledA).name());
+	const FixedBlockPool::Stats statsB = FindStats(typeid(PooledB).name());
+	CHECK_EQ(statsA.NumUsedBlocks, size_t(1));
+	CHECK_EQ(statsB.NumUsedBlocks, size_t(1));
+	CHECK_EQ(statsA.BlockSize, statsB.BlockSize);
+
+	// Blocks are 16 byte aligned and go back to the pool of their type through the base
+	CHECK_EQ(reinterpret_cast<uintptr_t>(a) % ObjectPools::BlockAlignment, uintptr_t(0));
+	delete a;
+	delete b;
+	CHECK_EQ(FindStats(typeid(PooledA).name()).NumUsedBlocks, size_t(0));
+	CHECK_EQ(FindStats(typeid(PooledB).name()).NumUsedBlocks, size_t(0));
+}
+
+TEST_CASE(ObjectPool_ReusesFreedBlocks)
+{
+	std::vector<PooledA*> objects;
+	for (int i = 0; i < 100; ++i)
+	{
+		objects.push_back(ObjectPools::New<PooledA>());
+	}
+	const size_t numSlabs = FindStats(typeid(PooledA).name()).NumSlabs;
+
+	PooledA* last = objects.back();
+	delete last;
+	objects.pop_back();
+	PooledA* reused = ObjectPools::New<PooledA>();
+	CHECK(reused == last);
+	objects.push_back(reused);
+
+	for (int round = 0; round < 10; ++round)
+	{
+		for (PooledA* object : objects)
+		{
+			delete object;
+		}
+		for (PooledA*& object : objects)
+		{
+			object = ObjectPools::New<PooledA>();
+		}
+	}
+	CHECK_EQ(FindStats(typeid(PooledA).name()).NumSlabs, numSlabs);
+
+	for (PooledA* object : objects)
+	{
+		delete object;
+	}
+}
+
+// Plain new expressions and oversized objects still work and free through the same path
+TEST_CASE(ObjectPool_FallbackAllocations)
+{
+	PooledBase* sized = new PooledB();
+	PooledBase* huge = ObjectPools::New<PooledHuge>();
+	PooledBase* hugeNew = new PooledHuge();
+
+	CHECK(FindStats(typeid(PooledHuge).name()).BlockSize == 0);
+	CHECK_EQ(reinterpret_cast<uintptr_t>(sized) % ObjectPools::BlockAlignment, uintptr_t(0));
+	CHECK_EQ(reinterpret_cast<uintptr_t>(huge) % ObjectPools::BlockAlignment, uintptr_t(0));
+
+	delete sized;
+	delete huge;
+	delete hugeNew;
+	CHECK_EQ(FindStats(typeid(PooledB).name()).NumUsedBlocks, size_t(0));
+}
@@ -0,0 +1,80 @@
+#include "TestFramework.h"
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE(RenderQueue_SortKeyFields)
+{
+	RenderDrawKey drawKey;
+	drawKey.ShaderId = 3;
+	drawKey.MaterialId = 7;
+	drawKey.MeshId = 9;
+	drawKey.Depth = 12.5f;
+	const uint64_t key = RenderQueue::MakeSortKey(RenderPass::Opaque, drawKey);
+	CHECK_EQ(key >> 60, uint64_t(1));
+	CHECK_EQ((key >> 48) & 0xfff, uint64_t(3));
+	CHECK_EQ((key >> 32) & 0xffff, uint64_t(7));
+	CHECK_EQ((key >> 16) & 0xffff, uint64_t(9));
+	CHECK(RenderQueue::HasDrawKey(key));
+	CHECK(!RenderQueue::HasDrawKey(RenderQueue::MakeSortKey(RenderPass::Opaque, RenderDrawKey())));
+
+	// Shader ids that wrap around to 0 still have a draw key
+	drawKey.ShaderId = 0x1000;
+	CHECK(RenderQueue::HasDrawKey(RenderQueue::MakeSortKey(RenderPass::Opaque, drawKey)));
+}
+
+TEST_CASE(RenderQueue_DepthSortsFrontToBack)
+{
+	uint64_t previous = 0;
+	for (float depth = 0.0f; depth < 10000.0f; depth = depth * 1.01f + 0.01f)
+	{
+		RenderDrawKey drawKey;
+		drawKey.Depth = depth;
+		const uint64_t key = RenderQueue::MakeSortKey(RenderPass::Shadow, drawKey);
+		CHECK(key >= previous);
+		previous = key;
+	}
+
+	RenderDrawKey behind;
+	behind.Depth = -5.0f;
+	CHECK_EQ(RenderQueue::MakeSortKey(RenderPass::Shadow, behind), uint64_t(0));
+}
+
+TEST_CASE(RenderQueue_SortIsStable)
+{
+	std::mt19937 rng(1);
+	for (const int numItems : { 0, 1, 2, 17, 1000, 100000 })
+	{
+		RenderQueue queue;
+		std::vector<RenderQueue::Item> expected;
+		for (int i = 0; i < numItems; ++i)
+		{
+			RenderDrawKey drawKey;
+			drawKey.ShaderId = 1 + rng() % 4;
+			drawKey.MaterialId = rng() % 200;
+			drawKey.MeshId = rng() % 300;
+			drawKey.Depth = (rng() % 100000) / 10.0f;
+
+			// Every tenth renderer has no draw key, those share one key and have to keep their order
+			const uint64_t key = RenderQueue::MakeSortKey(RenderPass::Opaque, i % 10 == 0 ? RenderDrawKey() : drawKey);
+			Renderer* owner = reinterpret_cast<Renderer*>(uintptr_t(i + 1));
+			queue.Add(key, owner);
+			expected.push_back({ key, owner });
+		}
+
+		std::stable_sort(expected.begin(), expected.end(), [](const RenderQueue::Item& InA, const RenderQueue::Item& InB) { return InA.Key < InB.Key; });
+		queue.Sort();
+
+		const std::vector<RenderQueue::Item>& items = queue.GetItems();
+		REQUIRE(items.size() == expected.size());
+		bool bSame = true;
+		for (size_t i = 0; i < items.size(); ++i)
+		{
+			bSame &= items[i].Key == expected[i].Key && items[i].Owner == expected[i].Owner;
+		}
+		CHECK(bSame);
+	}
+}
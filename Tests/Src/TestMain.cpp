@@ -0,0 +1,76 @@
+#include "TestFramework.h"
+
+#include <cstring>
+
+namespace Testing
+{
+	auto GetTests() -> std::vector<Case>&
+	{
+		static std::vector<Case> tests;
+		return tests;
+	}
+
+	auto GetBenchmarks() -> std::vector<Case>&
+	{
+		static std::vector<Case> benchmarks;
+		return benchmarks;
+	}
+
+	auto GetNumFailures() -> uint32_t&
+	{
+		static uint32_t numFailures = 0;
+		return numFailures;
+	}
+}
+
+// EngineTests [--list] [name...], runs every test without names
+int main(int argc, char** argv)
+{
+#ifdef ENGINE_BENCHMARKS
+	std::vector<Testing::Case>& cases = Testing::GetBenchmarks();
+#else
+	std::vector<Testing::Case>& cases = Testing::GetTests();
+#endif
+
+	if (argc > 1 && std::strcmp(argv[1], "--list") == 0)
+	{
+		for (const Testing::Case& testCase : cases)
+		{
+			std::cout << testCase.Name << "\n";
+		}
+		return 0;
+	}
+
+	uint32_t numRun = 0;
+	uint32_t numFailed = 0;
+	for (const Testing::Case& testCase : cases)
+	{
+		bool bSelected = argc == 1;
+		for (int i = 1; i < argc && !bSelected; ++i)
+		{
+			bSelected = std::strcmp(argv[i], testCase.Name) == 0;
+		}
+		if (!bSelected)
+		{
+			continue;
+		}
+
+		std::cout << "[ RUN  ] " << testCase.Name << std::endl;
+		Testing::GetNumFailures() = 0;
+		testCase.Function();
+		++numRun;
+
+		const bool bPassed = Testing::GetNumFailures() == 0;
+		numFailed += bPassed ? 0 : 1;
+		std::cout << (bPassed ? "[  OK  ] " : "[ FAIL ] ") << testCase.Name << std::endl;
+	}
+
+	if (numRun == 0)
+	{
+		std::cerr << "No test matches the given names" << std::endl;
+		return 1;
+	}
+
+	std::cout << numRun - numFailed << "/" << numRun << " passed" << std::endl;
+	return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+#include "TestFramework.h"
+
+#include "TextureArrayPacker.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	const TextureArrayKey AlbedoKey{ 98, 1024, 1024, 11 };
+	const TextureArrayKey NormalKey{ 83, 1024, 1024, 11 };
+}
+
+TEST_CASE(TextureArrayPacker_PagesDoubleUpToTheMaximum)
+{
+	TextureArrayPacker packer(2, 8);
+	std::vector<TextureArraySlot> slots(14);
+	uint32_t numNewPages = 0;
+	for (TextureArraySlot& slot : slots)
+	{
+		numNewPages += packer.Allocate(AlbedoKey, slot) ? 1 : 0;
+	}
+
+	// 2 + 4 + 8 slices
+	CHECK_EQ(numNewPages, 3u);
+	std::set<std::pair<uint32_t, uint32_t>> used;
+	for (const TextureArraySlot& slot : slots)
+	{
+		CHECK(slot.Slice < packer.GetPage(slot.Page).NumSlices);
+		used.insert({ slot.Page, slot.Slice });
+	}
+	CHECK_EQ(used.size(), slots.size());
+
+	// Pages that are already at the maximum don't grow further
+	for (int i = 0; i < 2; ++i)
+	{
+		TextureArraySlot slot;
+		CHECK(packer.Allocate(AlbedoKey, slot));
+		CHECK_EQ(packer.GetPage(slot.Page).NumSlices, 8u);
+		for (int j = 0; j < 7; ++j)
+		{
+			packer.Allocate(AlbedoKey, slot);
+		}
+	}
+}
+
+TEST_CASE(TextureArrayPacker_KeysDontSharePages)
+{
+	TextureArrayPacker packer(2, 8);
+	TextureArraySlot albedo;
+	TextureArraySlot normal;
+	CHECK(packer.Allocate(AlbedoKey, albedo));
+	CHECK(packer.Allocate(NormalKey, normal));
+	CHECK(albedo.Page != normal.Page);
+	CHECK_EQ(packer.GetPage(normal.Page).NumSlices, 2u);
+
+	// Same size, different mip count
+	TextureArrayKey fewerMips = AlbedoKey;
+	fewerMips.MipLevels = 1;
+	TextureArraySlot slot;
+	CHECK(packer.Allocate(fewerMips, slot));
+}
+
+TEST_CASE(TextureArrayPacker_SingleTextureCostsOneSlice)
+{
+	TextureArrayPacker packer;
+	TextureArraySlot slot;
+	CHECK(packer.Allocate(AlbedoKey, slot));
+	CHECK_EQ(packer.GetStats().NumSlices, 1u);
+	CHECK_EQ(packer.GetStats().NumUsedSlices, 1u);
+}
+
+TEST_CASE(TextureArrayPacker_EmptyPageIsReleased)
+{
+	TextureArrayPacker packer(2, 8);
+	std::vector<TextureArraySlot> slots(14);
+	for (TextureArraySlot& slot : slots)
+	{
+		packer.Allocate(AlbedoKey, slot);
+	}
+
+	// The first page has two slices
+	CHECK(!packer.Free(slots[0]));
+	CHECK(packer.Free(slots[1]));
+	CHECK(!packer.GetPage(slots[0].Page).bInUse);
+
+	// Its index is reused, sized like the largest page of the key
+	TextureArraySlot slot;
+	CHECK(packer.Allocate(AlbedoKey, slot));
+	CHECK_EQ(slot.Page, slots[0].Page);
+	CHECK_EQ(packer.GetPage(slot.Page).NumSlices, 8u);
+
+	const TextureArrayPacker::Stats stats = packer.GetStats();
+	CHECK_EQ(stats.NumPages, 3u);
+	CHECK_EQ(stats.NumSlices, 20u);
+	CHECK_EQ(stats.NumUsedSlices, 13u);
+}
+
+TEST_CASE(TextureArrayPacker_ReusesLowestSliceOfFullestPage)
+{
+	TextureArrayPacker packer(4, 4);
+	std::vector<TextureArraySlot> slots(6);
+	for (TextureArraySlot& slot : slots)
+	{
+		packer.Allocate(AlbedoKey, slot);
+	}
+
+	// The first page has 4 of 4 used and the second 2 of 4, freeing two slices of the first makes it 2 of 4 as well
+	packer.Free(slots[2]);
+	packer.Free(slots[1]);
+	TextureArraySlot slot;
+	CHECK(!packer.Allocate(AlbedoKey, slot));
+	CHECK_EQ(slot.Page, slots[0].Page);
+	CHECK_EQ(slot.Slice, 1u);
+
+	// Now the first page is the fuller one
+	CHECK(!packer.Allocate(AlbedoKey, slot));
+	CHECK_EQ(slot.Page, slots[0].Page);
+	CHECK_EQ(slot.Slice, 2u);
+}
+
+TEST_CASE(TextureArrayPacker_InvalidSlotIsIgnored)
+{
+	TextureArrayPacker packer;
+	CHECK(!packer.Free(TextureArraySlot()));
+	TextureArraySlot outOfRange;
+	outOfRange.Page = 5;
+	CHECK(!packer.Free(outOfRange));
+	CHECK_EQ(packer.GetStats().NumPages, 0u);
+}
@@ -0,0 +1,127 @@
+#include "TestFramework.h"
+
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+	// Smooth gradients with noise in red and green, a checker in blue and an alpha ramp.
+	// The size isn't a multiple of 4, so the edge blocks are partial.
+	auto MakeTestImage() -> TextureImage
+	{
+		TextureImage image;
+		image.Width = 257;
+		image.Height = 130;
+		image.Pixels.resize(size_t(image.Width) * image.Height * 4);
+
+		std::mt19937 rng(3);
+		std::normal_distribution<float> noise(0.0f, 6.0f);
+		for (uint32_t y = 0; y < image.Height; ++y)
+		{
+			for (uint32_t x = 0; x < image.Width; ++x)
+			{
+				uint8_t* pixel = &image.Pixels[(size_t(y) * image.Width + x) * 4];
+				pixel[0] = uint8_t(std::clamp(128.0f + 100.0f * std::sin(x * 0.05f) + noise(rng), 0.0f, 255.0f));
+				pixel[1] = uint8_t(std::clamp(128.0f + 100.0f * std::cos(y * 0.07f) + noise(rng), 0.0f, 255.0f));
+				pixel[2] = ((x / 16 + y / 16) & 1) ? 200 : 40;
+				pixel[3] = uint8_t(x * 255 / image.Width);
+			}
+		}
+		return image;
+	}
+
+	auto RoundTripPsnr(const TextureImage& InImage, TextureCompressionFormat InFormat, uint32_t InChannelMask) -> float
+	{
+		const std::vector<uint8_t> compressed = CompressImage(InImage, InFormat);
+		CHECK_EQ(compressed.size(), GetCompressedSize(InImage.Width, InImage.Height, InFormat));
+		const TextureImage decompressed = DecompressImage(compressed.data(), InImage.Width, InImage.Height, InFormat);
+		return ComputePsnr(InImage, decompressed, InChannelMask);
+	}
+}
+
+// Lower bounds a few dB under what the encoders reach, a regression in the endpoint fit drops below them
+TEST_CASE(TextureCompression_Bc1Psnr)
+{
+	CHECK(RoundTripPsnr(MakeTestImage(), TextureCompressionFormat::BC1, 0x7) > 33.0f);
+}
+
+TEST_CASE(TextureCompression_Bc3Psnr)
+{
+	CHECK(RoundTripPsnr(MakeTestImage(), TextureCompressionFormat::BC3, 0xF) > 34.0f);
+}
+
+TEST_CASE(TextureCompression_Bc5Psnr)
+{
+	CHECK(RoundTripPsnr(MakeTestImage(), TextureCompressionFormat::BC5, 0x3) > 45.0f);
+}
+
+TEST_CASE(TextureCompression_Bc7Psnr)
+{
+	CHECK(RoundTripPsnr(MakeTestImage(), TextureCompressionFormat::BC7, 0xF) > 36.0f);
+}
+
+TEST_CASE(TextureCompression_SolidBlocks)
+{
+	TextureImage solid;
+	solid.Width = 4;
+	solid.Height = 4;
+	for (int i = 0; i < 16; ++i)
+	{
+		solid.Pixels.insert(solid.Pixels.end(), { 200, 10, 99, 17 });
+	}
+
+	CHECK(RoundTripPsnr(solid, TextureCompressionFormat::BC1, 0x7) > 40.0f);
+	CHECK(RoundTripPsnr(solid, TextureCompressionFormat::BC3, 0xF) > 40.0f);
+	CHECK(std::isinf(RoundTripPsnr(solid, TextureCompressionFormat::BC5, 0x3)));
+	CHECK(RoundTripPsnr(solid, TextureCompressionFormat::BC7, 0xF) > 45.0f);
+}
+
+TEST_CASE(TextureCompression_MipChainHalvesDownToOnePixel)
+{
+	const TextureImage image = MakeTestImage();
+	for (const MipFilter filter : { MipFilter::Box, MipFilter::Kaiser })
+	{
+		MipChainSettings settings;
+		settings.Filter = filter;
+		settings.bSrgb = true;
+		const std::vector<TextureImage> chain = GenerateMipChain(image, settings);
+
+		REQUIRE(chain.size() == 9);
+		CHECK_EQ(chain[1].Width, 128u);
+		CHECK_EQ(chain[1].Height, 65u);
+		CHECK_EQ(chain[8].Width, 1u);
+		CHECK_EQ(chain[8].Height, 1u);
+
+		// The last mip is about the average, alpha is half the ramp
+		CHECK(std::abs(int(chain[8].Pixels[3]) - 127) <= 2);
+	}
+}
+
+TEST_CASE(TextureCompression_NormalMipsStayUnitLength)
+{
+	TextureImage normals;
+	normals.Width = 8;
+	normals.Height = 8;
+	for (int i = 0; i < 64; ++i)
+	{
+		const float angle = i * 0.3f;
+		const float x = 0.6f * std::cos(angle);
+		const float y = 0.6f * std::sin(angle);
+		const float z = 0.8f;
+		normals.Pixels.insert(normals.Pixels.end(), { uint8_t(std::lround((x * 0.5f + 0.5f) * 255.0f)),
+			uint8_t(std::lround((y * 0.5f + 0.5f) * 255.0f)), uint8_t(std::lround((z * 0.5f + 0.5f) * 255.0f)), 255 });
+	}
+
+	MipChainSettings settings;
+	settings.bNormalMap = true;
+	for (const TextureImage& mip : GenerateMipChain(normals, settings))
+	{
+		const float x = mip.Pixels[0] / 127.5f - 1.0f;
+		const float y = mip.Pixels[1] / 127.5f - 1.0f;
+		const float z = mip.Pixels[2] / 127.5f - 1.0f;
+		CHECK(std::abs(std::sqrt(x * x + y * y + z * z) - 1.0f) < 0.02f);
+	}
+}
@@ -0,0 +1,212 @@
+#include "TestFramework.h"
+
+#include "TextureResidency.h"
+
+#include <vector>
+
+namespace
+{
+	// Bytes of every mip of a square single byte per pixel texture
+	auto MakeMipBytes(uint32_t InSize) -> std::vector<size_t>
+	{
+		std::vector<size_t> mipBytes;
+		for (uint32_t size = InSize; ; size /= 2)
+		{
+			mipBytes.push_back(size_t(size) * size);
+			if (size == 1)
+			{
+				break;
+			}
+		}
+		return mipBytes;
+	}
+
+	auto CompleteAll(TextureResidency& InResidency, std::vector<TextureResidency::Change>& InChanges, bool bInSucceeded) -> void
+	{
+		for (const TextureResidency::Change& change : InChanges)
+		{
+			InResidency.CompleteChange(change.Id, bInSucceeded);
+		}
+		InChanges.clear();
+	}
+}
+
+TEST_CASE(TextureResidency_TailMip)
+{
+	TextureResidency residency;
+	CHECK_EQ(residency.GetTailMip(1024, 1024, 11, 10), 4u);
+	CHECK_EQ(residency.GetTailMip(1024, 1024, 11, 2), 2u);
+	CHECK_EQ(residency.GetTailMip(32, 32, 6, 5), 0u);
+}
+
+TEST_CASE(TextureResidency_StaysWithinBudget)
+{
+	TextureResidency residency;
+	residency.SetMemoryBudget(2500000);
+	residency.SetKeepFrames(2);
+
+	const uint32_t a = residency.AddTexture(1024, 1024, MakeMipBytes(1024), 4);
+	const uint32_t b = residency.AddTexture(1024, 1024, MakeMipBytes(1024), 4);
+	std::vector<TextureResidency::Change> changes;
+
+	residency.RequestResolution(a, 1024);
+	residency.RequestResolution(b, 300);
+	residency.Update(changes);
+	CHECK_EQ(changes.size(), size_t(2));
+	CHECK_EQ(residency.GetWantedMip(a), 0u);
+	CHECK_EQ(residency.GetWantedMip(b), 1u);
+	CompleteAll(residency, changes, true);
+	CHECK_EQ(residency.GetResidentMip(a), 0u);
+	CHECK_EQ(residency.GetResidentMip(b), 1u);
+
+	// No longer requested, but kept while the budget allows it
+	for (int frame = 0; frame < 5; ++frame)
+	{
+		residency.RequestResolution(b, 300);
+		residency.Update(changes);
+		CHECK(changes.empty());
+	}
+	CHECK_EQ(residency.GetWantedMip(a), 4u);
+	CHECK_EQ(residency.GetResidentMip(a), 0u);
+
+	// A new texture needs the memory, the unwanted mips go first
+	const uint32_t d = residency.AddTexture(1024, 1024, MakeMipBytes(1024), 4);
+	bool bTrimmedA = false;
+	for (int frame = 0; frame < 5; ++frame)
+	{
+		residency.RequestResolution(b, 300);
+		residency.RequestResolution(d, 2000);
+		residency.Update(changes);
+		for (const TextureResidency::Change& change : changes)
+		{
+			bTrimmedA |= change.Id == a && change.FirstMip == 4;
+		}
+		CompleteAll(residency, changes, true);
+	}
+	CHECK(bTrimmedA);
+	CHECK_EQ(residency.GetResidentMip(d), 0u);
+	CHECK(residency.GetStats().ResidentBytes <= 2500000);
+
+	// A smaller budget degrades the wanted textures
+	residency.SetMemoryBudget(1024 * 1024);
+	for (int frame = 0; frame < 6; ++frame)
+	{
+		residency.RequestResolution(b, 300);
+		residency.RequestResolution(d, 2000);
+		residency.Update(changes);
+		CompleteAll(residency, changes, true);
+	}
+	CHECK(residency.GetStats().ResidentBytes <= 1024 * 1024);
+}
+
+TEST_CASE(TextureResidency_RemovedWhilePending)
+{
+	TextureResidency residency;
+	residency.SetMemoryBudget(64 << 20);
+	const uint32_t id = residency.AddTexture(1024, 1024, MakeMipBytes(1024), 4);
+	std::vector<TextureResidency::Change> changes;
+
+	residency.RequestResolution(id, 5000);
+	residency.Update(changes);
+	REQUIRE(changes.size() == 1);
+	residency.RemoveTexture(id);
+	CompleteAll(residency, changes, true);
+	CHECK_EQ(residency.GetStats().NumPending, 0u);
+}
+
+TEST_CASE(TextureResidency_FailedChangeBacksOff)
+{
+	TextureResidency residency;
+	residency.SetMemoryBudget(64 << 20);
+	residency.SetFailureBackoff(4, 3);
+	const uint32_t id = residency.AddTexture(1024, 1024, MakeMipBytes(1024), 4);
+	std::vector<TextureResidency::Change> changes;
+
+	// Counts the frames until the change is asked for again, failing it every time
+	auto FramesUntilRetry = [&]() -> int
+	{
+		for (int frame = 1; frame <= 100; ++frame)
+		{
+			residency.RequestResolution(id, 1024);
+			residency.Update(changes);
+			if (!changes.empty())
+			{
+				CompleteAll(residency, changes, false);
+				return frame;
+			}
+		}
+		return -1;
+	};
+
+	residency.RequestResolution(id, 1024);
+	residency.Update(changes);
+	REQUIRE(changes.size() == 1);
+	CompleteAll(residency, changes, false);
+	CHECK_EQ(residency.GetResidentMip(id), 4u);
+	CHECK(!residency.IsPending(id));
+
+	// The wait doubles with every failure in a row
+	CHECK_EQ(FramesUntilRetry(), 4);
+	CHECK_EQ(FramesUntilRetry(), 8);
+	CHECK(!residency.IsStreamable(id));
+	CHECK_EQ(residency.GetStats().NumFailed, uint64_t(3));
+	CHECK_EQ(residency.GetStats().NumUnstreamable, 1u);
+
+	// Stops streaming and keeps what is resident
+	CHECK_EQ(FramesUntilRetry(), -1);
+	CHECK_EQ(residency.GetResidentMip(id), 4u);
+}
+
+TEST_CASE(TextureResidency_SuccessResetsBackoff)
+{
+	TextureResidency residency;
+	residency.SetMemoryBudget(64 << 20);
+	residency.SetFailureBackoff(4, 2);
+	residency.SetKeepFrames(1000);
+	const uint32_t id = residency.AddTexture(1024, 1024, MakeMipBytes(1024), 4);
+	std::vector<TextureResidency::Change> changes;
+
+	residency.RequestResolution(id, 1024);
+	residency.Update(changes);
+	CompleteAll(residency, changes, false);
+
+	for (int frame = 0; frame < 4 && changes.empty(); ++frame)
+	{
+		residency.RequestResolution(id, 1024);
+		residency.Update(changes);
+	}
+	REQUIRE(changes.size() == 1);
+	CompleteAll(residency, changes, true);
+	CHECK_EQ(residency.GetResidentMip(id), 0u);
+
+	// Two failures in a row would stop streaming, one after a success doesn't
+	residency.SetMemoryBudget(1024 * 1024);
+	residency.RequestResolution(id, 1024);
+	residency.Update(changes);
+	REQUIRE(changes.size() == 1);
+	CompleteAll(residency, changes, false);
+	CHECK(residency.IsStreamable(id));
+}
+
+TEST_CASE(TextureResidency_ReservedBytesCountAgainstBudget)
+{
+	TextureResidency residency;
+	residency.SetMemoryBudget(2 << 20);
+	const uint32_t id = residency.AddTexture(1024, 1024, MakeMipBytes(1024), 4);
+	std::vector<TextureResidency::Change> changes;
+
+	// The whole chain is a bit more than 1 MB, with 1.5 MB reserved only the half sized mip fits
+	residency.SetReservedBytes((3 << 20) / 2);
+	residency.RequestResolution(id, 1024);
+	residency.Update(changes);
+	REQUIRE(changes.size() == 1);
+	CHECK_EQ(changes[0].FirstMip, 1u);
+	CompleteAll(residency, changes, true);
+
+	// Growing reservations push resident mips out
+	residency.SetReservedBytes(2 << 20);
+	residency.RequestResolution(id, 1024);
+	residency.Update(changes);
+	REQUIRE(changes.size() == 1);
+	CHECK(changes[0].FirstMip > 1);
+}
@@ -0,0 +1,262 @@
+#include "TestFramework.h"
+
+#include "TransformStore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t NumComponents = 100000;
+	// Actors with a root and attached components, some of them attached to each other
+	constexpr uint32_t ComponentsPerHierarchy = 8;
+
+	// Handles in spawn order, parents of later spawns are not always allocated first
+	auto MakeStore(TransformStore& OutStore) -> std::vector<TransformStore::Handle>
+	{
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> offset(-10.0f, 10.0f);
+
+		std::vector<TransformStore::Handle> handles(NumComponents);
+		for (TransformStore::Handle& handle : handles)
+		{
+			handle = OutStore.Allocate();
+		}
+
+		for (uint32_t root = 0; root < NumComponents; root += ComponentsPerHierarchy)
+		{
+			for (uint32_t i = root; i < root + ComponentsPerHierarchy && i < NumComponents; ++i)
+			{
+				OutStore.SetRelativeTransform(handles[i], Transform(Vector3(offset(random), offset(random), offset(random)),
+					Rotator(Vector3(offset(random), offset(random), 0.0f)), Vector3::One));
+
+				// Attached to the root or to the previous component of the same actor
+				if (i != root)
+				{
+					OutStore.SetParent(handles[i], handles[random() % 2 ? root : i - 1]);
+				}
+			}
+		}
+
+		std::shuffle(handles.begin(), handles.end(), random);
+		return handles;
+	}
+
+	// Every actor moved, the way SceneComponent dirties its attached children
+	auto MarkAllDirty(TransformStore& InStore, const std::vector<TransformStore::Handle>& InHandles) -> void
+	{
+		for (const TransformStore::Handle handle : InHandles)
+		{
+			InStore.MarkDirty(handle);
+		}
+	}
+}
+
+// World matrices of 100k scene components after every actor moved.
+// Batched is the per frame forward pass, lazy is every renderer asking for its matrix in no particular order.
+BENCHMARK(TransformStore_WorldMatrices)
+{
+	TransformStore store;
+	const std::vector<TransformStore::Handle> handles = MakeStore(store);
+
+	// The first batched pass also sorts the entries by depth
+	const double relayoutMs = Testing::MeasureMs(1, [&]() { store.UpdateWorldMatrices(); });
+
+	const double batchedMs = Testing::MeasureMs(10, [&]()
+	{
+		MarkAllDirty(store, handles);
+		store.UpdateWorldMatrices();
+	});
+
+	// Clean after the batched pass, these reads only look the matrices up
+	float batchedSum = 0.0f;
+	for (const TransformStore::Handle handle : handles)
+	{
+		batchedSum += store.GetWorldMatrix(handle)._41;
+	}
+
+	float lazySum = 0.0f;
+	const double lazyMs = Testing::MeasureMs(10, [&]()
+	{
+		MarkAllDirty(store, handles);
+		lazySum = 0.0f;
+		for (const TransformStore::Handle handle : handles)
+		{
+			lazySum += store.GetWorldMatrix(handle)._41;
+		}
+	});
+
+	const double markMs = Testing::MeasureMs(10, [&]() { MarkAllDirty(store, handles); });
+
+	std::cout << "  " << NumComponents << " components: first pass with relayout " << relayoutMs << " ms, batched "
+		<< batchedMs << " ms, lazy " << lazyMs << " ms, marking dirty alone " << markMs << " ms" << std::endl;
+
+	// Both ways end up with the same matrices
+	TransformStore lazyStore;
+	const std::vector<TransformStore::Handle> lazyHandles = MakeStore(lazyStore);
+	for (const TransformStore::Handle handle : lazyHandles)
+	{
+		lazyStore.GetWorldMatrix(handle);
+	}
+	MarkAllDirty(store, handles);
+	store.UpdateWorldMatrices();
+	for (uint32_t i = 0; i < NumComponents; i += 997)
+	{
+		const Matrix& batched = store.GetWorldMatrix(handles[i]);
+		const Matrix& lazy = lazyStore.GetWorldMatrix(lazyHandles[i]);
+		CHECK(std::abs(batched._41 - lazy._41) < 1e-3f && std::abs(batched._42 - lazy._42) < 1e-3f);
+	}
+	// Same matrices summed in the same order
+	CHECK(std::abs(batchedSum - lazySum) <= 1e-3f * (1.0f + std::abs(batchedSum)));
+}
+
+namespace
+{
+	constexpr uint32_t NumHierarchyNodes = 10000;
+
+	// Every node attached to the one before
+	auto MakeChain(TransformStore& OutStore) -> std::vector<TransformStore::Handle>
+	{
+		std::vector<TransformStore::Handle> handles(NumHierarchyNodes);
+		for (uint32_t i = 0; i < NumHierarchyNodes; ++i)
+		{
+			handles[i] = OutStore.Allocate();
+			OutStore.SetRelativeTransform(handles[i], Transform(Vector3(1.0f, 0.0f, 0.0f), Rotator(Vector3(0.0f, 0.01f, 0.0f)), Vector3::One));
+			if (i > 0)
+			{
+				OutStore.SetParent(handles[i], handles[i - 1]);
+			}
+		}
+		return handles;
+	}
+
+	// Every node attached to the first one
+	auto MakeWideTree(TransformStore& OutStore) -> std::vector<TransformStore::Handle>
+	{
+		std::vector<TransformStore::Handle> handles(NumHierarchyNodes);
+		for (uint32_t i = 0; i < NumHierarchyNodes; ++i)
+		{
+			handles[i] = OutStore.Allocate();
+			OutStore.SetRelativeTransform(handles[i], Transform(Vector3(float(i % 100), float(i / 100), 0.0f), Rotator(Vector3(0.0f, float(i % 360), 0.0f)), Vector3::One));
+			if (i > 0)
+			{
+				OutStore.SetParent(handles[i], handles[0]);
+			}
+		}
+		return handles;
+	}
+
+	// Moves the root and dirties everything below it, as SceneComponent::MarkTransformDirty does
+	auto MoveRoot(TransformStore& InStore, const std::vector<TransformStore::Handle>& InHandles, float InOffset) -> void
+	{
+		InStore.SetRelativePosition(InHandles[0], Vector3(InOffset, 0.0f, 0.0f));
+		for (const TransformStore::Handle handle : InHandles)
+		{
+			InStore.MarkDirty(handle);
+		}
+	}
+
+	// What every read did before world transforms were cached: the relative matrices up to the root
+	auto ComputeUncachedWorldMatrix(const TransformStore& InStore, TransformStore::Handle InHandle) -> Matrix
+	{
+		Matrix world = InStore.GetRelativeTransform(InHandle).GetTransformMatrix();
+		for (TransformStore::Handle parent = InStore.GetParent(InHandle); parent != TransformStore::InvalidHandle; parent = InStore.GetParent(parent))
+		{
+			world = world * InStore.GetRelativeTransform(parent).GetTransformMatrix();
+		}
+		return world;
+	}
+
+	auto RunHierarchyBenchmark(const char* InName, std::vector<TransformStore::Handle> (*InMake)(TransformStore&)) -> void
+	{
+		TransformStore store;
+		const std::vector<TransformStore::Handle> handles = InMake(store);
+
+		// Uncached reads of a deep chain are quadratic, every hundredth node is enough to see the cost per read
+		constexpr uint32_t UncachedStride = 100;
+		float uncachedSum = 0.0f;
+		const double uncachedMs = Testing::MeasureMs(1, [&]()
+		{
+			for (uint32_t i = 0; i < NumHierarchyNodes; i += UncachedStride)
+			{
+				uncachedSum += ComputeUncachedWorldMatrix(store, handles[i])._41;
+			}
+		});
+		const double uncachedUsPerRead = uncachedMs * 1000.0 * UncachedStride / NumHierarchyNodes;
+
+		// The first read resolves the dirty chains, every later one is a cached lookup
+		float sum = 0.0f;
+		const double firstMs = Testing::MeasureMs(1, [&]()
+		{
+			for (const TransformStore::Handle handle : handles)
+			{
+				sum += store.GetWorldMatrix(handle)._41;
+			}
+		});
+
+		const double cachedMatrixMs = Testing::MeasureMs(10, [&]()
+		{
+			for (const TransformStore::Handle handle : handles)
+			{
+				sum += store.GetWorldMatrix(handle)._41;
+			}
+		});
+
+		const double cachedTransformMs = Testing::MeasureMs(10, [&]()
+		{
+			for (const TransformStore::Handle handle : handles)
+			{
+				sum += store.GetWorldTransform(handle).Position.x;
+			}
+		});
+
+		float offset = 0.0f;
+		const double movedMatrixMs = Testing::MeasureMs(10, [&]()
+		{
+			MoveRoot(store, handles, offset += 1.0f);
+			for (const TransformStore::Handle handle : handles)
+			{
+				sum += store.GetWorldMatrix(handle)._41;
+			}
+		});
+
+		const double movedTransformMs = Testing::MeasureMs(10, [&]()
+		{
+			MoveRoot(store, handles, offset += 1.0f);
+			for (const TransformStore::Handle handle : handles)
+			{
+				sum += store.GetWorldTransform(handle).Position.x;
+			}
+		});
+
+		const double movedBatchedMs = Testing::MeasureMs(10, [&]()
+		{
+			MoveRoot(store, handles, offset += 1.0f);
+			store.UpdateWorldMatrices();
+		});
+
+		std::cout << "  " << InName << ", " << NumHierarchyNodes << " nodes: uncached " << uncachedUsPerRead << " us per read, first pass "
+			<< firstMs << " ms" << std::endl;
+		std::cout << "    reading all cached: matrices " << cachedMatrixMs << " ms, transforms " << cachedTransformMs << " ms" << std::endl;
+		std::cout << "    moving the root and reading all: matrices " << movedMatrixMs << " ms, transforms " << movedTransformMs
+			<< " ms, batched update " << movedBatchedMs << " ms" << std::endl;
+
+		// The cache agrees with the uncached product, up to the error a deep chain accumulates
+		const TransformStore::Handle last = handles.back();
+		const Matrix uncached = ComputeUncachedWorldMatrix(store, last);
+		const Matrix& cached = store.GetWorldMatrix(last);
+		const float tolerance = 1e-3f * (1.0f + std::abs(uncached._41) + std::abs(uncached._43));
+		CHECK(std::abs(cached._41 - uncached._41) < tolerance && std::abs(cached._43 - uncached._43) < tolerance);
+		CHECK(std::isfinite(sum) && std::isfinite(uncachedSum));
+	}
+}
+
+// Repeated world matrix and transform reads of a 10k deep chain and a 10k wide tree,
+// compared with rebuilding them up the parents on every read as before caching.
+BENCHMARK(TransformStore_DeepAndWideHierarchies)
+{
+	RunHierarchyBenchmark("chain", &MakeChain);
+	RunHierarchyBenchmark("wide tree", &MakeWideTree);
+}
@@ -0,0 +1,162 @@
+#include "TestFramework.h"
+
+#include "UpdateList.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	struct FakeComponent
+	{
+		uint32_t mUpdateListIndex = UpdateList<FakeComponent>::InvalidIndex;
+		uint32_t NumUpdates = 0;
+		// Runs on update, may change the list
+		std::function<void()> OnUpdate;
+	};
+
+	auto MakeComponents(uint32_t InCount) -> std::vector<std::unique_ptr<FakeComponent>>
+	{
+		std::vector<std::unique_ptr<FakeComponent>> components;
+		for (uint32_t i = 0; i < InCount; ++i)
+		{
+			components.push_back(std::make_unique<FakeComponent>());
+		}
+		return components;
+	}
+
+	auto Update(UpdateList<FakeComponent>& InList) -> void
+	{
+		InList.ForEach([](FakeComponent* InComponent)
+		{
+			++InComponent->NumUpdates;
+			if (InComponent->OnUpdate)
+			{
+				InComponent->OnUpdate();
+			}
+		});
+	}
+
+	// Every listed object knows its slot and no slot is empty
+	auto IsConsistent(const UpdateList<FakeComponent>& InList) -> bool
+	{
+		const std::vector<FakeComponent*>& objects = InList.GetObjects();
+		for (uint32_t i = 0; i < objects.size(); ++i)
+		{
+			if (objects[i] == nullptr || objects[i]->mUpdateListIndex != i)
+			{
+				return false;
+			}
+		}
+		return InList.GetNum() == objects.size();
+	}
+}
+
+TEST_CASE(UpdateList_RemoveOutsideUpdate)
+{
+	auto components = MakeComponents(5);
+	UpdateList<FakeComponent> list;
+	for (const auto& component : components)
+	{
+		list.Add(component.get());
+	}
+
+	list.Remove(components[1].get());
+	CHECK_EQ(components[1]->mUpdateListIndex, UpdateList<FakeComponent>::InvalidIndex);
+	CHECK(list.GetObjects()[1] == components[4].get());
+	CHECK(IsConsistent(list));
+	CHECK_EQ(list.GetNum(), size_t(4));
+}
+
+// A component removing the one that would take its slot used to make the loop skip the moved component
+TEST_CASE(UpdateList_RemoveDuringUpdateSkipsNothing)
+{
+	auto components = MakeComponents(6);
+	UpdateList<FakeComponent> list;
+	for (const auto& component : components)
+	{
+		list.Add(component.get());
+	}
+
+	// 1 removes itself and 3, 4 removes 5 which is updated later
+	components[1]->OnUpdate = [&]() { list.Remove(components[1].get()); list.Remove(components[3].get()); };
+	components[4]->OnUpdate = [&]() { list.Remove(components[5].get()); };
+	Update(list);
+
+	CHECK_EQ(components[0]->NumUpdates, 1u);
+	CHECK_EQ(components[1]->NumUpdates, 1u);
+	CHECK_EQ(components[2]->NumUpdates, 1u);
+	CHECK_EQ(components[3]->NumUpdates, 0u);
+	CHECK_EQ(components[4]->NumUpdates, 1u);
+	CHECK_EQ(components[5]->NumUpdates, 0u);
+
+	CHECK_EQ(list.GetNum(), size_t(3));
+	CHECK(IsConsistent(list));
+
+	components[1]->OnUpdate = nullptr;
+	components[4]->OnUpdate = nullptr;
+	Update(list);
+	CHECK_EQ(components[0]->NumUpdates, 2u);
+	CHECK_EQ(components[2]->NumUpdates, 2u);
+	CHECK_EQ(components[4]->NumUpdates, 2u);
+}
+
+TEST_CASE(UpdateList_AddDuringUpdate)
+{
+	auto components = MakeComponents(4);
+	UpdateList<FakeComponent> list;
+	list.Add(components[0].get());
+	list.Add(components[1].get());
+
+	// Spawned components are updated in the same loop, a removed and added again one once
+	components[0]->OnUpdate = [&]() { list.Add(components[2].get()); list.Remove(components[1].get()); list.Add(components[1].get()); };
+	components[2]->OnUpdate = [&]() { list.Add(components[3].get()); list.Remove(components[0].get()); };
+	Update(list);
+
+	CHECK_EQ(components[0]->NumUpdates, 1u);
+	CHECK_EQ(components[1]->NumUpdates, 1u);
+	CHECK_EQ(components[2]->NumUpdates, 1u);
+	CHECK_EQ(components[3]->NumUpdates, 1u);
+	CHECK_EQ(list.GetNum(), size_t(3));
+	CHECK(IsConsistent(list));
+}
+
+// Removing everything while updating, holes at both ends and the middle
+TEST_CASE(UpdateList_RemoveAllDuringUpdate)
+{
+	auto components = MakeComponents(100);
+	UpdateList<FakeComponent> list;
+	for (const auto& component : components)
+	{
+		list.Add(component.get());
+	}
+
+	components[50]->OnUpdate = [&]()
+	{
+		for (uint32_t i = 0; i < 100; i += 2)
+		{
+			list.Remove(components[i].get());
+		}
+	};
+	Update(list);
+	CHECK_EQ(list.GetNum(), size_t(50));
+	CHECK(IsConsistent(list));
+	for (uint32_t i = 0; i < 100; ++i)
+	{
+		// Even ones after 50 were removed before their turn
+		CHECK_EQ(components[i]->NumUpdates, (i % 2 == 0 && i > 50) ? 0u : 1u);
+	}
+
+	components[50]->OnUpdate = nullptr;
+	components[1]->OnUpdate = [&]()
+	{
+		for (uint32_t i = 1; i < 100; i += 2)
+		{
+			list.Remove(components[i].get());
+		}
+	};
+	Update(list);
+	CHECK_EQ(list.GetNum(), size_t(0));
+	CHECK(list.GetObjects().empty());
+}